@@ -0,0 +1,135 @@
+// 线程缓存批量策略的工作负载：自适应的批量（M_grow_batch / M_shrink_batch）与固定的批量对比
+// 批量策略由 alloc.h 的 MYSTL_ALLOC_FIXED_BATCH 在编译期决定，统计计数需要 MYSTL_ALLOC_STATS，
+// 两者都必须在整个程序中一致，因此本文件不属于 mystl_bench，而是以两种设置各构建一个可执行文件，
+// 见 Bench/CMakeLists.txt；实现名为 adaptive 或 fixed_<批量>
+//
+// mixed_trace  每个线程按混合大小（70% <= 128、25% <= 1024、5% <= 4096 bytes）的分配与回收轨迹运行：
+//              持有的区块数在 64 与 8192 之间涨落，每个阶段先成批分配到目标数量，再随机替换一阵，
+//              然后成批回收到下一个目标；一次操作指一次分配或一次回收，
+//              另给出每千次操作的 refills（向内存池重填）、fetches（向中心自由链表取区块）
+//              与 releases（向中心自由链表归还区块）的次数
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "alloc.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "alloc_batch";
+
+    std::string policy_name() {
+#ifdef MYSTL_ALLOC_FIXED_BATCH
+        return "fixed_" + std::to_string(MYSTL_ALLOC_FIXED_BATCH);
+#else
+        return "adaptive";
+#endif // MYSTL_ALLOC_FIXED_BATCH
+    }
+
+    struct block {
+        void* p;
+        size_t size;
+    };
+
+    size_t mixed_size(xorshift& rng) {
+        const uint64_t x = rng.below(100);
+        if(x < 70)
+            return static_cast<size_t>(8 + rng.below(121));
+        if(x < 95)
+            return static_cast<size_t>(129 + rng.below(896));
+        return static_cast<size_t>(1025 + rng.below(3072));
+    }
+
+    // 所有 free list 的某项计数之和
+    struct batch_counters {
+        size_t refills;
+        size_t fetches;
+        size_t releases;
+    };
+
+    batch_counters read_counters() {
+        const mystl::alloc_stats s = mystl::alloc::stats();
+        batch_counters c = { 0, 0, 0 };
+        for(size_t i = 0; i < sizeof(s.size_class) / sizeof(s.size_class[0]); ++i) {
+            c.refills += s.size_class[i].refills;
+            c.fetches += s.size_class[i].fetches;
+            c.releases += s.size_class[i].releases;
+        }
+        return c;
+    }
+
+    void run_mixed_trace(context& ctx, size_t nthreads) {
+        const size_t targets[] = { 8192, 64, 4096, 256, 8192, 1024, 64 };
+        const size_t ntargets = sizeof(targets) / sizeof(targets[0]);
+        const uint64_t rounds = ctx.scaled(40) + 1;
+        const size_t churn = 4096;
+
+        mystl::alloc::flush_thread_cache();
+        mystl::alloc::trim();
+        const batch_counters before = read_counters();
+        measurement m(ctx, kSuite, "mixed_trace", policy_name(), nthreads);
+        std::vector<uint64_t> ops(nthreads, 0);
+        const double seconds = run_threads(nthreads, [&](size_t tid) {
+            xorshift rng(tid + 1);
+            std::vector<block> live;
+            live.reserve(8192);
+            uint64_t n = 0;
+            for(uint64_t r = 0; r < rounds; ++r) {
+                for(size_t t = 0; t < ntargets; ++t) {
+                    while(live.size() < targets[t]) {
+                        block b;
+                        b.size = mixed_size(rng);
+                        b.p = mystl::alloc::allocate(b.size);
+                        *static_cast<volatile char*>(b.p) = 1;
+                        live.push_back(b);
+                        ++n;
+                    }
+                    for(size_t i = 0; i < churn; ++i) {
+                        block& b = live[rng.below(live.size())];
+                        mystl::alloc::deallocate(b.p, b.size);
+                        b.size = mixed_size(rng);
+                        b.p = mystl::alloc::allocate(b.size);
+                        n += 2;
+                    }
+                    const size_t next = targets[(t + 1) % ntargets];
+                    while(live.size() > next) {
+                        const size_t k = static_cast<size_t>(rng.below(live.size()));
+                        mystl::alloc::deallocate(live[k].p, live[k].size);
+                        live[k] = live.back();
+                        live.pop_back();
+                        ++n;
+                    }
+                }
+            }
+            for(size_t i = 0; i < live.size(); ++i)
+                mystl::alloc::deallocate(live[i].p, live[i].size);
+            ops[tid] = n + live.size();
+        });
+        // 退出的线程的计数已并入统计，主线程自己的线程缓存不参与
+        const batch_counters after = read_counters();
+        uint64_t total = 0;
+        for(size_t i = 0; i < nthreads; ++i)
+            total += ops[i];
+        const double per_kop = 1000.0 / static_cast<double>(total);
+        m.extra("refills", static_cast<double>(after.refills - before.refills));
+        m.extra("refills_per_kop", static_cast<double>(after.refills - before.refills) * per_kop);
+        m.extra("fetches_per_kop", static_cast<double>(after.fetches - before.fetches) * per_kop);
+        m.extra("releases_per_kop", static_cast<double>(after.releases - before.releases) * per_kop);
+        m.finish(total, seconds);
+    }
+
+} // namespace
+
+MYSTL_BENCH("alloc_batch", mixed_trace) {
+#ifndef MYSTL_ALLOC_STATS
+    std::fprintf(stderr, "alloc_batch: built without MYSTL_ALLOC_STATS, counters are 0\n");
+#endif // MYSTL_ALLOC_STATS
+    const std::vector<size_t>& threads = ctx.opt().threads;
+    for(size_t i = 0; i < threads.size(); ++i)
+        run_mixed_trace(ctx, threads[i]);
+}
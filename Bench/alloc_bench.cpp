@@ -0,0 +1,595 @@
+// 分配器的标准工作负载：alloc、allocator<T>（new_policy 与 pool_policy）与系统 malloc 的对比
+// 每个工作负载对 --threads 给出的每个线程数、每种实现各测量一次；一次操作指一次分配或一次回收
+//
+// churn_64      每个线程持有 1024 个 64 bytes 的区块，随机挑一个释放再重新分配
+// mixed         同上，大小按 70% <= 128、25% <= 1024、5% <= 4096 bytes 随机选取
+// lifo / fifo   每个线程成批分配 1024 个 48 bytes 的区块，再按相反 / 相同的顺序全部释放
+// cross_thread  生产者分配 64 bytes 的区块，经单生产者单消费者的环形队列交给消费者释放，每两个线程一组
+// thread_churn  线程成批创建，每个线程只做少量分配与回收便退出，衡量线程缓存的建立与退出时归还的开销
+// larson        每个线程随机替换自己区块数组中的 16 ~ 512 bytes 的区块，每轮结束后把数组交给下一个线程，
+//               因此区块常由另一个线程释放
+// append_growth 每个线程像拼接字符串那样每次在缓冲区末尾追加 24 bytes，从空增长到 64 KiB 后释放，
+//               以 alloc::reallocate、alloc 上的“分配 - 拷贝 - 释放”与 std::realloc 对比；
+//               一次操作指一次追加，另以 in_place 给出不移动数据的增长所占的比例
+// chunk_source  依次以 EChunkMalloc、EChunkMmap、EChunkHugeTLB 作为 chunk 的来源，分配 64 MiB 的 64 bytes 区块，
+//               按随机的顺序把区块串成环后沿环访问；一次操作指访问一个区块，耗时主要取决于 cache 与 TLB 的缺失，
+//               另以 build_ns 给出每个区块的分配耗时，以 huge_kb 给出进程使用的大页（透明大页与显式大页）
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "bench.h"
+#include "alloc.h"
+#include "allocator.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif // __GLIBC__
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "alloc";
+
+    // 参与比较的实现，接口统一为按大小分配与按大小回收
+    struct impl_alloc {
+        static const char* name() { return "alloc"; }
+        static void* allocate(size_t n) { return mystl::alloc::allocate(n); }
+        static void deallocate(void* p, size_t n) { mystl::alloc::deallocate(p, n); }
+    };
+
+    struct impl_new_allocator {
+        static const char* name() { return "allocator<T>"; }
+        static void* allocate(size_t n) { return mystl::allocator<char>::allocate(n); }
+        static void deallocate(void* p, size_t n) { mystl::allocator<char>::deallocate(static_cast<char*>(p), n); }
+    };
+
+    struct impl_pool_allocator {
+        typedef mystl::allocator<char, mystl::pool_policy> allocator_type;
+        static const char* name() { return "allocator<T, pool_policy>"; }
+        static void* allocate(size_t n) { return allocator_type::allocate(n); }
+        static void deallocate(void* p, size_t n) { allocator_type::deallocate(static_cast<char*>(p), n); }
+    };
+
+    struct impl_malloc {
+        static const char* name() { return "malloc"; }
+        static void* allocate(size_t n) { return std::malloc(n); }
+        static void deallocate(void* p, size_t) { std::free(p); }
+    };
+
+    // 对 counts 中的每个值，依次以每种实现调用 fn(ctx, count, Impl())
+    template<typename Fn>
+    void for_each_impl(context& ctx, const std::vector<size_t>& counts, const Fn& fn) {
+        for(size_t i = 0; i < counts.size(); ++i) {
+            fn(ctx, counts[i], impl_alloc());
+            fn(ctx, counts[i], impl_new_allocator());
+            fn(ctx, counts[i], impl_pool_allocator());
+            fn(ctx, counts[i], impl_malloc());
+        }
+    }
+
+    template<typename Fn>
+    void for_each_impl(context& ctx, const Fn& fn) {
+        for_each_impl(ctx, ctx.opt().threads, fn);
+    }
+
+    // cross_thread 以生产者 / 消费者对为单位，由线程数得到不重复的对数，至少一对
+    std::vector<size_t> pair_counts(const std::vector<size_t>& threads) {
+        std::vector<size_t> pairs;
+        for(size_t i = 0; i < threads.size(); ++i) {
+            const size_t n = threads[i] < 2 ? 1 : threads[i] / 2;
+            if(std::find(pairs.begin(), pairs.end(), n) == pairs.end())
+                pairs.push_back(n);
+        }
+        return pairs;
+    }
+
+    // 测量之间把空闲内存还给系统，减少上一次测量对 RSS 的影响
+    void release_memory() {
+        mystl::alloc::flush_thread_cache();
+        mystl::alloc::trim();
+#ifdef __GLIBC__
+        malloc_trim(0);
+#endif // __GLIBC__
+    }
+
+    // 写入区块的首字节，使分配到的页真正被映射
+    inline void touch(void* p) {
+        *static_cast<volatile char*>(p) = 1;
+    }
+
+    struct block {
+        void* p;
+        size_t size;
+    };
+
+    struct fixed_size {
+        size_t n;
+        size_t operator()(xorshift&) const { return n; }
+    };
+
+    struct mixed_size {
+        size_t operator()(xorshift& rng) const {
+            const uint64_t x = rng.below(100);
+            if(x < 70)
+                return static_cast<size_t>(8 + rng.below(121));
+            if(x < 95)
+                return static_cast<size_t>(129 + rng.below(896));
+            return static_cast<size_t>(1025 + rng.below(3072));
+        }
+    };
+
+    struct larson_size {
+        size_t operator()(xorshift& rng) const { return static_cast<size_t>(16 + rng.below(497)); }
+    };
+
+    // 各线程的延迟样本在线程结束时并入 measurement
+    class sample_sink {
+    public:
+        explicit sample_sink(measurement& m) : m_(m) {}
+        void merge(latency_sampler& s) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            m_.add_samples(s.samples());
+        }
+
+    private:
+        measurement& m_;
+        std::mutex mutex_;
+    };
+
+    /*****************************************************************************************/
+    // 随机替换：churn_64 与 mixed
+
+    template<typename Impl, typename SizeFn>
+    void run_churn(context& ctx, const char* workload, size_t nthreads, SizeFn size_fn) {
+        const size_t slots = 1024;
+        const uint64_t iters = ctx.scaled(2000000);
+        release_memory();
+        measurement m(ctx, kSuite, workload, Impl::name(), nthreads);
+        sample_sink sink(m);
+        const double seconds = run_threads(nthreads, [&](size_t tid) {
+            xorshift rng(tid + 1);
+            latency_sampler s(ctx.opt().sample_every);
+            std::vector<block> live(slots);
+            for(size_t i = 0; i < slots; ++i) {
+                live[i].size = size_fn(rng);
+                live[i].p = Impl::allocate(live[i].size);
+                touch(live[i].p);
+            }
+            for(uint64_t i = 0; i < iters; ++i) {
+                block& b = live[rng.below(slots)];
+                s.run([&] { Impl::deallocate(b.p, b.size); });
+                b.size = size_fn(rng);
+                s.run([&] { b.p = Impl::allocate(b.size); });
+                touch(b.p);
+            }
+            for(size_t i = 0; i < slots; ++i)
+                Impl::deallocate(live[i].p, live[i].size);
+            sink.merge(s);
+        });
+        m.finish(nthreads * (2 * iters + 2 * slots), seconds);
+    }
+
+    struct churn_runner {
+        template<typename Impl>
+        void operator()(context& ctx, size_t nthreads, Impl) const {
+            run_churn<Impl>(ctx, "churn_64", nthreads, fixed_size{64});
+        }
+    };
+
+    struct mixed_runner {
+        template<typename Impl>
+        void operator()(context& ctx, size_t nthreads, Impl) const {
+            run_churn<Impl>(ctx, "mixed", nthreads, mixed_size());
+        }
+    };
+
+    /*****************************************************************************************/
+    // 释放顺序：lifo 与 fifo
+
+    template<typename Impl>
+    void run_order(context& ctx, const char* workload, size_t nthreads, bool lifo) {
+        const size_t batch = 1024;
+        const size_t size = 48;
+        const uint64_t rounds = ctx.scaled(2000);
+        release_memory();
+        measurement m(ctx, kSuite, workload, Impl::name(), nthreads);
+        sample_sink sink(m);
+        const double seconds = run_threads(nthreads, [&](size_t) {
+            latency_sampler s(ctx.opt().sample_every);
+            std::vector<void*> ptrs(batch);
+            for(uint64_t r = 0; r < rounds; ++r) {
+                for(size_t i = 0; i < batch; ++i) {
+                    s.run([&] { ptrs[i] = Impl::allocate(size); });
+                    touch(ptrs[i]);
+                }
+                if(lifo) {
+                    for(size_t i = batch; i != 0; --i)
+                        s.run([&] { Impl::deallocate(ptrs[i - 1], size); });
+                } else {
+                    for(size_t i = 0; i < batch; ++i)
+                        s.run([&] { Impl::deallocate(ptrs[i], size); });
+                }
+            }
+            sink.merge(s);
+        });
+        m.finish(nthreads * rounds * batch * 2, seconds);
+    }
+
+    struct lifo_runner {
+        template<typename Impl>
+        void operator()(context& ctx, size_t nthreads, Impl) const {
+            run_order<Impl>(ctx, "lifo", nthreads, true);
+        }
+    };
+
+    struct fifo_runner {
+        template<typename Impl>
+        void operator()(context& ctx, size_t nthreads, Impl) const {
+            run_order<Impl>(ctx, "fifo", nthreads, false);
+        }
+    };
+
+    /*****************************************************************************************/
+    // 生产者 / 消费者：cross_thread
+
+    // 单生产者单消费者的有界环形队列，只用于在线程间传递区块，不属于被测的实现
+    class handoff_ring {
+    public:
+        explicit handoff_ring(size_t capacity)
+            : slots_(capacity), capacity_(capacity), head_(0), tail_(0) {}
+
+        bool try_push(void* p) {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            if(tail - head_.load(std::memory_order_acquire) == capacity_)
+                return false;
+            slots_[tail % capacity_] = p;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_pop(void*& p) {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if(head == tail_.load(std::memory_order_acquire))
+                return false;
+            p = slots_[head % capacity_];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::vector<void*> slots_;
+        size_t capacity_;
+        alignas(64) std::atomic<size_t> head_;
+        alignas(64) std::atomic<size_t> tail_;
+    };
+
+    template<typename Impl>
+    void run_cross_thread(context& ctx, size_t pairs) {
+        typedef handoff_ring ring_type;
+        const size_t size = 64;
+        const uint64_t count = ctx.scaled(1000000);
+        release_memory();
+        std::vector<ring_type*> rings(pairs);
+        for(size_t i = 0; i < pairs; ++i)
+            rings[i] = new_aligned<ring_type>(1024);
+        measurement m(ctx, kSuite, "cross_thread", Impl::name(), pairs * 2);
+        sample_sink sink(m);
+        const double seconds = run_threads(pairs * 2, [&](size_t tid) {
+            ring_type& ring = *rings[tid / 2];
+            latency_sampler s(ctx.opt().sample_every);
+            if(tid % 2 == 0) {
+                for(uint64_t i = 0; i < count; ++i) {
+                    void* p = nullptr;
+                    s.run([&] { p = Impl::allocate(size); });
+                    touch(p);
+                    while(!ring.try_push(p))
+                        std::this_thread::yield();
+                }
+            } else {
+                for(uint64_t i = 0; i < count; ) {
+                    void* p;
+                    if(ring.try_pop(p)) {
+                        s.run([&] { Impl::deallocate(p, size); });
+                        ++i;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            sink.merge(s);
+        });
+        m.finish(pairs * count * 2, seconds);
+        for(size_t i = 0; i < pairs; ++i)
+            delete_aligned(rings[i]);
+    }
+
+    struct cross_thread_runner {
+        template<typename Impl>
+        void operator()(context& ctx, size_t pairs, Impl) const {
+            run_cross_thread<Impl>(ctx, pairs);
+        }
+    };
+
+    /*****************************************************************************************/
+    // 短生命周期的线程：thread_churn
+
+    template<typename Impl>
+    void run_thread_churn(context& ctx, size_t nthreads) {
+        const size_t per_thread = 256;
+        const size_t size = 64;
+        const uint64_t waves = ctx.scaled(500);
+        release_memory();
+        measurement m(ctx, kSuite, "thread_churn", Impl::name(), nthreads);
+        sample_sink sink(m);
+        // 计时包括线程的创建与退出，线程退出时会把线程缓存中的区块还给中心自由链表
+        for(uint64_t w = 0; w < waves; ++w) {
+            run_threads(nthreads, [&](size_t) {
+                latency_sampler s(ctx.opt().sample_every);
+                void* ptrs[per_thread];
+                for(size_t i = 0; i < per_thread; ++i) {
+                    s.run([&] { ptrs[i] = Impl::allocate(size); });
+                    touch(ptrs[i]);
+                }
+                for(size_t i = 0; i < per_thread; ++i)
+                    s.run([&] { Impl::deallocate(ptrs[i], size); });
+                sink.merge(s);
+            });
+        }
+        m.finish(waves * nthreads * per_thread * 2);
+    }
+
+    struct thread_churn_runner {
+        template<typename Impl>
+        void operator()(context& ctx, size_t nthreads, Impl) const {
+            run_thread_churn<Impl>(ctx, nthreads);
+        }
+    };
+
+    /*****************************************************************************************/
+    // larson
+
+    template<typename Impl>
+    void run_larson(context& ctx, size_t nthreads) {
+        const size_t slots = 1000;
+        const size_t rounds = 8;
+        const uint64_t per_round = ctx.scaled(250000);
+        release_memory();
+        std::vector<std::vector<block>> arrays(nthreads, std::vector<block>(slots));
+        spin_barrier barrier(nthreads);
+        measurement m(ctx, kSuite, "larson", Impl::name(), nthreads);
+        sample_sink sink(m);
+        const double seconds = run_threads(nthreads, [&](size_t tid) {
+            xorshift rng(tid + 17);
+            larson_size size_fn;
+            latency_sampler s(ctx.opt().sample_every);
+            std::vector<block>& own = arrays[tid];
+            for(size_t i = 0; i < slots; ++i) {
+                own[i].size = size_fn(rng);
+                own[i].p = Impl::allocate(own[i].size);
+                touch(own[i].p);
+            }
+            // 第 r 轮使用第 (tid + r) 个线程最初的数组，每个数组每轮恰好被一个线程使用
+            for(size_t r = 0; r < rounds; ++r) {
+                std::vector<block>& live = arrays[(tid + r) % nthreads];
+                for(uint64_t i = 0; i < per_round; ++i) {
+                    block& b = live[rng.below(slots)];
+                    s.run([&] { Impl::deallocate(b.p, b.size); });
+                    b.size = size_fn(rng);
+                    s.run([&] { b.p = Impl::allocate(b.size); });
+                    touch(b.p);
+                }
+                barrier.wait();
+            }
+            std::vector<block>& last = arrays[(tid + rounds) % nthreads];
+            for(size_t i = 0; i < slots; ++i)
+                Impl::deallocate(last[i].p, last[i].size);
+            sink.merge(s);
+        });
+        m.finish(nthreads * (2 * slots + 2 * rounds * per_round), seconds);
+    }
+
+    struct larson_runner {
+        template<typename Impl>
+        void operator()(context& ctx, size_t nthreads, Impl) const {
+            run_larson<Impl>(ctx, nthreads);
+        }
+    };
+
+    /*****************************************************************************************/
+    // append_growth
+
+    // 参与比较的增长方式，接口为把大小为 old_size 的 p 增长到 new_size，保留原有数据
+    struct grow_alloc_reallocate {
+        static const char* name() { return "alloc::reallocate"; }
+        static void* grow(void* p, size_t old_size, size_t new_size) {
+            return mystl::alloc::reallocate(p, old_size, new_size);
+        }
+        static void deallocate(void* p, size_t n) { mystl::alloc::deallocate(p, n); }
+    };
+
+    struct grow_alloc_copy {
+        static const char* name() { return "alloc+memcpy"; }
+        static void* grow(void* p, size_t old_size, size_t new_size) {
+            void* result = mystl::alloc::allocate(new_size);
+            if(p != nullptr) {
+                std::memcpy(result, p, old_size);
+                mystl::alloc::deallocate(p, old_size);
+            }
+            return result;
+        }
+        static void deallocate(void* p, size_t n) { mystl::alloc::deallocate(p, n); }
+    };
+
+    struct grow_realloc {
+        static const char* name() { return "realloc"; }
+        static void* grow(void* p, size_t, size_t new_size) { return std::realloc(p, new_size); }
+        static void deallocate(void* p, size_t) { std::free(p); }
+    };
+
+    template<typename Impl>
+    void run_append_growth(context& ctx, size_t nthreads) {
+        const size_t piece = 24;
+        const size_t limit = 64 * 1024;
+        const uint64_t rounds = ctx.scaled(2000);
+        release_memory();
+        measurement m(ctx, kSuite, "append_growth", Impl::name(), nthreads);
+        sample_sink sink(m);
+        std::atomic<uint64_t> moved(0);
+        const double seconds = run_threads(nthreads, [&](size_t) {
+            latency_sampler s(ctx.opt().sample_every);
+            uint64_t local_moved = 0;
+            for(uint64_t r = 0; r < rounds; ++r) {
+                char* p = nullptr;
+                size_t size = 0;
+                while(size < limit) {
+                    char* q = nullptr;
+                    s.run([&] { q = static_cast<char*>(Impl::grow(p, size, size + piece)); });
+                    if(q != p)
+                        ++local_moved;
+                    std::memset(q + size, static_cast<int>(r), piece);
+                    p = q;
+                    size += piece;
+                }
+                do_not_optimize(p[size - 1]);
+                Impl::deallocate(p, size);
+            }
+            moved.fetch_add(local_moved, std::memory_order_relaxed);
+            sink.merge(s);
+        });
+        const uint64_t appends = nthreads * rounds * ((limit + piece - 1) / piece);
+        m.extra("in_place", 1.0 - static_cast<double>(moved.load()) / static_cast<double>(appends));
+        m.finish(appends, seconds);
+    }
+
+    struct append_growth_runner {
+        context& ctx;
+        size_t threads;
+        template<typename Impl>
+        void operator()(Impl) const { run_append_growth<Impl>(ctx, threads); }
+    };
+
+    /*****************************************************************************************/
+    // chunk_source
+
+    // /proc/self/smaps_rollup 中 AnonHugePages 与 Private_Hugetlb 之和，单位 KB；不支持时返回 0
+    long huge_page_kb() {
+        long total = 0;
+#ifdef __linux__
+        std::FILE* f = std::fopen("/proc/self/smaps_rollup", "r");
+        if(f == nullptr)
+            return 0;
+        char line[256];
+        while(std::fgets(line, sizeof(line), f) != nullptr) {
+            if(std::strncmp(line, "AnonHugePages:", 14) == 0)
+                total += std::strtol(line + 14, nullptr, 10);
+            else if(std::strncmp(line, "Private_Hugetlb:", 16) == 0)
+                total += std::strtol(line + 16, nullptr, 10);
+        }
+        std::fclose(f);
+#endif // __linux__
+        return total;
+    }
+
+    struct ring_node {
+        ring_node* next;
+        uint64_t value;
+    };
+
+    void run_chunk_source(context& ctx, mystl::EChunkSource source, const char* name) {
+        const size_t size = 64;
+        const size_t count = static_cast<size_t>(ctx.scaled(1 << 20)) + 1024;
+        const uint64_t steps = ctx.scaled(20000000);
+        const mystl::EChunkSource saved = mystl::alloc::chunk_source();
+        release_memory();
+        mystl::alloc::set_chunk_source(source);
+        measurement m(ctx, kSuite, "chunk_source", name);
+
+        std::vector<ring_node*> nodes(count);
+        uint64_t t0 = now_ns();
+        for(size_t i = 0; i < count; ++i) {
+            nodes[i] = static_cast<ring_node*>(mystl::alloc::allocate(size));
+            nodes[i]->value = i;
+        }
+        const double build_seconds = static_cast<double>(now_ns() - t0) * 1e-9;
+
+        // 打乱顺序后串成一个环，相邻访问的区块通常不在同一页
+        std::vector<ring_node*> order(nodes);
+        xorshift rng(7);
+        for(size_t i = count; i > 1; --i)
+            std::swap(order[i - 1], order[rng.below(i)]);
+        for(size_t i = 0; i < count; ++i)
+            order[i]->next = order[(i + 1) % count];
+        const long huge_kb = huge_page_kb();
+
+        t0 = now_ns();
+        ring_node* p = order[0];
+        uint64_t sum = 0;
+        for(uint64_t i = 0; i < steps; ++i) {
+            sum += p->value;
+            p = p->next;
+        }
+        const double seconds = static_cast<double>(now_ns() - t0) * 1e-9;
+        do_not_optimize(sum);
+
+        for(size_t i = 0; i < count; ++i)
+            mystl::alloc::deallocate(nodes[i], size);
+        release_memory();
+        mystl::alloc::set_chunk_source(saved);
+        m.extra("blocks", static_cast<double>(count));
+        m.extra("build_ns", build_seconds * 1e9 / static_cast<double>(count));
+        m.extra("huge_kb", static_cast<double>(huge_kb));
+        m.finish(steps, seconds);
+    }
+
+} // namespace
+
+MYSTL_BENCH("alloc", churn_64) {
+    for_each_impl(ctx, churn_runner());
+}
+
+MYSTL_BENCH("alloc", mixed) {
+    for_each_impl(ctx, mixed_runner());
+}
+
+MYSTL_BENCH("alloc", lifo) {
+    for_each_impl(ctx, lifo_runner());
+}
+
+MYSTL_BENCH("alloc", fifo) {
+    for_each_impl(ctx, fifo_runner());
+}
+
+MYSTL_BENCH("alloc", cross_thread) {
+    for_each_impl(ctx, pair_counts(ctx.opt().threads), cross_thread_runner());
+}
+
+MYSTL_BENCH("alloc", thread_churn) {
+    for_each_impl(ctx, thread_churn_runner());
+}
+
+MYSTL_BENCH("alloc", larson) {
+    for_each_impl(ctx, larson_runner());
+}
+
+MYSTL_BENCH("alloc", append_growth) {
+    const std::vector<size_t>& threads = ctx.opt().threads;
+    for(size_t i = 0; i < threads.size(); ++i) {
+        append_growth_runner runner = { ctx, threads[i] };
+        runner(grow_alloc_reallocate());
+        runner(grow_alloc_copy());
+        runner(grow_realloc());
+    }
+}
+
+MYSTL_BENCH("alloc", chunk_source) {
+    run_chunk_source(ctx, mystl::EChunkMalloc, "EChunkMalloc");
+    run_chunk_source(ctx, mystl::EChunkMmap, "EChunkMmap");
+    run_chunk_source(ctx, mystl::EChunkHugeTLB, "EChunkHugeTLB");
+}
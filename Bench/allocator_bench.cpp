@@ -0,0 +1,158 @@
+// allocator<T, Policy> 的工作负载：节点的分配与回收，new_policy（::operator new）与 pool_policy（内存池）的对比
+//
+// node_churn  每个线程持有 4096 个节点，随机挑一个以 deallocate(p, 1) 回收，再以 allocate(1) 分配，
+//             与节点式容器经 allocator_traits 的调用方式相同；一次操作指一次分配或一次回收
+// list        std::list 以 allocator<T, Policy> 为分配器，push_back 一批元素再 clear；一次操作指一个节点的分配与回收
+// map         std::map 以 allocator<T, Policy> 为分配器，随机插入与删除键；一次操作指一次插入或一次删除
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "bench.h"
+#include "allocator.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "allocator";
+
+    // 与 std::list<int> 的节点大小相同：两个指针加一个值
+    struct node {
+        node* prev;
+        node* next;
+        int value;
+    };
+
+    struct new_policy_tag {
+        typedef mystl::new_policy policy;
+        static const char* name() { return "new_policy"; }
+    };
+
+    struct pool_policy_tag {
+        typedef mystl::pool_policy policy;
+        static const char* name() { return "pool_policy"; }
+    };
+
+    template<typename Fn>
+    void for_each_policy(const Fn& fn) {
+        fn(new_policy_tag());
+        fn(pool_policy_tag());
+    }
+
+    /*****************************************************************************************/
+    // node_churn
+
+    template<typename Tag>
+    void run_node_churn(context& ctx, size_t nthreads) {
+        typedef mystl::allocator<node, typename Tag::policy> allocator_type;
+        const size_t slots = 4096;
+        const uint64_t iters = ctx.scaled(2000000);
+        measurement m(ctx, kSuite, "node_churn", Tag::name(), nthreads);
+        std::mutex mutex;
+        const double seconds = run_threads(nthreads, [&](size_t tid) {
+            xorshift rng(tid + 1);
+            latency_sampler s(ctx.opt().sample_every);
+            std::vector<node*> live(slots);
+            for(size_t i = 0; i < slots; ++i) {
+                live[i] = allocator_type::allocate(1);
+                live[i]->value = static_cast<int>(i);
+            }
+            for(uint64_t i = 0; i < iters; ++i) {
+                node*& p = live[rng.below(slots)];
+                s.run([&] { allocator_type::deallocate(p, 1); });
+                s.run([&] { p = allocator_type::allocate(1); });
+                p->value = static_cast<int>(i);
+            }
+            for(size_t i = 0; i < slots; ++i)
+                allocator_type::deallocate(live[i], 1);
+            std::lock_guard<std::mutex> lock(mutex);
+            m.add_samples(s.samples());
+        });
+        m.finish(nthreads * (2 * iters + 2 * slots), seconds);
+    }
+
+    struct node_churn_runner {
+        context& ctx;
+        size_t threads;
+        template<typename Tag>
+        void operator()(Tag) const { run_node_churn<Tag>(ctx, threads); }
+    };
+
+    /*****************************************************************************************/
+    // list
+
+    struct list_runner {
+        context& ctx;
+        template<typename Tag>
+        void operator()(Tag) const {
+            typedef std::list<int, mystl::allocator<int, typename Tag::policy>> list_type;
+            const size_t batch = 10000;
+            const uint64_t rounds = ctx.scaled(400);
+            measurement m(ctx, kSuite, "list", Tag::name());
+            list_type l;
+            for(uint64_t r = 0; r < rounds; ++r) {
+                for(size_t i = 0; i < batch; ++i)
+                    l.push_back(static_cast<int>(i));
+                do_not_optimize(l.back());
+                l.clear();
+            }
+            m.finish(rounds * batch);
+        }
+    };
+
+    /*****************************************************************************************/
+    // map
+
+    struct map_runner {
+        context& ctx;
+        template<typename Tag>
+        void operator()(Tag) const {
+            typedef mystl::allocator<std::pair<const uint64_t, uint64_t>, typename Tag::policy> allocator_type;
+            typedef std::map<uint64_t, uint64_t, std::less<uint64_t>, allocator_type> map_type;
+            const uint64_t key_range = 1 << 16;
+            const uint64_t iters = ctx.scaled(2000000);
+            xorshift rng(7);
+            map_type mp;
+            for(uint64_t i = 0; i < key_range / 2; ++i)
+                mp[rng.below(key_range)] = i;
+            measurement m(ctx, kSuite, "map", Tag::name());
+            latency_sampler s(ctx.opt().sample_every);
+            for(uint64_t i = 0; i < iters; ++i) {
+                const uint64_t key = rng.below(key_range);
+                s.run([&] {
+                    if(i % 2 == 0)
+                        mp.insert(std::make_pair(key, i));
+                    else
+                        mp.erase(key);
+                });
+            }
+            do_not_optimize(mp.size());
+            m.add_samples(s.samples());
+            m.finish(iters);
+        }
+    };
+
+} // namespace
+
+MYSTL_BENCH("allocator", node_churn) {
+    const std::vector<size_t>& threads = ctx.opt().threads;
+    for(size_t i = 0; i < threads.size(); ++i) {
+        node_churn_runner runner = { ctx, threads[i] };
+        for_each_policy(runner);
+    }
+}
+
+MYSTL_BENCH("allocator", list) {
+    list_runner runner = { ctx };
+    for_each_policy(runner);
+}
+
+MYSTL_BENCH("allocator", map) {
+    map_runner runner = { ctx };
+    for_each_policy(runner);
+}
@@ -0,0 +1,424 @@
+#ifndef MY_TINY_BENCH_H_
+#define MY_TINY_BENCH_H_
+
+// mystl_bench 的公共部分：工作负载的登记、计时、延迟采样、峰值 RSS，以及结果的收集
+// 每个 *_bench.cpp 以 MYSTL_BENCH(suite, name) 定义工作负载，由 bench_main.cpp 统一运行与输出
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "alloc.h"
+#include "allocator.h"
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace mystl_bench {
+
+    typedef std::chrono::steady_clock clock_type;
+
+    inline uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock_type::now().time_since_epoch()).count());
+    }
+
+    // 连续两次读取时钟的最小间隔，延迟采样时从每个样本中扣除
+    inline uint64_t timer_overhead_ns() {
+        static const uint64_t overhead = [] {
+            uint64_t best = ~uint64_t(0);
+            for(int i = 0; i < 1000; ++i) {
+                const uint64_t t0 = now_ns();
+                const uint64_t t1 = now_ns();
+                best = std::min(best, t1 - t0);
+            }
+            return best;
+        }();
+        return overhead;
+    }
+
+    /*****************************************************************************************/
+    // 内存占用
+
+    // 读取 /proc/self/status 中的一项，单位 KB；不支持时返回 0
+    inline long proc_status_kb(const char* key) {
+#ifdef __linux__
+        std::FILE* f = std::fopen("/proc/self/status", "r");
+        if(f == nullptr)
+            return 0;
+        char line[256];
+        const size_t len = std::strlen(key);
+        long value = 0;
+        while(std::fgets(line, sizeof(line), f) != nullptr) {
+            if(std::strncmp(line, key, len) == 0 && line[len] == ':') {
+                value = std::strtol(line + len + 1, nullptr, 10);
+                break;
+            }
+        }
+        std::fclose(f);
+        return value;
+#else
+        (void)key;
+        return 0;
+#endif // __linux__
+    }
+
+    inline long current_rss_kb() {
+        return proc_status_kb("VmRSS");
+    }
+
+    // 进程的峰值 RSS，reset_peak_rss 之后从当前值重新统计
+    inline long peak_rss_kb() {
+        const long hwm = proc_status_kb("VmHWM");
+#ifdef __linux__
+        if(hwm == 0) {
+            rusage usage;
+            if(getrusage(RUSAGE_SELF, &usage) == 0)
+                return usage.ru_maxrss;
+        }
+#endif // __linux__
+        return hwm;
+    }
+
+    // Linux 上向 /proc/self/clear_refs 写入 5 把峰值 RSS 重置为当前值，其它平台不做任何事
+    inline void reset_peak_rss() {
+#ifdef __linux__
+        std::FILE* f = std::fopen("/proc/self/clear_refs", "w");
+        if(f != nullptr) {
+            std::fputs("5", f);
+            std::fclose(f);
+        }
+#endif // __linux__
+    }
+
+    /*****************************************************************************************/
+    // 运行参数与结果
+
+    struct options {
+        double scale = 1.0;                 // 操作次数的倍率，--quick 时取较小值
+        std::vector<size_t> threads;        // 多线程工作负载依次使用的线程数
+        size_t sample_every = 16;           // 每隔多少次操作采样一次单次操作的延迟
+    };
+
+    // 一次测量的结果，延迟未采样时为负
+    struct result {
+        std::string suite;
+        std::string workload;
+        std::string impl;
+        size_t threads = 1;
+        uint64_t ops = 0;
+        double seconds = 0.0;
+        double p50_ns = -1.0;
+        double p99_ns = -1.0;
+        long peak_rss_kb = 0;               // 测量期间进程的峰值 RSS
+        long rss_delta_kb = 0;              // 峰值 RSS 与测量开始时 RSS 之差
+        std::vector<std::pair<std::string, double>> extra;  // 工作负载特有的指标
+
+        double ops_per_sec() const { return seconds > 0.0 ? static_cast<double>(ops) / seconds : 0.0; }
+    };
+
+    class context {
+    public:
+        explicit context(const options& opt) : opt_(opt) {}
+
+        const options& opt() const { return opt_; }
+
+        // 按倍率缩放操作次数，至少为 1
+        uint64_t scaled(uint64_t n) const {
+            const double v = static_cast<double>(n) * opt_.scale;
+            return v < 1.0 ? 1 : static_cast<uint64_t>(v);
+        }
+
+        void report(const result& r) {
+            results_.push_back(r);
+            if(on_result_)
+                on_result_(r);
+        }
+
+        void on_result(std::function<void(const result&)> fn) { on_result_ = std::move(fn); }
+        const std::vector<result>& results() const { return results_; }
+
+    private:
+        options opt_;
+        std::vector<result> results_;
+        std::function<void(const result&)> on_result_;
+    };
+
+    /*****************************************************************************************/
+    // 延迟采样
+
+    // 每 every 次操作计时一次，其余操作不读时钟，采样使吞吐量多出约 1 / every 次时钟读取的开销
+    class latency_sampler {
+    public:
+        explicit latency_sampler(size_t every) : every_(every == 0 ? 1 : every), count_(0) {}
+
+        template<typename Op>
+        void run(Op&& op) {
+            if(++count_ == every_) {
+                count_ = 0;
+                const uint64_t t0 = now_ns();
+                op();
+                samples_.push_back(now_ns() - t0);
+            } else {
+                op();
+            }
+        }
+
+        // 直接记录一个样本，用于不便包装成单个操作的测量
+        void add(uint64_t ns) { samples_.push_back(ns); }
+
+        std::vector<uint64_t>& samples() { return samples_; }
+
+    private:
+        size_t every_;
+        size_t count_;
+        std::vector<uint64_t> samples_;
+    };
+
+    // 样本的 p 分位数（0 <= p <= 1），扣除时钟开销；没有样本时返回 -1
+    inline double percentile(std::vector<uint64_t>& samples, double p) {
+        if(samples.empty())
+            return -1.0;
+        const size_t k = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+        const uint64_t overhead = timer_overhead_ns();
+        const uint64_t v = samples[k];
+        return static_cast<double>(v > overhead ? v - overhead : 0);
+    }
+
+    /*****************************************************************************************/
+    // 测量
+
+    // 构造时记录起点并重置峰值 RSS，finish 时计算吞吐量、延迟分位数与内存占用并提交结果
+    class measurement {
+    public:
+        measurement(context& ctx, const char* suite, const std::string& workload,
+                    const std::string& impl, size_t threads = 1)
+            : ctx_(ctx) {
+            result_.suite = suite;
+            result_.workload = workload;
+            result_.impl = impl;
+            result_.threads = threads;
+            reset_peak_rss();
+            start_rss_ = current_rss_kb();
+            start_ = now_ns();
+        }
+
+        // 重新开始计时，用于排除准备工作（如线程创建、数据生成）的时间
+        void restart() { start_ = now_ns(); }
+
+        void add_samples(const std::vector<uint64_t>& s) { samples_.insert(samples_.end(), s.begin(), s.end()); }
+        void extra(const char* name, double value) { result_.extra.push_back(std::make_pair(std::string(name), value)); }
+
+        // seconds 为负时以构造（或 restart）至今的时间为准
+        const result& finish(uint64_t ops, double seconds = -1.0) {
+            const uint64_t end = now_ns();
+            result_.ops = ops;
+            result_.seconds = seconds >= 0.0 ? seconds : static_cast<double>(end - start_) * 1e-9;
+            result_.p50_ns = percentile(samples_, 0.50);
+            result_.p99_ns = percentile(samples_, 0.99);
+            result_.peak_rss_kb = peak_rss_kb();
+            result_.rss_delta_kb = result_.peak_rss_kb > start_rss_ ? result_.peak_rss_kb - start_rss_ : 0;
+            ctx_.report(result_);
+            return result_;
+        }
+
+    private:
+        context& ctx_;
+        result result_;
+        std::vector<uint64_t> samples_;
+        long start_rss_;
+        uint64_t start_;
+    };
+
+    // 启动 n 个线程执行 fn(0) ... fn(n - 1)，线程都就绪后才同时开始，返回从开始到全部结束的秒数
+    inline double run_threads(size_t n, const std::function<void(size_t)>& fn) {
+        std::atomic<size_t> ready(0);
+        std::atomic<bool> go(false);
+        std::vector<std::thread> threads;
+        threads.reserve(n);
+        for(size_t i = 0; i < n; ++i) {
+            threads.emplace_back([&, i] {
+                ready.fetch_add(1, std::memory_order_acq_rel);
+                while(!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                fn(i);
+            });
+        }
+        while(ready.load(std::memory_order_acquire) != n)
+            std::this_thread::yield();
+        const uint64_t start = now_ns();
+        go.store(true, std::memory_order_release);
+        for(size_t i = 0; i < n; ++i)
+            threads[i].join();
+        return static_cast<double>(now_ns() - start) * 1e-9;
+    }
+
+    // 自旋屏障：n 个线程都到达后一起继续，等待时让出处理器，线程数多于核数时也能推进
+    class spin_barrier {
+    public:
+        explicit spin_barrier(size_t n) : n_(n), count_(0), generation_(0) {}
+
+        void wait() {
+            const size_t gen = generation_.load(std::memory_order_acquire);
+            if(count_.fetch_add(1, std::memory_order_acq_rel) + 1 == n_) {
+                count_.store(0, std::memory_order_relaxed);
+                generation_.fetch_add(1, std::memory_order_release);
+            } else {
+                while(generation_.load(std::memory_order_acquire) == gen)
+                    std::this_thread::yield();
+            }
+        }
+
+    private:
+        const size_t n_;
+        std::atomic<size_t> count_;
+        std::atomic<size_t> generation_;
+    };
+
+    // 按类型的对齐要求在堆上构造对象，用于按缓存行对齐的并发结构（C++11 的 new 不保证超出的对齐）
+    template<typename T, typename... Args>
+    T* new_aligned(Args&&... args) {
+        void* p = mystl::aligned_malloc(sizeof(T), alignof(T));
+        if(p == nullptr)
+            throw std::bad_alloc();
+        try {
+            return ::new(p) T(std::forward<Args>(args)...);
+        } catch(...) {
+            mystl::aligned_free(p);
+            throw;
+        }
+    }
+
+    template<typename T>
+    void delete_aligned(T* p) {
+        if(p == nullptr)
+            return;
+        p->~T();
+        mystl::aligned_free(p);
+    }
+
+    // 统计经它分配、尚未回收的字节数的分配器，用于计算容器每个元素占用的内存
+    // 计数不加锁，只在单线程的测量中使用；满足标准库与 mystl 容器对分配器的要求
+    // 内存由 mystl::allocator<T> 分配，按缓存行对齐的节点（如 btree）同样适用
+    inline size_t& counted_bytes() {
+        static size_t bytes = 0;
+        return bytes;
+    }
+
+    template<typename T>
+    class counting_allocator {
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template<typename U>
+        struct rebind {
+            typedef counting_allocator<U> other;
+        };
+
+        counting_allocator() noexcept {}
+        template<typename U>
+        counting_allocator(const counting_allocator<U>&) noexcept {}
+
+        T* allocate() {
+            return allocate(1);
+        }
+
+        T* allocate(size_t n) {
+            counted_bytes() += n * sizeof(T);
+            return mystl::allocator<T>::allocate(n);
+        }
+
+        void deallocate(T* p) noexcept {
+            deallocate(p, 1);
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+            counted_bytes() -= n * sizeof(T);
+            mystl::allocator<T>::deallocate(p, n);
+        }
+    };
+
+    template<typename T, typename U>
+    bool operator==(const counting_allocator<T>&, const counting_allocator<U>&) noexcept { return true; }
+    template<typename T, typename U>
+    bool operator!=(const counting_allocator<T>&, const counting_allocator<U>&) noexcept { return false; }
+
+    // 防止编译器把结果未被使用的计算整个删掉
+    template<typename T>
+    inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        __asm__ __volatile__("" : : "r,m"(value) : "memory");
+#else
+        static volatile const T* sink;
+        sink = &value;
+#endif
+    }
+
+    // 一个小而快的伪随机数发生器，避免 <random> 的分布开销干扰测量
+    class xorshift {
+    public:
+        explicit xorshift(uint64_t seed) : state_(seed * 0x9E3779B97F4A7C15ull + 1) {}
+        uint64_t operator()() {
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 7;
+            state_ ^= state_ << 17;
+            return state_;
+        }
+        // [0, n) 中的随机数
+        uint64_t below(uint64_t n) { return (*this)() % n; }
+
+    private:
+        uint64_t state_;
+    };
+
+    /*****************************************************************************************/
+    // 工作负载的登记
+
+    typedef void (*bench_fn)(context&);
+
+    struct bench_entry {
+        const char* suite;
+        const char* name;
+        bench_fn fn;
+    };
+
+    inline std::vector<bench_entry>& registry() {
+        static std::vector<bench_entry> entries;
+        return entries;
+    }
+
+    struct registrar {
+        registrar(const char* suite, const char* name, bench_fn fn) {
+            bench_entry e = { suite, name, fn };
+            registry().push_back(e);
+        }
+    };
+
+} // namespace mystl_bench
+
+// 定义并登记一个工作负载，函数体内可使用 ctx（mystl_bench::context&）
+#define MYSTL_BENCH(suite, name)                                                        \
+    static void mystl_bench_##name(mystl_bench::context& ctx);                         \
+    static mystl_bench::registrar mystl_bench_registrar_##name(suite, #name, &mystl_bench_##name); \
+    static void mystl_bench_##name(mystl_bench::context& ctx)
+
+#endif // MY_TINY_BENCH_H_
@@ -0,0 +1,325 @@
+// mystl_bench 的入口：解析参数，按登记顺序运行匹配的工作负载，输出可读的表格与机器可读的结果
+//
+// 用法：mystl_bench [--list] [--filter=a,b] [--scale=X | --quick] [--threads=1,2,4]
+//                    [--sample-every=N] [--format=text|json|csv] [--json=FILE] [--csv=FILE] [--label=STR]
+// --filter 按 "suite/name" 的子串匹配；--json / --csv 把全部结果写入文件，便于跨提交比较
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+
+#ifndef MYSTL_BENCH_REVISION
+#define MYSTL_BENCH_REVISION "unknown"
+#endif // MYSTL_BENCH_REVISION
+
+#ifndef MYSTL_BENCH_BUILD_TYPE
+#define MYSTL_BENCH_BUILD_TYPE "unknown"
+#endif // MYSTL_BENCH_BUILD_TYPE
+
+namespace {
+
+    using namespace mystl_bench;
+
+    enum output_format { EFormatText, EFormatJson, EFormatCsv };
+
+    struct cli {
+        options opt;
+        std::vector<std::string> filters;
+        output_format format = EFormatText;
+        std::string json_path;
+        std::string csv_path;
+        std::string label;
+        bool list = false;
+    };
+
+    void print_usage(std::FILE* out) {
+        std::fprintf(out,
+            "usage: mystl_bench [options]\n"
+            "  --list                 list the workloads and exit\n"
+            "  --filter=a,b           run workloads whose \"suite/name\" contains any of the substrings\n"
+            "  --scale=X              multiply operation counts by X (default 1)\n"
+            "  --quick                same as --scale=0.02, for smoke runs\n"
+            "  --threads=1,2,4        thread counts for multi-threaded workloads\n"
+            "                         (default 1 and powers of two up to the hardware concurrency)\n"
+            "  --sample-every=N       time one operation in every N for the latency percentiles (default 16)\n"
+            "  --format=text|json|csv format written to stdout (default text)\n"
+            "  --json=FILE            also write all results as JSON to FILE\n"
+            "  --csv=FILE             also write all results as CSV to FILE\n"
+            "  --label=STR            free-form label stored in the output metadata\n");
+    }
+
+    std::vector<std::string> split(const std::string& s) {
+        std::vector<std::string> parts;
+        size_t begin = 0;
+        while(begin <= s.size()) {
+            const size_t end = std::min(s.find(',', begin), s.size());
+            if(end > begin)
+                parts.push_back(s.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        return parts;
+    }
+
+    bool starts_with(const char* arg, const char* prefix, const char** value) {
+        const size_t n = std::strlen(prefix);
+        if(std::strncmp(arg, prefix, n) != 0)
+            return false;
+        *value = arg + n;
+        return true;
+    }
+
+    std::vector<size_t> default_threads() {
+        const size_t hw = std::max<size_t>(1, std::thread::hardware_concurrency());
+        std::vector<size_t> threads;
+        for(size_t n = 1; n < hw; n *= 2)
+            threads.push_back(n);
+        threads.push_back(hw);
+        return threads;
+    }
+
+    bool parse(int argc, char** argv, cli& c) {
+        for(int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            const char* value = nullptr;
+            if(std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+                print_usage(stdout);
+                std::exit(0);
+            } else if(std::strcmp(arg, "--list") == 0) {
+                c.list = true;
+            } else if(std::strcmp(arg, "--quick") == 0) {
+                c.opt.scale = 0.02;
+            } else if(starts_with(arg, "--filter=", &value)) {
+                const std::vector<std::string> parts = split(value);
+                c.filters.insert(c.filters.end(), parts.begin(), parts.end());
+            } else if(starts_with(arg, "--scale=", &value)) {
+                c.opt.scale = std::strtod(value, nullptr);
+                if(!(c.opt.scale > 0.0))
+                    return false;
+            } else if(starts_with(arg, "--threads=", &value)) {
+                c.opt.threads.clear();
+                const std::vector<std::string> parts = split(value);
+                for(size_t k = 0; k < parts.size(); ++k) {
+                    const long n = std::strtol(parts[k].c_str(), nullptr, 10);
+                    if(n <= 0)
+                        return false;
+                    c.opt.threads.push_back(static_cast<size_t>(n));
+                }
+            } else if(starts_with(arg, "--sample-every=", &value)) {
+                const long n = std::strtol(value, nullptr, 10);
+                if(n <= 0)
+                    return false;
+                c.opt.sample_every = static_cast<size_t>(n);
+            } else if(starts_with(arg, "--format=", &value)) {
+                if(std::strcmp(value, "text") == 0)
+                    c.format = EFormatText;
+                else if(std::strcmp(value, "json") == 0)
+                    c.format = EFormatJson;
+                else if(std::strcmp(value, "csv") == 0)
+                    c.format = EFormatCsv;
+                else
+                    return false;
+            } else if(starts_with(arg, "--json=", &value)) {
+                c.json_path = value;
+            } else if(starts_with(arg, "--csv=", &value)) {
+                c.csv_path = value;
+            } else if(starts_with(arg, "--label=", &value)) {
+                c.label = value;
+            } else {
+                return false;
+            }
+        }
+        if(c.opt.threads.empty())
+            c.opt.threads = default_threads();
+        return true;
+    }
+
+    bool selected(const cli& c, const bench_entry& e) {
+        if(c.filters.empty())
+            return true;
+        const std::string full = std::string(e.suite) + "/" + e.name;
+        for(size_t i = 0; i < c.filters.size(); ++i) {
+            if(full.find(c.filters[i]) != std::string::npos)
+                return true;
+        }
+        return false;
+    }
+
+    /*****************************************************************************************/
+    // 输出
+
+    void print_text(std::FILE* out, const result& r) {
+        std::fprintf(out, "%-10s %-26s %-28s t=%-3zu %14.0f ops/s", r.suite.c_str(), r.workload.c_str(),
+                     r.impl.c_str(), r.threads, r.ops_per_sec());
+        if(r.p50_ns >= 0.0)
+            std::fprintf(out, "  p50 %8.1f ns  p99 %9.1f ns", r.p50_ns, r.p99_ns);
+        std::fprintf(out, "  peak %8ld KB (+%ld)", r.peak_rss_kb, r.rss_delta_kb);
+        for(size_t i = 0; i < r.extra.size(); ++i)
+            std::fprintf(out, "  %s=%g", r.extra[i].first.c_str(), r.extra[i].second);
+        std::fprintf(out, "\n");
+        std::fflush(out);
+    }
+
+    void write_json_string(std::FILE* out, const std::string& s) {
+        std::fputc('"', out);
+        for(size_t i = 0; i < s.size(); ++i) {
+            const unsigned char ch = static_cast<unsigned char>(s[i]);
+            if(ch == '"' || ch == '\\')
+                std::fprintf(out, "\\%c", ch);
+            else if(ch < 0x20)
+                std::fprintf(out, "\\u%04x", ch);
+            else
+                std::fputc(ch, out);
+        }
+        std::fputc('"', out);
+    }
+
+    void write_json_number(std::FILE* out, double v) {
+        if(v < 0.0)
+            std::fprintf(out, "null");
+        else
+            std::fprintf(out, "%.17g", v);
+    }
+
+    std::string utc_timestamp() {
+        char buf[32];
+        const std::time_t t = std::time(nullptr);
+        std::tm tm_utc;
+#ifdef _MSC_VER
+        gmtime_s(&tm_utc, &t);
+#else
+        gmtime_r(&t, &tm_utc);
+#endif // _MSC_VER
+        std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm_utc);
+        return buf;
+    }
+
+    void write_json(std::FILE* out, const cli& c, const std::vector<result>& results) {
+        std::fprintf(out, "{\n  \"meta\": {\"revision\": ");
+        write_json_string(out, MYSTL_BENCH_REVISION);
+        std::fprintf(out, ", \"build_type\": ");
+        write_json_string(out, MYSTL_BENCH_BUILD_TYPE);
+        std::fprintf(out, ", \"compiler\": ");
+#ifdef __VERSION__
+        write_json_string(out, __VERSION__);
+#else
+        write_json_string(out, "unknown");
+#endif // __VERSION__
+        std::fprintf(out, ", \"cplusplus\": %ld, \"hardware_concurrency\": %u, \"scale\": %.17g, \"label\": ",
+                     static_cast<long>(__cplusplus), std::thread::hardware_concurrency(), c.opt.scale);
+        write_json_string(out, c.label);
+        std::fprintf(out, ", \"timestamp\": ");
+        write_json_string(out, utc_timestamp());
+        std::fprintf(out, "},\n  \"results\": [");
+        for(size_t i = 0; i < results.size(); ++i) {
+            const result& r = results[i];
+            std::fprintf(out, "%s\n    {\"suite\": ", i == 0 ? "" : ",");
+            write_json_string(out, r.suite);
+            std::fprintf(out, ", \"workload\": ");
+            write_json_string(out, r.workload);
+            std::fprintf(out, ", \"impl\": ");
+            write_json_string(out, r.impl);
+            std::fprintf(out, ", \"threads\": %zu, \"ops\": %llu, \"seconds\": %.9g, \"ops_per_sec\": %.17g, \"p50_ns\": ",
+                         r.threads, static_cast<unsigned long long>(r.ops), r.seconds, r.ops_per_sec());
+            write_json_number(out, r.p50_ns);
+            std::fprintf(out, ", \"p99_ns\": ");
+            write_json_number(out, r.p99_ns);
+            std::fprintf(out, ", \"peak_rss_kb\": %ld, \"rss_delta_kb\": %ld, \"extra\": {", r.peak_rss_kb, r.rss_delta_kb);
+            for(size_t k = 0; k < r.extra.size(); ++k) {
+                std::fprintf(out, "%s", k == 0 ? "" : ", ");
+                write_json_string(out, r.extra[k].first);
+                std::fprintf(out, ": %.17g", r.extra[k].second);
+            }
+            std::fprintf(out, "}}");
+        }
+        std::fprintf(out, "\n  ]\n}\n");
+    }
+
+    void write_csv(std::FILE* out, const std::vector<result>& results) {
+        std::fprintf(out, "suite,workload,impl,threads,ops,seconds,ops_per_sec,p50_ns,p99_ns,peak_rss_kb,rss_delta_kb,extra\n");
+        for(size_t i = 0; i < results.size(); ++i) {
+            const result& r = results[i];
+            std::fprintf(out, "%s,%s,\"%s\",%zu,%llu,%.9g,%.17g,", r.suite.c_str(), r.workload.c_str(),
+                         r.impl.c_str(), r.threads, static_cast<unsigned long long>(r.ops), r.seconds, r.ops_per_sec());
+            if(r.p50_ns >= 0.0)
+                std::fprintf(out, "%.17g,%.17g,", r.p50_ns, r.p99_ns);
+            else
+                std::fprintf(out, ",,");
+            std::fprintf(out, "%ld,%ld,\"", r.peak_rss_kb, r.rss_delta_kb);
+            for(size_t k = 0; k < r.extra.size(); ++k)
+                std::fprintf(out, "%s%s=%.17g", k == 0 ? "" : ";", r.extra[k].first.c_str(), r.extra[k].second);
+            std::fprintf(out, "\"\n");
+        }
+    }
+
+    bool write_file(const std::string& path, const cli& c, const std::vector<result>& results, bool json) {
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        if(f == nullptr) {
+            std::fprintf(stderr, "mystl_bench: cannot open %s\n", path.c_str());
+            return false;
+        }
+        if(json)
+            write_json(f, c, results);
+        else
+            write_csv(f, results);
+        std::fclose(f);
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    cli c;
+    if(!parse(argc, argv, c)) {
+        print_usage(stderr);
+        return 2;
+    }
+
+    // 同一 suite 的工作负载排在一起，suite 内保持登记的顺序
+    std::vector<bench_entry> entries = registry();
+    std::stable_sort(entries.begin(), entries.end(), [](const bench_entry& a, const bench_entry& b) {
+        return std::strcmp(a.suite, b.suite) < 0;
+    });
+
+    if(c.list) {
+        for(size_t i = 0; i < entries.size(); ++i)
+            std::printf("%s/%s\n", entries[i].suite, entries[i].name);
+        return 0;
+    }
+
+    context ctx(c.opt);
+    // 表格在结果产生时逐行输出；stdout 用于 JSON / CSV 时改写到 stderr
+    std::FILE* text_out = c.format == EFormatText ? stdout : stderr;
+    ctx.on_result([text_out](const result& r) { print_text(text_out, r); });
+
+    timer_overhead_ns();
+    size_t ran = 0;
+    for(size_t i = 0; i < entries.size(); ++i) {
+        if(!selected(c, entries[i]))
+            continue;
+        entries[i].fn(ctx);
+        ++ran;
+    }
+    if(ran == 0) {
+        std::fprintf(stderr, "mystl_bench: no workload matches the filter\n");
+        return 1;
+    }
+
+    if(c.format == EFormatJson)
+        write_json(stdout, c, ctx.results());
+    else if(c.format == EFormatCsv)
+        write_csv(stdout, ctx.results());
+
+    bool ok = true;
+    if(!c.json_path.empty())
+        ok = write_file(c.json_path, c, ctx.results(), true) && ok;
+    if(!c.csv_path.empty())
+        ok = write_file(c.csv_path, c, ctx.results(), false) && ok;
+    return ok ? 0 : 1;
+}
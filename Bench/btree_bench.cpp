@@ -0,0 +1,203 @@
+// 有序映射的工作负载：btree_map 与 std::map 的对比，键与值都是 uint64_t
+// 映射的大小从 1K 起按 10 倍递增，不超过 scaled(1M)
+//
+// insert_random  向空映射逐个插入 n 个随机键
+// insert_sorted  向空映射按升序逐个插入 n 个键
+// bulk           以升序的 n 个元素的区间构造映射；btree_map 自底向上建树，std::map 逐个插在末尾
+// find           查找 n 个已在映射中的键，顺序与插入不同
+// scan           从随机的键开始以 lower_bound 定位，再顺序经过其后的 100 个元素；一次操作指经过一个元素，
+//                延迟按一次定位加顺序经过的整段采样
+// erase          按随机顺序逐个删除全部 n 个键
+// 除 scan 外，一次操作指一次插入、查找或删除；映射很小时重复若干轮，使每次测量至少约 1M 次操作
+// insert_random、insert_sorted 与 bulk 的结果另外给出 bytes_per_entry：建成的映射向分配器申请的字节数除以 n
+
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "btree_map.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "btree";
+    const size_t kScanLength = 100;
+
+    // 参与比较的实现；map<Alloc>::type 以指定的分配器实例化，用于统计内存占用
+    struct btree_impl {
+        static const char* name() { return "btree_map"; }
+        template<typename Alloc = mystl::allocator<mystl::pair<const uint64_t, uint64_t>>>
+        struct map {
+            typedef mystl::btree_map<uint64_t, uint64_t, mystl::less<uint64_t>, Alloc> type;
+        };
+        typedef counting_allocator<mystl::pair<const uint64_t, uint64_t>> counting_alloc;
+    };
+
+    struct std_map_impl {
+        static const char* name() { return "std::map"; }
+        template<typename Alloc = std::allocator<std::pair<const uint64_t, uint64_t>>>
+        struct map {
+            typedef std::map<uint64_t, uint64_t, std::less<uint64_t>, Alloc> type;
+        };
+        typedef counting_allocator<std::pair<const uint64_t, uint64_t>> counting_alloc;
+    };
+
+    struct keys {
+        std::vector<uint64_t> random;       // 随机顺序，用于 insert_random 与 erase
+        std::vector<uint64_t> sorted;       // 同一组键的升序
+        std::vector<uint64_t> shuffled;     // 同一组键的另一种顺序，用于 find 与 scan 的起点
+    };
+
+    keys make_keys(size_t n) {
+        keys k;
+        xorshift rng(n);
+        k.random.resize(n);
+        for(size_t i = 0; i < n; ++i)
+            k.random[i] = rng();
+        k.sorted = k.random;
+        std::sort(k.sorted.begin(), k.sorted.end());
+        k.sorted.erase(std::unique(k.sorted.begin(), k.sorted.end()), k.sorted.end());
+        k.shuffled = k.random;
+        for(size_t i = n; i > 1; --i)
+            std::swap(k.shuffled[i - 1], k.shuffled[rng.below(i)]);
+        return k;
+    }
+
+    // 每个阶段的测量与计时，计时在各轮中累计
+    struct phase {
+        measurement m;
+        latency_sampler sampler;
+        double seconds;
+        phase(context& ctx, const char* name, size_t n, const char* impl)
+            : m(ctx, kSuite, std::string(name) + "_" + std::to_string(n), impl),
+              sampler(ctx.opt().sample_every), seconds(0.0) {
+            m.extra("entries", static_cast<double>(n));
+        }
+        void finish(uint64_t ops) {
+            m.add_samples(sampler.samples());
+            m.finish(ops, seconds);
+        }
+    };
+
+    inline double seconds_since(uint64_t t0) {
+        return static_cast<double>(now_ns() - t0) * 1e-9;
+    }
+
+    template<typename Map>
+    std::vector<typename Map::value_type> make_values(const std::vector<uint64_t>& sorted) {
+        std::vector<typename Map::value_type> values;
+        values.reserve(sorted.size());
+        for(size_t i = 0; i < sorted.size(); ++i)
+            values.push_back(typename Map::value_type(sorted[i], i));
+        return values;
+    }
+
+    // 容器向分配器申请的字节数折合到每个元素，不计 malloc 自身的开销
+    template<typename Impl>
+    double bytes_per_entry(const std::vector<uint64_t>& order) {
+        typedef typename Impl::template map<typename Impl::counting_alloc>::type map_type;
+        const size_t before = counted_bytes();
+        map_type m;
+        for(size_t i = 0; i < order.size(); ++i)
+            m.insert(typename map_type::value_type(order[i], i));
+        return static_cast<double>(counted_bytes() - before) / static_cast<double>(m.size());
+    }
+
+    template<typename Impl>
+    double bulk_bytes_per_entry(const std::vector<uint64_t>& sorted) {
+        typedef typename Impl::template map<typename Impl::counting_alloc>::type map_type;
+        const std::vector<typename map_type::value_type> values = make_values<map_type>(sorted);
+        const size_t before = counted_bytes();
+        map_type m(values.data(), values.data() + values.size());
+        return static_cast<double>(counted_bytes() - before) / static_cast<double>(m.size());
+    }
+
+    template<typename Impl>
+    void run_map(context& ctx, const keys& k) {
+        typedef typename Impl::template map<>::type map_type;
+        const size_t n = k.random.size();
+        const uint64_t rounds = n >= 1000000 ? 1 : 1000000 / n;
+        const std::vector<typename map_type::value_type> values = make_values<map_type>(k.sorted);
+        phase insert_random(ctx, "insert_random", n, Impl::name());
+        phase insert_sorted(ctx, "insert_sorted", n, Impl::name());
+        phase bulk(ctx, "bulk", n, Impl::name());
+        phase find(ctx, "find", n, Impl::name());
+        phase scan(ctx, "scan", n, Impl::name());
+        phase erase(ctx, "erase", n, Impl::name());
+        uint64_t sum = 0;
+        uint64_t scanned = 0;
+
+        for(uint64_t r = 0; r < rounds; ++r) {
+            {
+                map_type m;
+                const uint64_t t0 = now_ns();
+                for(size_t i = 0; i < n; ++i)
+                    insert_sorted.sampler.run([&] { m.insert(typename map_type::value_type(k.sorted[i], i)); });
+                insert_sorted.seconds += seconds_since(t0);
+            }
+            {
+                const uint64_t t0 = now_ns();
+                map_type m(values.data(), values.data() + values.size());
+                bulk.seconds += seconds_since(t0);
+                do_not_optimize(m.size());
+            }
+
+            map_type* m = new map_type();
+            uint64_t t0 = now_ns();
+            for(size_t i = 0; i < n; ++i)
+                insert_random.sampler.run([&] { m->insert(typename map_type::value_type(k.random[i], i)); });
+            insert_random.seconds += seconds_since(t0);
+
+            t0 = now_ns();
+            for(size_t i = 0; i < n; ++i)
+                find.sampler.run([&] { sum += m->find(k.shuffled[i])->second; });
+            find.seconds += seconds_since(t0);
+
+            t0 = now_ns();
+            for(size_t i = 0; i < n; i += kScanLength) {
+                scan.sampler.run([&] {
+                    typename map_type::const_iterator it = m->lower_bound(k.shuffled[i]);
+                    for(size_t j = 0; j < kScanLength && it != m->end(); ++j, ++it) {
+                        sum += it->second;
+                        ++scanned;
+                    }
+                });
+            }
+            scan.seconds += seconds_since(t0);
+            do_not_optimize(sum);
+
+            t0 = now_ns();
+            for(size_t i = 0; i < n; ++i)
+                erase.sampler.run([&] { m->erase(k.shuffled[i]); });
+            erase.seconds += seconds_since(t0);
+            delete m;
+        }
+
+        insert_random.m.extra("bytes_per_entry", bytes_per_entry<Impl>(k.random));
+        insert_sorted.m.extra("bytes_per_entry", bytes_per_entry<Impl>(k.sorted));
+        bulk.m.extra("bytes_per_entry", bulk_bytes_per_entry<Impl>(k.sorted));
+        insert_random.finish(rounds * n);
+        insert_sorted.finish(rounds * k.sorted.size());
+        bulk.finish(rounds * k.sorted.size());
+        find.finish(rounds * n);
+        scan.finish(scanned);
+        erase.finish(rounds * n);
+    }
+
+} // namespace
+
+MYSTL_BENCH("btree", map_vs_btree) {
+    const uint64_t max_entries = ctx.scaled(1000000);
+    for(uint64_t n = 1000; n <= max_entries; n *= 10) {
+        const keys k = make_keys(static_cast<size_t>(n));
+        run_map<btree_impl>(ctx, k);
+        run_map<std_map_impl>(ctx, k);
+    }
+}
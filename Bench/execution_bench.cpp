@@ -0,0 +1,210 @@
+// execution.h 的工作负载：par 与 seq 对比，对 --threads 中的每个 n，以 n - 1 个工作线程加上调用线程的线程池
+// 执行 par（见 set_execution_pool）；元素为 uint64_t，区间约 scaled(8M) 个元素，重复 4 遍，一次操作指处理一个元素
+//
+// copy        copy，只受内存带宽限制
+// fill        fill，只受内存带宽限制
+// for_each    for_each 原地做几轮乘法与移位，计算量较大
+// transform   一元 transform，src 到 dst
+// transform2  二元 transform，src 与 src2 到 dst
+// reduce      以 plus 归约（有证同元素，每块从 0 开始）
+// reduce_max  以求最大值的函数对象归约（没有证同元素，每块从第一个元素开始）
+//
+// seq 的结果以 impl 为 seq 给出；par 的结果另以 speedup 给出相对 seq 的加速比，
+// cores 为硬件线程数，efficiency 为 speedup 除以 min(线程数, cores)，线程数超过 cores 时不再有加速
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "execution.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "execution";
+    const int kRepeats = 4;
+
+    inline double seconds_since(uint64_t t0) {
+        return static_cast<double>(now_ns() - t0) * 1e-9;
+    }
+
+    inline uint64_t mix(uint64_t x) {
+        for(int r = 0; r < 4; ++r)
+            x = (x ^ (x >> 29)) * 0xbf58476d1ce4e5b9ULL;
+        return x;
+    }
+
+    // 各工作负载共用的数据，dst 在每次测量前恢复为相同的内容
+    struct arrays {
+        std::vector<uint64_t> src, src2, dst;
+        explicit arrays(size_t n) : src(n), src2(n), dst(n) {
+            xorshift rng(n);
+            for(size_t i = 0; i < n; ++i) {
+                src[i] = rng();
+                src2[i] = rng();
+            }
+        }
+        size_t size() const { return src.size(); }
+        void reset() { std::copy(src.begin(), src.end(), dst.begin()); }
+        // dst 的抽样校验和
+        uint64_t checksum() const {
+            uint64_t sum = 0;
+            for(size_t i = 0; i < dst.size(); i += 4099)
+                sum = sum * 31 + dst[i];
+            return sum + dst.back();
+        }
+    };
+
+    struct max_op {
+        uint64_t operator()(uint64_t a, uint64_t b) const { return a < b ? b : a; }
+    };
+
+    // 每个工作负载执行一遍，返回用于核对 seq 与 par 结果的值
+    struct copy_kernel {
+        static const char* name() { return "copy"; }
+        template<typename Policy>
+        uint64_t operator()(const Policy& policy, arrays& a) const {
+            mystl::copy(policy, a.src2.data(), a.src2.data() + a.size(), a.dst.data());
+            return a.dst[a.size() / 2];
+        }
+    };
+
+    struct fill_kernel {
+        static const char* name() { return "fill"; }
+        template<typename Policy>
+        uint64_t operator()(const Policy& policy, arrays& a) const {
+            mystl::fill(policy, a.dst.data(), a.dst.data() + a.size(), uint64_t(7));
+            return a.dst[a.size() / 2];
+        }
+    };
+
+    struct for_each_kernel {
+        static const char* name() { return "for_each"; }
+        template<typename Policy>
+        uint64_t operator()(const Policy& policy, arrays& a) const {
+            mystl::for_each(policy, a.dst.data(), a.dst.data() + a.size(), [](uint64_t& x) { x = mix(x); });
+            return a.dst[a.size() / 2];
+        }
+    };
+
+    struct transform_kernel {
+        static const char* name() { return "transform"; }
+        template<typename Policy>
+        uint64_t operator()(const Policy& policy, arrays& a) const {
+            mystl::transform(policy, a.src.data(), a.src.data() + a.size(), a.dst.data(),
+                             [](uint64_t x) { return x * 0x9e3779b97f4a7c15ULL + (x >> 7); });
+            return a.dst[a.size() / 2];
+        }
+    };
+
+    struct transform2_kernel {
+        static const char* name() { return "transform2"; }
+        template<typename Policy>
+        uint64_t operator()(const Policy& policy, arrays& a) const {
+            mystl::transform(policy, a.src.data(), a.src.data() + a.size(), a.src2.data(), a.dst.data(),
+                             [](uint64_t x, uint64_t y) { return x * 31 + (y ^ (x >> 3)); });
+            return a.dst[a.size() / 2];
+        }
+    };
+
+    struct reduce_kernel {
+        static const char* name() { return "reduce"; }
+        template<typename Policy>
+        uint64_t operator()(const Policy& policy, arrays& a) const {
+            return mystl::reduce(policy, a.src.data(), a.src.data() + a.size(), uint64_t(0));
+        }
+    };
+
+    struct reduce_max_kernel {
+        static const char* name() { return "reduce_max"; }
+        template<typename Policy>
+        uint64_t operator()(const Policy& policy, arrays& a) const {
+            return mystl::reduce(policy, a.src.data(), a.src.data() + a.size(), uint64_t(0), max_op());
+        }
+    };
+
+    // 执行 kRepeats 遍，返回秒数，check 为各遍结果与 dst 校验和的组合
+    template<typename Kernel, typename Policy>
+    double run_once(const Kernel& kernel, const Policy& policy, arrays& a, uint64_t& check) {
+        a.reset();
+        check = 0;
+        const uint64_t t0 = now_ns();
+        for(int r = 0; r < kRepeats; ++r)
+            check = check * 31 + kernel(policy, a);
+        const double seconds = seconds_since(t0);
+        check = check * 31 + a.checksum();
+        return seconds;
+    }
+
+    template<typename Kernel>
+    void run(context& ctx, const Kernel& kernel) {
+        const size_t n = std::max<size_t>(static_cast<size_t>(ctx.scaled(8 * 1024 * 1024)),
+                                          4 * mystl::parallel_grain<uint64_t>());
+        arrays a(n);
+        const size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+        const uint64_t ops = static_cast<uint64_t>(n) * kRepeats;
+
+        // 先执行一遍，让页都已映射
+        uint64_t expected = 0;
+        run_once(kernel, mystl::execution::seq, a, expected);
+
+        measurement seq(ctx, kSuite, kernel.name(), "seq");
+        const double seq_seconds = run_once(kernel, mystl::execution::seq, a, expected);
+        seq.extra("elements", static_cast<double>(n));
+        seq.finish(ops, seq_seconds);
+
+        const std::vector<size_t>& threads = ctx.opt().threads;
+        for(size_t t = 0; t < threads.size(); ++t) {
+            mystl::thread_pool pool(threads[t] - 1);
+            mystl::set_execution_pool(&pool);
+            measurement m(ctx, kSuite, kernel.name(), "par", threads[t]);
+            uint64_t got = 0;
+            const double seconds = run_once(kernel, mystl::execution::par, a, got);
+            mystl::set_execution_pool(nullptr);
+            if(got != expected) {
+                std::fprintf(stderr, "execution/%s: par produced a wrong result\n", kernel.name());
+                std::abort();
+            }
+            const double speedup = seq_seconds / seconds;
+            m.extra("elements", static_cast<double>(n));
+            m.extra("speedup", speedup);
+            m.extra("cores", static_cast<double>(cores));
+            m.extra("efficiency", speedup / static_cast<double>(std::min(threads[t], cores)));
+            m.finish(ops, seconds);
+        }
+    }
+
+} // namespace
+
+MYSTL_BENCH("execution", copy) {
+    run(ctx, copy_kernel());
+}
+
+MYSTL_BENCH("execution", fill) {
+    run(ctx, fill_kernel());
+}
+
+MYSTL_BENCH("execution", for_each) {
+    run(ctx, for_each_kernel());
+}
+
+MYSTL_BENCH("execution", transform) {
+    run(ctx, transform_kernel());
+}
+
+MYSTL_BENCH("execution", transform2) {
+    run(ctx, transform2_kernel());
+}
+
+MYSTL_BENCH("execution", reduce) {
+    run(ctx, reduce_kernel());
+}
+
+MYSTL_BENCH("execution", reduce_max) {
+    run(ctx, reduce_max_kernel());
+}
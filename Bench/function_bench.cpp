@@ -0,0 +1,154 @@
+// 可调用对象包装的工作负载：mystl::function / move_only_function 与 std::function 的对比
+// 被包装的对象按捕获的大小分为 fnptr（函数指针）、capture8、capture24、capture48：
+// capture24 超出 libstdc++ 的 std::function 内部缓冲区，capture48 超出 mystl::function 默认的内部缓冲区，
+// 另以 mystl::function<R(Args...), 64> 给出加大缓冲区后的结果
+//
+// construct  由可调用对象构造包装再析构
+// copy       复制一个已构造的包装再析构
+// invoke     依次调用一组包装
+// move_only  构造捕获 unique_ptr 的包装并移动一次；std::function 不能持有只能移动的对象，以 shared_ptr 代替
+// 单次操作只有几纳秒，不采样延迟，只给出吞吐量
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "function.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "function";
+
+    typedef uint64_t signature(uint64_t);
+
+    uint64_t add_one(uint64_t x) { return x + 1; }
+
+    // 捕获 Bytes 个字节的可调用对象
+    template<size_t Bytes>
+    struct capture {
+        uint64_t data[Bytes / sizeof(uint64_t)];
+        explicit capture(uint64_t seed) {
+            for(size_t i = 0; i < Bytes / sizeof(uint64_t); ++i)
+                data[i] = seed + i;
+        }
+        uint64_t operator()(uint64_t x) const { return x + data[0] + data[Bytes / sizeof(uint64_t) - 1]; }
+    };
+
+    template<typename Wrapper, typename F>
+    void run_construct(context& ctx, const char* workload, const char* impl, const F& f) {
+        const uint64_t iters = ctx.scaled(10000000);
+        measurement m(ctx, kSuite, workload, impl);
+        for(uint64_t i = 0; i < iters; ++i) {
+            Wrapper w(f);
+            do_not_optimize(w);
+        }
+        m.finish(iters);
+    }
+
+    template<typename Wrapper, typename F>
+    void run_copy(context& ctx, const char* workload, const char* impl, const F& f) {
+        const uint64_t iters = ctx.scaled(10000000);
+        const Wrapper src(f);
+        measurement m(ctx, kSuite, workload, impl);
+        for(uint64_t i = 0; i < iters; ++i) {
+            Wrapper w(src);
+            do_not_optimize(w);
+        }
+        m.finish(iters);
+    }
+
+    template<typename Wrapper, typename F>
+    void run_invoke(context& ctx, const char* workload, const char* impl, const F& f) {
+        const size_t count = 64;
+        const uint64_t rounds = ctx.scaled(500000);
+        std::vector<Wrapper> ws(count, Wrapper(f));
+        uint64_t x = 0;
+        measurement m(ctx, kSuite, workload, impl);
+        for(uint64_t r = 0; r < rounds; ++r) {
+            for(size_t i = 0; i < count; ++i)
+                x = ws[i](x);
+            do_not_optimize(x);
+        }
+        m.finish(rounds * count);
+    }
+
+    // 对一个可调用对象，依次测量三种包装的三种操作
+    template<typename F>
+    void run_all(context& ctx, const char* name, const F& f) {
+        const std::string construct = std::string("construct_") + name;
+        const std::string copy = std::string("copy_") + name;
+        const std::string invoke = std::string("invoke_") + name;
+        typedef mystl::function<signature> mystl_function;
+        typedef mystl::function<signature, 64> mystl_function64;
+        typedef std::function<signature> std_function;
+
+        run_construct<mystl_function>(ctx, construct.c_str(), "mystl::function", f);
+        run_construct<mystl_function64>(ctx, construct.c_str(), "mystl::function<64>", f);
+        run_construct<std_function>(ctx, construct.c_str(), "std::function", f);
+        run_copy<mystl_function>(ctx, copy.c_str(), "mystl::function", f);
+        run_copy<mystl_function64>(ctx, copy.c_str(), "mystl::function<64>", f);
+        run_copy<std_function>(ctx, copy.c_str(), "std::function", f);
+        run_invoke<mystl_function>(ctx, invoke.c_str(), "mystl::function", f);
+        run_invoke<mystl_function64>(ctx, invoke.c_str(), "mystl::function<64>", f);
+        run_invoke<std_function>(ctx, invoke.c_str(), "std::function", f);
+    }
+
+    // 只能移动的可调用对象
+    struct unique_adder {
+        std::unique_ptr<uint64_t> value;
+        uint64_t operator()(uint64_t x) const { return x + *value; }
+    };
+
+    struct shared_adder {
+        std::shared_ptr<uint64_t> value;
+        uint64_t operator()(uint64_t x) const { return x + *value; }
+    };
+
+} // namespace
+
+MYSTL_BENCH("function", fnptr) {
+    run_all(ctx, "fnptr", &add_one);
+}
+
+MYSTL_BENCH("function", capture8) {
+    run_all(ctx, "capture8", capture<8>(1));
+}
+
+MYSTL_BENCH("function", capture24) {
+    run_all(ctx, "capture24", capture<24>(1));
+}
+
+MYSTL_BENCH("function", capture48) {
+    run_all(ctx, "capture48", capture<48>(1));
+}
+
+MYSTL_BENCH("function", move_only) {
+    const uint64_t iters = ctx.scaled(5000000);
+    {
+        measurement m(ctx, kSuite, "move_only", "mystl::move_only_function");
+        for(uint64_t i = 0; i < iters; ++i) {
+            unique_adder f;
+            f.value.reset(new uint64_t(i));
+            mystl::move_only_function<signature> a(std::move(f));
+            mystl::move_only_function<signature> b(std::move(a));
+            do_not_optimize(b);
+        }
+        m.finish(iters);
+    }
+    {
+        measurement m(ctx, kSuite, "move_only", "std::function (shared_ptr)");
+        for(uint64_t i = 0; i < iters; ++i) {
+            shared_adder f;
+            f.value.reset(new uint64_t(i));
+            std::function<signature> a(std::move(f));
+            std::function<signature> b(std::move(a));
+            do_not_optimize(b);
+        }
+        m.finish(iters);
+    }
+}
@@ -0,0 +1,275 @@
+// 哈希表的工作负载：flat_hash_map 与 std::unordered_map 的对比，键与值都是 uint64_t
+// 表的大小从 1K 起按 10 倍递增，不超过 scaled(10M)，--scale=10 时到 100M
+//
+// insert  向空表逐个插入 n 个随机键
+// hit     查找 n 个已在表中的键，顺序与插入不同
+// miss    查找 n 个不在表中的键
+// erase   逐个删除全部 n 个键
+// 一次操作指一次插入、查找或删除；表很小时重复若干轮，使每次测量至少约 1M 次操作
+// insert 的结果另外给出 bytes_per_entry：建满 n 个元素的表向分配器申请的字节数除以 n
+//
+// 哈希函数本身的工作负载，与替换之前的恒等哈希（整数、指针）和逐字节的 FNV-1a（字节序列）对比：
+// bytes    hash_bytes 与 FNV-1a 哈希长度 8 ~ 4096 bytes 的键；一次操作指哈希一个键，另以 gb_per_s 给出吞吐量
+// buckets  2^20 个键放入 2^16 个桶，键为连续整数、步长 4096 的整数、16 bytes 对齐的地址与 16 bytes 的字符串；
+//          一次操作指哈希一个键；chi2_low 与 chi2_h1 分别为按低位（h & mask）与按 flat_hash_map 的 h >> 7 取桶时
+//          每自由度的卡方值（均匀分布时约为 1），max_load 为按 h >> 7 取桶时最满的桶的键数（平均 16）
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "flat_hash_map.h"
+#include "functional.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "hash";
+
+    // 参与比较的实现；map<Alloc>::type 以指定的分配器实例化，用于统计内存占用
+    struct flat_impl {
+        static const char* name() { return "flat_hash_map"; }
+        template<typename Alloc = mystl::allocator<mystl::pair<const uint64_t, uint64_t>>>
+        struct map {
+            typedef mystl::flat_hash_map<uint64_t, uint64_t, mystl::hash<uint64_t>,
+                                         mystl::equal_to<uint64_t>, Alloc> type;
+        };
+        typedef counting_allocator<mystl::pair<const uint64_t, uint64_t>> counting_alloc;
+    };
+
+    struct unordered_impl {
+        static const char* name() { return "std::unordered_map"; }
+        template<typename Alloc = std::allocator<std::pair<const uint64_t, uint64_t>>>
+        struct map {
+            typedef std::unordered_map<uint64_t, uint64_t, std::hash<uint64_t>,
+                                       std::equal_to<uint64_t>, Alloc> type;
+        };
+        typedef counting_allocator<std::pair<const uint64_t, uint64_t>> counting_alloc;
+    };
+
+    struct keys {
+        std::vector<uint64_t> present;      // 插入顺序
+        std::vector<uint64_t> shuffled;     // 同一组键的另一种顺序，用于 hit
+        std::vector<uint64_t> missing;      // 不在表中的键
+    };
+
+    keys make_keys(size_t n) {
+        keys k;
+        xorshift rng(n);
+        k.present.resize(n);
+        k.missing.resize(n);
+        // 最低位区分两组键，保证 missing 中的键不在表中
+        for(size_t i = 0; i < n; ++i) {
+            k.present[i] = rng() | 1;
+            k.missing[i] = rng() & ~uint64_t(1);
+        }
+        k.shuffled = k.present;
+        for(size_t i = n; i > 1; --i)
+            std::swap(k.shuffled[i - 1], k.shuffled[rng.below(i)]);
+        return k;
+    }
+
+    // 每个阶段的测量与计时，计时在各轮中累计
+    struct phase {
+        measurement m;
+        latency_sampler sampler;
+        double seconds;
+        phase(context& ctx, const char* name, size_t n, const char* impl)
+            : m(ctx, kSuite, std::string(name) + "_" + std::to_string(n), impl),
+              sampler(ctx.opt().sample_every), seconds(0.0) {
+            m.extra("entries", static_cast<double>(n));
+        }
+        void finish(uint64_t ops) {
+            m.add_samples(sampler.samples());
+            m.finish(ops, seconds);
+        }
+    };
+
+    // 容器向分配器申请的字节数折合到每个元素，不计 malloc 自身的开销
+    template<typename Impl>
+    double bytes_per_entry(const keys& k) {
+        typedef typename Impl::template map<typename Impl::counting_alloc>::type map_type;
+        const size_t before = counted_bytes();
+        map_type m;
+        for(size_t i = 0; i < k.present.size(); ++i)
+            m.insert(typename map_type::value_type(k.present[i], i));
+        return static_cast<double>(counted_bytes() - before) / static_cast<double>(k.present.size());
+    }
+
+    template<typename Impl>
+    void run_map(context& ctx, const keys& k) {
+        typedef typename Impl::template map<>::type map_type;
+        const size_t n = k.present.size();
+        const uint64_t rounds = n >= 1000000 ? 1 : 1000000 / n;
+        phase insert(ctx, "insert", n, Impl::name());
+        phase hit(ctx, "hit", n, Impl::name());
+        phase miss(ctx, "miss", n, Impl::name());
+        phase erase(ctx, "erase", n, Impl::name());
+
+        for(uint64_t r = 0; r < rounds; ++r) {
+            map_type* m = new map_type();
+            uint64_t t0 = now_ns();
+            for(size_t i = 0; i < n; ++i)
+                insert.sampler.run([&] { m->insert(typename map_type::value_type(k.present[i], i)); });
+            insert.seconds += static_cast<double>(now_ns() - t0) * 1e-9;
+
+            uint64_t sum = 0;
+            t0 = now_ns();
+            for(size_t i = 0; i < n; ++i)
+                hit.sampler.run([&] { sum += m->find(k.shuffled[i])->second; });
+            hit.seconds += static_cast<double>(now_ns() - t0) * 1e-9;
+
+            t0 = now_ns();
+            for(size_t i = 0; i < n; ++i)
+                miss.sampler.run([&] { sum += m->count(k.missing[i]); });
+            miss.seconds += static_cast<double>(now_ns() - t0) * 1e-9;
+            do_not_optimize(sum);
+
+            t0 = now_ns();
+            for(size_t i = 0; i < n; ++i)
+                erase.sampler.run([&] { m->erase(k.present[i]); });
+            erase.seconds += static_cast<double>(now_ns() - t0) * 1e-9;
+            delete m;
+        }
+
+        insert.m.extra("bytes_per_entry", bytes_per_entry<Impl>(k));
+        insert.finish(rounds * n);
+        hit.finish(rounds * n);
+        miss.finish(rounds * n);
+        erase.finish(rounds * n);
+    }
+
+    /*****************************************************************************************/
+    // 哈希函数
+
+    // 替换之前的 bitwies_hash：逐字节的 64 位 FNV-1a
+    inline uint64_t fnv1a(const void* first, size_t count) {
+        const unsigned char* p = static_cast<const unsigned char*>(first);
+        uint64_t h = 14695981039346656037ull;
+        for(size_t i = 0; i < count; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    struct hash_bytes_impl {
+        static const char* name() { return "hash_bytes"; }
+        static uint64_t hash(const void* p, size_t n) { return mystl::hash_bytes(p, n); }
+    };
+
+    struct fnv1a_impl {
+        static const char* name() { return "fnv1a"; }
+        static uint64_t hash(const void* p, size_t n) { return fnv1a(p, n); }
+    };
+
+    // 在 64 KiB 的随机字节中依次取长度为 len 的键，总计约 scaled(256 MiB)
+    template<typename Impl>
+    void run_bytes(context& ctx, size_t len) {
+        const size_t buffer_size = 64 * 1024;
+        std::vector<unsigned char> buf(buffer_size + len);
+        xorshift rng(len);
+        for(size_t i = 0; i < buf.size(); ++i)
+            buf[i] = static_cast<unsigned char>(rng());
+        const uint64_t keys = ctx.scaled(uint64_t(256) << 20) / len + 1;
+        measurement m(ctx, kSuite, "bytes_" + std::to_string(len), Impl::name());
+        uint64_t sum = 0;
+        size_t offset = 0;
+        const uint64_t t0 = now_ns();
+        for(uint64_t i = 0; i < keys; ++i) {
+            sum += Impl::hash(buf.data() + offset, len);
+            offset = (offset + 64) & (buffer_size - 1);
+        }
+        const double seconds = static_cast<double>(now_ns() - t0) * 1e-9;
+        do_not_optimize(sum);
+        m.extra("gb_per_s", static_cast<double>(keys * len) / seconds * 1e-9);
+        m.finish(keys, seconds);
+    }
+
+    const size_t kBucketKeys = size_t(1) << 20;
+    const size_t kBuckets = size_t(1) << 16;
+
+    // 以 hash(i) 为第 i 个键的哈希值，统计桶的分布
+    template<typename Hash>
+    void run_buckets(context& ctx, const char* keyset, const char* impl, Hash hash) {
+        std::vector<uint64_t> hashes(kBucketKeys);
+        measurement m(ctx, kSuite, std::string("buckets_") + keyset, impl);
+        const uint64_t t0 = now_ns();
+        for(size_t i = 0; i < kBucketKeys; ++i)
+            hashes[i] = hash(i);
+        const double seconds = static_cast<double>(now_ns() - t0) * 1e-9;
+
+        std::vector<uint32_t> low(kBuckets, 0), h1(kBuckets, 0);
+        for(size_t i = 0; i < kBucketKeys; ++i) {
+            ++low[hashes[i] & (kBuckets - 1)];
+            ++h1[(hashes[i] >> 7) & (kBuckets - 1)];
+        }
+        const double expected = static_cast<double>(kBucketKeys) / static_cast<double>(kBuckets);
+        double chi_low = 0.0, chi_h1 = 0.0;
+        uint32_t max_load = 0;
+        for(size_t b = 0; b < kBuckets; ++b) {
+            chi_low += (low[b] - expected) * (low[b] - expected) / expected;
+            chi_h1 += (h1[b] - expected) * (h1[b] - expected) / expected;
+            max_load = h1[b] > max_load ? h1[b] : max_load;
+        }
+        m.extra("chi2_low", chi_low / static_cast<double>(kBuckets - 1));
+        m.extra("chi2_h1", chi_h1 / static_cast<double>(kBuckets - 1));
+        m.extra("max_load", max_load);
+        m.finish(kBucketKeys, seconds);
+    }
+
+    // 16 bytes 的字符串键
+    struct string_key {
+        char text[17];
+        explicit string_key(size_t i) { std::snprintf(text, sizeof(text), "key-%012zu", i); }
+    };
+
+} // namespace
+
+MYSTL_BENCH("hash", flat_vs_unordered) {
+    const uint64_t max_entries = ctx.scaled(10000000);
+    for(uint64_t n = 1000; n <= max_entries; n *= 10) {
+        const keys k = make_keys(static_cast<size_t>(n));
+        run_map<flat_impl>(ctx, k);
+        run_map<unordered_impl>(ctx, k);
+    }
+}
+
+MYSTL_BENCH("hash", bytes) {
+    const size_t lengths[] = { 8, 16, 32, 64, 256, 4096 };
+    for(size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        run_bytes<hash_bytes_impl>(ctx, lengths[i]);
+        run_bytes<fnv1a_impl>(ctx, lengths[i]);
+    }
+}
+
+MYSTL_BENCH("hash", buckets) {
+    const mystl::hash<uint64_t> int_hash;
+    run_buckets(ctx, "seq_int", "mystl::hash", [&](size_t i) { return int_hash(i); });
+    run_buckets(ctx, "seq_int", "identity", [](size_t i) { return uint64_t(i); });
+    run_buckets(ctx, "stride_int", "mystl::hash", [&](size_t i) { return int_hash(uint64_t(i) << 12); });
+    run_buckets(ctx, "stride_int", "identity", [](size_t i) { return uint64_t(i) << 12; });
+
+    const uintptr_t base = uintptr_t(0x7f0000000000ull);
+    const mystl::hash<const char*> ptr_hash;
+    run_buckets(ctx, "pointer", "mystl::hash", [&](size_t i) {
+        return ptr_hash(reinterpret_cast<const char*>(base + 16 * i));
+    });
+    run_buckets(ctx, "pointer", "identity", [&](size_t i) { return uint64_t(base + 16 * i); });
+
+    // 字符串在计时之前生成
+    std::vector<string_key> strings;
+    strings.reserve(kBucketKeys);
+    for(size_t i = 0; i < kBucketKeys; ++i)
+        strings.push_back(string_key(i));
+    run_buckets(ctx, "string", "hash_bytes", [&](size_t i) { return mystl::hash_bytes(strings[i].text, 16); });
+    run_buckets(ctx, "string", "fnv1a", [&](size_t i) { return fnv1a(strings[i].text, 16); });
+}
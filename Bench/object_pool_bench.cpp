@@ -0,0 +1,238 @@
+// object_pool 的工作负载：单个对象的分配与回收，object_pool_policy 与 new_policy、pool_policy 的对比
+// 节点与 std::map 的节点大小相近：三个指针加一个值
+//
+// churn  每个线程持有 4096 个节点，随机挑一个以 deallocate(p) 回收，再以 allocate() 分配；
+//        一次操作指一次分配或一次回收
+// tree   逐个分配节点建一棵随机插入的二叉查找树，中序遍历若干遍后逐个回收；
+//        一次操作指遍历经过一个节点，另以 build_ns / free_ns 给出建树与回收时每个节点的耗时
+// clear  由一个局部的 object_pool 分配一批节点后一次 clear，与逐个 deallocate、逐个 delete 对比；
+//        一次操作指一个节点的分配与回收
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "bench.h"
+#include "allocator.h"
+#include "object_pool.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "object_pool";
+
+    struct node {
+        node* left;
+        node* right;
+        node* parent;
+        uint64_t value;
+    };
+
+    struct new_policy_tag {
+        typedef mystl::new_policy policy;
+        static const char* name() { return "new_policy"; }
+    };
+
+    struct pool_policy_tag {
+        typedef mystl::pool_policy policy;
+        static const char* name() { return "pool_policy"; }
+    };
+
+    struct object_pool_policy_tag {
+        typedef mystl::object_pool_policy policy;
+        static const char* name() { return "object_pool_policy"; }
+    };
+
+    template<typename Fn>
+    void for_each_policy(const Fn& fn) {
+        fn(new_policy_tag());
+        fn(pool_policy_tag());
+        fn(object_pool_policy_tag());
+    }
+
+    inline double seconds_since(uint64_t t0) {
+        return static_cast<double>(now_ns() - t0) * 1e-9;
+    }
+
+    /*****************************************************************************************/
+    // churn
+
+    template<typename Tag>
+    void run_churn(context& ctx, size_t nthreads) {
+        typedef mystl::allocator<node, typename Tag::policy> allocator_type;
+        const size_t slots = 4096;
+        const uint64_t iters = ctx.scaled(2000000);
+        measurement m(ctx, kSuite, "churn", Tag::name(), nthreads);
+        std::mutex mutex;
+        const double seconds = run_threads(nthreads, [&](size_t tid) {
+            xorshift rng(tid + 1);
+            latency_sampler s(ctx.opt().sample_every);
+            std::vector<node*> live(slots);
+            for(size_t i = 0; i < slots; ++i) {
+                live[i] = allocator_type::allocate();
+                live[i]->value = i;
+            }
+            for(uint64_t i = 0; i < iters; ++i) {
+                node*& p = live[rng.below(slots)];
+                s.run([&] { allocator_type::deallocate(p); });
+                s.run([&] { p = allocator_type::allocate(); });
+                p->value = i;
+            }
+            for(size_t i = 0; i < slots; ++i)
+                allocator_type::deallocate(live[i]);
+            std::lock_guard<std::mutex> lock(mutex);
+            m.add_samples(s.samples());
+        });
+        m.finish(nthreads * (2 * iters + 2 * slots), seconds);
+    }
+
+    struct churn_runner {
+        context& ctx;
+        size_t threads;
+        template<typename Tag>
+        void operator()(Tag) const { run_churn<Tag>(ctx, threads); }
+    };
+
+    /*****************************************************************************************/
+    // tree
+
+    // 以父指针做非递归的中序遍历，依次经过每个节点
+    uint64_t inorder_sum(node* root) {
+        uint64_t sum = 0;
+        node* p = root;
+        if(p == nullptr) return 0;
+        while(p->left != nullptr) p = p->left;
+        while(p != nullptr) {
+            sum += p->value;
+            if(p->right != nullptr) {
+                p = p->right;
+                while(p->left != nullptr) p = p->left;
+            } else {
+                node* child = p;
+                p = p->parent;
+                while(p != nullptr && p->right == child) {
+                    child = p;
+                    p = p->parent;
+                }
+            }
+        }
+        return sum;
+    }
+
+    struct tree_runner {
+        context& ctx;
+        template<typename Tag>
+        void operator()(Tag) const {
+            typedef mystl::allocator<node, typename Tag::policy> allocator_type;
+            const size_t n = static_cast<size_t>(ctx.scaled(1000000));
+            const size_t walks = 10;
+            measurement m(ctx, kSuite, "tree", Tag::name());
+
+            xorshift rng(11);
+            std::vector<node*> nodes(n);
+            node* root = nullptr;
+            uint64_t t0 = now_ns();
+            for(size_t i = 0; i < n; ++i) {
+                node* x = allocator_type::allocate();
+                x->left = x->right = x->parent = nullptr;
+                x->value = rng();
+                node** link = &root;
+                node* parent = nullptr;
+                while(*link != nullptr) {
+                    parent = *link;
+                    link = x->value < parent->value ? &parent->left : &parent->right;
+                }
+                x->parent = parent;
+                *link = x;
+                nodes[i] = x;
+            }
+            const double build_seconds = seconds_since(t0);
+
+            t0 = now_ns();
+            uint64_t sum = 0;
+            for(size_t w = 0; w < walks; ++w)
+                sum += inorder_sum(root);
+            const double walk_seconds = seconds_since(t0);
+            do_not_optimize(sum);
+
+            t0 = now_ns();
+            for(size_t i = 0; i < n; ++i)
+                allocator_type::deallocate(nodes[i]);
+            const double free_seconds = seconds_since(t0);
+
+            m.extra("nodes", static_cast<double>(n));
+            m.extra("build_ns", build_seconds * 1e9 / static_cast<double>(n));
+            m.extra("free_ns", free_seconds * 1e9 / static_cast<double>(n));
+            m.finish(walks * n, walk_seconds);
+        }
+    };
+
+    /*****************************************************************************************/
+    // clear
+
+    void run_clear(context& ctx) {
+        typedef mystl::object_pool<node> pool_type;
+        const size_t batch = 10000;
+        const uint64_t rounds = ctx.scaled(400);
+        std::vector<node*> nodes(batch);
+        {
+            measurement m(ctx, kSuite, "clear", "object_pool::clear");
+            pool_type pool;
+            for(uint64_t r = 0; r < rounds; ++r) {
+                for(size_t i = 0; i < batch; ++i) {
+                    nodes[i] = pool.allocate();
+                    nodes[i]->value = i;
+                }
+                do_not_optimize(nodes[batch - 1]->value);
+                pool.clear();
+            }
+            m.finish(rounds * batch);
+        }
+        {
+            measurement m(ctx, kSuite, "clear", "object_pool::deallocate");
+            pool_type pool;
+            for(uint64_t r = 0; r < rounds; ++r) {
+                for(size_t i = 0; i < batch; ++i) {
+                    nodes[i] = pool.allocate();
+                    nodes[i]->value = i;
+                }
+                do_not_optimize(nodes[batch - 1]->value);
+                for(size_t i = 0; i < batch; ++i)
+                    pool.deallocate(nodes[i]);
+            }
+            m.finish(rounds * batch);
+        }
+        {
+            measurement m(ctx, kSuite, "clear", "new/delete");
+            for(uint64_t r = 0; r < rounds; ++r) {
+                for(size_t i = 0; i < batch; ++i) {
+                    nodes[i] = new node;
+                    nodes[i]->value = i;
+                }
+                do_not_optimize(nodes[batch - 1]->value);
+                for(size_t i = 0; i < batch; ++i)
+                    delete nodes[i];
+            }
+            m.finish(rounds * batch);
+        }
+    }
+
+} // namespace
+
+MYSTL_BENCH("object_pool", churn) {
+    const std::vector<size_t>& threads = ctx.opt().threads;
+    for(size_t i = 0; i < threads.size(); ++i) {
+        churn_runner runner = { ctx, threads[i] };
+        for_each_policy(runner);
+    }
+}
+
+MYSTL_BENCH("object_pool", tree) {
+    tree_runner runner = { ctx };
+    for_each_policy(runner);
+}
+
+MYSTL_BENCH("object_pool", clear) {
+    run_clear(ctx);
+}
@@ -0,0 +1,210 @@
+// 并发队列的工作负载：spsc_ring、mpmc_queue 与以 std::mutex 保护的 std::deque 的对比
+// 元素是 uint64_t，队列容量 1024；队列满或空时让出处理器
+//
+// spsc       一个生产者、一个消费者
+// spsc_n     同上，每次以 try_push_n / try_pop_n 搬运至多 32 个元素
+// mpmc       对 --threads 中的每个 n，依次以 1 对 n、n 对 1、n 对 n 个生产者与消费者运行
+// mpmc_n     同 mpmc，以 try_push_n / try_pop_n 搬运
+//
+// 一次操作指一个元素从入队到出队；延迟是采样元素从入队前到出队后经过的时间，包括在队列中等待的时间，
+// 线程多于处理器时主要反映调度的间隔
+
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "concurrent_queue.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "queue";
+    const size_t kCapacity = 1024;
+    const size_t kBatch = 32;
+
+    // 对照组：以互斥锁保护的有界 std::deque，接口与 mpmc_queue 相同
+    class mutex_queue {
+    public:
+        explicit mutex_queue(size_t capacity) : capacity_(capacity) {}
+
+        bool try_push(uint64_t value) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(items_.size() == capacity_)
+                return false;
+            items_.push_back(value);
+            return true;
+        }
+
+        bool try_pop(uint64_t& value) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(items_.empty())
+                return false;
+            value = items_.front();
+            items_.pop_front();
+            return true;
+        }
+
+        size_t try_push_n(const uint64_t* first, size_t n) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(n > capacity_ - items_.size())
+                n = capacity_ - items_.size();
+            items_.insert(items_.end(), first, first + n);
+            return n;
+        }
+
+        size_t try_pop_n(uint64_t* out, size_t n) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(n > items_.size())
+                n = items_.size();
+            std::copy(items_.begin(), items_.begin() + n, out);
+            items_.erase(items_.begin(), items_.begin() + n);
+            return n;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::deque<uint64_t> items_;
+        size_t capacity_;
+    };
+
+    // 元素的值：采样的元素是入队前的时间戳，其余为 0
+    class stamper {
+    public:
+        explicit stamper(size_t every) : every_(every == 0 ? 1 : every), count_(0) {}
+        uint64_t next() {
+            if(++count_ == every_) {
+                count_ = 0;
+                return now_ns();
+            }
+            return 0;
+        }
+
+    private:
+        size_t every_;
+        size_t count_;
+    };
+
+    inline void record(latency_sampler& s, uint64_t stamp) {
+        if(stamp != 0)
+            s.add(now_ns() - stamp);
+    }
+
+    // producers 个生产者各入队 count 个元素，consumers 个消费者一起把它们全部取出
+    template<typename Queue>
+    void run_queue(context& ctx, const char* workload, const char* impl,
+                   size_t producers, size_t consumers, bool batch) {
+        const uint64_t count = ctx.scaled(2000000) / producers + 1;
+        const uint64_t total = count * producers;
+        Queue* q = new_aligned<Queue>(kCapacity);
+        std::atomic<uint64_t> consumed(0);
+        std::mutex mutex;
+        const std::string name = std::string(workload) + "_" + std::to_string(producers) + "p" +
+                                 std::to_string(consumers) + "c";
+        measurement m(ctx, kSuite, name, impl, producers + consumers);
+        const size_t every = ctx.opt().sample_every;
+
+        const double seconds = run_threads(producers + consumers, [&](size_t tid) {
+            if(tid < producers) {
+                stamper st(every);
+                if(batch) {
+                    uint64_t buf[kBatch];
+                    for(uint64_t i = 0; i < count; ) {
+                        const size_t n = count - i < kBatch ? static_cast<size_t>(count - i) : kBatch;
+                        for(size_t j = 0; j < n; ++j)
+                            buf[j] = st.next();
+                        for(size_t done = 0; done < n; ) {
+                            const size_t pushed = q->try_push_n(buf + done, n - done);
+                            if(pushed == 0)
+                                std::this_thread::yield();
+                            done += pushed;
+                        }
+                        i += n;
+                    }
+                } else {
+                    for(uint64_t i = 0; i < count; ++i) {
+                        const uint64_t v = st.next();
+                        while(!q->try_push(v))
+                            std::this_thread::yield();
+                    }
+                }
+            } else {
+                latency_sampler s(every);
+                uint64_t buf[kBatch];
+                while(consumed.load(std::memory_order_relaxed) < total) {
+                    size_t n = 0;
+                    if(batch) {
+                        n = q->try_pop_n(buf, kBatch);
+                    } else if(q->try_pop(buf[0])) {
+                        n = 1;
+                    }
+                    if(n == 0) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    for(size_t j = 0; j < n; ++j)
+                        record(s, buf[j]);
+                    consumed.fetch_add(n, std::memory_order_relaxed);
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                m.add_samples(s.samples());
+            }
+        });
+        m.finish(total, seconds);
+        delete_aligned(q);
+    }
+
+    // 对 --threads 中的每个 n 得到不重复的 (生产者, 消费者) 组合
+    std::vector<std::pair<size_t, size_t>> mpmc_shapes(const std::vector<size_t>& threads) {
+        std::vector<std::pair<size_t, size_t>> shapes;
+        for(size_t i = 0; i < threads.size(); ++i) {
+            const size_t n = threads[i];
+            const std::pair<size_t, size_t> candidates[] = {
+                std::make_pair(size_t(1), n), std::make_pair(n, size_t(1)), std::make_pair(n, n)
+            };
+            for(size_t j = 0; j < 3; ++j) {
+                if(std::find(shapes.begin(), shapes.end(), candidates[j]) == shapes.end())
+                    shapes.push_back(candidates[j]);
+            }
+        }
+        return shapes;
+    }
+
+    void run_spsc(context& ctx, const char* workload, bool batch) {
+        run_queue<mystl::spsc_ring<uint64_t>>(ctx, workload, "spsc_ring", 1, 1, batch);
+        run_queue<mystl::mpmc_queue<uint64_t>>(ctx, workload, "mpmc_queue", 1, 1, batch);
+        run_queue<mutex_queue>(ctx, workload, "mutex+deque", 1, 1, batch);
+    }
+
+    void run_mpmc(context& ctx, const char* workload, bool batch) {
+        const std::vector<std::pair<size_t, size_t>> shapes = mpmc_shapes(ctx.opt().threads);
+        for(size_t i = 0; i < shapes.size(); ++i) {
+            run_queue<mystl::mpmc_queue<uint64_t>>(ctx, workload, "mpmc_queue",
+                                                   shapes[i].first, shapes[i].second, batch);
+            run_queue<mutex_queue>(ctx, workload, "mutex+deque", shapes[i].first, shapes[i].second, batch);
+        }
+    }
+
+} // namespace
+
+MYSTL_BENCH("queue", spsc) {
+    run_spsc(ctx, "spsc", false);
+}
+
+MYSTL_BENCH("queue", spsc_n) {
+    run_spsc(ctx, "spsc_n", true);
+}
+
+MYSTL_BENCH("queue", mpmc) {
+    run_mpmc(ctx, "mpmc", false);
+}
+
+MYSTL_BENCH("queue", mpmc_n) {
+    run_mpmc(ctx, "mpmc_n", true);
+}
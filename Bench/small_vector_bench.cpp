@@ -0,0 +1,210 @@
+// 小序列的工作负载：small_vector<uint64_t, 8> 与 mystl::vector、std::vector 的对比
+// 序列的长度为 1、4、8 时 small_vector 只用内联缓冲区，16、32 时超出内联容量，改用堆上的存储
+//
+// build   构造一个空序列，push_back n 个元素，遍历求和后析构；一次操作指一个序列从构造到析构
+// copy    由一个有 n 个元素的序列复制构造再析构；一次操作指一次复制
+// move    在两个序列之间来回移动构造一个有 n 个元素的序列；一次操作指一次移动
+// nested  以外层 std::vector 持有 100K 个长度为 0 ~ 8 的随机序列，建成后遍历全部元素再整体析构；
+//         一次操作指一个内层序列，另以 build_ns / walk_ns 给出建与遍历时每个内层序列的耗时
+// 单次操作只有几十纳秒，不采样延迟，只给出吞吐量
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "small_vector.h"
+#include "vector.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "small_vector";
+
+    // 参与比较的实现
+    struct small_vector_impl {
+        typedef mystl::small_vector<uint64_t, 8> type;
+        static const char* name() { return "small_vector<8>"; }
+    };
+
+    struct mystl_vector_impl {
+        typedef mystl::vector<uint64_t> type;
+        static const char* name() { return "mystl::vector"; }
+    };
+
+    struct std_vector_impl {
+        typedef std::vector<uint64_t> type;
+        static const char* name() { return "std::vector"; }
+    };
+
+    template<typename Fn>
+    void for_each_impl(const Fn& fn) {
+        fn(small_vector_impl());
+        fn(mystl_vector_impl());
+        fn(std_vector_impl());
+    }
+
+    inline double seconds_since(uint64_t t0) {
+        return static_cast<double>(now_ns() - t0) * 1e-9;
+    }
+
+    template<typename Vec>
+    uint64_t sum_of(const Vec& v) {
+        uint64_t sum = 0;
+        for(typename Vec::const_iterator it = v.begin(); it != v.end(); ++it)
+            sum += *it;
+        return sum;
+    }
+
+    template<typename Vec>
+    Vec make_sequence(size_t n) {
+        Vec v;
+        for(size_t i = 0; i < n; ++i)
+            v.push_back(i);
+        return v;
+    }
+
+    std::string workload_name(const char* name, size_t n) {
+        return std::string(name) + "_" + std::to_string(n);
+    }
+
+    const size_t kLengths[] = { 1, 4, 8, 16, 32 };
+
+    /*****************************************************************************************/
+    // build
+
+    struct build_runner {
+        context& ctx;
+        size_t n;
+        template<typename Impl>
+        void operator()(Impl) const {
+            typedef typename Impl::type vec_type;
+            const uint64_t iters = ctx.scaled(2000000);
+            measurement m(ctx, kSuite, workload_name("build", n), Impl::name());
+            uint64_t sum = 0;
+            for(uint64_t i = 0; i < iters; ++i) {
+                vec_type v;
+                for(size_t j = 0; j < n; ++j)
+                    v.push_back(i + j);
+                sum += sum_of(v);
+                do_not_optimize(sum);
+            }
+            m.extra("elements", static_cast<double>(n));
+            m.finish(iters);
+        }
+    };
+
+    /*****************************************************************************************/
+    // copy / move
+
+    struct copy_runner {
+        context& ctx;
+        size_t n;
+        template<typename Impl>
+        void operator()(Impl) const {
+            typedef typename Impl::type vec_type;
+            const uint64_t iters = ctx.scaled(2000000);
+            const vec_type src = make_sequence<vec_type>(n);
+            measurement m(ctx, kSuite, workload_name("copy", n), Impl::name());
+            for(uint64_t i = 0; i < iters; ++i) {
+                vec_type v(src);
+                do_not_optimize(v.data()[n - 1]);
+            }
+            m.extra("elements", static_cast<double>(n));
+            m.finish(iters);
+        }
+    };
+
+    struct move_runner {
+        context& ctx;
+        size_t n;
+        template<typename Impl>
+        void operator()(Impl) const {
+            typedef typename Impl::type vec_type;
+            const uint64_t iters = ctx.scaled(2000000);
+            vec_type a = make_sequence<vec_type>(n);
+            measurement m(ctx, kSuite, workload_name("move", n), Impl::name());
+            for(uint64_t i = 0; i < iters; i += 2) {
+                vec_type b(std::move(a));
+                do_not_optimize(b.data()[n - 1]);
+                a = std::move(b);
+                do_not_optimize(a.data()[n - 1]);
+            }
+            if(a.size() != n) {
+                std::fprintf(stderr, "small_vector/move: %s lost elements\n", Impl::name());
+                std::abort();
+            }
+            m.extra("elements", static_cast<double>(n));
+            m.finish(iters);
+        }
+    };
+
+    /*****************************************************************************************/
+    // nested
+
+    struct nested_runner {
+        context& ctx;
+        template<typename Impl>
+        void operator()(Impl) const {
+            typedef typename Impl::type vec_type;
+            const size_t count = 100000;
+            const uint64_t rounds = ctx.scaled(40) + 1;
+            double build_seconds = 0.0;
+            double walk_seconds = 0.0;
+            uint64_t sum = 0;
+            measurement m(ctx, kSuite, "nested", Impl::name());
+            const uint64_t start = now_ns();
+            for(uint64_t r = 0; r < rounds; ++r) {
+                xorshift rng(r + 1);
+                uint64_t t0 = now_ns();
+                std::vector<vec_type> outer(count);
+                for(size_t i = 0; i < count; ++i) {
+                    const size_t len = static_cast<size_t>(rng.below(9));
+                    for(size_t j = 0; j < len; ++j)
+                        outer[i].push_back(i + j);
+                }
+                build_seconds += seconds_since(t0);
+
+                t0 = now_ns();
+                for(size_t i = 0; i < count; ++i)
+                    sum += sum_of(outer[i]);
+                walk_seconds += seconds_since(t0);
+                do_not_optimize(sum);
+            }
+            const double seconds = seconds_since(start);
+            m.extra("build_ns", build_seconds * 1e9 / static_cast<double>(rounds * count));
+            m.extra("walk_ns", walk_seconds * 1e9 / static_cast<double>(rounds * count));
+            m.finish(rounds * count, seconds);
+        }
+    };
+
+    template<typename Runner>
+    void run_lengths(context& ctx) {
+        for(size_t i = 0; i < sizeof(kLengths) / sizeof(kLengths[0]); ++i) {
+            Runner runner = { ctx, kLengths[i] };
+            for_each_impl(runner);
+        }
+    }
+
+} // namespace
+
+MYSTL_BENCH("small_vector", build) {
+    run_lengths<build_runner>(ctx);
+}
+
+MYSTL_BENCH("small_vector", copy) {
+    run_lengths<copy_runner>(ctx);
+}
+
+MYSTL_BENCH("small_vector", move) {
+    run_lengths<move_runner>(ctx);
+}
+
+MYSTL_BENCH("small_vector", nested) {
+    nested_runner runner = { ctx };
+    for_each_impl(runner);
+}
@@ -0,0 +1,155 @@
+// 排序的工作负载：mystl::sort / stable_sort 与 std::sort / std::stable_sort 的对比
+// 每种键类型（uint64_t、int32_t、double）各有四种输入：random 随机，sorted 已升序，reverse 降序，
+// dups 只有 16 个不同的值；另有 record 以自定义比较函数排序结构体（不走基数排序），
+// 以及 pair 以 sort_by_key(selectfirst) 按 first 排序。一次操作指排好一个元素，计时不包括复制输入。
+
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "algo.h"
+#include "functional.h"
+#include "util.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "sort";
+    const size_t kRepeats = 5;
+
+    enum input_pattern { random_input, sorted_input, reverse_input, dups_input };
+
+    const char* pattern_name(input_pattern p) {
+        switch(p) {
+            case random_input:  return "random";
+            case sorted_input:  return "sorted";
+            case reverse_input: return "reverse";
+            default:            return "dups";
+        }
+    }
+
+    // 由 64 位随机数得到各种键类型的值，double 取 [-1e6, 1e6) 内的值，覆盖正负两种符号
+    template<typename T> T make_key(uint64_t x);
+    template<> uint64_t make_key<uint64_t>(uint64_t x) { return x; }
+    template<> int32_t make_key<int32_t>(uint64_t x) { return static_cast<int32_t>(static_cast<uint32_t>(x)); }
+    template<> double make_key<double>(uint64_t x) {
+        return static_cast<double>(x >> 11) * (2e6 / 9007199254740992.0) - 1e6;
+    }
+
+    template<typename T>
+    std::vector<T> make_input(size_t n, input_pattern p) {
+        xorshift rng(n + static_cast<uint64_t>(p));
+        std::vector<T> v(n);
+        for(size_t i = 0; i < n; ++i)
+            v[i] = make_key<T>(p == dups_input ? rng.below(16) * 0x9E3779B97F4A7C15ull : rng());
+        if(p == sorted_input)
+            std::sort(v.begin(), v.end());
+        else if(p == reverse_input)
+            std::sort(v.begin(), v.end(), [](const T& a, const T& b) { return b < a; });
+        return v;
+    }
+
+    // 以 fn 排序 input 的副本 kRepeats 次，只对排序计时，每次排完检查结果有序
+    template<typename T, typename Fn, typename Less>
+    void measure_sort(context& ctx, const std::string& workload, const char* impl,
+                      const std::vector<T>& input, Fn fn, Less less) {
+        std::vector<T> work(input.size());
+        measurement m(ctx, kSuite, workload, impl);
+        double seconds = 0.0;
+        for(size_t r = 0; r < kRepeats; ++r) {
+            std::copy(input.begin(), input.end(), work.begin());
+            const uint64_t t0 = now_ns();
+            fn(work.data(), work.data() + work.size());
+            seconds += static_cast<double>(now_ns() - t0) * 1e-9;
+            if(!std::is_sorted(work.begin(), work.end(), less)) {
+                std::fprintf(stderr, "sort/%s: %s produced an unsorted result\n", workload.c_str(), impl);
+                std::abort();
+            }
+        }
+        m.extra("elements", static_cast<double>(input.size()));
+        m.finish(kRepeats * input.size(), seconds);
+    }
+
+    template<typename T>
+    void run_keys(context& ctx, const char* type_name) {
+        const size_t n = static_cast<size_t>(ctx.scaled(1000000));
+        const input_pattern patterns[] = { random_input, sorted_input, reverse_input, dups_input };
+        for(size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); ++i) {
+            const std::vector<T> input = make_input<T>(n, patterns[i]);
+            const std::string workload = std::string(type_name) + "_" + pattern_name(patterns[i]);
+            std::less<T> less;
+            measure_sort(ctx, workload, "mystl::sort", input, [](T* f, T* l) { mystl::sort(f, l); }, less);
+            measure_sort(ctx, workload, "std::sort", input, [](T* f, T* l) { std::sort(f, l); }, less);
+            measure_sort(ctx, workload, "mystl::stable_sort", input, [](T* f, T* l) { mystl::stable_sort(f, l); }, less);
+            measure_sort(ctx, workload, "std::stable_sort", input, [](T* f, T* l) { std::stable_sort(f, l); }, less);
+        }
+    }
+
+    // 比较函数不是 less / greater 的结构体，mystl::sort 使用 pdqsort
+    struct record {
+        uint64_t key;
+        uint64_t payload[3];
+    };
+
+    struct record_less {
+        bool operator()(const record& a, const record& b) const { return a.key < b.key; }
+    };
+
+} // namespace
+
+MYSTL_BENCH("sort", u64) {
+    run_keys<uint64_t>(ctx, "u64");
+}
+
+MYSTL_BENCH("sort", i32) {
+    run_keys<int32_t>(ctx, "i32");
+}
+
+MYSTL_BENCH("sort", f64) {
+    run_keys<double>(ctx, "f64");
+}
+
+MYSTL_BENCH("sort", record) {
+    const size_t n = static_cast<size_t>(ctx.scaled(500000));
+    const std::vector<uint64_t> keys = make_input<uint64_t>(n, random_input);
+    std::vector<record> input(n);
+    for(size_t i = 0; i < n; ++i) {
+        input[i].key = keys[i];
+        input[i].payload[0] = input[i].payload[1] = input[i].payload[2] = i;
+    }
+    record_less less;
+    measure_sort(ctx, "record_random", "mystl::sort", input,
+                 [](record* f, record* l) { mystl::sort(f, l, record_less()); }, less);
+    measure_sort(ctx, "record_random", "std::sort", input,
+                 [](record* f, record* l) { std::sort(f, l, record_less()); }, less);
+    measure_sort(ctx, "record_random", "mystl::stable_sort", input,
+                 [](record* f, record* l) { mystl::stable_sort(f, l, record_less()); }, less);
+    measure_sort(ctx, "record_random", "std::stable_sort", input,
+                 [](record* f, record* l) { std::stable_sort(f, l, record_less()); }, less);
+}
+
+MYSTL_BENCH("sort", pair) {
+    typedef mystl::pair<uint32_t, uint32_t> pair_type;
+    const size_t n = static_cast<size_t>(ctx.scaled(1000000));
+    const std::vector<uint64_t> keys = make_input<uint64_t>(n, random_input);
+    std::vector<pair_type> input(n);
+    for(size_t i = 0; i < n; ++i)
+        input[i] = pair_type(static_cast<uint32_t>(keys[i]), static_cast<uint32_t>(i));
+    auto less = [](const pair_type& a, const pair_type& b) { return a.first < b.first; };
+    measure_sort(ctx, "pair_by_first", "mystl::sort_by_key", input, [](pair_type* f, pair_type* l) {
+        mystl::sort_by_key(f, l, mystl::selectfirst<pair_type>());
+    }, less);
+    measure_sort(ctx, "pair_by_first", "std::sort", input, [&](pair_type* f, pair_type* l) {
+        std::sort(f, l, less);
+    }, less);
+    measure_sort(ctx, "pair_by_first", "mystl::stable_sort_by_key", input, [](pair_type* f, pair_type* l) {
+        mystl::stable_sort_by_key(f, l, mystl::selectfirst<pair_type>());
+    }, less);
+    measure_sort(ctx, "pair_by_first", "std::stable_sort", input, [&](pair_type* f, pair_type* l) {
+        std::stable_sort(f, l, less);
+    }, less);
+}
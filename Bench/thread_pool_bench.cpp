@@ -0,0 +1,260 @@
+// 线程池的工作负载：对 --threads 中的每个 n，以 n - 1 个工作线程加上调用线程运行，并与单线程的顺序执行对比
+//
+// fib           递归的 fib(n)，参数不小于 20 时以 task_group 派生一个子任务，其余顺序计算；一次操作指一个派生的任务，
+//               顺序执行时按同样的任务数计算
+// spawn         同上，但每一层都派生任务，衡量单个任务的派生、窃取与同步的开销
+// parallel_for  对数组的每个元素做一次 sqrt，另以 std::thread 静态均分作为对照；一次操作指一个元素
+// tree          随机分叉（0 ~ 4 个子节点）的不平衡树，叶子上做固定量的计算；一次操作指一个节点
+//
+// 顺序执行的结果以 impl 为 sequential 给出，其余结果另以 speedup 给出相对它的加速比
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "thread_pool.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "thread_pool";
+
+    inline double seconds_since(uint64_t t0) {
+        return static_cast<double>(now_ns() - t0) * 1e-9;
+    }
+
+    void check(bool ok, const char* workload, const char* impl) {
+        if(!ok) {
+            std::fprintf(stderr, "thread_pool/%s: %s produced a wrong result\n", workload, impl);
+            std::abort();
+        }
+    }
+
+    /*****************************************************************************************/
+    // fib / spawn
+
+    uint64_t fib_seq(unsigned n) {
+        return n < 2 ? n : fib_seq(n - 1) + fib_seq(n - 2);
+    }
+
+    // 参数不小于 cutoff 时派生任务，tasks 记录派生的任务数
+    uint64_t fib_par(mystl::thread_pool& pool, unsigned n, unsigned cutoff, std::atomic<uint64_t>& tasks) {
+        if(n < cutoff || n < 2)
+            return fib_seq(n);
+        uint64_t a = 0;
+        auto task = mystl::make_task([&] { a = fib_par(pool, n - 1, cutoff, tasks); });
+        mystl::task_group g(pool);
+        g.spawn(task);
+        tasks.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t b = fib_par(pool, n - 2, cutoff, tasks);
+        g.sync();
+        return a + b;
+    }
+
+    // fib_par 派生的任务数，顺序执行的结果以同样的数目计算吞吐量
+    uint64_t spawn_count(unsigned n, unsigned cutoff) {
+        std::vector<uint64_t> count(n + 1, 0);
+        for(unsigned i = 2; i <= n; ++i)
+            count[i] = i < cutoff ? 0 : 1 + count[i - 1] + count[i - 2];
+        return count[n];
+    }
+
+    // fib 的参数随倍率变化，运行时间大致与倍率成正比
+    unsigned fib_arg(const context& ctx) {
+        unsigned n = 32;
+        for(double s = ctx.opt().scale; s < 0.9 && n > 16; s *= 1.618)
+            --n;
+        return n;
+    }
+
+    void run_fib(context& ctx, const char* workload, unsigned cutoff) {
+        const unsigned n = fib_arg(ctx);
+        measurement seq(ctx, kSuite, workload, "sequential");
+        uint64_t t0 = now_ns();
+        const uint64_t expected = fib_seq(n);
+        const double seq_seconds = seconds_since(t0);
+        do_not_optimize(expected);
+        seq.extra("n", n);
+        seq.finish(spawn_count(n, cutoff), seq_seconds);
+
+        const std::vector<size_t>& threads = ctx.opt().threads;
+        for(size_t i = 0; i < threads.size(); ++i) {
+            mystl::thread_pool pool(threads[i] - 1);
+            std::atomic<uint64_t> tasks(0);
+            measurement m(ctx, kSuite, workload, "thread_pool", threads[i]);
+            t0 = now_ns();
+            const uint64_t got = fib_par(pool, n, cutoff, tasks);
+            const double seconds = seconds_since(t0);
+            check(got == expected && tasks.load() == spawn_count(n, cutoff), workload, "thread_pool");
+            m.extra("n", n);
+            m.extra("speedup", seq_seconds / seconds);
+            m.finish(tasks.load(), seconds);
+        }
+    }
+
+    /*****************************************************************************************/
+    // parallel_for
+
+    inline void kernel(std::vector<double>& v, size_t i) {
+        v[i] = std::sqrt(v[i] + static_cast<double>(i));
+    }
+
+    void run_parallel_for(context& ctx) {
+        const size_t n = static_cast<size_t>(ctx.scaled(16 * 1024 * 1024));
+        std::vector<double> v(n, 1.0);
+
+        measurement seq(ctx, kSuite, "parallel_for", "sequential");
+        uint64_t t0 = now_ns();
+        for(size_t i = 0; i < n; ++i)
+            kernel(v, i);
+        const double seq_seconds = seconds_since(t0);
+        do_not_optimize(v[n / 2]);
+        seq.finish(n, seq_seconds);
+
+        const std::vector<size_t>& threads = ctx.opt().threads;
+        for(size_t t = 0; t < threads.size(); ++t) {
+            const size_t nthreads = threads[t];
+            {
+                mystl::thread_pool pool(nthreads - 1);
+                measurement m(ctx, kSuite, "parallel_for", "thread_pool", nthreads);
+                t0 = now_ns();
+                pool.parallel_for(n, [&](size_t i) { kernel(v, i); });
+                const double seconds = seconds_since(t0);
+                m.extra("speedup", seq_seconds / seconds);
+                m.finish(n, seconds);
+            }
+            {
+                // 对照：每次调用都创建线程，按线程数静态均分
+                measurement m(ctx, kSuite, "parallel_for", "std::thread", nthreads);
+                t0 = now_ns();
+                std::vector<std::thread> workers;
+                for(size_t w = 0; w < nthreads; ++w) {
+                    workers.emplace_back([&, w] {
+                        const size_t lo = n * w / nthreads, hi = n * (w + 1) / nthreads;
+                        for(size_t i = lo; i < hi; ++i)
+                            kernel(v, i);
+                    });
+                }
+                for(size_t w = 0; w < workers.size(); ++w)
+                    workers[w].join();
+                const double seconds = seconds_since(t0);
+                m.extra("speedup", seq_seconds / seconds);
+                m.finish(n, seconds);
+            }
+        }
+        do_not_optimize(v[n / 3]);
+    }
+
+    /*****************************************************************************************/
+    // tree
+
+    // 以种子 1 生成的深度为 10 的树约有 3700 个节点，其中约一半是叶子
+    const unsigned kTreeDepth = 10;
+    const unsigned kTreeSeed = 1;
+
+    inline unsigned tree_next(unsigned seed) {
+        return seed * 1103515245u + 12345u;
+    }
+
+    // 节点的子节点数由 seed 决定，0 ~ 4 个，因此各子树的大小差别很大
+    inline unsigned tree_children(unsigned seed) {
+        return (tree_next(seed) >> 16) % 5;
+    }
+
+    uint64_t tree_leaf(unsigned seed, unsigned work) {
+        uint64_t s = 0;
+        for(unsigned i = 0; i < work; ++i)
+            s += (seed * 2654435761u + i) % 7;
+        return s;
+    }
+
+    // 返回子树的节点数，叶子的计算结果累加到 sum
+    uint64_t tree_seq(unsigned seed, unsigned depth, unsigned work, uint64_t& sum) {
+        if(depth == 0) {
+            sum += tree_leaf(seed, work);
+            return 1;
+        }
+        const unsigned kids = tree_children(seed);
+        uint64_t nodes = 1;
+        for(unsigned k = 0; k < kids; ++k)
+            nodes += tree_seq(tree_next(seed) + k, depth - 1, work, sum);
+        return nodes;
+    }
+
+    struct tree_result {
+        uint64_t nodes;
+        uint64_t sum;
+    };
+
+    tree_result tree_par(mystl::thread_pool& pool, unsigned seed, unsigned depth, unsigned work) {
+        if(depth == 0) {
+            tree_result r = { 1, tree_leaf(seed, work) };
+            return r;
+        }
+        const unsigned kids = tree_children(seed);
+        tree_result parts[4] = {};
+        mystl::task_group g(pool);
+        auto t1 = mystl::make_task([&] { parts[1] = tree_par(pool, tree_next(seed) + 1, depth - 1, work); });
+        auto t2 = mystl::make_task([&] { parts[2] = tree_par(pool, tree_next(seed) + 2, depth - 1, work); });
+        auto t3 = mystl::make_task([&] { parts[3] = tree_par(pool, tree_next(seed) + 3, depth - 1, work); });
+        if(kids > 1) g.spawn(t1);
+        if(kids > 2) g.spawn(t2);
+        if(kids > 3) g.spawn(t3);
+        if(kids > 0)
+            parts[0] = tree_par(pool, tree_next(seed), depth - 1, work);
+        g.sync();
+        tree_result r = { 1, 0 };
+        for(unsigned k = 0; k < kids; ++k) {
+            r.nodes += parts[k].nodes;
+            r.sum += parts[k].sum;
+        }
+        return r;
+    }
+
+    void run_tree(context& ctx) {
+        const unsigned work = static_cast<unsigned>(ctx.scaled(20000));
+        const unsigned seed = kTreeSeed;
+
+        measurement seq(ctx, kSuite, "tree", "sequential");
+        uint64_t sum = 0;
+        uint64_t t0 = now_ns();
+        const uint64_t nodes = tree_seq(seed, kTreeDepth, work, sum);
+        const double seq_seconds = seconds_since(t0);
+        seq.finish(nodes, seq_seconds);
+
+        const std::vector<size_t>& threads = ctx.opt().threads;
+        for(size_t i = 0; i < threads.size(); ++i) {
+            mystl::thread_pool pool(threads[i] - 1);
+            measurement m(ctx, kSuite, "tree", "thread_pool", threads[i]);
+            t0 = now_ns();
+            const tree_result r = tree_par(pool, seed, kTreeDepth, work);
+            const double seconds = seconds_since(t0);
+            check(r.nodes == nodes && r.sum == sum, "tree", "thread_pool");
+            m.extra("speedup", seq_seconds / seconds);
+            m.finish(nodes, seconds);
+        }
+    }
+
+} // namespace
+
+MYSTL_BENCH("thread_pool", fib) {
+    run_fib(ctx, "fib", 20);
+}
+
+MYSTL_BENCH("thread_pool", spawn) {
+    run_fib(ctx, "spawn", 2);
+}
+
+MYSTL_BENCH("thread_pool", parallel_for) {
+    run_parallel_for(ctx);
+}
+
+MYSTL_BENCH("thread_pool", tree) {
+    run_tree(ctx);
+}
@@ -0,0 +1,158 @@
+// uninitialized.h 的工作负载：可平凡复制类型的 memmove / memset 路径与标准库、逐个构造的循环对比
+// 缓冲区大小取 16 KiB（L1）、1 MiB（L2 / L3）与 64 MiB（主存），不超过 scaled(64 MiB)，元素为 uint64_t；
+// 一次操作指处理一个元素，另以 gb_per_s 给出每秒写入目标区间的字节数（copy / move 另读同样多的字节）
+//
+// copy        uninitialized_copy；对比 std::uninitialized_copy、memcpy 与逐个 placement new 的循环
+// move        uninitialized_move；对比 std::uninitialized_copy 与逐个 placement new 的循环
+// fill_zero   uninitialized_fill_n 填充所有字节相同的值 0，走 memset；对比 std::uninitialized_fill_n 与 memset
+// fill_value  uninitialized_fill_n 填充字节不同的值，逐个 memcpy；对比 std::uninitialized_fill_n
+// value_init  uninitialized_value_construct_n，走 memset；对比逐个值初始化的循环
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "uninitialized.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "uninitialized";
+
+    inline double seconds_since(uint64_t t0) {
+        return static_cast<double>(now_ns() - t0) * 1e-9;
+    }
+
+    // 以固定的缓冲区重复执行 fn(src, dst, n)，直到处理的字节数约为 scaled(4 GiB)
+    template<typename Fn>
+    void run_kernel(context& ctx, const char* workload, const char* impl, size_t bytes, const Fn& fn) {
+        const size_t n = bytes / sizeof(uint64_t);
+        std::vector<uint64_t> src(n);
+        for(size_t i = 0; i < n; ++i)
+            src[i] = i * 0x9e3779b97f4a7c15ULL;
+        uint64_t* dst = static_cast<uint64_t*>(::operator new(n * sizeof(uint64_t)));
+        // 先写一遍，让页都已映射
+        std::memset(dst, 0, n * sizeof(uint64_t));
+
+        const uint64_t total = ctx.scaled(uint64_t(4) << 30);
+        const uint64_t reps = total / bytes + 1;
+        measurement m(ctx, kSuite, std::string(workload) + "_" + std::to_string(bytes >> 10) + "k", impl);
+        const uint64_t t0 = now_ns();
+        for(uint64_t r = 0; r < reps; ++r) {
+            fn(src.data(), dst, n);
+            do_not_optimize(dst[r % n]);
+        }
+        const double seconds = seconds_since(t0);
+        m.extra("gb_per_s", static_cast<double>(reps * bytes) / seconds * 1e-9);
+        m.finish(reps * n, seconds);
+        ::operator delete(dst);
+    }
+
+    std::vector<size_t> buffer_sizes(context& ctx) {
+        std::vector<size_t> sizes;
+        const size_t candidates[] = { size_t(16) << 10, size_t(1) << 20, size_t(64) << 20 };
+        const uint64_t limit = ctx.scaled(uint64_t(64) << 20);
+        for(size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); ++i) {
+            if(i == 0 || candidates[i] <= limit)
+                sizes.push_back(candidates[i]);
+        }
+        return sizes;
+    }
+
+    const uint64_t kPattern = 0x0102030405060708ULL;
+
+    void run_copy(context& ctx, size_t bytes) {
+        run_kernel(ctx, "copy", "mystl", bytes, [](const uint64_t* s, uint64_t* d, size_t n) {
+            const uint64_t* cs = s;
+            mystl::uninitialized_copy(cs, cs + n, d);
+        });
+        run_kernel(ctx, "copy", "std", bytes, [](const uint64_t* s, uint64_t* d, size_t n) {
+            std::uninitialized_copy(s, s + n, d);
+        });
+        run_kernel(ctx, "copy", "memcpy", bytes, [](const uint64_t* s, uint64_t* d, size_t n) {
+            std::memcpy(d, s, n * sizeof(uint64_t));
+        });
+        run_kernel(ctx, "copy", "loop", bytes, [](const uint64_t* s, uint64_t* d, size_t n) {
+            for(size_t i = 0; i < n; ++i)
+                ::new (static_cast<void*>(d + i)) uint64_t(s[i]);
+        });
+    }
+
+    void run_move(context& ctx, size_t bytes) {
+        run_kernel(ctx, "move", "mystl", bytes, [](const uint64_t* s, uint64_t* d, size_t n) {
+            uint64_t* ms = const_cast<uint64_t*>(s);
+            mystl::uninitialized_move(ms, ms + n, d);
+        });
+        run_kernel(ctx, "move", "std", bytes, [](const uint64_t* s, uint64_t* d, size_t n) {
+            std::uninitialized_copy(s, s + n, d);
+        });
+        run_kernel(ctx, "move", "loop", bytes, [](const uint64_t* s, uint64_t* d, size_t n) {
+            for(size_t i = 0; i < n; ++i)
+                ::new (static_cast<void*>(d + i)) uint64_t(s[i]);
+        });
+    }
+
+    void run_fill_zero(context& ctx, size_t bytes) {
+        run_kernel(ctx, "fill_zero", "mystl", bytes, [](const uint64_t*, uint64_t* d, size_t n) {
+            mystl::uninitialized_fill_n(d, n, uint64_t(0));
+        });
+        run_kernel(ctx, "fill_zero", "std", bytes, [](const uint64_t*, uint64_t* d, size_t n) {
+            std::uninitialized_fill_n(d, n, uint64_t(0));
+        });
+        run_kernel(ctx, "fill_zero", "memset", bytes, [](const uint64_t*, uint64_t* d, size_t n) {
+            std::memset(d, 0, n * sizeof(uint64_t));
+        });
+    }
+
+    void run_fill_value(context& ctx, size_t bytes) {
+        run_kernel(ctx, "fill_value", "mystl", bytes, [](const uint64_t*, uint64_t* d, size_t n) {
+            mystl::uninitialized_fill_n(d, n, kPattern);
+        });
+        run_kernel(ctx, "fill_value", "std", bytes, [](const uint64_t*, uint64_t* d, size_t n) {
+            std::uninitialized_fill_n(d, n, kPattern);
+        });
+    }
+
+    void run_value_init(context& ctx, size_t bytes) {
+        run_kernel(ctx, "value_init", "mystl", bytes, [](const uint64_t*, uint64_t* d, size_t n) {
+            mystl::uninitialized_value_construct_n(d, n);
+        });
+        run_kernel(ctx, "value_init", "loop", bytes, [](const uint64_t*, uint64_t* d, size_t n) {
+            for(size_t i = 0; i < n; ++i)
+                ::new (static_cast<void*>(d + i)) uint64_t();
+        });
+    }
+
+    template<typename Fn>
+    void for_each_size(context& ctx, Fn fn) {
+        const std::vector<size_t> sizes = buffer_sizes(ctx);
+        for(size_t i = 0; i < sizes.size(); ++i)
+            fn(ctx, sizes[i]);
+    }
+
+} // namespace
+
+MYSTL_BENCH("uninitialized", copy) {
+    for_each_size(ctx, run_copy);
+}
+
+MYSTL_BENCH("uninitialized", move) {
+    for_each_size(ctx, run_move);
+}
+
+MYSTL_BENCH("uninitialized", fill_zero) {
+    for_each_size(ctx, run_fill_zero);
+}
+
+MYSTL_BENCH("uninitialized", fill_value) {
+    for_each_size(ctx, run_fill_value);
+}
+
+MYSTL_BENCH("uninitialized", value_init) {
+    for_each_size(ctx, run_value_init);
+}
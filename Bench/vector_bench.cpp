@@ -0,0 +1,180 @@
+// 向量的工作负载：mystl::vector 与 libstdc++ 的 std::vector 对比
+// 元素类型分为 POD（uint64_t，扩容与搬移走 memcpy / memmove）与非平凡类型（32 个字符的 std::string，逐个移动）
+//
+// push_back  从空向量逐个 push_back n 个元素，不预先 reserve；一次操作指一次 push_back
+// insert     从空向量开始，每次在随机位置 insert 一个元素，直到 n 个；一次操作指一次 insert
+// erase      由 n 个元素的向量开始，每次 erase 随机位置的一个元素，直到为空；一次操作指一次 erase
+// insert 与 erase 的开销主要是搬移插入点之后的元素，n 取得比 push_back 小
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "vector.h"
+
+namespace {
+
+    using namespace mystl_bench;
+
+    const char* const kSuite = "vector";
+
+    // 参与比较的实现
+    struct mystl_vector_impl {
+        template<typename T>
+        struct vec {
+            typedef mystl::vector<T> type;
+        };
+        static const char* name() { return "mystl::vector"; }
+    };
+
+    struct std_vector_impl {
+        template<typename T>
+        struct vec {
+            typedef std::vector<T> type;
+        };
+        static const char* name() { return "std::vector"; }
+    };
+
+    // 元素类型
+    struct pod_elem {
+        typedef uint64_t type;
+        static const char* name() { return "pod"; }
+        static type make(uint64_t i) { return i; }
+        static uint64_t key(const type& x) { return x; }
+    };
+
+    struct string_elem {
+        typedef std::string type;
+        static const char* name() { return "string"; }
+        static type make(uint64_t i) { return std::string(32, static_cast<char>('a' + i % 26)); }
+        static uint64_t key(const type& x) { return static_cast<uint64_t>(x[0]); }
+    };
+
+    template<typename Fn>
+    void for_each_impl(const Fn& fn) {
+        fn(mystl_vector_impl());
+        fn(std_vector_impl());
+    }
+
+    inline double seconds_since(uint64_t t0) {
+        return static_cast<double>(now_ns() - t0) * 1e-9;
+    }
+
+    std::string workload_name(const char* name, const char* elem) {
+        return std::string(name) + "_" + elem;
+    }
+
+    /*****************************************************************************************/
+    // push_back
+
+    template<typename Elem>
+    struct push_back_runner {
+        context& ctx;
+        template<typename Impl>
+        void operator()(Impl) const {
+            typedef typename Impl::template vec<typename Elem::type>::type vec_type;
+            const size_t n = 100000;
+            const uint64_t rounds = ctx.scaled(100) + 1;
+            const typename Elem::type value = Elem::make(7);
+            measurement m(ctx, kSuite, workload_name("push_back", Elem::name()), Impl::name());
+            uint64_t sum = 0;
+            const uint64_t t0 = now_ns();
+            for(uint64_t r = 0; r < rounds; ++r) {
+                vec_type v;
+                for(size_t i = 0; i < n; ++i)
+                    v.push_back(value);
+                sum += Elem::key(v[n - 1]) + v.size();
+                do_not_optimize(sum);
+            }
+            const double seconds = seconds_since(t0);
+            m.extra("elements", static_cast<double>(n));
+            m.finish(rounds * n, seconds);
+        }
+    };
+
+    /*****************************************************************************************/
+    // insert / erase
+
+    template<typename Elem>
+    struct insert_runner {
+        context& ctx;
+        template<typename Impl>
+        void operator()(Impl) const {
+            typedef typename Impl::template vec<typename Elem::type>::type vec_type;
+            const size_t n = 20000;
+            const uint64_t rounds = ctx.scaled(10) + 1;
+            measurement m(ctx, kSuite, workload_name("insert", Elem::name()), Impl::name());
+            latency_sampler s(ctx.opt().sample_every);
+            uint64_t sum = 0;
+            const uint64_t t0 = now_ns();
+            for(uint64_t r = 0; r < rounds; ++r) {
+                xorshift rng(r + 1);
+                vec_type v;
+                for(size_t i = 0; i < n; ++i) {
+                    const size_t pos = static_cast<size_t>(rng.below(v.size() + 1));
+                    s.run([&] { v.insert(v.begin() + static_cast<std::ptrdiff_t>(pos), Elem::make(i)); });
+                }
+                sum += Elem::key(v[n / 2]);
+                do_not_optimize(sum);
+            }
+            const double seconds = seconds_since(t0);
+            m.add_samples(s.samples());
+            m.extra("elements", static_cast<double>(n));
+            m.finish(rounds * n, seconds);
+        }
+    };
+
+    template<typename Elem>
+    struct erase_runner {
+        context& ctx;
+        template<typename Impl>
+        void operator()(Impl) const {
+            typedef typename Impl::template vec<typename Elem::type>::type vec_type;
+            const size_t n = 20000;
+            const uint64_t rounds = ctx.scaled(10) + 1;
+            measurement m(ctx, kSuite, workload_name("erase", Elem::name()), Impl::name());
+            latency_sampler s(ctx.opt().sample_every);
+            double seconds = 0.0;
+            uint64_t sum = 0;
+            for(uint64_t r = 0; r < rounds; ++r) {
+                xorshift rng(r + 1);
+                vec_type v;
+                for(size_t i = 0; i < n; ++i)
+                    v.push_back(Elem::make(i));
+                const uint64_t t0 = now_ns();
+                while(!v.empty()) {
+                    const size_t pos = static_cast<size_t>(rng.below(v.size()));
+                    s.run([&] { v.erase(v.begin() + static_cast<std::ptrdiff_t>(pos)); });
+                    sum += v.size();
+                }
+                seconds += seconds_since(t0);
+                do_not_optimize(sum);
+            }
+            m.add_samples(s.samples());
+            m.extra("elements", static_cast<double>(n));
+            m.finish(rounds * n, seconds);
+        }
+    };
+
+    template<template<typename> class Runner>
+    void run_elems(context& ctx) {
+        Runner<pod_elem> pod = { ctx };
+        for_each_impl(pod);
+        Runner<string_elem> str = { ctx };
+        for_each_impl(str);
+    }
+
+} // namespace
+
+MYSTL_BENCH("vector", push_back) {
+    run_elems<push_back_runner>(ctx);
+}
+
+MYSTL_BENCH("vector", insert) {
+    run_elems<insert_runner>(ctx);
+}
+
+MYSTL_BENCH("vector", erase) {
+    run_elems<erase_runner>(ctx);
+}
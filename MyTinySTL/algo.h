@@ -0,0 +1,940 @@
+#ifndef MY_TINY_ALGO_H_
+#define MY_TINY_ALGO_H_
+
+// 这个头文件包含了 mystl 的一系列算法
+// sort 使用 pattern-defeating quicksort，算术类型使用无分支的分块划分；
+// stable_sort 使用归并排序；连续存储的整数与 IEEE 浮点键在元素较多时改用 LSD 基数排序
+
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+#include <new>
+#include <limits>
+#include <type_traits>
+
+#include "type_traits.h"
+#include "algobase.h"
+#include "iterator.h"
+#include "functional.h"
+#include "allocator.h"
+#include "construct.h"
+#include "uninitialized.h"
+#include "util.h"
+
+namespace mystl {
+
+/*****************************************************************************************/
+// for_each
+// 使用一个函数对象 f 对[first, last)区间内的每个元素执行一个 operator() 操作，但不能改变元素内容
+// f() 可返回一个值，但该值会被忽略
+/*****************************************************************************************/
+template<typename InputIter, typename Function>
+Function for_each(InputIter first, InputIter last, Function f) {
+    for(; first != last; ++first) {
+        f(*first);
+    }
+    return f;
+}
+
+/*****************************************************************************************/
+// transform
+// 第一个版本以函数对象 unary_op 作用于[first, last)中的每个元素并将结果保存至 result 中
+// 第二个版本以函数对象 binary_op 作用于两个序列[first1, last1)、[first2, last2)的相同位置
+/*****************************************************************************************/
+template<typename InputIter, typename OutputIter, typename UnaryOperation>
+OutputIter transform(InputIter first, InputIter last, OutputIter result, UnaryOperation unary_op) {
+    for(; first != last; ++first, ++result) {
+        *result = unary_op(*first);
+    }
+    return result;
+}
+
+template<typename InputIter1, typename InputIter2, typename OutputIter, typename BinaryOperation>
+OutputIter transform(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+    OutputIter result, BinaryOperation binary_op) {
+    for(; first1 != last1; ++first1, ++first2, ++result) {
+        *result = binary_op(*first1, *first2);
+    }
+    return result;
+}
+
+/*****************************************************************************************/
+// lower_bound
+// 在[first, last)中查找第一个不小于 value 的元素，返回指向它的迭代器，若没有则返回 last
+/*****************************************************************************************/
+template<typename ForwardIter, typename T, typename Compare>
+ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T& value, Compare comp) {
+    typedef typename iterator_traits<ForwardIter>::difference_type difference_type;
+    difference_type len = mystl::distance(first, last);
+    while(len > 0) {
+        const difference_type half = len >> 1;
+        ForwardIter middle = first;
+        mystl::advance(middle, half);
+        if(comp(*middle, value)) {
+            first = ++middle;
+            len -= half + 1;
+        } else {
+            len = half;
+        }
+    }
+    return first;
+}
+
+template<typename ForwardIter, typename T>
+ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T& value) {
+    return mystl::lower_bound(first, last, value, mystl::less<T>());
+}
+
+/*****************************************************************************************/
+// upper_bound
+// 在[first, last)中查找第一个大于 value 的元素，返回指向它的迭代器，若没有则返回 last
+/*****************************************************************************************/
+template<typename ForwardIter, typename T, typename Compare>
+ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T& value, Compare comp) {
+    typedef typename iterator_traits<ForwardIter>::difference_type difference_type;
+    difference_type len = mystl::distance(first, last);
+    while(len > 0) {
+        const difference_type half = len >> 1;
+        ForwardIter middle = first;
+        mystl::advance(middle, half);
+        if(comp(value, *middle)) {
+            len = half;
+        } else {
+            first = ++middle;
+            len -= half + 1;
+        }
+    }
+    return first;
+}
+
+template<typename ForwardIter, typename T>
+ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T& value) {
+    return mystl::upper_bound(first, last, value, mystl::less<T>());
+}
+
+/*****************************************************************************************/
+// reverse
+// 将[first, last)区间内的元素反转
+/*****************************************************************************************/
+template<typename BidirectionalIter>
+void reverse(BidirectionalIter first, BidirectionalIter last) {
+    while(first != last && first != --last) {
+        mystl::iter_swap(first++, last);
+    }
+}
+
+/*****************************************************************************************/
+// rotate
+// 将[first, middle)内的元素和[middle, last)内的元素互换，返回原 first 所指元素的新位置
+/*****************************************************************************************/
+template<typename ForwardIter>
+ForwardIter rotate(ForwardIter first, ForwardIter middle, ForwardIter last) {
+    if(first == middle)
+        return last;
+    if(middle == last)
+        return first;
+    ForwardIter next = middle;
+    do {
+        mystl::iter_swap(first++, next++);
+        if(first == middle)
+            middle = next;
+    } while(next != last);
+    ForwardIter result = first;
+    next = middle;
+    while(next != last) {
+        mystl::iter_swap(first++, next++);
+        if(first == middle)
+            middle = next;
+        else if(next == last)
+            next = middle;
+    }
+    return result;
+}
+
+/*****************************************************************************************/
+// 排序的辅助工具
+/*****************************************************************************************/
+enum {
+    ESortInsertionThreshold = 24,   // 小于该长度的区间使用插入排序
+    ESortNintherThreshold = 128,    // 大于该长度的区间以 ninther（九数取中）选取枢轴
+    ESortPartialInsertionLimit = 8, // 近乎有序时，插入排序允许移动的元素个数上限
+    ESortBlockSize = 64,            // 无分支划分每次记录的偏移量个数
+    ESortCachelineSize = 64,
+    EStableSortChunk = 32,          // 归并排序中先用插入排序排好的小段长度
+    ERadixSortThreshold = 256       // 不少于该长度的可基数排序区间使用基数排序
+};
+
+// 排序使用的临时缓冲区，分配失败时 size() 为 0，调用者改用不需要缓冲区的算法
+template<typename T>
+class sort_buffer {
+public:
+    explicit sort_buffer(size_t n) : data_(nullptr), size_(0) {
+        try {
+            data_ = mystl::allocator<T>::allocate(n);
+            size_ = n;
+        } catch(const std::bad_alloc&) {
+        }
+    }
+    ~sort_buffer() {
+        if(data_ != nullptr)
+            mystl::allocator<T>::deallocate(data_, size_);
+    }
+
+    sort_buffer(const sort_buffer&) = delete;
+    sort_buffer& operator=(const sort_buffer&) = delete;
+
+    T* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+// 函数对象：以 key 提取的键比较两个元素
+template<typename KeyExtract, typename Compare>
+struct key_compare {
+    KeyExtract key;
+    Compare comp;
+
+    key_compare(const KeyExtract& k, const Compare& c) : key(k), comp(c) {}
+
+    template<typename T>
+    bool operator()(const T& lhs, const T& rhs) const { return comp(key(lhs), key(rhs)); }
+};
+
+// 判断比较操作能否使用无分支划分：算术类型上的 less / greater，或以算术类型的键比较
+template<typename Compare, typename T>
+struct is_branchless_compare : std::false_type {};
+
+template<typename T>
+struct is_branchless_compare<mystl::less<T>, T> : std::is_arithmetic<T> {};
+
+template<typename T>
+struct is_branchless_compare<mystl::greater<T>, T> : std::is_arithmetic<T> {};
+
+template<typename KeyExtract, typename Compare, typename T>
+struct is_branchless_compare<key_compare<KeyExtract, Compare>, T>
+    : is_branchless_compare<Compare, typename std::decay<
+        decltype(std::declval<const KeyExtract&>()(std::declval<const T&>()))>::type> {};
+
+/*****************************************************************************************/
+// 插入排序
+/*****************************************************************************************/
+template<typename RandomIter, typename Compare>
+void insertion_sort(RandomIter first, RandomIter last, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    if(first == last)
+        return;
+    for(RandomIter cur = first + 1; cur != last; ++cur) {
+        RandomIter sift = cur;
+        RandomIter sift_1 = cur - 1;
+        if(comp(*sift, *sift_1)) {
+            value_type tmp = mystl::move(*sift);
+            do {
+                *sift-- = mystl::move(*sift_1);
+            } while(sift != first && comp(tmp, *--sift_1));
+            *sift = mystl::move(tmp);
+        }
+    }
+}
+
+// 要求 first 之前存在一个不大于区间内任何元素的元素，省去边界检查
+template<typename RandomIter, typename Compare>
+void unguarded_insertion_sort(RandomIter first, RandomIter last, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    if(first == last)
+        return;
+    for(RandomIter cur = first + 1; cur != last; ++cur) {
+        RandomIter sift = cur;
+        RandomIter sift_1 = cur - 1;
+        if(comp(*sift, *sift_1)) {
+            value_type tmp = mystl::move(*sift);
+            do {
+                *sift-- = mystl::move(*sift_1);
+            } while(comp(tmp, *--sift_1));
+            *sift = mystl::move(tmp);
+        }
+    }
+}
+
+// 移动的元素超过 ESortPartialInsertionLimit 个时放弃并返回 false，区间仍是原区间的一个排列
+template<typename RandomIter, typename Compare>
+bool partial_insertion_sort(RandomIter first, RandomIter last, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    if(first == last)
+        return true;
+    size_t limit = 0;
+    for(RandomIter cur = first + 1; cur != last; ++cur) {
+        RandomIter sift = cur;
+        RandomIter sift_1 = cur - 1;
+        if(comp(*sift, *sift_1)) {
+            value_type tmp = mystl::move(*sift);
+            do {
+                *sift-- = mystl::move(*sift_1);
+            } while(sift != first && comp(tmp, *--sift_1));
+            *sift = mystl::move(tmp);
+            limit += static_cast<size_t>(cur - sift);
+            if(limit > ESortPartialInsertionLimit)
+                return false;
+        }
+    }
+    return true;
+}
+
+/*****************************************************************************************/
+// 堆排序，划分多次严重失衡时使用，保证 O(NlogN) 的最坏复杂度
+/*****************************************************************************************/
+template<typename RandomIter, typename Distance, typename T, typename Compare>
+void heap_sift_down(RandomIter first, Distance hole, Distance len, T value, Compare comp) {
+    Distance child = 2 * hole + 1;
+    while(child < len) {
+        if(child + 1 < len && comp(*(first + child), *(first + (child + 1))))
+            ++child;
+        if(!comp(value, *(first + child)))
+            break;
+        *(first + hole) = mystl::move(*(first + child));
+        hole = child;
+        child = 2 * hole + 1;
+    }
+    *(first + hole) = mystl::move(value);
+}
+
+template<typename RandomIter, typename Compare>
+void heap_sort(RandomIter first, RandomIter last, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    const difference_type len = last - first;
+    for(difference_type i = len / 2; i-- > 0;) {
+        mystl::heap_sift_down(first, i, len, value_type(mystl::move(*(first + i))), comp);
+    }
+    for(difference_type n = len - 1; n > 0; --n) {
+        value_type value = mystl::move(*(first + n));
+        *(first + n) = mystl::move(*first);
+        mystl::heap_sift_down(first, difference_type(0), n, mystl::move(value), comp);
+    }
+}
+
+/*****************************************************************************************/
+// pattern-defeating quicksort
+// 有序、逆序、大量重复等模式下接近线性，随机输入与快速排序相当，最坏 O(NlogN)
+/*****************************************************************************************/
+template<typename RandomIter, typename Compare>
+void sort2(RandomIter a, RandomIter b, Compare comp) {
+    if(comp(*b, *a))
+        mystl::iter_swap(a, b);
+}
+
+template<typename RandomIter, typename Compare>
+void sort3(RandomIter a, RandomIter b, RandomIter c, Compare comp) {
+    mystl::sort2(a, b, comp);
+    mystl::sort2(b, c, comp);
+    mystl::sort2(a, b, comp);
+}
+
+// 以 *first 为枢轴划分，小于枢轴的放在左侧，不小于的放在右侧
+// 返回枢轴的最终位置，以及划分前区间是否已经划分好
+template<typename RandomIter, typename Compare>
+mystl::pair<RandomIter, bool> partition_right(RandomIter begin, RandomIter end, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    value_type pivot(mystl::move(*begin));
+    RandomIter first = begin;
+    RandomIter last = end;
+
+    // 枢轴取自三个元素的中位数，左侧必然存在不小于枢轴的元素
+    while(comp(*++first, pivot));
+    if(first - 1 == begin) {
+        while(first < last && !comp(*--last, pivot));
+    } else {
+        while(!comp(*--last, pivot));
+    }
+
+    const bool already_partitioned = first >= last;
+    while(first < last) {
+        mystl::iter_swap(first, last);
+        while(comp(*++first, pivot));
+        while(!comp(*--last, pivot));
+    }
+
+    RandomIter pivot_pos = first - 1;
+    *begin = mystl::move(*pivot_pos);
+    *pivot_pos = mystl::move(pivot);
+    return mystl::pair<RandomIter, bool>(pivot_pos, already_partitioned);
+}
+
+// 交换 offsets_l、offsets_r 记录的 num 对元素，两侧个数相同时逐对交换，否则以循环移位减少一半写入
+template<typename RandomIter>
+void swap_offsets(RandomIter first, RandomIter last, const unsigned char* offsets_l,
+    const unsigned char* offsets_r, size_t num, bool use_swaps) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    if(use_swaps) {
+        for(size_t i = 0; i < num; ++i) {
+            mystl::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+        }
+    } else if(num > 0) {
+        RandomIter l = first + offsets_l[0];
+        RandomIter r = last - offsets_r[0];
+        value_type tmp(mystl::move(*l));
+        *l = mystl::move(*r);
+        for(size_t i = 1; i < num; ++i) {
+            l = first + offsets_l[i];
+            *r = mystl::move(*l);
+            r = last - offsets_r[i];
+            *l = mystl::move(*r);
+        }
+        *r = mystl::move(tmp);
+    }
+}
+
+// partition_right 的无分支版本（BlockQuicksort）
+// 先把一块元素与枢轴的比较结果写成偏移量数组，再成批交换，比较结果不再影响分支预测
+template<typename RandomIter, typename Compare>
+mystl::pair<RandomIter, bool> partition_right_branchless(RandomIter begin, RandomIter end, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    value_type pivot(mystl::move(*begin));
+    RandomIter first = begin;
+    RandomIter last = end;
+
+    while(comp(*++first, pivot));
+    if(first - 1 == begin) {
+        while(first < last && !comp(*--last, pivot));
+    } else {
+        while(!comp(*--last, pivot));
+    }
+
+    const bool already_partitioned = first >= last;
+    if(!already_partitioned) {
+        mystl::iter_swap(first, last);
+        ++first;
+
+        alignas(ESortCachelineSize) unsigned char offsets_l[ESortBlockSize];
+        alignas(ESortCachelineSize) unsigned char offsets_r[ESortBlockSize];
+        RandomIter offsets_l_base = first;
+        RandomIter offsets_r_base = last;
+        size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+        while(first < last) {
+            // 两侧都没有待交换的元素时平分剩余区间，否则只填充空的一侧
+            const size_t num_unknown = static_cast<size_t>(last - first);
+            const size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            const size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+            if(left_split >= ESortBlockSize) {
+                for(size_t i = 0; i < ESortBlockSize;) {
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                }
+            } else {
+                for(size_t i = 0; i < left_split;) {
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                }
+            }
+
+            if(right_split >= ESortBlockSize) {
+                for(size_t i = 0; i < ESortBlockSize;) {
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                }
+            } else {
+                for(size_t i = 0; i < right_split;) {
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                }
+            }
+
+            const size_t num = mystl::min(num_l, num_r);
+            mystl::swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l,
+                                offsets_r + start_r, num, num_l == num_r);
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+            if(num_l == 0) {
+                start_l = 0;
+                offsets_l_base = first;
+            }
+            if(num_r == 0) {
+                start_r = 0;
+                offsets_r_base = last;
+            }
+        }
+
+        // 区间已全部比较过，剩余一侧的待交换元素移到中间
+        if(num_l) {
+            while(num_l--) {
+                mystl::iter_swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+            }
+            first = last;
+        }
+        if(num_r) {
+            while(num_r--) {
+                mystl::iter_swap(offsets_r_base - offsets_r[start_r + num_r], first);
+                ++first;
+            }
+            last = first;
+        }
+    }
+
+    RandomIter pivot_pos = first - 1;
+    *begin = mystl::move(*pivot_pos);
+    *pivot_pos = mystl::move(pivot);
+    return mystl::pair<RandomIter, bool>(pivot_pos, already_partitioned);
+}
+
+// 以 *first 为枢轴划分，等于枢轴的元素放在左侧，用于跳过与左邻枢轴相等的一大段元素
+template<typename RandomIter, typename Compare>
+RandomIter partition_left(RandomIter begin, RandomIter end, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    value_type pivot(mystl::move(*begin));
+    RandomIter first = begin;
+    RandomIter last = end;
+
+    while(comp(pivot, *--last));
+    if(last + 1 == end) {
+        while(first < last && !comp(pivot, *++first));
+    } else {
+        while(!comp(pivot, *++first));
+    }
+
+    while(first < last) {
+        mystl::iter_swap(first, last);
+        while(comp(pivot, *--last));
+        while(!comp(pivot, *++first));
+    }
+
+    RandomIter pivot_pos = last;
+    *begin = mystl::move(*pivot_pos);
+    *pivot_pos = mystl::move(pivot);
+    return pivot_pos;
+}
+
+template<typename RandomIter, typename Compare>
+mystl::pair<RandomIter, bool> pdq_partition(RandomIter begin, RandomIter end, Compare comp, std::true_type) {
+    return mystl::partition_right_branchless(begin, end, comp);
+}
+
+template<typename RandomIter, typename Compare>
+mystl::pair<RandomIter, bool> pdq_partition(RandomIter begin, RandomIter end, Compare comp, std::false_type) {
+    return mystl::partition_right(begin, end, comp);
+}
+
+// leftmost 为 false 时，begin 之前的元素不大于区间内的任何元素
+template<typename RandomIter, typename Compare, typename Branchless>
+void pdqsort_loop(RandomIter begin, RandomIter end, Compare comp, int bad_allowed,
+    Branchless branchless, bool leftmost = true) {
+    typedef typename iterator_traits<RandomIter>::difference_type difference_type;
+    for(;;) {
+        const difference_type size = end - begin;
+        if(size < ESortInsertionThreshold) {
+            if(leftmost)
+                mystl::insertion_sort(begin, end, comp);
+            else
+                mystl::unguarded_insertion_sort(begin, end, comp);
+            return;
+        }
+
+        // 选取枢轴并放到 begin
+        const difference_type s2 = size / 2;
+        if(size > ESortNintherThreshold) {
+            mystl::sort3(begin, begin + s2, end - 1, comp);
+            mystl::sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+            mystl::sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+            mystl::sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+            mystl::iter_swap(begin, begin + s2);
+        } else {
+            mystl::sort3(begin + s2, begin, end - 1, comp);
+        }
+
+        // 枢轴与左邻的枢轴相等，说明重复元素很多，把等于枢轴的元素一次划分出去，不再递归
+        if(!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = mystl::partition_left(begin, end, comp) + 1;
+            continue;
+        }
+
+        const mystl::pair<RandomIter, bool> part = mystl::pdq_partition(begin, end, comp, branchless);
+        const RandomIter pivot_pos = part.first;
+        const difference_type l_size = pivot_pos - begin;
+        const difference_type r_size = end - (pivot_pos + 1);
+
+        if(l_size < size / 8 || r_size < size / 8) {
+            // 划分严重失衡：次数过多时改用堆排序，否则打乱两侧的部分元素以破坏造成失衡的模式
+            if(--bad_allowed == 0) {
+                mystl::heap_sort(begin, end, comp);
+                return;
+            }
+            if(l_size >= ESortInsertionThreshold) {
+                mystl::iter_swap(begin, begin + l_size / 4);
+                mystl::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if(l_size > ESortNintherThreshold) {
+                    mystl::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                    mystl::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                    mystl::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    mystl::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if(r_size >= ESortInsertionThreshold) {
+                mystl::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                mystl::iter_swap(end - 1, end - r_size / 4);
+                if(r_size > ESortNintherThreshold) {
+                    mystl::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    mystl::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    mystl::iter_swap(end - 2, end - (1 + r_size / 4));
+                    mystl::iter_swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        } else if(part.second && mystl::partial_insertion_sort(begin, pivot_pos, comp) &&
+                  mystl::partial_insertion_sort(pivot_pos + 1, end, comp)) {
+            // 划分前已经划分好，且两侧都近乎有序，插入排序已完成排序
+            return;
+        }
+
+        // 递归排序左侧，循环处理右侧
+        mystl::pdqsort_loop(begin, pivot_pos, comp, bad_allowed, branchless, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+template<typename RandomIter, typename Compare>
+void pdqsort(RandomIter first, RandomIter last, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    if(last - first < 2)
+        return;
+    int bad_allowed = 1;
+    for(auto n = last - first; n > 1; n >>= 1) {
+        ++bad_allowed;
+    }
+    mystl::pdqsort_loop(first, last, comp, bad_allowed,
+                        is_branchless_compare<Compare, value_type>());
+}
+
+/*****************************************************************************************/
+// LSD 基数排序
+// 键映射为无符号整数，使无符号比较的结果与原比较一致，再从低到高按字节分配
+// 一次遍历统计所有字节的直方图，所有元素在某字节上相同时跳过该趟
+// 元素按字节搬运，要求可平凡重定位（见 type_traits.h）；排序是稳定的
+/*****************************************************************************************/
+template<typename T, typename Enable = void>
+struct radix_traits {
+    static constexpr bool value = false;
+};
+
+// 整数：有符号数翻转符号位
+template<typename T>
+struct radix_traits<T, typename std::enable_if<
+    std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    static constexpr bool value = true;
+    typedef typename std::make_unsigned<T>::type key_type;
+
+    static key_type key(T x) noexcept {
+        return std::is_signed<T>::value
+            ? static_cast<key_type>(static_cast<key_type>(x) ^ (key_type(1) << (sizeof(T) * 8 - 1)))
+            : static_cast<key_type>(x);
+    }
+};
+
+// IEEE 浮点数：负数翻转所有位，非负数翻转符号位；-0.0 视为 +0.0，NaN 的位置不确定
+template<typename T>
+struct radix_traits<T, typename std::enable_if<
+    std::is_floating_point<T>::value && std::numeric_limits<T>::is_iec559 &&
+    (sizeof(T) == 4 || sizeof(T) == 8)>::type> {
+    static constexpr bool value = true;
+    typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type key_type;
+
+    static key_type key(T x) noexcept {
+        if(x == T(0))
+            x = T(0);
+        key_type u;
+        std::memcpy(&u, &x, sizeof(T));
+        const key_type sign = key_type(1) << (sizeof(T) * 8 - 1);
+        return (u & sign) ? static_cast<key_type>(~u) : static_cast<key_type>(u | sign);
+    }
+};
+
+// 由比较操作得到基数排序的键：less / greater 及以它们比较提取出的键
+template<typename Compare, typename T, typename Enable = void>
+struct radix_sort_key {
+    static constexpr bool value = false;
+};
+
+template<typename T>
+struct radix_sort_key<mystl::less<T>, T, typename std::enable_if<radix_traits<T>::value>::type> {
+    static constexpr bool value = true;
+    typedef typename radix_traits<T>::key_type key_type;
+
+    explicit radix_sort_key(const mystl::less<T>&) {}
+    key_type operator()(const T& x) const noexcept { return radix_traits<T>::key(x); }
+};
+
+template<typename T>
+struct radix_sort_key<mystl::greater<T>, T, typename std::enable_if<radix_traits<T>::value>::type> {
+    static constexpr bool value = true;
+    typedef typename radix_traits<T>::key_type key_type;
+
+    explicit radix_sort_key(const mystl::greater<T>&) {}
+    key_type operator()(const T& x) const noexcept {
+        return static_cast<key_type>(~radix_traits<T>::key(x));
+    }
+};
+
+template<typename KeyExtract, typename Compare, typename T>
+struct radix_sort_key<key_compare<KeyExtract, Compare>, T, typename std::enable_if<
+    radix_sort_key<Compare, typename std::decay<decltype(
+        std::declval<const KeyExtract&>()(std::declval<const T&>()))>::type>::value>::type> {
+    typedef typename std::decay<decltype(
+        std::declval<const KeyExtract&>()(std::declval<const T&>()))>::type extracted_type;
+    typedef radix_sort_key<Compare, extracted_type> base_key;
+
+    static constexpr bool value = true;
+    typedef typename base_key::key_type key_type;
+
+    explicit radix_sort_key(const key_compare<KeyExtract, Compare>& c) : key(c.key), base(c.comp) {}
+    key_type operator()(const T& x) const { return base(key(x)); }
+
+    KeyExtract key;
+    base_key base;
+};
+
+// buffer 至少可容纳 last - first 个元素
+template<typename T, typename RadixKey>
+void radix_sort(T* first, T* last, T* buffer, const RadixKey& rkey) {
+    typedef typename RadixKey::key_type key_type;
+    const size_t n = static_cast<size_t>(last - first);
+    size_t count[sizeof(key_type)][256] = {};
+    for(T* p = first; p != last; ++p) {
+        const key_type k = rkey(*p);
+        for(size_t d = 0; d < sizeof(key_type); ++d) {
+            ++count[d][static_cast<unsigned char>(k >> (d * 8))];
+        }
+    }
+
+    T* src = first;
+    T* dst = buffer;
+    const key_type k0 = rkey(*first);
+    for(size_t d = 0; d < sizeof(key_type); ++d) {
+        size_t* c = count[d];
+        if(c[static_cast<unsigned char>(k0 >> (d * 8))] == n)
+            continue;
+        size_t sum = 0;
+        for(size_t b = 0; b < 256; ++b) {
+            const size_t t = c[b];
+            c[b] = sum;
+            sum += t;
+        }
+        for(T* p = src; p != src + n; ++p) {
+            std::memcpy(static_cast<void*>(dst + c[static_cast<unsigned char>(rkey(*p) >> (d * 8))]++),
+                        static_cast<const void*>(p), sizeof(T));
+        }
+        mystl::swap(src, dst);
+    }
+    if(src != first)
+        std::memcpy(static_cast<void*>(first), static_cast<const void*>(src), n * sizeof(T));
+}
+
+// 能够使用基数排序的区间：连续存储、可平凡重定位，比较操作能映射为无符号键
+template<typename T, typename Compare>
+struct use_radix_sort : std::integral_constant<bool,
+    radix_sort_key<Compare, T>::value && is_trivially_relocatable<T>::value> {};
+
+// 成功完成排序时返回 true；元素过少或缓冲区分配失败时返回 false，区间不变
+// 基数排序不能利用输入中已有的顺序，因此先以线性时间处理升序与严格降序的输入
+template<typename T, typename Compare>
+bool try_radix_sort(T* first, T* last, Compare comp, std::true_type) {
+    const size_t n = static_cast<size_t>(last - first);
+    if(n < ERadixSortThreshold)
+        return false;
+    T* cur = first + 1;
+    if(comp(*cur, *first)) {
+        while(++cur != last && comp(*cur, *(cur - 1)));
+        if(cur == last) {
+            mystl::reverse(first, last);
+            return true;
+        }
+    } else {
+        while(++cur != last && !comp(*cur, *(cur - 1)));
+        if(cur == last)
+            return true;
+    }
+    sort_buffer<T> buf(n);
+    if(buf.size() == 0)
+        return false;
+    mystl::radix_sort(first, last, buf.data(), radix_sort_key<Compare, T>(comp));
+    return true;
+}
+
+template<typename Iter, typename Compare>
+bool try_radix_sort(Iter, Iter, Compare, std::false_type) {
+    return false;
+}
+
+template<typename Iter, typename Compare>
+bool try_radix_sort(Iter first, Iter last, Compare comp) {
+    typedef typename iterator_traits<Iter>::value_type value_type;
+    return mystl::try_radix_sort(first, last, comp, std::integral_constant<bool,
+        std::is_pointer<Iter>::value && use_radix_sort<value_type, Compare>::value>());
+}
+
+/*****************************************************************************************/
+// sort
+// 将[first, last)内的元素以 comp 升序排列，不保证相等元素的相对次序
+// 连续存储的可基数排序区间不少于 ERadixSortThreshold 个元素时使用基数排序，否则使用 pdqsort
+/*****************************************************************************************/
+template<typename RandomIter, typename Compare>
+void sort(RandomIter first, RandomIter last, Compare comp) {
+    if(last - first < 2)
+        return;
+    auto ufirst = mystl::unwrap_iter(first);
+    auto ulast = mystl::unwrap_iter(last);
+    if(!mystl::try_radix_sort(ufirst, ulast, comp))
+        mystl::pdqsort(ufirst, ulast, comp);
+}
+
+template<typename RandomIter>
+void sort(RandomIter first, RandomIter last) {
+    mystl::sort(first, last, mystl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// stable_sort
+// 将[first, last)内的元素以 comp 升序排列，相等元素保持原来的相对次序
+// 使用归并排序，临时缓冲区分配失败时改用原地归并；可基数排序的区间与 sort 相同地使用基数排序
+/*****************************************************************************************/
+// 把 [first, middle) 移到缓冲区，再与 [middle, last) 归并回 first
+template<typename RandomIter, typename Pointer, typename Compare>
+void merge_with_buffer(RandomIter first, RandomIter middle, RandomIter last, Pointer buffer, Compare comp) {
+    Pointer buffer_end = mystl::uninitialized_move(first, middle, buffer);
+    Pointer b = buffer;
+    RandomIter out = first;
+    RandomIter r = middle;
+    try {
+        while(b != buffer_end && r != last) {
+            if(comp(*r, *b))
+                *out++ = mystl::move(*r++);
+            else
+                *out++ = mystl::move(*b++);
+        }
+    } catch(...) {
+        // 缓冲区剩余的元素放回空出的位置，区间仍是原区间的一个排列
+        mystl::move(b, buffer_end, out);
+        mystl::destroy(buffer, buffer_end);
+        throw;
+    }
+    mystl::move(b, buffer_end, out);
+    mystl::destroy(buffer, buffer_end);
+}
+
+// 缓冲区至少可容纳 (last - first) / 2 个元素
+template<typename RandomIter, typename Pointer, typename Compare>
+void merge_sort_with_buffer(RandomIter first, RandomIter last, Pointer buffer, Compare comp) {
+    if(last - first <= EStableSortChunk) {
+        mystl::insertion_sort(first, last, comp);
+        return;
+    }
+    RandomIter middle = first + (last - first) / 2;
+    mystl::merge_sort_with_buffer(first, middle, buffer, comp);
+    mystl::merge_sort_with_buffer(middle, last, buffer, comp);
+    if(comp(*middle, *(middle - 1)))
+        mystl::merge_with_buffer(first, middle, last, buffer, comp);
+}
+
+// 没有缓冲区时的原地归并，以二分查找与 rotate 把问题一分为二
+template<typename RandomIter, typename Distance, typename Compare>
+void merge_without_buffer(RandomIter first, RandomIter middle, RandomIter last,
+    Distance len1, Distance len2, Compare comp) {
+    if(len1 == 0 || len2 == 0)
+        return;
+    if(len1 + len2 == 2) {
+        if(comp(*middle, *first))
+            mystl::iter_swap(first, middle);
+        return;
+    }
+    RandomIter first_cut = first;
+    RandomIter second_cut = middle;
+    Distance len11 = 0;
+    Distance len22 = 0;
+    if(len1 > len2) {
+        len11 = len1 / 2;
+        first_cut = first + len11;
+        second_cut = mystl::lower_bound(middle, last, *first_cut, comp);
+        len22 = second_cut - middle;
+    } else {
+        len22 = len2 / 2;
+        second_cut = middle + len22;
+        first_cut = mystl::upper_bound(first, middle, *second_cut, comp);
+        len11 = first_cut - first;
+    }
+    RandomIter new_middle = mystl::rotate(first_cut, middle, second_cut);
+    mystl::merge_without_buffer(first, first_cut, new_middle, len11, len22, comp);
+    mystl::merge_without_buffer(new_middle, second_cut, last, len1 - len11, len2 - len22, comp);
+}
+
+template<typename RandomIter, typename Compare>
+void merge_sort_without_buffer(RandomIter first, RandomIter last, Compare comp) {
+    if(last - first <= EStableSortChunk) {
+        mystl::insertion_sort(first, last, comp);
+        return;
+    }
+    RandomIter middle = first + (last - first) / 2;
+    mystl::merge_sort_without_buffer(first, middle, comp);
+    mystl::merge_sort_without_buffer(middle, last, comp);
+    mystl::merge_without_buffer(first, middle, last, middle - first, last - middle, comp);
+}
+
+template<typename RandomIter, typename Compare>
+void stable_sort(RandomIter first, RandomIter last, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    if(last - first < 2)
+        return;
+    auto ufirst = mystl::unwrap_iter(first);
+    auto ulast = mystl::unwrap_iter(last);
+    if(mystl::try_radix_sort(ufirst, ulast, comp))
+        return;
+    if(ulast - ufirst <= EStableSortChunk) {
+        mystl::insertion_sort(ufirst, ulast, comp);
+        return;
+    }
+    sort_buffer<value_type> buf(static_cast<size_t>(ulast - ufirst) / 2);
+    if(buf.size() != 0)
+        mystl::merge_sort_with_buffer(ufirst, ulast, buf.data(), comp);
+    else
+        mystl::merge_sort_without_buffer(ufirst, ulast, comp);
+}
+
+template<typename RandomIter>
+void stable_sort(RandomIter first, RandomIter last) {
+    mystl::stable_sort(first, last, mystl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// sort_by_key / stable_sort_by_key
+// 以 key(x) 提取的键比较元素，如以 selectfirst、selectsecond 按 pair 的某个成员排序
+// 键为整数或浮点数且以 less / greater 比较时同样可以使用基数排序
+/*****************************************************************************************/
+template<typename RandomIter, typename KeyExtract, typename Compare>
+void sort_by_key(RandomIter first, RandomIter last, KeyExtract key, Compare comp) {
+    mystl::sort(first, last, key_compare<KeyExtract, Compare>(key, comp));
+}
+
+template<typename RandomIter, typename KeyExtract>
+void sort_by_key(RandomIter first, RandomIter last, KeyExtract key) {
+    typedef typename std::decay<decltype(key(*first))>::type key_type;
+    mystl::sort_by_key(first, last, key, mystl::less<key_type>());
+}
+
+template<typename RandomIter, typename KeyExtract, typename Compare>
+void stable_sort_by_key(RandomIter first, RandomIter last, KeyExtract key, Compare comp) {
+    mystl::stable_sort(first, last, key_compare<KeyExtract, Compare>(key, comp));
+}
+
+template<typename RandomIter, typename KeyExtract>
+void stable_sort_by_key(RandomIter first, RandomIter last, KeyExtract key) {
+    typedef typename std::decay<decltype(key(*first))>::type key_type;
+    mystl::stable_sort_by_key(first, last, key, mystl::less<key_type>());
+}
+
+} // namespace mystl
+
+#endif // MY_TINY_ALGO_H_
@@ -1,15 +1,197 @@
-#ifndef MY_TINY_STL_H_
-#define MY_TINY_STL_H_
+#ifndef MY_TINY_ALGOBASE_H_
+#define MY_TINY_ALGOBASE_H_
 
 // 该文件包含了 mystl 的基本算法
+// 连续迭代器（见 iterator.h 的 contiguous_iterator_tag）先解包为原生指针，再使用 memmove 或 SIMD 版本
+// 连续存储的算术类型区间上的 fill、equal、mismatch、lexicographical_compare、count、find
+// 使用 SSE2 / AVX2 向量化实现，编译时按 __AVX2__、__SSE2__ 选择，定义 MYSTL_NO_SIMD 可以关闭
 
 #include <cstring>
+#include <cstdint>
 
 #include "iterator.h"
 #include "util.h"
 
+#if !defined(MYSTL_NO_SIMD) && (defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MYSTL_SIMD 1
+#ifdef __AVX2__
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif // __AVX2__
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+#endif
+
 namespace mystl {
 
+/*************************************************************************/
+// SIMD 内核
+// 以字节为单位比较两个向量，得到每个字节是否相等的掩码，再按元素宽度归约
+// 只用于整数类型（逐位相等即值相等）与 fill 的按位写入
+/*************************************************************************/
+#ifdef MYSTL_SIMD
+
+#ifdef __AVX2__
+typedef __m256i simd_vec;
+enum { ESimdBytes = 32 };
+
+inline simd_vec simd_load(const void* p) {
+    return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+}
+inline void simd_store(void* p, simd_vec v) {
+    _mm256_storeu_si256(static_cast<__m256i*>(p), v);
+}
+inline uint32_t simd_eq_mask(simd_vec a, simd_vec b) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+}
+const uint32_t simd_full_mask = 0xFFFFFFFFu;
+#else
+typedef __m128i simd_vec;
+enum { ESimdBytes = 16 };
+
+inline simd_vec simd_load(const void* p) {
+    return _mm_loadu_si128(static_cast<const __m128i*>(p));
+}
+inline void simd_store(void* p, simd_vec v) {
+    _mm_storeu_si128(static_cast<__m128i*>(p), v);
+}
+inline uint32_t simd_eq_mask(simd_vec a, simd_vec b) {
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+}
+const uint32_t simd_full_mask = 0xFFFFu;
+#endif // __AVX2__
+
+// 最低位的 1 的位置，m 不能为 0
+inline unsigned simd_ctz(uint32_t m) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, m);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(m));
+#endif // _MSC_VER
+}
+
+// 没有 popcnt 指令时以位运算计算，避免调用库函数
+inline unsigned simd_popcount(uint32_t m) {
+#if defined(__POPCNT__) && !defined(_MSC_VER)
+    return static_cast<unsigned>(__builtin_popcount(m));
+#else
+    m = m - ((m >> 1) & 0x55555555u);
+    m = (m & 0x33333333u) + ((m >> 2) & 0x33333333u);
+    m = (m + (m >> 4)) & 0x0F0F0F0Fu;
+    return static_cast<unsigned>((m * 0x01010101u) >> 24);
+#endif
+}
+
+// 把每个字节的掩码归约为每个 Size 字节元素的掩码：元素的所有字节都相等时，元素首字节对应的位为 1
+template<size_t Size>
+inline uint32_t simd_elem_mask(uint32_t m) {
+    if(Size >= 2) m &= m >> 1;
+    if(Size >= 4) m &= m >> 2;
+    if(Size >= 8) m &= m >> 4;
+    return Size == 1 ? m : Size == 2 ? (m & 0x55555555u) : Size == 4 ? (m & 0x11111111u) : (m & 0x01010101u);
+}
+
+// 用 value 的字节重复填满一个向量
+template<typename T>
+inline simd_vec simd_broadcast(const T& value) {
+    unsigned char buf[ESimdBytes];
+    for(size_t i = 0; i < static_cast<size_t>(ESimdBytes); i += sizeof(T)) {
+        std::memcpy(buf + i, &value, sizeof(T));
+    }
+    return simd_load(buf);
+}
+
+#endif // MYSTL_SIMD
+
+// 返回 [a, a + n) 与 [b, b + n) 第一个不相等的元素下标，全部相等时返回 n
+template<typename T>
+size_t simd_mismatch(const T* a, const T* b, size_t n) {
+    size_t i = 0;
+#ifdef MYSTL_SIMD
+    const size_t step = ESimdBytes / sizeof(T);
+    for(; i + step <= n; i += step) {
+        const uint32_t m = simd_eq_mask(simd_load(a + i), simd_load(b + i));
+        if(m != simd_full_mask)
+            return i + simd_ctz(~m) / sizeof(T);
+    }
+#endif // MYSTL_SIMD
+    for(; i < n; ++i) {
+        if(a[i] != b[i])
+            return i;
+    }
+    return n;
+}
+
+// 返回 [p, p + n) 中第一个等于 value 的元素下标，没有时返回 n
+template<typename T>
+size_t simd_find(const T* p, size_t n, T value) {
+    size_t i = 0;
+#ifdef MYSTL_SIMD
+    const size_t step = ESimdBytes / sizeof(T);
+    const simd_vec v = simd_broadcast(value);
+    for(; i + step <= n; i += step) {
+        const uint32_t m = simd_elem_mask<sizeof(T)>(simd_eq_mask(simd_load(p + i), v));
+        if(m != 0)
+            return i + simd_ctz(m) / sizeof(T);
+    }
+#endif // MYSTL_SIMD
+    for(; i < n; ++i) {
+        if(p[i] == value)
+            return i;
+    }
+    return n;
+}
+
+// 返回 [p, p + n) 中等于 value 的元素个数
+template<typename T>
+size_t simd_count(const T* p, size_t n, T value) {
+    size_t i = 0, result = 0;
+#ifdef MYSTL_SIMD
+    const size_t step = ESimdBytes / sizeof(T);
+    const simd_vec v = simd_broadcast(value);
+    for(; i + step <= n; i += step) {
+        result += simd_popcount(simd_elem_mask<sizeof(T)>(simd_eq_mask(simd_load(p + i), v)));
+    }
+#endif // MYSTL_SIMD
+    for(; i < n; ++i) {
+        if(p[i] == value)
+            ++result;
+    }
+    return result;
+}
+
+// 把 [p, p + n) 全部写为 value
+template<typename T>
+void simd_fill(T* p, size_t n, T value) {
+    size_t i = 0;
+#ifdef MYSTL_SIMD
+    const size_t step = ESimdBytes / sizeof(T);
+    const simd_vec v = simd_broadcast(value);
+    for(; i + step <= n; i += step) {
+        simd_store(p + i, v);
+    }
+#endif // MYSTL_SIMD
+    for(; i < n; ++i) {
+        p[i] = value;
+    }
+}
+
+// 可以使用 SIMD 内核比较的类型：整数（包括字符）与枚举，宽度为 1、2、4、8 字节
+template<typename T>
+struct simd_comparable : public m_bool_constant<
+    (std::is_integral<T>::value || std::is_enum<T>::value) && !std::is_same<T, bool>::value &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)> {};
+
+// 可以使用 SIMD 内核按位填充的类型：算术类型，宽度为 2、4、8 字节
+template<typename T>
+struct simd_fillable : public m_bool_constant<
+    std::is_arithmetic<T>::value && (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)> {};
+
 #ifdef max
 #pragma message("#undefing macro max")
 #undef max
@@ -41,7 +223,7 @@ const T& max(const T& lhs, const T& rhs, Compare compare) {
 /************************************************************************/
 template<typename T>
 const T& min(const T& lhs, const T& rhs) {
-    return rhs < lsh ? rhs : lhs;
+    return rhs < lhs ? rhs : lhs;
 };
 
 // 重载版本使用函数对象 comp 代替比较操作
@@ -99,9 +281,11 @@ unchecked_copy(Tp* first, Tp* last, Up* result) {
     return result + n;
 };
 
+// 连续迭代器先解包为原生指针
 template<typename InputIter, typename OutputIter>
 OutputIter copy(InputIter first, InputIter last, OutputIter result) {
-    return unchecked_copy(first, last, result);
+    return mystl::rewrap_iter(result, unchecked_copy(mystl::unwrap_iter(first),
+        mystl::unwrap_iter(last), mystl::unwrap_iter(result)));
 };
 
 /*********************************************************************/
@@ -123,7 +307,7 @@ template<typename RandomIter1, typename BidirectionalIter2>
 BidirectionalIter2 unchecked_copy_backward_cat(RandomIter1 first, RandomIter1 last,
     BidirectionalIter2 result, mystl::random_access_iterator_tag) {
     for(auto n = last - first; n > 0; --n) {
-        *--result == *--last;
+        *--result = *--last;
     }
     return result;
 }
@@ -152,9 +336,407 @@ unchecked_copy_backward(Tp* first, Tp* last, Up* result) {
 template<typename BidirectionalIter1, typename BidirectionalIter2>
 BidirectionalIter2 copy_backward(BidirectionalIter1 first, BidirectionalIter1 last, 
     BidirectionalIter2 result) {
-    return unchecked_copy_backward(first, last, result);
+    return mystl::rewrap_iter(result, unchecked_copy_backward(mystl::unwrap_iter(first),
+        mystl::unwrap_iter(last), mystl::unwrap_iter(result)));
+}
+
+// 原生指针的 reverse_iterator 之间的拷贝，即底层指针区间的反向拷贝，
+// copy 与 copy_backward 互相转换后可以使用 memmove
+template<typename Tp, typename Up>
+mystl::reverse_iterator<Up*> copy(mystl::reverse_iterator<Tp*> first, mystl::reverse_iterator<Tp*> last,
+    mystl::reverse_iterator<Up*> result) {
+    return mystl::reverse_iterator<Up*>(mystl::copy_backward(last.base(), first.base(), result.base()));
+}
+
+template<typename Tp, typename Up>
+mystl::reverse_iterator<Up*> copy_backward(mystl::reverse_iterator<Tp*> first, mystl::reverse_iterator<Tp*> last,
+    mystl::reverse_iterator<Up*> result) {
+    return mystl::reverse_iterator<Up*>(mystl::copy(last.base(), first.base(), result.base()));
+}
+
+/*********************************************************************/
+// move
+// 把 [first, last)区间内的元素移动到 [result, result + (last - first))内
+/*********************************************************************/
+// input_iterator_tag 版本
+template<typename InputIter, typename OutputIter>
+OutputIter unchecked_move_cat(InputIter first, InputIter last, OutputIter result, mystl::input_iterator_tag) {
+    for(; first != last; ++first, ++result) {
+        *result = mystl::move(*first);
+    }
+    return result;
+}
+
+// random_access_iterator_tag 版本
+template<typename RandomIter, typename OutputIter>
+OutputIter unchecked_move_cat(RandomIter first, RandomIter last, OutputIter result, mystl::random_access_iterator_tag) {
+    for(auto n = last - first; n > 0; --n, ++first, ++result) {
+        *result = mystl::move(*first);
+    }
+    return result;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter unchecked_move(InputIter first, InputIter last, OutputIter result) {
+    return unchecked_move_cat(first, last, result, iterator_category(first));
+}
+
+// 为 trivially_move_assignable 类型提供特化版本
+template<typename Tp, typename Up>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+    std::is_trivially_move_assignable<Up>::value,
+    Up*>::type
+unchecked_move(Tp* first, Tp* last, Up* result) {
+    const auto n = static_cast<size_t>(last - first);
+    if(n != 0)
+        std::memmove(result, first, n * sizeof(Up));
+    return result + n;
+}
+
+template<typename InputIter, typename OutputIter>
+OutputIter move(InputIter first, InputIter last, OutputIter result) {
+    return mystl::rewrap_iter(result, unchecked_move(mystl::unwrap_iter(first),
+        mystl::unwrap_iter(last), mystl::unwrap_iter(result)));
+}
+
+/*********************************************************************/
+// move_backward
+// 将[first, last)区间内的元素移动到[result - (last - first), result)内
+/*********************************************************************/
+// bidirectional_iterator_tag 版本
+template<typename BidirectionalIter1, typename BidirectionalIter2>
+BidirectionalIter2 unchecked_move_backward_cat(BidirectionalIter1 first, BidirectionalIter1 last,
+    BidirectionalIter2 result, mystl::bidirectional_iterator_tag) {
+    while(first != last) {
+        *--result = mystl::move(*--last);
+    }
+    return result;
+}
+
+// random_access_iterator_tag 版本
+template<typename RandomIter1, typename BidirectionalIter2>
+BidirectionalIter2 unchecked_move_backward_cat(RandomIter1 first, RandomIter1 last,
+    BidirectionalIter2 result, mystl::random_access_iterator_tag) {
+    for(auto n = last - first; n > 0; --n) {
+        *--result = mystl::move(*--last);
+    }
+    return result;
+}
+
+template<typename BidirectionalIter1, typename BidirectionalIter2>
+BidirectionalIter2 unchecked_move_backward(BidirectionalIter1 first, BidirectionalIter1 last,
+    BidirectionalIter2 result) {
+    return unchecked_move_backward_cat(first, last, result, iterator_category(first));
+}
+
+// 为 trivially_move_assignable 类型提供特化版本
+template<typename Tp, typename Up>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+    std::is_trivially_move_assignable<Up>::value,
+    Up*>::type
+unchecked_move_backward(Tp* first, Tp* last, Up* result) {
+    const auto n = static_cast<size_t>(last - first);
+    if(n != 0) {
+        result -= n;
+        std::memmove(result, first, n * sizeof(Up));
+    }
+    return result;
+}
+
+template<typename BidirectionalIter1, typename BidirectionalIter2>
+BidirectionalIter2 move_backward(BidirectionalIter1 first, BidirectionalIter1 last,
+    BidirectionalIter2 result) {
+    return mystl::rewrap_iter(result, unchecked_move_backward(mystl::unwrap_iter(first),
+        mystl::unwrap_iter(last), mystl::unwrap_iter(result)));
+}
+
+// 原生指针的 reverse_iterator 之间的移动，转换为底层指针区间的反向移动
+template<typename Tp, typename Up>
+mystl::reverse_iterator<Up*> move(mystl::reverse_iterator<Tp*> first, mystl::reverse_iterator<Tp*> last,
+    mystl::reverse_iterator<Up*> result) {
+    return mystl::reverse_iterator<Up*>(mystl::move_backward(last.base(), first.base(), result.base()));
+}
+
+template<typename Tp, typename Up>
+mystl::reverse_iterator<Up*> move_backward(mystl::reverse_iterator<Tp*> first, mystl::reverse_iterator<Tp*> last,
+    mystl::reverse_iterator<Up*> result) {
+    return mystl::reverse_iterator<Up*>(mystl::move(last.base(), first.base(), result.base()));
+}
+
+/*********************************************************************/
+// equal
+// 比较第一序列在 [first, last)区间上的元素值是否和第二序列相等
+/*********************************************************************/
+template<typename InputIter1, typename InputIter2>
+bool unchecked_equal(InputIter1 first1, InputIter1 last1, InputIter2 first2) {
+    for(; first1 != last1; ++first1, ++first2) {
+        if(!(*first1 == *first2))
+            return false;
+    }
+    return true;
+}
+
+// 为整数类型提供特化版本
+template<typename Tp, typename Up>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<Tp>::type, typename std::remove_const<Up>::type>::value &&
+    simd_comparable<typename std::remove_const<Tp>::type>::value,
+    bool>::type
+unchecked_equal(Tp* first1, Tp* last1, Up* first2) {
+    const auto n = static_cast<size_t>(last1 - first1);
+    return n == 0 || std::memcmp(first1, first2, n * sizeof(Tp)) == 0;
+}
+
+template<typename InputIter1, typename InputIter2>
+bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2) {
+    return unchecked_equal(mystl::unwrap_iter(first1), mystl::unwrap_iter(last1), mystl::unwrap_iter(first2));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template<typename InputIter1, typename InputIter2, typename Compare>
+bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2, Compare comp) {
+    for(; first1 != last1; ++first1, ++first2) {
+        if(!comp(*first1, *first2))
+            return false;
+    }
+    return true;
+}
+
+/*********************************************************************/
+// mismatch
+// 平行比较两个序列，找到第一处失配的元素，返回一对迭代器，分别指向两个序列中失配的元素
+/*********************************************************************/
+template<typename InputIter1, typename InputIter2>
+mystl::pair<InputIter1, InputIter2>
+unchecked_mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2) {
+    while(first1 != last1 && *first1 == *first2) {
+        ++first1;
+        ++first2;
+    }
+    return mystl::pair<InputIter1, InputIter2>(first1, first2);
+}
+
+// 为整数类型提供特化版本
+template<typename Tp, typename Up>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<Tp>::type, typename std::remove_const<Up>::type>::value &&
+    simd_comparable<typename std::remove_const<Tp>::type>::value,
+    mystl::pair<Tp*, Up*>>::type
+unchecked_mismatch(Tp* first1, Tp* last1, Up* first2) {
+    const size_t i = mystl::simd_mismatch(first1, first2, static_cast<size_t>(last1 - first1));
+    return mystl::pair<Tp*, Up*>(first1 + i, first2 + i);
+}
+
+template<typename InputIter1, typename InputIter2>
+mystl::pair<InputIter1, InputIter2>
+mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2) {
+    auto r = unchecked_mismatch(mystl::unwrap_iter(first1), mystl::unwrap_iter(last1), mystl::unwrap_iter(first2));
+    return mystl::pair<InputIter1, InputIter2>(mystl::rewrap_iter(first1, r.first),
+                                               mystl::rewrap_iter(first2, r.second));
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template<typename InputIter1, typename InputIter2, typename Compare>
+mystl::pair<InputIter1, InputIter2>
+mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, Compare comp) {
+    while(first1 != last1 && comp(*first1, *first2)) {
+        ++first1;
+        ++first2;
+    }
+    return mystl::pair<InputIter1, InputIter2>(first1, first2);
+}
+
+/*********************************************************************/
+// count
+// 对 [first, last)区间内的元素与给定值进行比较，返回相等元素的个数
+/*********************************************************************/
+template<typename InputIter, typename T>
+size_t unchecked_count(InputIter first, InputIter last, const T& value) {
+    size_t n = 0;
+    for(; first != last; ++first) {
+        if(*first == value)
+            ++n;
+    }
+    return n;
+}
+
+// 为整数类型提供特化版本，value 的类型须与元素类型相同
+template<typename Tp, typename Up>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+    simd_comparable<Up>::value,
+    size_t>::type
+unchecked_count(Tp* first, Tp* last, const Up& value) {
+    return mystl::simd_count(first, static_cast<size_t>(last - first), value);
+}
+
+template<typename InputIter, typename T>
+size_t count(InputIter first, InputIter last, const T& value) {
+    return unchecked_count(mystl::unwrap_iter(first), mystl::unwrap_iter(last), value);
+}
+
+/*********************************************************************/
+// find
+// 在 [first, last)区间内找到第一个等于 value 的元素，返回指向该元素的迭代器
+/*********************************************************************/
+template<typename InputIter, typename T>
+InputIter unchecked_find(InputIter first, InputIter last, const T& value) {
+    while(first != last && !(*first == value)) {
+        ++first;
+    }
+    return first;
+}
+
+// 为整数类型提供特化版本，value 的类型须与元素类型相同，单字节类型使用 memchr
+template<typename Tp, typename Up>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+    simd_comparable<Up>::value,
+    Tp*>::type
+unchecked_find(Tp* first, Tp* last, const Up& value) {
+    if(sizeof(Up) == 1) {
+        if(first == last)
+            return last;
+        const void* p = std::memchr(first, *reinterpret_cast<const unsigned char*>(&value),
+                                    static_cast<size_t>(last - first));
+        return p == nullptr ? last : static_cast<Tp*>(const_cast<void*>(p));
+    }
+    return first + mystl::simd_find(first, static_cast<size_t>(last - first), value);
+}
+
+template<typename InputIter, typename T>
+InputIter find(InputIter first, InputIter last, const T& value) {
+    return mystl::rewrap_iter(first, unchecked_find(mystl::unwrap_iter(first), mystl::unwrap_iter(last), value));
+}
+
+/*********************************************************************/
+// fill_n
+// 从 first 位置开始填充 n 个值
+/*********************************************************************/
+template<typename OutputIter, typename Size, typename T>
+OutputIter unchecked_fill_n(OutputIter first, Size n, const T& value) {
+    for(; n > 0; --n, ++first) {
+        *first = value;
+    }
+    return first;
+}
+
+// 为 one-byte 类型提供特化版本
+template<typename Tp, typename Size, typename Up>
+typename std::enable_if<
+    std::is_integral<Tp>::value && sizeof(Tp) == 1 &&
+    !std::is_same<Tp, bool>::value &&
+    std::is_integral<Up>::value && sizeof(Up) == 1,
+    Tp*>::type
+unchecked_fill_n(Tp* first, Size n, Up value) {
+    if(n > 0) {
+        std::memset(first, (unsigned char)value, (size_t)(n));
+    }
+    return first + n;
+}
+
+// 为 2、4、8 字节的算术类型提供特化版本，先把 value 转换为元素类型，再按位写入
+template<typename Tp, typename Size, typename Up>
+typename std::enable_if<
+    simd_fillable<Tp>::value && std::is_arithmetic<Up>::value,
+    Tp*>::type
+unchecked_fill_n(Tp* first, Size n, Up value) {
+    if(n > 0) {
+        mystl::simd_fill(first, static_cast<size_t>(n), static_cast<Tp>(value));
+        return first + n;
+    }
+    return first;
+}
+
+template<typename OutputIter, typename Size, typename T>
+OutputIter fill_n(OutputIter first, Size n, const T& value) {
+    return mystl::rewrap_iter(first, unchecked_fill_n(mystl::unwrap_iter(first), n, value));
+}
+
+/*********************************************************************/
+// fill
+// 为 [first, last)区间内的所有元素填充新值
+/*********************************************************************/
+template<typename ForwardIter, typename T>
+void fill_cat(ForwardIter first, ForwardIter last, const T& value, mystl::forward_iterator_tag) {
+    for(; first != last; ++first) {
+        *first = value;
+    }
+}
+
+template<typename RandomIter, typename T>
+void fill_cat(RandomIter first, RandomIter last, const T& value, mystl::random_access_iterator_tag) {
+    unchecked_fill_n(first, last - first, value);
+}
+
+template<typename ForwardIter, typename T>
+void fill(ForwardIter first, ForwardIter last, const T& value) {
+    fill_cat(mystl::unwrap_iter(first), mystl::unwrap_iter(last), value, iterator_category(first));
+}
+
+/*********************************************************************/
+// lexicographical_compare
+// 以字典序排列对两个序列进行比较，当在某个位置发现第一组不相等元素时，有下列几种情况：
+// (1)如果第一序列的元素较小，返回 true ，否则返回 false
+// (2)如果到达 last1 而尚未到达 last2 返回 true
+// (3)如果到达 last2 而尚未到达 last1 返回 false
+// (4)如果同时到达 last1 和 last2 返回 false
+/*********************************************************************/
+template<typename InputIter1, typename InputIter2>
+bool unchecked_lexicographical_compare(InputIter1 first1, InputIter1 last1,
+    InputIter2 first2, InputIter2 last2) {
+    for(; first1 != last1 && first2 != last2; ++first1, ++first2) {
+        if(*first1 < *first2)
+            return true;
+        if(*first2 < *first1)
+            return false;
+    }
+    return first1 == last1 && first2 != last2;
+}
+
+// 重载版本使用函数对象 comp 代替比较操作
+template<typename InputIter1, typename InputIter2, typename Compare>
+bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
+    InputIter2 first2, InputIter2 last2, Compare comp) {
+    for(; first1 != last1 && first2 != last2; ++first1, ++first2) {
+        if(comp(*first1, *first2))
+            return true;
+        if(comp(*first2, *first1))
+            return false;
+    }
+    return first1 == last1 && first2 != last2;
+}
+
+// 为整数类型提供特化版本：unsigned char 直接使用 memcmp，
+// 其它类型先找到第一处失配，再比较失配的元素
+template<typename Tp, typename Up>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<Tp>::type, typename std::remove_const<Up>::type>::value &&
+    simd_comparable<typename std::remove_const<Tp>::type>::value,
+    bool>::type
+unchecked_lexicographical_compare(Tp* first1, Tp* last1, Up* first2, Up* last2) {
+    const auto len1 = static_cast<size_t>(last1 - first1);
+    const auto len2 = static_cast<size_t>(last2 - first2);
+    // 先比较相同长度的部分
+    const size_t n = len1 < len2 ? len1 : len2;
+    if(std::is_same<typename std::remove_const<Tp>::type, unsigned char>::value) {
+        const int result = n != 0 ? std::memcmp(first1, first2, n) : 0;
+        // 若相等，长度较长的比较大
+        return result != 0 ? result < 0 : len1 < len2;
+    }
+    const size_t i = mystl::simd_mismatch(first1, first2, n);
+    return i != n ? first1[i] < first2[i] : len1 < len2;
+}
+
+template<typename InputIter1, typename InputIter2>
+bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
+    InputIter2 first2, InputIter2 last2) {
+    return unchecked_lexicographical_compare(mystl::unwrap_iter(first1), mystl::unwrap_iter(last1),
+                                             mystl::unwrap_iter(first2), mystl::unwrap_iter(last2));
 }
 
 }
 
-#endif // MY_TINY_STL_H_
\ No newline at end of file
+#endif // MY_TINY_ALGOBASE_H_
\ No newline at end of file
@@ -1,14 +1,49 @@
-#ifndef MY_TINY_STL_H_
-#define MY_TINY_STL_H_
+#ifndef MY_TINY_ALLOC_H_
+#define MY_TINY_ALLOC_H_
 
 // 头文件包含一个类 alloc，用于分配和回收内存，以内存池的方式实现
-// 此文件已弃用，暂时保留
+// allocator 以 pool_policy 为分配策略时，小内存经由此内存池分配
 #include <new>
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
 
-namespace mystl { 
+#if defined(__GLIBC__) || defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// 定义 MYSTL_ALLOC_STATS 以开启内存池的统计计数，未定义时计数代码不参与编译
+// 线程缓存等内部结构的布局随之改变，同一程序中的所有翻译单元必须取相同的设置；
+// 每个包含本文件的翻译单元在静态初始化时登记自己的设置，不一致时打印错误并 abort
+#ifdef MYSTL_ALLOC_STATS
+#define MYSTL_ALLOC_STAT(stmt) stmt
+#define MYSTL_ALLOC_STATS_ENABLED true
+#else
+#define MYSTL_ALLOC_STAT(stmt)
+#define MYSTL_ALLOC_STATS_ENABLED false
+#endif // MYSTL_ALLOC_STATS
+
+// 定义 MYSTL_ALLOC_FIXED_BATCH 为正整数时，线程缓存与中心自由链表之间每次搬运固定的区块数
+// （仍不超过 M_transfer_number），不再按需求倍增与减半；用于与自适应的批量对比，
+// 不改变数据布局，但同一程序中的翻译单元应取相同的设置
+
+// 内存池 chunk 的默认来源，可在包含本文件前定义为 EChunkSource 中的任一值
+#ifndef MYSTL_ALLOC_CHUNK_SOURCE
+#define MYSTL_ALLOC_CHUNK_SOURCE EChunkMalloc
+#endif // MYSTL_ALLOC_CHUNK_SOURCE
+
+namespace mystl {
     // 共用体：FreeList
     // 采用链表的方式进行管理内存的方式，分配与回收小内存（<=4k)区块
     union FreeList {
@@ -32,78 +67,451 @@ namespace mystl {
     // free lists 个数
     enum { EFreeListsNumber = 56 };
 
+    // 线程缓存与中心自由链表之间一次搬运的字节数上限，以及搬运区块数的上下限
+    // 每个线程的每个 free list 各自调整搬运的区块数：持续需要时倍增，需求停止时减半
+    enum { ETransferBytes = 16384 };
+    enum { ETransferMinBlocks = 2, ETransferMaxBlocks = 512 };
+
+    // 内存池向系统申请 chunk 的方式
+    // 非 Linux 平台上 EChunkMmap、EChunkHugeTLB 均退回 EChunkMalloc
+    enum EChunkSource {
+        EChunkMalloc,       // std::malloc
+        EChunkMmap,         // 匿名 mmap，按 2 MiB 对齐，并以 MADV_HUGEPAGE 建议内核使用透明大页
+        EChunkHugeTLB       // 以 MAP_HUGETLB 映射显式大页，系统没有预留大页时退回 EChunkMmap
+    };
+
+    // 大页的大小，mmap 得到的 chunk 以此为粒度
+    enum { EHugePageBytes = 2 * 1024 * 1024 };
+
+    // 结构体：ChunkHeader
+    // 位于内存池向系统申请的每一块 chunk 的头部，把所有 chunk 串成链表，以便追踪与归还
+    struct ChunkHeader {
+        ChunkHeader* next;      // 下一块 chunk
+        size_t size;            // 整块 chunk 的大小，包括头部
+        EChunkSource source;    // chunk 的实际来源，决定归还的方式
+    };
+
+    // chunk 头部占用的大小，保证其后的区块按 8 bytes 对齐
+    enum { EChunkHeaderBytes = (sizeof(ChunkHeader) + EAlign128 - 1) & ~(EAlign128 - 1) };
+
+    // 申请按 alignment 对齐的 bytes 大小的空间，alignment 必须是 2 的幂
+    // 失败时返回 nullptr，以 aligned_free 释放
+    inline void* aligned_malloc(size_t bytes, size_t alignment) {
+        if(alignment < sizeof(void*))
+            alignment = sizeof(void*);
+#ifdef _MSC_VER
+        return _aligned_malloc(bytes, alignment);
+#else
+        void* p = nullptr;
+        return posix_memalign(&p, alignment, bytes) == 0 ? p : nullptr;
+#endif // _MSC_VER
+    }
+
+    inline void aligned_free(void* p) {
+#ifdef _MSC_VER
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif // _MSC_VER
+    }
+
+    // 结构体：alloc_size_class_stats
+    // 一个 free list 的统计快照
+    struct alloc_size_class_stats {
+        size_t block_size;          // 区块大小
+        size_t allocs;              // 分配次数
+        size_t frees;               // 回收次数
+        size_t requested_bytes;     // 调用者申请的字节数之和，与 allocs * block_size 之差即上调造成的内部碎片
+        size_t fetches;             // 线程缓存为空，向中心自由链表取区块的次数
+        size_t releases;            // 线程缓存过满，向中心自由链表归还区块的次数
+        size_t refills;             // M_refill 的次数
+        size_t central_blocks;      // 中心自由链表上的区块数
+        size_t cached_blocks;       // 各线程缓存中的区块数
+    };
+
+    // 结构体：alloc_stats
+    // 内存池的统计快照，由 alloc::stats() 取得
+    struct alloc_stats {
+        bool enabled;               // 是否以 MYSTL_ALLOC_STATS 编译，否则计数项均为 0
+        size_t heap_bytes;          // 内存池持有的 chunk 总字节数
+        size_t chunk_count;         // 内存池持有的 chunk 个数
+        size_t chunk_allocs;        // M_chunk_alloc 向系统申请 chunk 的次数
+        size_t pool_free_bytes;     // 内存池中尚未切分的字节数
+        size_t trims;               // trim 的次数
+        size_t trimmed_bytes;       // trim 归还系统的字节数
+        size_t large_allocs;        // 超过 4096 bytes，直接调用 std::malloc 的次数
+        size_t large_frees;         // 超过 4096 bytes，直接调用 std::free 的次数
+        size_t large_alloc_bytes;   // std::malloc 申请的字节数之和
+        size_t large_free_bytes;    // std::free 释放的字节数之和
+        alloc_size_class_stats size_class[EFreeListsNumber];
+    };
+
+    // 模板类：alloc_state
+    // 内存池的全局状态。以类模板的静态成员定义，可以放在头文件中，
+    // 多个翻译单元包含本头文件时链接为同一份；alloc 以之为基类，成员函数中直接使用这些名字
+    template<int Inst>
+    struct alloc_state {
+        static char* start_free;    // 内存池起始位置
+        static char* end_free;      // 内存池结束位置
+        static size_t heap_size;    // 申请 heap 空间附加值大小
+
+        static FreeList* free_list[EFreeListsNumber];   // 中心自由链表
+        static ChunkHeader* chunk_list;                 // 内存池持有的所有 chunk
+        static EChunkSource source;                     // 之后申请 chunk 的方式
+
+        static std::mutex pool_mutex;                       // 保护 start_free，end_free，heap_size，chunk_list
+        static std::mutex list_mutex[EFreeListsNumber];     // 保护对应的中心自由链表
+
+        static std::atomic<int> stats_mode;     // 各翻译单元登记的 MYSTL_ALLOC_STATS 设置，0 表示尚未登记
+
+#ifdef MYSTL_ALLOC_STATS
+        static size_t central_length[EFreeListsNumber];  // 中心自由链表的区块数，由 list_mutex 保护
+        static size_t class_blocks[EFreeListsNumber];    // 切分给各 free list 的区块数，由 pool_mutex 保护
+        static size_t chunk_allocs;                      // 由 pool_mutex 保护
+        static size_t trims;                             // 由 pool_mutex 保护
+        static size_t trimmed_bytes;                     // 由 pool_mutex 保护
+#endif // MYSTL_ALLOC_STATS
+    };
+
+    template<int Inst> char* alloc_state<Inst>::start_free = nullptr;
+    template<int Inst> char* alloc_state<Inst>::end_free = nullptr;
+    template<int Inst> size_t alloc_state<Inst>::heap_size = 0;
+
+    template<int Inst> FreeList* alloc_state<Inst>::free_list[EFreeListsNumber] = {};
+    template<int Inst> ChunkHeader* alloc_state<Inst>::chunk_list = nullptr;
+    template<int Inst> EChunkSource alloc_state<Inst>::source = MYSTL_ALLOC_CHUNK_SOURCE;
+
+    template<int Inst> std::mutex alloc_state<Inst>::pool_mutex;
+    template<int Inst> std::mutex alloc_state<Inst>::list_mutex[EFreeListsNumber];
+
+    template<int Inst> std::atomic<int> alloc_state<Inst>::stats_mode(0);
+
+#ifdef MYSTL_ALLOC_STATS
+    template<int Inst> size_t alloc_state<Inst>::central_length[EFreeListsNumber] = {};
+    template<int Inst> size_t alloc_state<Inst>::class_blocks[EFreeListsNumber] = {};
+    template<int Inst> size_t alloc_state<Inst>::chunk_allocs = 0;
+    template<int Inst> size_t alloc_state<Inst>::trims = 0;
+    template<int Inst> size_t alloc_state<Inst>::trimmed_bytes = 0;
+#endif // MYSTL_ALLOC_STATS
+
     // 空间配置类 alloc
     // 如果内存较大，超过 4096 bytes，直接调用 std::malloc，std::free
     // 当内存较小时，以内存池管理，每次配置一大块内存，并维护对应的自由链表
-    class alloc {
+    // 区块按自身大小的自然对齐切分（大小的最低位 1 所代表的 2 的幂），
+    // 例如 64 bytes 的区块按 64 对齐，4096 bytes 的区块按页对齐
+    // 每个线程持有一份线程缓存，小内存的分配与回收只操作线程缓存，不需要加锁；
+    // 线程缓存为空或过满时，才加锁与中心自由链表成批交换区块
+    class alloc : private alloc_state<0> {
     public:
         static void* allocate(size_t n);
         static void deallocate(void* p, size_t n);
+        static void* allocate_aligned(size_t n, size_t alignment);
+        static void deallocate_aligned(void* p, size_t n, size_t alignment);
         static void* reallocate(void* p, size_t old_size, size_t new_size);
+        static bool try_expand_in_place(void* p, size_t old_size, size_t new_size);
+
+        static void flush_thread_cache();
+        static size_t trim();
+        static void start_background_trim(std::chrono::milliseconds interval);
+        static void stop_background_trim();
+
+        static void set_chunk_source(EChunkSource source);
+        static EChunkSource chunk_source();
+
+        static alloc_stats stats();
     private:
-        static char* start_free;    // 内存池起始位置
-        static char* end_free;      // 内存池结束位置
-        static size_t heap_size;    // 申请 heap 空间附加值大小
+        friend struct alloc_stats_mode_check;
 
-        static FreeList* free_list[EFreeListsNumber];   // 自由链表
+        struct ThreadCache;
+        struct ThreadStats;
+        struct ChunkUsage;
+        struct TrimWorker;
 
         static size_t M_align(size_t bytes);
         static size_t M_round_up(size_t bytes);
         static size_t M_freelist_index(size_t bytes);
-        static void* M_refill(size_t n);
+        static size_t M_block_size(size_t index);
+        static size_t M_block_align(size_t bytes);
+        static size_t M_transfer_number(size_t bytes);
+        static void M_grow_batch(ThreadCache& cache, size_t index, size_t n);
+        static void M_shrink_batch(ThreadCache& cache, size_t index);
+        static size_t M_initial_batch(size_t index);
+        static ThreadCache& M_thread_cache();
+        static void* M_fetch_from_central(ThreadCache& cache, size_t index, size_t n);
+        static void M_release_to_central(ThreadCache& cache, size_t index, size_t nblock);
+        static void* M_refill(ThreadCache& cache, size_t n, size_t nblock);
         static char* M_chunk_alloc(size_t size, size_t& nobj);
+        static void M_free_range(char* p, size_t bytes);
+        static ChunkHeader* M_system_alloc(size_t bytes);
+        static void M_system_free(ChunkHeader* chunk);
+        static ChunkUsage* M_find_chunk(ChunkUsage* usage, size_t count, char* p);
+        static TrimWorker& M_trim_worker();
+        static void M_check_stats_mode(bool enabled);
+
+#ifdef MYSTL_ALLOC_STATS
+        struct StatsRegistry;
+
+        static StatsRegistry& M_stats_registry();
+        static void M_stat_add(std::atomic<size_t>& counter, size_t n);
+        static void M_merge_stats(alloc_stats& result, const ThreadStats& s);
+#endif // MYSTL_ALLOC_STATS
     };
 
-    // 静态成员变量初始化
-    char* alloc::start_free = nullptr;
-    char* alloc::end_free = nullptr;
-    size_t alloc::heap_size = 0;
-
-    FreeList* alloc::free_list[EFreeListsNumber] = {
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+#ifdef MYSTL_ALLOC_STATS
+    // 结构体：alloc::ThreadStats
+    // 一个线程的计数，只由所属线程写入，其他线程只读，读写均为 relaxed
+    struct alloc::ThreadStats {
+        struct SizeClass {
+            std::atomic<size_t> allocs;
+            std::atomic<size_t> frees;
+            std::atomic<size_t> requested_bytes;
+            std::atomic<size_t> fetches;
+            std::atomic<size_t> releases;
+            std::atomic<size_t> refills;
+        };
+        SizeClass size_class[EFreeListsNumber];
+        std::atomic<size_t> large_allocs;
+        std::atomic<size_t> large_frees;
+        std::atomic<size_t> large_alloc_bytes;
+        std::atomic<size_t> large_free_bytes;
     };
+#endif // MYSTL_ALLOC_STATS
+
+    // 结构体：alloc::ThreadCache
+    // 每个线程私有的自由链表，只被所属线程访问
+    struct alloc::ThreadCache {
+        FreeList* free_list[EFreeListsNumber];  // 线程私有的自由链表
+        size_t length[EFreeListsNumber];        // 每条自由链表上的区块个数
+        size_t batch[EFreeListsNumber];         // 每条自由链表下一次搬运的区块数
+#ifdef MYSTL_ALLOC_STATS
+        ThreadStats stats;                      // 本线程的计数
+        ThreadCache* prev;                      // cache_list 中的前后节点
+        ThreadCache* next;
+#endif // MYSTL_ALLOC_STATS
+
+        ThreadCache();
+        ~ThreadCache();
+    };
+
+    // 结构体：alloc::ChunkUsage
+    // trim 时统计一块 chunk 中空闲的字节数
+    struct alloc::ChunkUsage {
+        ChunkHeader* chunk;     // 对应的 chunk
+        size_t free_bytes;      // chunk 中位于自由链表或内存池剩余空间的字节数
+        bool released;          // chunk 完全空闲，将归还系统
+
+        // 按 chunk 地址排序，供 std::qsort 使用
+        static int compare(const void* lhs, const void* rhs) {
+            const char* l = reinterpret_cast<const char*>(static_cast<const ChunkUsage*>(lhs)->chunk);
+            const char* r = reinterpret_cast<const char*>(static_cast<const ChunkUsage*>(rhs)->chunk);
+            return l < r ? -1 : (r < l ? 1 : 0);
+        }
+    };
+
+    // 结构体：alloc::TrimWorker
+    // 后台线程，按固定间隔调用 trim
+    struct alloc::TrimWorker {
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::thread thread;
+        bool stop = false;
+
+        ~TrimWorker() { alloc::stop_background_trim(); }
+    };
+
+#ifdef MYSTL_ALLOC_STATS
+    // 结构体：alloc::StatsRegistry
+    // 所有存活的线程缓存，以及已退出线程的计数
+    struct alloc::StatsRegistry {
+        ThreadCache* cache_list;    // 所有存活的线程缓存
+        ThreadStats retired;        // 已退出线程的计数
+        std::mutex mutex;           // 保护 cache_list 与 retired
+    };
+
+    // 有意不析构，退出较晚的线程仍可安全地注销自己的线程缓存
+    inline alloc::StatsRegistry& alloc::M_stats_registry() {
+        static StatsRegistry* registry = new StatsRegistry();
+        return *registry;
+    }
+
+    // 只有所属线程写入计数，用 relaxed 读写代替原子加，快路径上没有加锁指令
+    inline void alloc::M_stat_add(std::atomic<size_t>& counter, size_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+#endif // MYSTL_ALLOC_STATS
+
+    // 线程缓存构造时登记到 cache_list，以便统计时汇总
+    inline alloc::ThreadCache::ThreadCache() : free_list(), length() {
+        for(size_t i = 0; i < EFreeListsNumber; ++i)
+            batch[i] = alloc::M_initial_batch(i);
+#ifdef MYSTL_ALLOC_STATS
+        std::memset(static_cast<void*>(&stats), 0, sizeof(stats));
+        StatsRegistry& registry = alloc::M_stats_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        prev = nullptr;
+        next = registry.cache_list;
+        if(next != nullptr)
+            next->prev = this;
+        registry.cache_list = this;
+#endif // MYSTL_ALLOC_STATS
+    }
+
+    // 线程退出时，把缓存的区块全部归还中心自由链表
+    inline alloc::ThreadCache::~ThreadCache() {
+        for(size_t i = 0; i < EFreeListsNumber; ++i) {
+            if(length[i] != 0)
+                alloc::M_release_to_central(*this, i, length[i]);
+        }
+#ifdef MYSTL_ALLOC_STATS
+        // 计数并入 retired，再从 cache_list 摘除
+        StatsRegistry& registry = alloc::M_stats_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for(size_t i = 0; i < EFreeListsNumber; ++i) {
+            const ThreadStats::SizeClass& from = stats.size_class[i];
+            ThreadStats::SizeClass& to = registry.retired.size_class[i];
+            alloc::M_stat_add(to.allocs, from.allocs.load(std::memory_order_relaxed));
+            alloc::M_stat_add(to.frees, from.frees.load(std::memory_order_relaxed));
+            alloc::M_stat_add(to.requested_bytes, from.requested_bytes.load(std::memory_order_relaxed));
+            alloc::M_stat_add(to.fetches, from.fetches.load(std::memory_order_relaxed));
+            alloc::M_stat_add(to.releases, from.releases.load(std::memory_order_relaxed));
+            alloc::M_stat_add(to.refills, from.refills.load(std::memory_order_relaxed));
+        }
+        alloc::M_stat_add(registry.retired.large_allocs, stats.large_allocs.load(std::memory_order_relaxed));
+        alloc::M_stat_add(registry.retired.large_frees, stats.large_frees.load(std::memory_order_relaxed));
+        alloc::M_stat_add(registry.retired.large_alloc_bytes, stats.large_alloc_bytes.load(std::memory_order_relaxed));
+        alloc::M_stat_add(registry.retired.large_free_bytes, stats.large_free_bytes.load(std::memory_order_relaxed));
+        if(prev != nullptr)
+            prev->next = next;
+        else
+            registry.cache_list = next;
+        if(next != nullptr)
+            next->prev = prev;
+#endif // MYSTL_ALLOC_STATS
+    }
 
     // 分配大小为 n 的空间， n > 0
     inline void* alloc::allocate(size_t n) {
-        FreeList* my_free_list;
-        FreeList* result;
-        if(n > static_cast<size_t>(ESmallObjectBytes))
+        if(n > static_cast<size_t>(ESmallObjectBytes)) {
+            MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_allocs, 1));
+            MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_alloc_bytes, n));
             return std::malloc(n);
-        my_free_list = free_list[M_freelist_index(n)];
-        result = my_free_list;
-        if(result == nullptr) {
-            void* r = M_refill(M_round_up(n));
-            return r;
         }
-        my_free_list = result->next;
+        const size_t index = M_freelist_index(n);
+        ThreadCache& cache = M_thread_cache();
+        MYSTL_ALLOC_STAT(M_stat_add(cache.stats.size_class[index].allocs, 1));
+        MYSTL_ALLOC_STAT(M_stat_add(cache.stats.size_class[index].requested_bytes, n));
+        FreeList* result = cache.free_list[index];
+        if(result == nullptr)
+            return M_fetch_from_central(cache, index, M_round_up(n));
+        cache.free_list[index] = result->next;
+        --cache.length[index];
         return result;
     }
 
     // 释放 p 指向的大小为 n 的空间，p 不能为空
     inline void alloc::deallocate(void* p, size_t n) {
         if(n > static_cast<size_t>(ESmallObjectBytes)) {
+            MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_frees, 1));
+            MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_free_bytes, n));
             std::free(p);
             return;
         }
+        const size_t index = M_freelist_index(n);
+        ThreadCache& cache = M_thread_cache();
+        MYSTL_ALLOC_STAT(M_stat_add(cache.stats.size_class[index].frees, 1));
         FreeList* q = reinterpret_cast<FreeList*>(p);
-        FreeList* my_free_list;
-        my_free_list = free_list[M_freelist_index(n)];
-        q->next = my_free_list;
-        my_free_list = q;
+        q->next = cache.free_list[index];
+        cache.free_list[index] = q;
+        // 线程缓存过满时，说明需求已经停止，把一批区块归还中心自由链表，并减小批量
+        if(++cache.length[index] > (cache.batch[index] << 1)) {
+            M_release_to_central(cache, index, cache.batch[index]);
+            M_shrink_batch(cache, index);
+        }
     }
 
-    // 重新分配空间，接受三个参数，参数一定为指向空间的指针，
+    // 分配大小为 n，按 alignment 对齐的空间，alignment 必须是 2 的幂，以 deallocate_aligned 释放
+    // n 上调至 alignment 的倍数后不超过 4096 bytes 时，由内存池中自然对齐满足要求的区块提供
+    inline void* alloc::allocate_aligned(size_t n, size_t alignment) {
+        if(alignment <= static_cast<size_t>(EAlign128))
+            return allocate(n);
+        const size_t bytes = (n + alignment - 1) & ~(alignment - 1);
+        if(bytes <= static_cast<size_t>(ESmallObjectBytes))
+            return allocate(bytes);
+        MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_allocs, 1));
+        MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_alloc_bytes, n));
+        return aligned_malloc(n, alignment);
+    }
+
+    // 释放由 allocate_aligned 分配的空间，n 与 alignment 须与分配时相同
+    inline void alloc::deallocate_aligned(void* p, size_t n, size_t alignment) {
+        if(alignment <= static_cast<size_t>(EAlign128)) {
+            deallocate(p, n);
+            return;
+        }
+        const size_t bytes = (n + alignment - 1) & ~(alignment - 1);
+        if(bytes <= static_cast<size_t>(ESmallObjectBytes)) {
+            deallocate(p, bytes);
+            return;
+        }
+        MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_frees, 1));
+        MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_free_bytes, n));
+        aligned_free(p);
+    }
+
+    // 重新分配空间，接受三个参数，参数一为指向空间的指针，
     // 参数二为原来的空间的大小，参数三为申请空间的大小
+    // 原有数据（取两者中较小的大小）会保留；能原地满足时返回原指针
+    // 此后应以 new_size 释放返回的空间
     inline void* alloc::reallocate(void* p, size_t old_size, size_t new_size) {
+        if(p == nullptr)
+            return allocate(new_size);
+        if(try_expand_in_place(p, old_size, new_size))
+            return p;
+        if(old_size > static_cast<size_t>(ESmallObjectBytes) &&
+           new_size > static_cast<size_t>(ESmallObjectBytes)) {
+            // 大内存交给 std::realloc，glibc 对 mmap 得到的大块会使用 mremap 免去拷贝
+            void* result = std::realloc(p, new_size);
+            if(result != nullptr) {
+                MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_frees, 1));
+                MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_free_bytes, old_size));
+                MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_allocs, 1));
+                MYSTL_ALLOC_STAT(M_stat_add(M_thread_cache().stats.large_alloc_bytes, new_size));
+            }
+            return result;
+        }
+        void* result = allocate(new_size);
+        if(result == nullptr)
+            return nullptr;
+        std::memcpy(result, p, old_size < new_size ? old_size : new_size);
         deallocate(p, old_size);
-        p = allocate(new_size);
-        return p;
+        return result;
+    }
+
+    // 尝试不移动数据，让 p 指向的大小为 old_size 的空间改为 new_size 大小
+    // 成功时返回 true，此后应以 new_size 释放 p；失败时 p 不受影响
+    // 小内存在新旧大小属于同一个 free list 时成功；
+    // 大内存在新大小不超过 malloc 实际给出的大小时成功
+    inline bool alloc::try_expand_in_place(void* p, size_t old_size, size_t new_size) {
+        const size_t small = static_cast<size_t>(ESmallObjectBytes);
+        if(old_size <= small && new_size <= small)
+            return old_size != 0 && new_size != 0 && M_round_up(old_size) == M_round_up(new_size);
+        if(old_size > small && new_size > small) {
+#ifdef __GLIBC__
+            const bool fits = new_size <= malloc_usable_size(p);
+#else
+            (void)p;
+            const bool fits = new_size <= old_size;
+#endif
+#ifdef MYSTL_ALLOC_STATS
+            // 之后以 new_size 回收，大小的变化计入申请或释放的字节数，两者之差仍是仍在使用的字节数
+            if(fits && new_size > old_size)
+                M_stat_add(M_thread_cache().stats.large_alloc_bytes, new_size - old_size);
+            if(fits && new_size < old_size)
+                M_stat_add(M_thread_cache().stats.large_free_bytes, old_size - new_size);
+#endif // MYSTL_ALLOC_STATS
+            return fits;
+        }
+        return false;
     }
 
     // bytes 对应上调大小
@@ -139,84 +547,588 @@ namespace mystl {
             : (47 + (bytes + EAlign4096 - 2049) / EAlign4096);
     }
 
-    // 重填 free list
-    void* alloc::M_refill(size_t n) {
-        size_t nblock = 10;
-        char* c = M_chunk_alloc(n, nblock);
-        FreeList* my_free_list;
-        FreeList* result, *cur, *next;
+    // 第 index 个 free list 的区块大小，M_freelist_index 的逆运算
+    inline size_t alloc::M_block_size(size_t index) {
+        if(index < 24) {
+            return index < 16
+                ? (index + 1) * EAlign128
+                : 128 + (index - 15) * EAlign256;
+        }
+        if(index < 40) {
+            return index < 32
+                ? 256 + (index - 23) * EAlign512
+                : 512 + (index - 31) * EAlign1024;
+        }
+        return index < 48
+            ? 1024 + (index - 39) * EAlign2048
+            : 2048 + (index - 47) * EAlign4096;
+    }
+
+    // 大小为 bytes 的区块的自然对齐，即 bytes 最低位的 1 所代表的 2 的幂
+    inline size_t alloc::M_block_align(size_t bytes) {
+        return bytes & (~bytes + 1);
+    }
+
+    // 线程缓存与中心自由链表之间一次搬运的区块数的上限，由字节数上限决定，小区块多搬，大区块少搬
+    inline size_t alloc::M_transfer_number(size_t bytes) {
+        const size_t n = ETransferBytes / M_round_up(bytes);
+        if(n < static_cast<size_t>(ETransferMinBlocks))
+            return ETransferMinBlocks;
+        if(n > static_cast<size_t>(ETransferMaxBlocks))
+            return ETransferMaxBlocks;
+        return n;
+    }
+
+    // 线程缓存又一次被取空，说明需求持续，批量倍增（slow start），不超过 M_transfer_number
+    inline void alloc::M_grow_batch(ThreadCache& cache, size_t index, size_t n) {
+#ifdef MYSTL_ALLOC_FIXED_BATCH
+        (void)cache; (void)index; (void)n;
+#else
+        const size_t limit = M_transfer_number(n);
+        if(cache.batch[index] < limit)
+            cache.batch[index] = (cache.batch[index] << 1) < limit ? (cache.batch[index] << 1) : limit;
+#endif // MYSTL_ALLOC_FIXED_BATCH
+    }
+
+    // 批量减半，不低于 ETransferMinBlocks
+    inline void alloc::M_shrink_batch(ThreadCache& cache, size_t index) {
+#ifdef MYSTL_ALLOC_FIXED_BATCH
+        (void)cache; (void)index;
+#else
+        const size_t half = cache.batch[index] >> 1;
+        cache.batch[index] = half < static_cast<size_t>(ETransferMinBlocks)
+            ? static_cast<size_t>(ETransferMinBlocks) : half;
+#endif // MYSTL_ALLOC_FIXED_BATCH
+    }
+
+    // 线程缓存建立或清空后第 index 个 free list 的批量
+    // 自适应时从 ETransferMinBlocks 开始；固定批量时取 MYSTL_ALLOC_FIXED_BATCH，并限制在 M_transfer_number 之内
+    inline size_t alloc::M_initial_batch(size_t index) {
+#ifdef MYSTL_ALLOC_FIXED_BATCH
+        const size_t fixed = static_cast<size_t>(MYSTL_ALLOC_FIXED_BATCH);
+        const size_t limit = M_transfer_number(M_block_size(index));
+        return fixed < limit ? fixed : limit;
+#else
+        (void)index;
+        return ETransferMinBlocks;
+#endif // MYSTL_ALLOC_FIXED_BATCH
+    }
+
+    // 取得当前线程的线程缓存
+    inline alloc::ThreadCache& alloc::M_thread_cache() {
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+
+    // 线程缓存为空时，从中心自由链表成批取出区块，第一个区块返回给调用者，
+    // 其余纳入线程缓存；中心自由链表也为空时，从内存池重填
+    inline void* alloc::M_fetch_from_central(ThreadCache& cache, size_t index, size_t n) {
+        const size_t want = cache.batch[index];
+        M_grow_batch(cache, index, n);
+        FreeList* first;
+        FreeList* last;
+        size_t nblock = 0;
+        MYSTL_ALLOC_STAT(M_stat_add(cache.stats.size_class[index].fetches, 1));
+        {
+            std::lock_guard<std::mutex> lock(list_mutex[index]);
+            first = last = free_list[index];
+            if(first != nullptr) {
+                for(nblock = 1; nblock < want && last->next != nullptr; ++nblock)
+                    last = last->next;
+                free_list[index] = last->next;
+                MYSTL_ALLOC_STAT(central_length[index] -= nblock);
+            }
+        }
+        if(nblock == 0)
+            return M_refill(cache, n, want);
+        last->next = cache.free_list[index];
+        cache.free_list[index] = first->next;
+        cache.length[index] += nblock - 1;
+        return first;
+    }
+
+    // 从线程缓存摘下 nblock 个区块，一次性挂到中心自由链表上
+    inline void alloc::M_release_to_central(ThreadCache& cache, size_t index, size_t nblock) {
+        FreeList* first = cache.free_list[index];
+        FreeList* last = first;
+        for(size_t i = 1; i < nblock; ++i)
+            last = last->next;
+        cache.free_list[index] = last->next;
+        cache.length[index] -= nblock;
+        MYSTL_ALLOC_STAT(M_stat_add(cache.stats.size_class[index].releases, 1));
+
+        std::lock_guard<std::mutex> lock(list_mutex[index]);
+        last->next = free_list[index];
+        free_list[index] = first;
+        MYSTL_ALLOC_STAT(central_length[index] += nblock);
+    }
+
+    // 重填线程缓存，n 已上调至区块大小，一次切分的区块数为 M_fetch_from_central 增长前的批量
+    inline void* alloc::M_refill(ThreadCache& cache, size_t n, size_t nblock) {
+        const size_t index = M_freelist_index(n);
+        char* c;
+        MYSTL_ALLOC_STAT(M_stat_add(cache.stats.size_class[index].refills, 1));
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            c = M_chunk_alloc(n, nblock);
+            MYSTL_ALLOC_STAT(class_blocks[index] += nblock);
+        }
         // 如果只有一个区块，就把这个区块返回给调用者，free list 没有增加新的节点
         if(nblock == 1) return c;
-        // 否则把区块给调用者，剩下的纳入 free list 作为新的节点
-        my_free_list = free_list[M_freelist_index(n)];
-        result = (FreeList*)c;
-        my_free_list = next = (FreeList*)(c + n);
-        for(size_t i = 1; ; ++i) {
-            cur = next;
-            next = (FreeList*)((char*)next + n);
-            if(nblock - 1 == i) {
-                cur->next = nullptr;
-                break;
-            } else {
-                cur->next = next;
-            }
+        // 否则把区块给调用者，剩下的纳入线程缓存作为新的节点
+        FreeList* head = (FreeList*)(c + n);
+        FreeList* cur = head;
+        for(size_t i = 2; i < nblock; ++i) {
+            cur->next = (FreeList*)((char*)cur + n);
+            cur = cur->next;
         }
-        return result;
+        cur->next = cache.free_list[index];
+        cache.free_list[index] = head;
+        cache.length[index] += nblock - 1;
+        return c;
     }
 
     // 从内存池中取空间 free list 使用，条件不允许时，会调整 nblock
-    char* alloc::M_chunk_alloc(size_t size, size_t& nblock) {
+    // 区块起始地址按 size 的自然对齐上调，对齐产生的空隙编入中心自由链表
+    // 调用者必须持有 pool_mutex
+    inline char* alloc::M_chunk_alloc(size_t size, size_t& nblock) {
         char* result;
         size_t need_bytes = size * nblock;
         size_t pool_bytes = end_free - start_free;
+        const size_t align = M_block_align(size);
+        const size_t pad = (0 - reinterpret_cast<uintptr_t>(start_free)) & (align - 1);
 
-        // 如果内存池剩余大小完全满足需求量，返回它
-        if(pool_bytes >= need_bytes) {
-            result = start_free;
-            start_free += need_bytes;
-            return result;
-        } else if(pool_bytes >= size) {
+        if(pool_bytes >= pad + size) {
+            M_free_range(start_free, pad);
+            start_free += pad;
+            pool_bytes -= pad;
             // 如果内存池剩余大小不能完全满足需求量，但至少可以分配一个或一个以上的区块，就返回它
-            nblock = pool_bytes / size;
-            need_bytes = size * nblock;
+            if(pool_bytes < need_bytes) {
+                nblock = pool_bytes / size;
+                need_bytes = size * nblock;
+            }
             result = start_free;
             start_free += need_bytes;
             return result;
         } else {
-            // 如果内存池剩余的大小连一个区块都无法满足
-            if(pool_bytes > 0) {
-                FreeList* my_free_list = free_list[M_freelist_index(pool_bytes)];
-                ((FreeList*)start_free)->next = my_free_list;
-                my_free_list = (FreeList*)start_free;
-            }
-            // 申请堆空间
-            size_t bytes_to_get = (need_bytes << 1) + M_round_up(heap_size >> 4);
-            start_free = (char*)std::malloc(bytes_to_get);
-            if(!start_free) {
+            // 如果内存池剩余的大小连一个区块都无法满足，把残余空间切成区块，编入中心自由链表
+            M_free_range(start_free, pool_bytes);
+            start_free = end_free;
+            // 申请堆空间，头部用于记录 chunk，另留出对齐所需的空间
+            size_t bytes_to_get = (need_bytes << 1) + M_round_up(heap_size >> 4) + EChunkHeaderBytes + align;
+            ChunkHeader* chunk = M_system_alloc(bytes_to_get);
+            if(!chunk) {
                 // 堆空间也不够
-                FreeList* my_free_list, *p;
-                // 试着查找有无未用的区块，且区块足够大的 free list
+                // 试着查找有无未用的区块，且区块足够大、对齐满足要求的 free list
                 for(size_t i = size; i <= ESmallObjectBytes; i += M_align(i)) {
-                    my_free_list = free_list[M_freelist_index(i)];
-                    p = my_free_list;
+                    if(i & (align - 1))
+                        continue;
+                    const size_t index = M_freelist_index(i);
+                    FreeList* p;
+                    {
+                        std::lock_guard<std::mutex> lock(list_mutex[index]);
+                        p = free_list[index];
+                        if(p) free_list[index] = p->next;
+                        MYSTL_ALLOC_STAT(if(p) --central_length[index]);
+                    }
                     if(p) {
-                        my_free_list = p->next;
+                        MYSTL_ALLOC_STAT(--class_blocks[index]);
                         start_free = (char*)p;
                         end_free = start_free + i;
                         return M_chunk_alloc(size, nblock);
                     }
                 }
                 std::printf("out of memory");
-                end_free = nullptr;
+                start_free = end_free = nullptr;
                 throw std::bad_alloc();
             }
-            end_free = start_free + bytes_to_get;
-            heap_size += bytes_to_get;
+            chunk->next = chunk_list;
+            chunk_list = chunk;
+            start_free = (char*)chunk + EChunkHeaderBytes;
+            end_free = (char*)chunk + chunk->size;
+            heap_size += chunk->size;
+            MYSTL_ALLOC_STAT(++chunk_allocs);
             return M_chunk_alloc(size, nblock);
         }
     }
 
-} // namespace mystl 
+    // 把 [p, p + bytes) 切成区块编入中心自由链表，每个区块都满足其大小的自然对齐
+    // 调用者必须持有 pool_mutex
+    inline void alloc::M_free_range(char* p, size_t bytes) {
+        while(bytes > 0) {
+            size_t block = static_cast<size_t>(ESmallObjectBytes);
+            if(bytes < block) {
+                block = M_round_up(bytes);
+                if(block > bytes)
+                    block -= M_align(block);
+            }
+            while(reinterpret_cast<uintptr_t>(p) & (M_block_align(block) - 1))
+                block -= M_align(block);
+            const size_t index = M_freelist_index(block);
+            {
+                std::lock_guard<std::mutex> lock(list_mutex[index]);
+                ((FreeList*)p)->next = free_list[index];
+                free_list[index] = (FreeList*)p;
+                MYSTL_ALLOC_STAT(++central_length[index]);
+            }
+            MYSTL_ALLOC_STAT(++class_blocks[index]);
+            p += block;
+            bytes -= block;
+        }
+    }
+
+    // 按 source 向系统申请至少 bytes 大小的 chunk，并填好 size 与 source，失败时返回 nullptr
+    // mmap 得到的 chunk 大小上调至大页的整数倍，起始地址按大页对齐
+    // 调用者必须持有 pool_mutex
+    inline ChunkHeader* alloc::M_system_alloc(size_t bytes) {
+#ifdef __linux__
+        if(source != EChunkMalloc) {
+            const size_t huge = static_cast<size_t>(EHugePageBytes);
+            const size_t size = (bytes + huge - 1) & ~(huge - 1);
+            void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+            if(source == EChunkHugeTLB) {
+                p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if(p != MAP_FAILED) {
+                    ChunkHeader* chunk = static_cast<ChunkHeader*>(p);
+                    chunk->size = size;
+                    chunk->source = EChunkHugeTLB;
+                    return chunk;
+                }
+            }
+#endif // MAP_HUGETLB
+            // 多映射一个大页，再把首尾多余的部分解除映射，得到按大页对齐的区域
+            p = ::mmap(nullptr, size + huge, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(p == MAP_FAILED)
+                return nullptr;
+            char* raw = static_cast<char*>(p);
+            char* aligned = reinterpret_cast<char*>(
+                (reinterpret_cast<uintptr_t>(raw) + huge - 1) & ~(static_cast<uintptr_t>(huge) - 1));
+            if(aligned != raw)
+                ::munmap(raw, aligned - raw);
+            if(raw + huge != aligned)
+                ::munmap(aligned + size, raw + huge - aligned);
+#ifdef MADV_HUGEPAGE
+            ::madvise(aligned, size, MADV_HUGEPAGE);
+#endif // MADV_HUGEPAGE
+            ChunkHeader* chunk = reinterpret_cast<ChunkHeader*>(aligned);
+            chunk->size = size;
+            chunk->source = EChunkMmap;
+            return chunk;
+        }
+#endif // __linux__
+        ChunkHeader* chunk = static_cast<ChunkHeader*>(std::malloc(bytes));
+        if(chunk != nullptr) {
+            chunk->size = bytes;
+            chunk->source = EChunkMalloc;
+        }
+        return chunk;
+    }
+
+    // 按 chunk 的来源把它归还系统
+    inline void alloc::M_system_free(ChunkHeader* chunk) {
+#ifdef __linux__
+        if(chunk->source != EChunkMalloc) {
+            ::munmap(chunk, chunk->size);
+            return;
+        }
+#endif // __linux__
+        std::free(chunk);
+    }
+
+    // 设置之后申请 chunk 的方式，已有的 chunk 不受影响
+    inline void alloc::set_chunk_source(EChunkSource s) {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        source = s;
+    }
+
+    inline EChunkSource alloc::chunk_source() {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        return source;
+    }
+
+    // 在按地址排序的 usage 中查找 p 所属的 chunk，p 必须来自内存池
+    inline alloc::ChunkUsage* alloc::M_find_chunk(ChunkUsage* usage, size_t count, char* p) {
+        size_t lo = 0, hi = count;
+        while(hi - lo > 1) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if(p < (char*)usage[mid].chunk)
+                hi = mid;
+            else
+                lo = mid;
+        }
+        return usage + lo;
+    }
+
+    // 把当前线程缓存的区块全部归还中心自由链表
+    inline void alloc::flush_thread_cache() {
+        ThreadCache& cache = M_thread_cache();
+        for(size_t i = 0; i < EFreeListsNumber; ++i) {
+            if(cache.length[i] != 0)
+                M_release_to_central(cache, i, cache.length[i]);
+            cache.batch[i] = M_initial_batch(i);
+        }
+    }
+
+    // 把所有区块都已空闲的 chunk 归还系统，返回归还的字节数
+    // 只统计中心自由链表与内存池剩余空间，其他线程缓存中的区块视为仍在使用
+    inline size_t alloc::trim() {
+        flush_thread_cache();
+        std::lock_guard<std::mutex> pool_lock(pool_mutex);
+        size_t count = 0;
+        for(ChunkHeader* c = chunk_list; c != nullptr; c = c->next)
+            ++count;
+        if(count == 0)
+            return 0;
+        ChunkUsage* usage = (ChunkUsage*)std::malloc(count * sizeof(ChunkUsage));
+        if(usage == nullptr)
+            return 0;
+        count = 0;
+        for(ChunkHeader* c = chunk_list; c != nullptr; c = c->next) {
+            usage[count].chunk = c;
+            usage[count].free_bytes = 0;
+            usage[count].released = false;
+            ++count;
+        }
+        std::qsort(usage, count, sizeof(ChunkUsage), &ChunkUsage::compare);
+
+        for(size_t i = 0; i < EFreeListsNumber; ++i)
+            list_mutex[i].lock();
+
+        // 统计每块 chunk 的空闲字节数
+        if(start_free != end_free)
+            M_find_chunk(usage, count, start_free)->free_bytes += end_free - start_free;
+        for(size_t i = 0; i < EFreeListsNumber; ++i) {
+            const size_t bytes = M_block_size(i);
+            for(FreeList* p = free_list[i]; p != nullptr; p = p->next)
+                M_find_chunk(usage, count, (char*)p)->free_bytes += bytes;
+        }
+
+        // 完全空闲的 chunk 的区块从中心自由链表摘除
+        size_t released = 0;
+        for(size_t i = 0; i < count; ++i) {
+            if(usage[i].free_bytes + EChunkHeaderBytes == usage[i].chunk->size) {
+                usage[i].released = true;
+                released += usage[i].chunk->size;
+            }
+        }
+        if(released != 0) {
+            for(size_t i = 0; i < EFreeListsNumber; ++i) {
+                FreeList** link = &free_list[i];
+                while(*link != nullptr) {
+                    if(M_find_chunk(usage, count, (char*)*link)->released) {
+                        *link = (*link)->next;
+                        MYSTL_ALLOC_STAT(--central_length[i]);
+                        MYSTL_ALLOC_STAT(--class_blocks[i]);
+                    } else {
+                        link = &(*link)->next;
+                    }
+                }
+            }
+        }
+
+        for(size_t i = 0; i < EFreeListsNumber; ++i)
+            list_mutex[i].unlock();
+
+        if(released != 0) {
+            if(start_free != end_free && M_find_chunk(usage, count, start_free)->released)
+                start_free = end_free = nullptr;
+            ChunkHeader** link = &chunk_list;
+            while(*link != nullptr) {
+                ChunkHeader* c = *link;
+                if(M_find_chunk(usage, count, (char*)c)->released) {
+                    *link = c->next;
+                    M_system_free(c);
+                } else {
+                    link = &c->next;
+                }
+            }
+            heap_size -= released;
+            MYSTL_ALLOC_STAT(trimmed_bytes += released);
+#ifdef __GLIBC__
+            // 让 glibc 把堆顶的空闲内存也归还系统
+            malloc_trim(0);
+#endif
+        }
+        std::free(usage);
+        MYSTL_ALLOC_STAT(++trims);
+        return released;
+    }
+
+    // 取得后台 trim 线程的状态
+    inline alloc::TrimWorker& alloc::M_trim_worker() {
+        static TrimWorker worker;
+        return worker;
+    }
+
+    // 启动后台线程，每隔 interval 调用一次 trim，已启动时先停止原有线程
+    inline void alloc::start_background_trim(std::chrono::milliseconds interval) {
+        stop_background_trim();
+        TrimWorker& worker = M_trim_worker();
+        worker.stop = false;
+        worker.thread = std::thread([&worker, interval]() {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            while(!worker.cond.wait_for(lock, interval, [&worker]() { return worker.stop; })) {
+                lock.unlock();
+                alloc::trim();
+                lock.lock();
+            }
+        });
+    }
+
+    // 停止后台 trim 线程
+    inline void alloc::stop_background_trim() {
+        TrimWorker& worker = M_trim_worker();
+        if(!worker.thread.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.stop = true;
+        }
+        worker.cond.notify_one();
+        worker.thread.join();
+    }
+
+#ifdef MYSTL_ALLOC_STATS
+    // 把一个线程的计数累加进统计快照
+    inline void alloc::M_merge_stats(alloc_stats& result, const ThreadStats& s) {
+        for(size_t i = 0; i < EFreeListsNumber; ++i) {
+            const ThreadStats::SizeClass& from = s.size_class[i];
+            alloc_size_class_stats& to = result.size_class[i];
+            to.allocs += from.allocs.load(std::memory_order_relaxed);
+            to.frees += from.frees.load(std::memory_order_relaxed);
+            to.requested_bytes += from.requested_bytes.load(std::memory_order_relaxed);
+            to.fetches += from.fetches.load(std::memory_order_relaxed);
+            to.releases += from.releases.load(std::memory_order_relaxed);
+            to.refills += from.refills.load(std::memory_order_relaxed);
+        }
+        result.large_allocs += s.large_allocs.load(std::memory_order_relaxed);
+        result.large_frees += s.large_frees.load(std::memory_order_relaxed);
+        result.large_alloc_bytes += s.large_alloc_bytes.load(std::memory_order_relaxed);
+        result.large_free_bytes += s.large_free_bytes.load(std::memory_order_relaxed);
+    }
+#endif // MYSTL_ALLOC_STATS
+
+    // 取得内存池的统计快照
+    // 其他线程同时在分配时，各项计数之间可能相差正在进行中的少量操作
+    // 登记一个翻译单元的 MYSTL_ALLOC_STATS 设置，与先前登记的不同时终止程序
+    inline void alloc::M_check_stats_mode(bool enabled) {
+        const int mode = enabled ? 2 : 1;
+        int expected = 0;
+        if(!stats_mode.compare_exchange_strong(expected, mode) && expected != mode) {
+            std::fprintf(stderr, "mystl::alloc: translation units disagree on MYSTL_ALLOC_STATS; "
+                                 "every translation unit must be built with the same setting\n");
+            std::abort();
+        }
+    }
+
+    // 结构体：alloc_stats_mode_check
+    // 构造时以所在翻译单元的设置调用 M_check_stats_mode；定义在各翻译单元中相同，设置由参数传入
+    struct alloc_stats_mode_check {
+        explicit alloc_stats_mode_check(bool enabled) {
+            alloc::M_check_stats_mode(enabled);
+        }
+    };
+
+    namespace {
+        // 每个包含本文件的翻译单元各有一份，静态初始化时完成登记
+        const alloc_stats_mode_check alloc_stats_mode_checker(MYSTL_ALLOC_STATS_ENABLED);
+    }
+
+    inline alloc_stats alloc::stats() {
+        alloc_stats result;
+        std::memset(&result, 0, sizeof(result));
+        for(size_t i = 0; i < EFreeListsNumber; ++i)
+            result.size_class[i].block_size = M_block_size(i);
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            result.heap_bytes = heap_size;
+            for(ChunkHeader* c = chunk_list; c != nullptr; c = c->next)
+                ++result.chunk_count;
+            result.pool_free_bytes = end_free - start_free;
+#ifdef MYSTL_ALLOC_STATS
+            result.chunk_allocs = chunk_allocs;
+            result.trims = trims;
+            result.trimmed_bytes = trimmed_bytes;
+            // 先借用 cached_blocks 记下切分给各 free list 的区块数
+            for(size_t i = 0; i < EFreeListsNumber; ++i)
+                result.size_class[i].cached_blocks = class_blocks[i];
+#endif // MYSTL_ALLOC_STATS
+        }
+#ifdef MYSTL_ALLOC_STATS
+        result.enabled = true;
+        for(size_t i = 0; i < EFreeListsNumber; ++i) {
+            std::lock_guard<std::mutex> lock(list_mutex[i]);
+            result.size_class[i].central_blocks = central_length[i];
+        }
+        {
+            StatsRegistry& registry = M_stats_registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            M_merge_stats(result, registry.retired);
+            for(ThreadCache* c = registry.cache_list; c != nullptr; c = c->next)
+                M_merge_stats(result, c->stats);
+        }
+        // 线程缓存中的区块数 = 切分的区块数 - 使用中的区块数 - 中心自由链表的区块数
+        for(size_t i = 0; i < EFreeListsNumber; ++i) {
+            alloc_size_class_stats& sc = result.size_class[i];
+            const size_t used = sc.allocs - sc.frees + sc.central_blocks;
+            sc.cached_blocks = sc.cached_blocks > used ? sc.cached_blocks - used : 0;
+        }
+#endif // MYSTL_ALLOC_STATS
+        return result;
+    }
+
+    // 以可读的表格形式输出统计快照
+    inline void print_alloc_stats(const alloc_stats& s, std::FILE* out = stdout) {
+        size_t idle_bytes = s.pool_free_bytes;
+        size_t waste_bytes = 0;
+        for(size_t i = 0; i < EFreeListsNumber; ++i) {
+            const alloc_size_class_stats& sc = s.size_class[i];
+            idle_bytes += (sc.central_blocks + sc.cached_blocks) * sc.block_size;
+            waste_bytes += sc.allocs * sc.block_size - sc.requested_bytes;
+        }
+        std::fprintf(out, "mystl::alloc stats%s\n", s.enabled ? "" : " (MYSTL_ALLOC_STATS not defined)");
+        std::fprintf(out, "  heap bytes      : %zu in %zu chunks (%zu chunk allocs)\n",
+            s.heap_bytes, s.chunk_count, s.chunk_allocs);
+        std::fprintf(out, "  idle bytes      : %zu (pool %zu)\n", idle_bytes, s.pool_free_bytes);
+        std::fprintf(out, "  round-up waste  : %zu\n", waste_bytes);
+        std::fprintf(out, "  trims           : %zu, %zu bytes released\n", s.trims, s.trimmed_bytes);
+        std::fprintf(out, "  large allocs    : %zu (%zu bytes), frees %zu (%zu bytes)\n",
+            s.large_allocs, s.large_alloc_bytes, s.large_frees, s.large_free_bytes);
+        std::fprintf(out, "  %6s %12s %12s %10s %10s %8s %10s %10s %12s\n",
+            "size", "allocs", "frees", "fetches", "releases", "refills", "central", "cached", "waste");
+        for(size_t i = 0; i < EFreeListsNumber; ++i) {
+            const alloc_size_class_stats& sc = s.size_class[i];
+            if(sc.allocs == 0 && sc.central_blocks == 0 && sc.cached_blocks == 0)
+                continue;
+            std::fprintf(out, "  %6zu %12zu %12zu %10zu %10zu %8zu %10zu %10zu %12zu\n",
+                sc.block_size, sc.allocs, sc.frees, sc.fetches, sc.releases, sc.refills,
+                sc.central_blocks, sc.cached_blocks, sc.allocs * sc.block_size - sc.requested_bytes);
+        }
+    }
+
+    // 以 JSON 形式输出统计快照，便于保存与比较
+    inline void print_alloc_stats_json(const alloc_stats& s, std::FILE* out = stdout) {
+        std::fprintf(out, "{\"enabled\":%s,\"heap_bytes\":%zu,\"chunk_count\":%zu,\"chunk_allocs\":%zu,"
+            "\"pool_free_bytes\":%zu,\"trims\":%zu,\"trimmed_bytes\":%zu,"
+            "\"large_allocs\":%zu,\"large_frees\":%zu,\"large_alloc_bytes\":%zu,\"large_free_bytes\":%zu,"
+            "\"size_classes\":[",
+            s.enabled ? "true" : "false", s.heap_bytes, s.chunk_count, s.chunk_allocs,
+            s.pool_free_bytes, s.trims, s.trimmed_bytes,
+            s.large_allocs, s.large_frees, s.large_alloc_bytes, s.large_free_bytes);
+        for(size_t i = 0; i < EFreeListsNumber; ++i) {
+            const alloc_size_class_stats& sc = s.size_class[i];
+            std::fprintf(out, "%s{\"block_size\":%zu,\"allocs\":%zu,\"frees\":%zu,\"requested_bytes\":%zu,"
+                "\"fetches\":%zu,\"releases\":%zu,\"refills\":%zu,\"central_blocks\":%zu,\"cached_blocks\":%zu}",
+                i == 0 ? "" : ",", sc.block_size, sc.allocs, sc.frees, sc.requested_bytes,
+                sc.fetches, sc.releases, sc.refills, sc.central_blocks, sc.cached_blocks);
+        }
+        std::fprintf(out, "]}\n");
+    }
+
+} // namespace mystl
 
 
-#endif // MY_TINY_STL_H_
\ No newline at end of file
+#endif // MY_TINY_ALLOC_H_
@@ -2,14 +2,95 @@
 #define MY_TINY_ALLOCATOR_H_
 
 // 这个头文件包含一个模板类 allocator，用于管理内存的分配、释放，对象的构造、析构
+// 以及 allocator 可选的分配策略 new_policy、pool_policy，和按指定对齐分配的 aligned_allocator
 
+#include <new>
+#include <type_traits>
+
+#include "alloc.h"
 #include "construct.h"
 #include "util.h"
 
 namespace mystl {
+    // 分配策略：new_policy
+    // 直接调用 ::operator new / ::operator delete
+    struct new_policy {
+        // 策略保证的对齐大小
+        enum { alignment = alignof(std::max_align_t) };
+
+        static void* allocate(size_t bytes) {
+            return ::operator new(bytes);
+        }
+
+        static void deallocate(void* ptr, size_t /*bytes*/) {
+            ::operator delete(ptr);
+        }
+
+        // 按 align 对齐分配，align 超过 alignment 时使用
+        static void* allocate(size_t bytes, size_t align) {
+#ifdef __cpp_aligned_new
+            return ::operator new(bytes, std::align_val_t(align));
+#else
+            void* p = mystl::aligned_malloc(bytes, align);
+            if(p == nullptr) throw std::bad_alloc();
+            return p;
+#endif // __cpp_aligned_new
+        }
+
+        static void deallocate(void* ptr, size_t /*bytes*/, size_t align) {
+#ifdef __cpp_aligned_new
+            ::operator delete(ptr, std::align_val_t(align));
+#else
+            (void)align;
+            mystl::aligned_free(ptr);
+#endif // __cpp_aligned_new
+        }
+    };
+
+    // 分配策略：pool_policy
+    // 小内存交给内存池 alloc 按大小分级管理，释放时传入已知的大小，区块不需要额外的头部记录大小
+    struct pool_policy {
+        // 内存池的区块按 8 bytes 对齐
+        enum { alignment = EAlign128 };
+
+        static void* allocate(size_t bytes) {
+            void* p = mystl::alloc::allocate(bytes);
+            if(p == nullptr) throw std::bad_alloc();
+            return p;
+        }
+
+        static void deallocate(void* ptr, size_t bytes) {
+            mystl::alloc::deallocate(ptr, bytes);
+        }
+
+        // 按 align 对齐分配，区块大小上调到 align 的倍数后仍由内存池提供
+        static void* allocate(size_t bytes, size_t align) {
+            void* p = mystl::alloc::allocate_aligned(bytes, align);
+            if(p == nullptr) throw std::bad_alloc();
+            return p;
+        }
+
+        static void deallocate(void* ptr, size_t bytes, size_t align) {
+            mystl::alloc::deallocate_aligned(ptr, bytes, align);
+        }
+    };
+
+    // Policy 是否提供单个对象的分配 allocate_object<T>() / deallocate_object<T>(T*)，以 object_policy_tag 标记
+    template<typename Policy>
+    struct has_object_allocate {
+    private:
+        struct two { char a; char b; };
+        template<typename U> static two test(...);
+        template<typename U> static char test(typename U::object_policy_tag* = 0);
+    public:
+        static const bool value = sizeof(test<Policy>(0)) == sizeof(char);
+    };
+
     // 模板类：allocator
-    // 模板函数代表数据类型
-    template<typename T>
+    // 模板参数 T 代表数据类型，Policy 代表分配策略
+    // 当 T 的对齐要求超过 Policy 的保证时，使用 Policy 带对齐参数的版本
+    // Policy 提供单个对象的分配时，allocate() / deallocate(T*) 交给它，例如 object_pool_policy
+    template<typename T, typename Policy = new_policy>
     class allocator {
     public:
         typedef T           value_type;
@@ -19,8 +100,18 @@ namespace mystl {
         typedef const T&    const_reference;
         typedef size_t      size_type;
         typedef ptrdiff_t   difference_type;
-    
+        typedef Policy      policy_type;
+
+        template<typename U>
+        struct rebind {
+            typedef allocator<U, Policy> other;
+        };
+
     public:
+        allocator() noexcept {}
+        template<typename U>
+        allocator(const allocator<U, Policy>&) noexcept {}
+
         static T* allocate();
         static T* allocate(size_type n);
 
@@ -36,62 +127,161 @@ namespace mystl {
 
         static void destroy(T* ptr);
         static void destroy(T* first, T* last);
+
+    private:
+        typedef std::integral_constant<bool,
+            (alignof(T) > static_cast<size_t>(Policy::alignment))> M_over_aligned;
+
+        static void* M_allocate(size_type bytes, std::false_type) {
+            return Policy::allocate(bytes);
+        }
+        static void* M_allocate(size_type bytes, std::true_type) {
+            return Policy::allocate(bytes, alignof(T));
+        }
+        static void M_deallocate(T* ptr, size_type bytes, std::false_type) {
+            Policy::deallocate(ptr, bytes);
+        }
+        static void M_deallocate(T* ptr, size_type bytes, std::true_type) {
+            Policy::deallocate(ptr, bytes, alignof(T));
+        }
+
+        typedef std::integral_constant<bool, has_object_allocate<Policy>::value> M_object_policy;
+
+        static T* M_allocate_one(std::false_type) {
+            return static_cast<T*>(M_allocate(sizeof(T), M_over_aligned()));
+        }
+        template<typename P = Policy>
+        static T* M_allocate_one(std::true_type) {
+            return P::template allocate_object<T>();
+        }
+        static void M_deallocate_one(T* ptr, std::false_type) {
+            M_deallocate(ptr, sizeof(T), M_over_aligned());
+        }
+        template<typename P = Policy>
+        static void M_deallocate_one(T* ptr, std::true_type) {
+            P::template deallocate_object<T>(ptr);
+        }
     };
 
-    template<typename T>
-    T* allocator<T>::allocate() {
-        return static_cast<T*>(::operator new(sizeof(T)));
+    template<typename T, typename Policy>
+    T* allocator<T, Policy>::allocate() {
+        return M_allocate_one(M_object_policy());
     }
 
-    template<typename T>
-    T* allocator<T>::allocate(size_type n) {
+    template<typename T, typename Policy>
+    T* allocator<T, Policy>::allocate(size_type n) {
         if(n == 0) return nullptr;
-        return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(M_allocate(n * sizeof(T), M_over_aligned()));
     }
 
-    template<typename T>
-    void allocator<T>::deallocate(T* ptr) {
+    template<typename T, typename Policy>
+    void allocator<T, Policy>::deallocate(T* ptr) {
         if(ptr == nullptr) return;
-        ::operator delete(ptr);
+        M_deallocate_one(ptr, M_object_policy());
     }
 
-    template<typename T>
-    void allocator<T>::deallocate(T* ptr, size_type /*size*/) {
+    template<typename T, typename Policy>
+    void allocator<T, Policy>::deallocate(T* ptr, size_type n) {
         if(ptr == nullptr) return;
-        ::operator delete(ptr);
+        M_deallocate(ptr, n * sizeof(T), M_over_aligned());
     }
 
-    template<typename T>
-    void allocator<T>::construct(T* ptr) {
+    template<typename T, typename Policy>
+    void allocator<T, Policy>::construct(T* ptr) {
         mystl::construct(ptr);
     }
 
-    template<typename T>
-    void allocator<T>::construct(T* ptr, const T& value) {
+    template<typename T, typename Policy>
+    void allocator<T, Policy>::construct(T* ptr, const T& value) {
         mystl::construct(ptr, value);
     }
 
-    template<typename T>
-    void allocator<T>::construct(T* ptr, T&& value) {
+    template<typename T, typename Policy>
+    void allocator<T, Policy>::construct(T* ptr, T&& value) {
         mystl::construct(ptr, mystl::move(value));
     }
 
-    template<typename T>
+    template<typename T, typename Policy>
     template<typename... Args>
-    void allocator<T>::construct(T* ptr, Args&& ...args) {
+    void allocator<T, Policy>::construct(T* ptr, Args&& ...args) {
         mystl::construct(ptr, mystl::forward<Args>(args)...);
     }
-    
-    template<typename T>
-    void allocator<T>::destroy(T* ptr) {
+
+    template<typename T, typename Policy>
+    void allocator<T, Policy>::destroy(T* ptr) {
         mystl::destroy(ptr);
-    } 
+    }
 
-    template<typename T>
-    void allocator<T>::destroy(T* first, T* last) {
+    template<typename T, typename Policy>
+    void allocator<T, Policy>::destroy(T* first, T* last) {
         mystl::destroy(first, last);
     }
-    
+
+    // 同一分配策略的 allocator 之间可以互相释放对方分配的内存
+    template<typename T, typename U, typename Policy>
+    bool operator==(const allocator<T, Policy>&, const allocator<U, Policy>&) noexcept {
+        return true;
+    }
+
+    template<typename T, typename U, typename Policy>
+    bool operator!=(const allocator<T, Policy>&, const allocator<U, Policy>&) noexcept {
+        return false;
+    }
+
+    // 模板类：aligned_allocator
+    // 按 Align 与 alignof(T) 中的较大者对齐分配，用于 SIMD 数据、按缓存行或页对齐的缓冲区等
+    // Align 必须是 2 的幂，对象的构造、析构沿用 allocator
+    template<typename T, size_t Align, typename Policy = new_policy>
+    class aligned_allocator : public allocator<T, Policy> {
+        static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Align must be a power of 2");
+
+    public:
+        typedef typename allocator<T, Policy>::size_type size_type;
+
+        enum { alignment = Align < alignof(T) ? alignof(T) : Align };
+
+        template<typename U>
+        struct rebind {
+            typedef aligned_allocator<U, Align, Policy> other;
+        };
+
+    public:
+        aligned_allocator() noexcept {}
+        template<typename U>
+        aligned_allocator(const aligned_allocator<U, Align, Policy>&) noexcept {}
+
+        static T* allocate() {
+            return static_cast<T*>(Policy::allocate(sizeof(T), alignment));
+        }
+
+        static T* allocate(size_type n) {
+            if(n == 0) return nullptr;
+            return static_cast<T*>(Policy::allocate(n * sizeof(T), alignment));
+        }
+
+        static void deallocate(T* ptr) {
+            if(ptr == nullptr) return;
+            Policy::deallocate(ptr, sizeof(T), alignment);
+        }
+
+        static void deallocate(T* ptr, size_type n) {
+            if(ptr == nullptr) return;
+            Policy::deallocate(ptr, n * sizeof(T), alignment);
+        }
+    };
+
+    template<typename T, typename U, size_t Align, typename Policy>
+    bool operator==(const aligned_allocator<T, Align, Policy>&,
+                    const aligned_allocator<U, Align, Policy>&) noexcept {
+        return true;
+    }
+
+    template<typename T, typename U, size_t Align, typename Policy>
+    bool operator!=(const aligned_allocator<T, Align, Policy>&,
+                    const aligned_allocator<U, Align, Policy>&) noexcept {
+        return false;
+    }
+
 }
 
-#endif // MY_TINY_ALLOCATOR_H_
\ No newline at end of file
+#endif // MY_TINY_ALLOCATOR_H_
@@ -0,0 +1,925 @@
+#ifndef MY_TINY_BTREE_H_
+#define MY_TINY_BTREE_H_
+
+// 这个头文件包含一个模板类 btree，作为 btree_map、btree_set 的底层实现
+// B+ 树：元素只存放在叶节点中，叶节点之间以双向链表相连，顺序遍历与区间扫描只沿链表前进；
+// 内部节点只存放分隔键与子节点指针，分隔键连续存放，节点内查找扫描一段连续的内存
+// 节点大小以缓存行为单位（默认 4 个缓存行），一个节点容纳数十个元素，树高远低于红黑树，
+// 查找时每层只访问一个节点，缓存缺失次数约为红黑树的 log(节点容量) 分之一
+
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "allocator.h"
+#include "construct.h"
+#include "functional.h"
+#include "vector.h"
+#include "util.h"
+
+namespace mystl {
+
+    // 节点的目标大小与对齐：节点按缓存行对齐，大小为缓存行的整数倍
+    enum { EBtreeCachelineSize = 64 };
+    enum { EBtreeNodeBytes = 4 * EBtreeCachelineSize };
+
+    // 树高的上限：内部节点至少有两个子节点，64 层足以容纳 size_t 能表示的元素个数
+    enum { EBtreeMaxHeight = 64 };
+
+    // 节点公共的头部
+    struct btree_node_base {
+        unsigned short count;   // 叶节点中的元素个数，内部节点中的键个数
+        bool leaf;
+    };
+
+    // 叶节点：Slots 个连续存放的元素，以及前后叶节点的指针
+    template<typename Value, size_t Slots, size_t Align>
+    struct alignas(Align) btree_leaf_node : btree_node_base {
+        typedef Value value_type;
+
+        btree_leaf_node* prev;
+        btree_leaf_node* next;
+        alignas(Value) unsigned char storage[sizeof(Value) * Slots];
+
+        Value* values() noexcept { return reinterpret_cast<Value*>(storage); }
+    };
+
+    // 内部节点：Slots 个连续存放的分隔键，以及 Slots + 1 个子节点指针
+    // 子节点 i 中的键不小于键 i - 1，且小于键 i
+    template<typename Key, size_t Slots, size_t Align>
+    struct alignas(Align) btree_inner_node : btree_node_base {
+        alignas(Key) unsigned char storage[sizeof(Key) * Slots];
+        btree_node_base* children[Slots + 1];
+
+        Key* keys() noexcept { return reinterpret_cast<Key*>(storage); }
+    };
+
+    // 由元素与键的大小决定每种节点的容量，使节点接近 EBtreeNodeBytes
+    template<typename Value, typename Key>
+    struct btree_node_traits {
+        enum { leaf_fit = (static_cast<size_t>(EBtreeNodeBytes) - 3 * sizeof(void*)) / sizeof(Value) };
+        enum { inner_fit = (static_cast<size_t>(EBtreeNodeBytes) - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(void*)) };
+
+        enum { leaf_slots = leaf_fit < 4 ? 4 : leaf_fit };
+        enum { inner_slots = inner_fit < 3 ? 3 : inner_fit };
+
+        enum { value_align = alignof(Value) < alignof(Key) ? alignof(Key) : alignof(Value) };
+        enum { align = static_cast<size_t>(value_align) < static_cast<size_t>(EBtreeCachelineSize)
+                       ? static_cast<size_t>(EBtreeCachelineSize) : static_cast<size_t>(value_align) };
+
+        typedef btree_leaf_node<Value, leaf_slots, align>   leaf_node;
+        typedef btree_inner_node<Key, inner_slots, align>   inner_node;
+    };
+
+    // btree 的迭代器，指向叶节点中的一个元素；尾后迭代器指向最后一个叶节点的末尾
+    template<typename Leaf, typename Ref, typename Ptr>
+    struct btree_iterator : public mystl::iterator<mystl::bidirectional_iterator_tag,
+                                                   typename Leaf::value_type, ptrdiff_t, Ptr, Ref> {
+        typedef btree_iterator<Leaf, Ref, Ptr>  self;
+        typedef typename Leaf::value_type       T;
+
+        Leaf* node;
+        size_t pos;
+
+        btree_iterator() noexcept : node(nullptr), pos(0) {}
+        btree_iterator(Leaf* n, size_t p) noexcept : node(n), pos(p) {}
+
+        // 非常量迭代器可以转换为常量迭代器
+        template<typename R, typename P, typename std::enable_if<
+            std::is_same<Ref, const T&>::value && !std::is_same<R, Ref>::value, int>::type = 0>
+        btree_iterator(const btree_iterator<Leaf, R, P>& rhs) noexcept : node(rhs.node), pos(rhs.pos) {}
+
+        Ref operator*() const { return node->values()[pos]; }
+        Ptr operator->() const { return node->values() + pos; }
+
+        self& operator++() {
+            if(++pos == node->count && node->next != nullptr) {
+                node = node->next;
+                pos = 0;
+            }
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self& operator--() {
+            if(pos == 0) {
+                node = node->prev;
+                pos = node->count;
+            }
+            --pos;
+            return *this;
+        }
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        template<typename R, typename P>
+        bool operator==(const btree_iterator<Leaf, R, P>& rhs) const { return node == rhs.node && pos == rhs.pos; }
+        template<typename R, typename P>
+        bool operator!=(const btree_iterator<Leaf, R, P>& rhs) const { return !(*this == rhs); }
+    };
+
+    // 模板类：btree
+    // Value 为元素类型，KeyOfValue 从元素中取出键，Compare 为键的比较函数，键不允许重复
+    // 插入与删除会在节点内与节点间搬移元素，之后指向元素的迭代器、指针与引用都可能失效
+    // 节点内的元素以 relocate_n 搬移，可平凡重定位的元素直接复制字节，其它元素的移动构造不应抛出异常
+    template<typename Value, typename Key, typename KeyOfValue, typename Compare, typename Alloc>
+    class btree {
+    private:
+        typedef btree_node_traits<Value, Key>           node_traits;
+        typedef btree_node_base                         node_base;
+        typedef typename node_traits::leaf_node         leaf_node;
+        typedef typename node_traits::inner_node        inner_node;
+
+    public:
+        typedef Key                                     key_type;
+        typedef Value                                   value_type;
+        typedef Compare                                 key_compare;
+        typedef Alloc                                   allocator_type;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+        typedef Value*                                  pointer;
+        typedef const Value*                            const_pointer;
+        typedef Value&                                  reference;
+        typedef const Value&                            const_reference;
+
+        typedef btree_iterator<leaf_node, Value&, Value*>               iterator;
+        typedef btree_iterator<leaf_node, const Value&, const Value*>   const_iterator;
+        typedef mystl::reverse_iterator<iterator>                       reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator>                 const_reverse_iterator;
+
+        enum { leaf_slots = node_traits::leaf_slots };
+        enum { inner_slots = node_traits::inner_slots };
+
+    private:
+        typedef typename Alloc::template rebind<leaf_node>::other   leaf_allocator;
+        typedef typename Alloc::template rebind<inner_node>::other  inner_allocator;
+
+        // 非根节点的最少元素数与最少键数，两个相邻节点合并后不超过容量
+        enum { M_leaf_min = leaf_slots / 2 };
+        enum { M_inner_min = (inner_slots - 1) / 2 };
+
+        // 标量键在节点内顺序比较整个节点，没有分支，编译器可以向量化；其它键二分查找
+        typedef std::integral_constant<bool, std::is_scalar<Key>::value> M_linear_search;
+
+        // 自根向下经过的内部节点，以及选择的子节点下标
+        struct path_entry {
+            inner_node* node;
+            size_t index;
+        };
+
+        node_base* root_;
+        leaf_node* leftmost_;
+        leaf_node* rightmost_;
+        size_type size_;
+        key_compare comp_;
+        allocator_type alloc_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        explicit btree(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+            : root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), size_(0), comp_(comp), alloc_(alloc) {}
+
+        // 复制时按顺序整体建树，叶节点是满的
+        btree(const btree& rhs)
+            : root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), size_(0),
+              comp_(rhs.comp_), alloc_(rhs.alloc_) {
+            if(rhs.size_ != 0)
+                M_build_sorted(rhs.begin(), rhs.size_);
+        }
+
+        btree(btree&& rhs) noexcept
+            : root_(rhs.root_), leftmost_(rhs.leftmost_), rightmost_(rhs.rightmost_), size_(rhs.size_),
+              comp_(rhs.comp_), alloc_(mystl::move(rhs.alloc_)) {
+            rhs.M_reset_empty();
+        }
+
+        btree& operator=(const btree& rhs) {
+            if(this != &rhs) {
+                btree tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        btree& operator=(btree&& rhs) noexcept {
+            if(this != &rhs) {
+                clear();
+                root_ = rhs.root_;
+                leftmost_ = rhs.leftmost_;
+                rightmost_ = rhs.rightmost_;
+                size_ = rhs.size_;
+                comp_ = rhs.comp_;
+                alloc_ = mystl::move(rhs.alloc_);
+                rhs.M_reset_empty();
+            }
+            return *this;
+        }
+
+        ~btree() {
+            clear();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return iterator(leftmost_, 0); }
+        const_iterator begin() const noexcept { return const_iterator(leftmost_, 0); }
+        iterator end() noexcept {
+            return iterator(rightmost_, rightmost_ == nullptr ? 0 : rightmost_->count);
+        }
+        const_iterator end() const noexcept {
+            return const_iterator(rightmost_, rightmost_ == nullptr ? 0 : rightmost_->count);
+        }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return size_ == 0; }
+        size_type size() const noexcept { return size_; }
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(value_type); }
+
+        // 修改容器相关操作
+        template<typename... Args>
+        mystl::pair<iterator, bool> emplace_unique(Args&& ...args) {
+            value_type tmp(mystl::forward<Args>(args)...);
+            return M_find_or_insert(KeyOfValue()(tmp), [&](value_type* p) {
+                mystl::construct(p, mystl::move(tmp));
+            });
+        }
+
+        mystl::pair<iterator, bool> insert_unique(const value_type& value) {
+            return M_find_or_insert(KeyOfValue()(value), [&](value_type* p) {
+                mystl::construct(p, value);
+            });
+        }
+
+        mystl::pair<iterator, bool> insert_unique(value_type&& value) {
+            return M_find_or_insert(KeyOfValue()(value), [&](value_type* p) {
+                mystl::construct(p, mystl::move(value));
+            });
+        }
+
+        // 空树插入严格递增的前向迭代器区间时，自底向上整体建树，不逐个查找与分裂
+        template<typename Iter>
+        void insert_unique(Iter first, Iter last) {
+            M_insert_range(first, last, mystl::iterator_category(first));
+        }
+
+        // 键不存在时以 construct(p) 在 p 上构造元素，construct 构造的元素的键必须等于 key
+        template<typename Construct>
+        mystl::pair<iterator, bool> find_or_insert(const key_type& key, Construct construct) {
+            return M_find_or_insert(key, construct);
+        }
+
+        // 删除一个元素，返回其后继；叶节点下溢时向兄弟节点借元素或与之合并，并沿路径向上调整
+        iterator erase(const_iterator pos) {
+            path_entry path[EBtreeMaxHeight];
+            size_t depth = 0;
+            M_descend(KeyOfValue()(*pos), path, depth);
+            return M_erase_at(path, depth, pos.node, pos.pos);
+        }
+        iterator erase(iterator pos) {
+            return erase(const_iterator(pos));
+        }
+        iterator erase(const_iterator first, const_iterator last) {
+            if(first == begin() && last == end()) {
+                clear();
+                return end();
+            }
+            // 删除会搬移元素，以 last 的键重新定位
+            if(last == end()) {
+                while(first != end())
+                    first = erase(first);
+                return end();
+            }
+            const key_type stop(KeyOfValue()(*last));
+            iterator it(first.node, first.pos);
+            while(comp_(KeyOfValue()(*it), stop))
+                it = erase(it);
+            return it;
+        }
+
+        size_type erase(const key_type& key) {
+            if(root_ == nullptr)
+                return 0;
+            path_entry path[EBtreeMaxHeight];
+            size_t depth = 0;
+            leaf_node* leaf = M_descend(key, path, depth);
+            const size_t pos = M_lower_in(leaf->values(), leaf->count, key, KeyOfValue(), M_linear_search());
+            if(pos == leaf->count || comp_(key, KeyOfValue()(leaf->values()[pos])))
+                return 0;
+            M_erase_at(path, depth, leaf, pos);
+            return 1;
+        }
+
+        void clear() noexcept {
+            if(root_ != nullptr)
+                M_destroy_node(root_);
+            M_reset_empty();
+        }
+
+        void swap(btree& rhs) noexcept {
+            mystl::swap(root_, rhs.root_);
+            mystl::swap(leftmost_, rhs.leftmost_);
+            mystl::swap(rightmost_, rhs.rightmost_);
+            mystl::swap(size_, rhs.size_);
+            mystl::swap(comp_, rhs.comp_);
+            mystl::swap(alloc_, rhs.alloc_);
+        }
+
+        // 查找相关操作
+        iterator find(const key_type& key) {
+            if(root_ == nullptr)
+                return end();
+            leaf_node* leaf = M_find_leaf(key);
+            const size_t pos = M_lower_in(leaf->values(), leaf->count, key, KeyOfValue(), M_linear_search());
+            if(pos == leaf->count || comp_(key, KeyOfValue()(leaf->values()[pos])))
+                return end();
+            return iterator(leaf, pos);
+        }
+        const_iterator find(const key_type& key) const {
+            return const_cast<btree*>(this)->find(key);
+        }
+
+        size_type count(const key_type& key) const { return find(key) == end() ? 0 : 1; }
+        bool contains(const key_type& key) const { return find(key) != end(); }
+
+        iterator lower_bound(const key_type& key) {
+            if(root_ == nullptr)
+                return end();
+            leaf_node* leaf = M_find_leaf(key);
+            return M_normalize(leaf, M_lower_in(leaf->values(), leaf->count, key, KeyOfValue(), M_linear_search()));
+        }
+        const_iterator lower_bound(const key_type& key) const {
+            return const_cast<btree*>(this)->lower_bound(key);
+        }
+
+        iterator upper_bound(const key_type& key) {
+            if(root_ == nullptr)
+                return end();
+            leaf_node* leaf = M_find_leaf(key);
+            return M_normalize(leaf, M_upper_in(leaf->values(), leaf->count, key, KeyOfValue(), M_linear_search()));
+        }
+        const_iterator upper_bound(const key_type& key) const {
+            return const_cast<btree*>(this)->upper_bound(key);
+        }
+
+        mystl::pair<iterator, iterator> equal_range(const key_type& key) {
+            iterator it = lower_bound(key);
+            iterator last = it;
+            if(last != end() && !comp_(key, KeyOfValue()(*last)))
+                ++last;
+            return mystl::pair<iterator, iterator>(it, last);
+        }
+        mystl::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            mystl::pair<iterator, iterator> r = const_cast<btree*>(this)->equal_range(key);
+            return mystl::pair<const_iterator, const_iterator>(r.first, r.second);
+        }
+
+        key_compare key_comp() const { return comp_; }
+        allocator_type get_allocator() const { return alloc_; }
+
+    private:
+        // helper functions
+
+        void M_reset_empty() noexcept {
+            root_ = nullptr;
+            leftmost_ = rightmost_ = nullptr;
+            size_ = 0;
+        }
+
+        // 节点只分配内存并设置头部，元素与键按需构造
+        leaf_node* M_new_leaf() {
+            leaf_node* p = leaf_allocator(alloc_).allocate();
+            ::new(static_cast<void*>(p)) leaf_node;
+            p->count = 0;
+            p->leaf = true;
+            p->prev = p->next = nullptr;
+            return p;
+        }
+
+        inner_node* M_new_inner() {
+            inner_node* p = inner_allocator(alloc_).allocate();
+            ::new(static_cast<void*>(p)) inner_node;
+            p->count = 0;
+            p->leaf = false;
+            return p;
+        }
+
+        void M_free_leaf(leaf_node* p) noexcept {
+            mystl::destroy(p->values(), p->values() + p->count);
+            leaf_allocator(alloc_).deallocate(p);
+        }
+
+        void M_free_inner(inner_node* p) noexcept {
+            mystl::destroy(p->keys(), p->keys() + p->count);
+            inner_allocator(alloc_).deallocate(p);
+        }
+
+        void M_free_node(node_base* p) noexcept {
+            if(p->leaf)
+                M_free_leaf(static_cast<leaf_node*>(p));
+            else
+                M_free_inner(static_cast<inner_node*>(p));
+        }
+
+        void M_destroy_node(node_base* x) noexcept {
+            if(!x->leaf) {
+                inner_node* in = static_cast<inner_node*>(x);
+                for(size_t i = 0; i <= in->count; ++i)
+                    M_destroy_node(in->children[i]);
+            }
+            M_free_node(x);
+        }
+
+        // 节点内查找：[a, a + n) 中第一个键不小于 key（lower）或大于 key（upper）的下标
+        template<typename T, typename Proj>
+        size_t M_lower_in(const T* a, size_t n, const key_type& key, Proj proj, std::true_type) const {
+            size_t r = 0;
+            for(size_t i = 0; i < n; ++i)
+                r += comp_(proj(a[i]), key) ? 1 : 0;
+            return r;
+        }
+        template<typename T, typename Proj>
+        size_t M_lower_in(const T* a, size_t n, const key_type& key, Proj proj, std::false_type) const {
+            size_t lo = 0;
+            while(n != 0) {
+                const size_t half = n >> 1;
+                if(comp_(proj(a[lo + half]), key)) {
+                    lo += half + 1;
+                    n -= half + 1;
+                } else {
+                    n = half;
+                }
+            }
+            return lo;
+        }
+
+        template<typename T, typename Proj>
+        size_t M_upper_in(const T* a, size_t n, const key_type& key, Proj proj, std::true_type) const {
+            size_t r = 0;
+            for(size_t i = 0; i < n; ++i)
+                r += comp_(key, proj(a[i])) ? 0 : 1;
+            return r;
+        }
+        template<typename T, typename Proj>
+        size_t M_upper_in(const T* a, size_t n, const key_type& key, Proj proj, std::false_type) const {
+            size_t lo = 0;
+            while(n != 0) {
+                const size_t half = n >> 1;
+                if(!comp_(key, proj(a[lo + half]))) {
+                    lo += half + 1;
+                    n -= half + 1;
+                } else {
+                    n = half;
+                }
+            }
+            return lo;
+        }
+
+        // 内部节点中 key 所在的子节点：不大于 key 的分隔键个数
+        size_t M_child_index(inner_node* in, const key_type& key) const {
+            return M_upper_in(in->keys(), in->count, key, mystl::identity<Key>(), M_linear_search());
+        }
+
+        leaf_node* M_find_leaf(const key_type& key) const {
+            node_base* x = root_;
+            while(!x->leaf) {
+                inner_node* in = static_cast<inner_node*>(x);
+                x = in->children[M_child_index(in, key)];
+            }
+            return static_cast<leaf_node*>(x);
+        }
+
+        // 与 M_find_leaf 相同，并记录经过的路径
+        leaf_node* M_descend(const key_type& key, path_entry* path, size_t& depth) const {
+            node_base* x = root_;
+            depth = 0;
+            while(!x->leaf) {
+                inner_node* in = static_cast<inner_node*>(x);
+                const size_t i = M_child_index(in, key);
+                path[depth].node = in;
+                path[depth].index = i;
+                ++depth;
+                x = in->children[i];
+            }
+            return static_cast<leaf_node*>(x);
+        }
+
+        // 叶节点末尾的位置转到下一个叶节点的开头，最后一个叶节点的末尾即尾后迭代器
+        iterator M_normalize(leaf_node* leaf, size_t pos) {
+            if(pos == leaf->count && leaf->next != nullptr)
+                return iterator(leaf->next, 0);
+            return iterator(leaf, pos);
+        }
+
+        template<typename Construct>
+        mystl::pair<iterator, bool> M_find_or_insert(const key_type& key, Construct construct) {
+            if(root_ == nullptr) {
+                leaf_node* leaf = M_new_leaf();
+                try {
+                    construct(leaf->values());
+                } catch(...) {
+                    M_free_leaf(leaf);
+                    throw;
+                }
+                leaf->count = 1;
+                root_ = leftmost_ = rightmost_ = leaf;
+                size_ = 1;
+                return mystl::pair<iterator, bool>(iterator(leaf, 0), true);
+            }
+            path_entry path[EBtreeMaxHeight];
+            size_t depth = 0;
+            leaf_node* leaf = M_descend(key, path, depth);
+            const size_t pos = M_lower_in(leaf->values(), leaf->count, key, KeyOfValue(), M_linear_search());
+            if(pos != leaf->count && !comp_(key, KeyOfValue()(leaf->values()[pos])))
+                return mystl::pair<iterator, bool>(iterator(leaf, pos), false);
+            return mystl::pair<iterator, bool>(M_insert_at(path, depth, leaf, pos, key, construct), true);
+        }
+
+        // 在叶节点 leaf 的 pos 处插入新元素，叶节点已满时分裂，分隔键沿路径向上插入
+        // 可能抛出异常的步骤（复制分隔键、分配节点、构造元素）都在改动树之前完成
+        template<typename Construct>
+        iterator M_insert_at(path_entry* path, size_t depth, leaf_node* leaf, size_t pos,
+                             const key_type& key, Construct& construct) {
+            value_type* v = leaf->values();
+            if(leaf->count < leaf_slots) {
+                mystl::relocate_n(v + pos, leaf->count - pos, v + pos + 1);
+                try {
+                    construct(v + pos);
+                } catch(...) {
+                    mystl::relocate_n(v + pos + 1, leaf->count - pos, v + pos);
+                    throw;
+                }
+                ++leaf->count;
+                ++size_;
+                return iterator(leaf, pos);
+            }
+
+            // 在最后一个叶节点的末尾插入时（顺序插入）不均分，左侧保持满的
+            const size_t mid = (leaf == rightmost_ && pos == leaf->count) ? pos : leaf->count / 2;
+            key_type sep(pos == mid ? key : KeyOfValue()(v[mid]));
+            node_base* fresh[EBtreeMaxHeight + 2] = {};
+            const size_t nfresh = M_prepare_split(path, depth, fresh);
+            alignas(value_type) unsigned char buf[sizeof(value_type)];
+            value_type* tmp = reinterpret_cast<value_type*>(buf);
+            try {
+                construct(tmp);
+            } catch(...) {
+                for(size_t i = 0; i < nfresh; ++i)
+                    M_free_node(fresh[i]);
+                throw;
+            }
+
+            leaf_node* right = static_cast<leaf_node*>(fresh[0]);
+            mystl::relocate_n(v + mid, leaf->count - mid, right->values());
+            right->count = static_cast<unsigned short>(leaf->count - mid);
+            leaf->count = static_cast<unsigned short>(mid);
+            right->prev = leaf;
+            right->next = leaf->next;
+            if(right->next != nullptr)
+                right->next->prev = right;
+            else
+                rightmost_ = right;
+            leaf->next = right;
+
+            leaf_node* target = pos < mid ? leaf : right;
+            const size_t at = pos < mid ? pos : pos - mid;
+            value_type* tv = target->values();
+            mystl::relocate_n(tv + at, target->count - at, tv + at + 1);
+            mystl::relocate_n(tmp, 1, tv + at);
+            ++target->count;
+            ++size_;
+
+            M_insert_separator(path, depth, sep, right, fresh + 1);
+            return iterator(target, at);
+        }
+
+        // 预先分配分裂所需的节点：一个叶节点，路径上每个已满的内部节点各一个，根分裂时再加一个新根
+        size_t M_prepare_split(path_entry* path, size_t depth, node_base** fresh) {
+            size_t n = 0;
+            try {
+                fresh[n++] = M_new_leaf();
+                size_t d = depth;
+                while(d != 0 && path[d - 1].node->count == inner_slots) {
+                    fresh[n++] = M_new_inner();
+                    --d;
+                }
+                if(d == 0)
+                    fresh[n++] = M_new_inner();
+            } catch(...) {
+                for(size_t i = 0; i < n; ++i)
+                    M_free_node(fresh[i]);
+                throw;
+            }
+            return n;
+        }
+
+        // 把分隔键 sep 与其右侧的子节点 right 插入到内部节点 x 的第 i 个键处
+        void M_inner_insert(inner_node* x, size_t i, key_type& sep, node_base* right) noexcept {
+            key_type* k = x->keys();
+            mystl::relocate_n(k + i, x->count - i, k + i + 1);
+            mystl::construct(k + i, mystl::move(sep));
+            std::memmove(x->children + i + 2, x->children + i + 1, (x->count - i) * sizeof(node_base*));
+            x->children[i + 1] = right;
+            ++x->count;
+        }
+
+        // 删除内部节点 x 的第 i 个键与其右侧的子节点
+        void M_inner_remove(inner_node* x, size_t i) noexcept {
+            key_type* k = x->keys();
+            mystl::destroy(k + i);
+            mystl::relocate_n(k + i + 1, x->count - i - 1, k + i);
+            std::memmove(x->children + i + 1, x->children + i + 2, (x->count - i - 1) * sizeof(node_base*));
+            --x->count;
+        }
+
+        // 沿路径向上插入分隔键，已满的内部节点分裂，中间的键提升到上一层
+        void M_insert_separator(path_entry* path, size_t depth, key_type& sep, node_base* right,
+                                node_base** fresh) noexcept {
+            for(size_t d = depth; d != 0; --d) {
+                inner_node* x = path[d - 1].node;
+                const size_t i = path[d - 1].index;
+                if(x->count < inner_slots) {
+                    M_inner_insert(x, i, sep, right);
+                    return;
+                }
+                inner_node* r = static_cast<inner_node*>(*fresh++);
+                const size_t mid = inner_slots / 2;
+                key_type* k = x->keys();
+                key_type promoted(mystl::move(k[mid]));
+                mystl::destroy(k + mid);
+                mystl::relocate_n(k + mid + 1, x->count - mid - 1, r->keys());
+                std::memcpy(r->children, x->children + mid + 1, (x->count - mid) * sizeof(node_base*));
+                r->count = static_cast<unsigned short>(x->count - mid - 1);
+                x->count = static_cast<unsigned short>(mid);
+                if(i <= mid)
+                    M_inner_insert(x, i, sep, right);
+                else
+                    M_inner_insert(r, i - mid - 1, sep, right);
+                sep = mystl::move(promoted);
+                right = r;
+            }
+            inner_node* root = static_cast<inner_node*>(*fresh);
+            mystl::construct(root->keys(), mystl::move(sep));
+            root->children[0] = root_;
+            root->children[1] = right;
+            root->count = 1;
+            root_ = root;
+        }
+
+        iterator M_erase_at(path_entry* path, size_t depth, leaf_node* leaf, size_t pos) {
+            value_type* v = leaf->values();
+            mystl::destroy(v + pos);
+            mystl::relocate_n(v + pos + 1, leaf->count - pos - 1, v + pos);
+            --leaf->count;
+            --size_;
+            if(depth == 0) {
+                if(leaf->count == 0) {
+                    M_free_leaf(leaf);
+                    M_reset_empty();
+                    return end();
+                }
+                return iterator(leaf, pos);
+            }
+            iterator next = M_normalize(leaf, pos);
+            if(leaf->count >= M_leaf_min)
+                return next;
+            // 重新平衡会搬移元素，以后继的键重新定位
+            if(next == end()) {
+                M_rebalance(path, depth, leaf);
+                return end();
+            }
+            const key_type k(KeyOfValue()(*next));
+            M_rebalance(path, depth, leaf);
+            return lower_bound(k);
+        }
+
+        // 叶节点下溢：向左右兄弟借一个元素，兄弟也不够时合并，合并使父节点少一个键，沿路径向上重复
+        void M_rebalance(path_entry* path, size_t depth, leaf_node* leaf) {
+            inner_node* p = path[depth - 1].node;
+            const size_t i = path[depth - 1].index;
+            value_type* v = leaf->values();
+            if(i != 0) {
+                leaf_node* left = static_cast<leaf_node*>(p->children[i - 1]);
+                if(left->count > M_leaf_min) {
+                    mystl::relocate_n(v, leaf->count, v + 1);
+                    mystl::relocate_n(left->values() + left->count - 1, 1, v);
+                    --left->count;
+                    ++leaf->count;
+                    p->keys()[i - 1] = KeyOfValue()(v[0]);
+                    return;
+                }
+            }
+            if(i != p->count) {
+                leaf_node* right = static_cast<leaf_node*>(p->children[i + 1]);
+                if(right->count > M_leaf_min) {
+                    value_type* rv = right->values();
+                    mystl::relocate_n(rv, 1, v + leaf->count);
+                    mystl::relocate_n(rv + 1, right->count - 1, rv);
+                    --right->count;
+                    ++leaf->count;
+                    p->keys()[i] = KeyOfValue()(rv[0]);
+                    return;
+                }
+            }
+            M_merge_leaves(p, i != 0 ? i - 1 : i);
+
+            for(size_t d = depth - 1; ; --d) {
+                inner_node* x = path[d].node;
+                if(d == 0) {
+                    if(x->count == 0) {
+                        root_ = x->children[0];
+                        M_free_inner(x);
+                    }
+                    return;
+                }
+                if(x->count >= M_inner_min)
+                    return;
+                inner_node* pp = path[d - 1].node;
+                const size_t j = path[d - 1].index;
+                if(j != 0) {
+                    inner_node* left = static_cast<inner_node*>(pp->children[j - 1]);
+                    if(left->count > M_inner_min) {
+                        M_rotate_right(pp, j - 1, left, x);
+                        return;
+                    }
+                }
+                if(j != pp->count) {
+                    inner_node* right = static_cast<inner_node*>(pp->children[j + 1]);
+                    if(right->count > M_inner_min) {
+                        M_rotate_left(pp, j, x, right);
+                        return;
+                    }
+                }
+                M_merge_inners(pp, j != 0 ? j - 1 : j);
+            }
+        }
+
+        // 合并父节点 p 的第 k、k + 1 个子叶节点
+        void M_merge_leaves(inner_node* p, size_t k) noexcept {
+            leaf_node* left = static_cast<leaf_node*>(p->children[k]);
+            leaf_node* right = static_cast<leaf_node*>(p->children[k + 1]);
+            mystl::relocate_n(right->values(), right->count, left->values() + left->count);
+            left->count = static_cast<unsigned short>(left->count + right->count);
+            right->count = 0;
+            left->next = right->next;
+            if(left->next != nullptr)
+                left->next->prev = left;
+            else
+                rightmost_ = left;
+            M_free_leaf(right);
+            M_inner_remove(p, k);
+        }
+
+        // 左兄弟 left 的最后一个子节点经父节点的第 k 个键转给 x
+        void M_rotate_right(inner_node* p, size_t k, inner_node* left, inner_node* x) noexcept {
+            key_type* xk = x->keys();
+            mystl::relocate_n(xk, x->count, xk + 1);
+            mystl::construct(xk, mystl::move(p->keys()[k]));
+            std::memmove(x->children + 1, x->children, (x->count + 1) * sizeof(node_base*));
+            x->children[0] = left->children[left->count];
+            ++x->count;
+            key_type* lk = left->keys() + left->count - 1;
+            p->keys()[k] = mystl::move(*lk);
+            mystl::destroy(lk);
+            --left->count;
+        }
+
+        // 右兄弟 right 的第一个子节点经父节点的第 k 个键转给 x
+        void M_rotate_left(inner_node* p, size_t k, inner_node* x, inner_node* right) noexcept {
+            mystl::construct(x->keys() + x->count, mystl::move(p->keys()[k]));
+            x->children[x->count + 1] = right->children[0];
+            ++x->count;
+            key_type* rk = right->keys();
+            p->keys()[k] = mystl::move(rk[0]);
+            mystl::destroy(rk);
+            mystl::relocate_n(rk + 1, right->count - 1, rk);
+            std::memmove(right->children, right->children + 1, right->count * sizeof(node_base*));
+            --right->count;
+        }
+
+        // 合并父节点 p 的第 k、k + 1 个子内部节点，父节点的第 k 个键下移到两者之间
+        void M_merge_inners(inner_node* p, size_t k) noexcept {
+            inner_node* left = static_cast<inner_node*>(p->children[k]);
+            inner_node* right = static_cast<inner_node*>(p->children[k + 1]);
+            mystl::construct(left->keys() + left->count, mystl::move(p->keys()[k]));
+            mystl::relocate_n(right->keys(), right->count, left->keys() + left->count + 1);
+            std::memcpy(left->children + left->count + 1, right->children, (right->count + 1) * sizeof(node_base*));
+            left->count = static_cast<unsigned short>(left->count + right->count + 1);
+            right->count = 0;
+            M_free_inner(right);
+            M_inner_remove(p, k);
+        }
+
+        template<typename Iter>
+        void M_insert_range(Iter first, Iter last, mystl::input_iterator_tag) {
+            for(; first != last; ++first)
+                insert_unique(*first);
+        }
+
+        template<typename Iter>
+        void M_insert_range(Iter first, Iter last, mystl::forward_iterator_tag) {
+            if(empty() && first != last && M_is_sorted_unique(first, last)) {
+                M_build_sorted(first, static_cast<size_type>(mystl::distance(first, last)));
+                return;
+            }
+            for(; first != last; ++first)
+                insert_unique(*first);
+        }
+
+        template<typename Iter>
+        bool M_is_sorted_unique(Iter first, Iter last) const {
+            Iter prev = first;
+            for(++first; first != last; ++first, ++prev) {
+                if(!comp_(KeyOfValue()(*prev), KeyOfValue()(*first)))
+                    return false;
+            }
+            return true;
+        }
+
+        // 以严格递增的 n 个元素自底向上建树：元素依次填满叶节点（余数均摊到前面的叶节点），
+        // 每层的节点再均分到上一层，每个节点的第一个分隔键提升到上一层；树必须为空
+        template<typename Iter>
+        void M_build_sorted(Iter first, size_type n) {
+            const size_type nleaves = (n + leaf_slots - 1) / leaf_slots;
+            mystl::vector<node_base*> nodes;
+            mystl::vector<key_type> seps;
+            mystl::vector<inner_node*> inners;
+            nodes.reserve(nleaves);
+            seps.reserve(nleaves);
+            inners.reserve(nleaves);
+            try {
+                leaf_node* prev = nullptr;
+                for(size_type j = 0; j < nleaves; ++j) {
+                    leaf_node* leaf = M_new_leaf();
+                    leaf->prev = prev;
+                    if(prev != nullptr)
+                        prev->next = leaf;
+                    else
+                        leftmost_ = leaf;
+                    rightmost_ = leaf;
+                    prev = leaf;
+                    nodes.push_back(leaf);
+                    const size_type cnt = n / nleaves + (j < n % nleaves ? 1 : 0);
+                    for(size_type k = 0; k < cnt; ++k, ++first) {
+                        mystl::construct(leaf->values() + k, *first);
+                        ++leaf->count;
+                    }
+                    seps.push_back(KeyOfValue()(leaf->values()[0]));
+                }
+                while(nodes.size() > 1) {
+                    const size_type m = nodes.size();
+                    const size_type g = (m + inner_slots) / (inner_slots + 1);
+                    size_type c = 0;
+                    for(size_type j = 0; j < g; ++j) {
+                        const size_type cnt = m / g + (j < m % g ? 1 : 0);
+                        inner_node* x = M_new_inner();
+                        inners.push_back(x);
+                        x->children[0] = nodes[c];
+                        for(size_type t = 1; t < cnt; ++t) {
+                            mystl::construct(x->keys() + t - 1, mystl::move(seps[c + t]));
+                            x->children[t] = nodes[c + t];
+                            ++x->count;
+                        }
+                        // 本层的第 j 个节点与它的分隔键，覆盖已经读过的位置
+                        nodes[j] = x;
+                        if(j != c)
+                            seps[j] = mystl::move(seps[c]);
+                        c += cnt;
+                    }
+                    nodes.erase(nodes.begin() + g, nodes.end());
+                    seps.erase(seps.begin() + g, seps.end());
+                }
+            } catch(...) {
+                for(size_type j = 0; j < inners.size(); ++j)
+                    M_free_inner(inners[j]);
+                for(leaf_node* leaf = leftmost_; leaf != nullptr; ) {
+                    leaf_node* next = leaf->next;
+                    M_free_leaf(leaf);
+                    leaf = next;
+                }
+                M_reset_empty();
+                throw;
+            }
+            root_ = nodes[0];
+            size_ = n;
+        }
+    };
+
+} // namespace mystl
+
+#endif // MY_TINY_BTREE_H_
@@ -0,0 +1,261 @@
+#ifndef MY_TINY_BTREE_MAP_H_
+#define MY_TINY_BTREE_MAP_H_
+
+// 这个头文件包含一个模板类 btree_map
+// btree_map : 有序映射，元素按键排序存放在 B+ 树的叶节点中，底层实现为 btree
+// 与红黑树实现的有序映射不同，插入与删除之后，指向元素的迭代器、指针与引用都可能失效
+
+#include <initializer_list>
+#include <stdexcept>
+
+#include "btree.h"
+#include "algobase.h"
+#include "functional.h"
+#include "allocator.h"
+#include "util.h"
+
+namespace mystl {
+
+    // 模板类 btree_map，键值不允许重复
+    // 参数一代表键值类型，参数二代表实值类型，参数三代表键值比较方式，缺省使用 mystl::less，参数四代表空间配置器
+    template<typename Key, typename T, typename Compare = mystl::less<Key>,
+             typename Alloc = mystl::allocator<mystl::pair<const Key, T>>>
+    class btree_map {
+    private:
+        typedef btree<mystl::pair<const Key, T>, Key, mystl::selectfirst<mystl::pair<const Key, T>>,
+                      Compare, Alloc> base_type;
+        base_type tree_;
+
+    public:
+        typedef typename base_type::allocator_type          allocator_type;
+        typedef typename base_type::key_type                key_type;
+        typedef T                                           mapped_type;
+        typedef typename base_type::value_type              value_type;
+        typedef typename base_type::key_compare             key_compare;
+
+        typedef typename base_type::size_type               size_type;
+        typedef typename base_type::difference_type         difference_type;
+        typedef typename base_type::pointer                 pointer;
+        typedef typename base_type::const_pointer           const_pointer;
+        typedef typename base_type::reference               reference;
+        typedef typename base_type::const_reference         const_reference;
+
+        typedef typename base_type::iterator                iterator;
+        typedef typename base_type::const_iterator          const_iterator;
+        typedef typename base_type::reverse_iterator        reverse_iterator;
+        typedef typename base_type::const_reverse_iterator  const_reverse_iterator;
+
+        // 按键比较元素
+        class value_compare : public binary_function<value_type, value_type, bool> {
+            friend class btree_map<Key, T, Compare, Alloc>;
+        private:
+            Compare comp;
+            value_compare(Compare c) : comp(c) {}
+        public:
+            bool operator()(const value_type& lhs, const value_type& rhs) const {
+                return comp(lhs.first, rhs.first);
+            }
+        };
+
+    public:
+        // 构造、复制、移动函数
+        btree_map() : tree_() {}
+
+        explicit btree_map(const key_compare& comp, const allocator_type& alloc = allocator_type())
+            : tree_(comp, alloc) {}
+
+        // 空映射插入严格递增的前向迭代器区间时整体建树
+        template<typename Iter, typename std::enable_if<
+            mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        btree_map(Iter first, Iter last, const key_compare& comp = key_compare(),
+            const allocator_type& alloc = allocator_type())
+            : tree_(comp, alloc) {
+            tree_.insert_unique(first, last);
+        }
+
+        btree_map(std::initializer_list<value_type> ilist, const key_compare& comp = key_compare(),
+            const allocator_type& alloc = allocator_type())
+            : tree_(comp, alloc) {
+            tree_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        btree_map(const btree_map& rhs) : tree_(rhs.tree_) {}
+        btree_map(btree_map&& rhs) noexcept : tree_(mystl::move(rhs.tree_)) {}
+
+        btree_map& operator=(const btree_map& rhs) {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+        btree_map& operator=(btree_map&& rhs) noexcept {
+            tree_ = mystl::move(rhs.tree_);
+            return *this;
+        }
+        btree_map& operator=(std::initializer_list<value_type> ilist) {
+            tree_.clear();
+            tree_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~btree_map() = default;
+
+        // 迭代器相关
+        iterator begin() noexcept { return tree_.begin(); }
+        const_iterator begin() const noexcept { return tree_.begin(); }
+        iterator end() noexcept { return tree_.end(); }
+        const_iterator end() const noexcept { return tree_.end(); }
+
+        reverse_iterator rbegin() noexcept { return tree_.rbegin(); }
+        const_reverse_iterator rbegin() const noexcept { return tree_.rbegin(); }
+        reverse_iterator rend() noexcept { return tree_.rend(); }
+        const_reverse_iterator rend() const noexcept { return tree_.rend(); }
+
+        const_iterator cbegin() const noexcept { return tree_.cbegin(); }
+        const_iterator cend() const noexcept { return tree_.cend(); }
+        const_reverse_iterator crbegin() const noexcept { return tree_.rbegin(); }
+        const_reverse_iterator crend() const noexcept { return tree_.rend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return tree_.empty(); }
+        size_type size() const noexcept { return tree_.size(); }
+        size_type max_size() const noexcept { return tree_.max_size(); }
+
+        // 修改容器操作
+
+        // emplace
+        template<typename ...Args>
+        mystl::pair<iterator, bool> emplace(Args&& ...args) {
+            return tree_.emplace_unique(mystl::forward<Args>(args)...);
+        }
+
+        // 键不存在时以 key 与 args 构造元素，键已存在时不构造任何对象
+        template<typename ...Args>
+        mystl::pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args) {
+            return tree_.find_or_insert(key, [&](value_type* p) {
+                mystl::construct(p, key, mapped_type(mystl::forward<Args>(args)...));
+            });
+        }
+        template<typename ...Args>
+        mystl::pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args) {
+            return tree_.find_or_insert(key, [&](value_type* p) {
+                mystl::construct(p, mystl::move(key), mapped_type(mystl::forward<Args>(args)...));
+            });
+        }
+
+        // insert
+        mystl::pair<iterator, bool> insert(const value_type& value) {
+            return tree_.insert_unique(value);
+        }
+        mystl::pair<iterator, bool> insert(value_type&& value) {
+            return tree_.insert_unique(mystl::move(value));
+        }
+
+        template<typename Iter>
+        void insert(Iter first, Iter last) {
+            tree_.insert_unique(first, last);
+        }
+        void insert(std::initializer_list<value_type> ilist) {
+            tree_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        // 键已存在时把 obj 赋给它的实值
+        template<typename M>
+        mystl::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+            mystl::pair<iterator, bool> r = try_emplace(key, mystl::forward<M>(obj));
+            if(!r.second)
+                r.first->second = mystl::forward<M>(obj);
+            return r;
+        }
+
+        // erase / clear
+        iterator erase(iterator pos) { return tree_.erase(pos); }
+        iterator erase(const_iterator pos) { return tree_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return tree_.erase(first, last); }
+        size_type erase(const key_type& key) { return tree_.erase(key); }
+
+        void clear() noexcept { tree_.clear(); }
+
+        void swap(btree_map& rhs) noexcept { tree_.swap(rhs.tree_); }
+
+        // 查找相关
+        mapped_type& at(const key_type& key) {
+            iterator it = tree_.find(key);
+            if(it == tree_.end()) throw std::out_of_range("btree_map<Key, T> no such element exists");
+            return it->second;
+        }
+        const mapped_type& at(const key_type& key) const {
+            const_iterator it = tree_.find(key);
+            if(it == tree_.end()) throw std::out_of_range("btree_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        mapped_type& operator[](const key_type& key) {
+            return try_emplace(key).first->second;
+        }
+        mapped_type& operator[](key_type&& key) {
+            return try_emplace(mystl::move(key)).first->second;
+        }
+
+        iterator find(const key_type& key) { return tree_.find(key); }
+        const_iterator find(const key_type& key) const { return tree_.find(key); }
+
+        size_type count(const key_type& key) const { return tree_.count(key); }
+        bool contains(const key_type& key) const { return tree_.contains(key); }
+
+        iterator lower_bound(const key_type& key) { return tree_.lower_bound(key); }
+        const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+        iterator upper_bound(const key_type& key) { return tree_.upper_bound(key); }
+        const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+        mystl::pair<iterator, iterator> equal_range(const key_type& key) {
+            return tree_.equal_range(key);
+        }
+        mystl::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            return tree_.equal_range(key);
+        }
+
+        key_compare key_comp() const { return tree_.key_comp(); }
+        value_compare value_comp() const { return value_compare(tree_.key_comp()); }
+        allocator_type get_allocator() const { return tree_.get_allocator(); }
+    };
+
+    // 重载比较操作符
+    template<typename Key, typename T, typename Compare, typename Alloc>
+    bool operator==(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs) {
+        return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<typename Key, typename T, typename Compare, typename Alloc>
+    bool operator<(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs) {
+        return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<typename Key, typename T, typename Compare, typename Alloc>
+    bool operator!=(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<typename Key, typename T, typename Compare, typename Alloc>
+    bool operator>(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs) {
+        return rhs < lhs;
+    }
+
+    template<typename Key, typename T, typename Compare, typename Alloc>
+    bool operator<=(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<typename Key, typename T, typename Compare, typename Alloc>
+    bool operator>=(const btree_map<Key, T, Compare, Alloc>& lhs, const btree_map<Key, T, Compare, Alloc>& rhs) {
+        return !(lhs < rhs);
+    }
+
+    // 重载 mystl 的 swap
+    template<typename Key, typename T, typename Compare, typename Alloc>
+    void swap(btree_map<Key, T, Compare, Alloc>& lhs, btree_map<Key, T, Compare, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+
+#endif // MY_TINY_BTREE_MAP_H_
@@ -0,0 +1,198 @@
+#ifndef MY_TINY_BTREE_SET_H_
+#define MY_TINY_BTREE_SET_H_
+
+// 这个头文件包含一个模板类 btree_set
+// btree_set : 有序集合，元素按键排序存放在 B+ 树的叶节点中，底层实现为 btree
+// 与红黑树实现的有序集合不同，插入与删除之后，指向元素的迭代器、指针与引用都可能失效
+
+#include <initializer_list>
+
+#include "btree.h"
+#include "algobase.h"
+#include "functional.h"
+#include "allocator.h"
+#include "util.h"
+
+namespace mystl {
+
+    // 模板类 btree_set，键值不允许重复
+    // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，参数三代表空间配置器
+    template<typename Key, typename Compare = mystl::less<Key>, typename Alloc = mystl::allocator<Key>>
+    class btree_set {
+    private:
+        typedef btree<Key, Key, mystl::identity<Key>, Compare, Alloc> base_type;
+        base_type tree_;
+
+    public:
+        typedef typename base_type::allocator_type          allocator_type;
+        typedef typename base_type::key_type                key_type;
+        typedef typename base_type::value_type              value_type;
+        typedef typename base_type::key_compare             key_compare;
+        typedef typename base_type::key_compare             value_compare;
+
+        typedef typename base_type::size_type               size_type;
+        typedef typename base_type::difference_type         difference_type;
+        typedef typename base_type::const_pointer           pointer;
+        typedef typename base_type::const_pointer           const_pointer;
+        typedef typename base_type::const_reference         reference;
+        typedef typename base_type::const_reference         const_reference;
+
+        // 元素即键，不允许通过迭代器修改
+        typedef typename base_type::const_iterator          iterator;
+        typedef typename base_type::const_iterator          const_iterator;
+        typedef typename base_type::const_reverse_iterator  reverse_iterator;
+        typedef typename base_type::const_reverse_iterator  const_reverse_iterator;
+
+    public:
+        // 构造、复制、移动函数
+        btree_set() : tree_() {}
+
+        explicit btree_set(const key_compare& comp, const allocator_type& alloc = allocator_type())
+            : tree_(comp, alloc) {}
+
+        // 空集合插入严格递增的前向迭代器区间时整体建树
+        template<typename Iter, typename std::enable_if<
+            mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        btree_set(Iter first, Iter last, const key_compare& comp = key_compare(),
+            const allocator_type& alloc = allocator_type())
+            : tree_(comp, alloc) {
+            tree_.insert_unique(first, last);
+        }
+
+        btree_set(std::initializer_list<value_type> ilist, const key_compare& comp = key_compare(),
+            const allocator_type& alloc = allocator_type())
+            : tree_(comp, alloc) {
+            tree_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        btree_set(const btree_set& rhs) : tree_(rhs.tree_) {}
+        btree_set(btree_set&& rhs) noexcept : tree_(mystl::move(rhs.tree_)) {}
+
+        btree_set& operator=(const btree_set& rhs) {
+            tree_ = rhs.tree_;
+            return *this;
+        }
+        btree_set& operator=(btree_set&& rhs) noexcept {
+            tree_ = mystl::move(rhs.tree_);
+            return *this;
+        }
+        btree_set& operator=(std::initializer_list<value_type> ilist) {
+            tree_.clear();
+            tree_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~btree_set() = default;
+
+        // 迭代器相关
+        iterator begin() const noexcept { return tree_.begin(); }
+        iterator end() const noexcept { return tree_.end(); }
+        reverse_iterator rbegin() const noexcept { return tree_.rbegin(); }
+        reverse_iterator rend() const noexcept { return tree_.rend(); }
+
+        const_iterator cbegin() const noexcept { return tree_.cbegin(); }
+        const_iterator cend() const noexcept { return tree_.cend(); }
+        const_reverse_iterator crbegin() const noexcept { return tree_.rbegin(); }
+        const_reverse_iterator crend() const noexcept { return tree_.rend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return tree_.empty(); }
+        size_type size() const noexcept { return tree_.size(); }
+        size_type max_size() const noexcept { return tree_.max_size(); }
+
+        // 修改容器操作
+
+        // emplace
+        template<typename ...Args>
+        mystl::pair<iterator, bool> emplace(Args&& ...args) {
+            return M_const_result(tree_.emplace_unique(mystl::forward<Args>(args)...));
+        }
+
+        // insert
+        mystl::pair<iterator, bool> insert(const value_type& value) {
+            return M_const_result(tree_.insert_unique(value));
+        }
+        mystl::pair<iterator, bool> insert(value_type&& value) {
+            return M_const_result(tree_.insert_unique(mystl::move(value)));
+        }
+
+        template<typename Iter>
+        void insert(Iter first, Iter last) {
+            tree_.insert_unique(first, last);
+        }
+        void insert(std::initializer_list<value_type> ilist) {
+            tree_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        // erase / clear
+        iterator erase(const_iterator pos) { return tree_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return tree_.erase(first, last); }
+        size_type erase(const key_type& key) { return tree_.erase(key); }
+
+        void clear() noexcept { tree_.clear(); }
+
+        void swap(btree_set& rhs) noexcept { tree_.swap(rhs.tree_); }
+
+        // 查找相关
+        const_iterator find(const key_type& key) const { return tree_.find(key); }
+
+        size_type count(const key_type& key) const { return tree_.count(key); }
+        bool contains(const key_type& key) const { return tree_.contains(key); }
+
+        const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+        const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+        mystl::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+            return tree_.equal_range(key);
+        }
+
+        key_compare key_comp() const { return tree_.key_comp(); }
+        value_compare value_comp() const { return tree_.key_comp(); }
+        allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+    private:
+        static mystl::pair<iterator, bool> M_const_result(const mystl::pair<typename base_type::iterator, bool>& r) {
+            return mystl::pair<iterator, bool>(r.first, r.second);
+        }
+    };
+
+    // 重载比较操作符
+    template<typename Key, typename Compare, typename Alloc>
+    bool operator==(const btree_set<Key, Compare, Alloc>& lhs, const btree_set<Key, Compare, Alloc>& rhs) {
+        return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<typename Key, typename Compare, typename Alloc>
+    bool operator<(const btree_set<Key, Compare, Alloc>& lhs, const btree_set<Key, Compare, Alloc>& rhs) {
+        return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<typename Key, typename Compare, typename Alloc>
+    bool operator!=(const btree_set<Key, Compare, Alloc>& lhs, const btree_set<Key, Compare, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<typename Key, typename Compare, typename Alloc>
+    bool operator>(const btree_set<Key, Compare, Alloc>& lhs, const btree_set<Key, Compare, Alloc>& rhs) {
+        return rhs < lhs;
+    }
+
+    template<typename Key, typename Compare, typename Alloc>
+    bool operator<=(const btree_set<Key, Compare, Alloc>& lhs, const btree_set<Key, Compare, Alloc>& rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<typename Key, typename Compare, typename Alloc>
+    bool operator>=(const btree_set<Key, Compare, Alloc>& lhs, const btree_set<Key, Compare, Alloc>& rhs) {
+        return !(lhs < rhs);
+    }
+
+    // 重载 mystl 的 swap
+    template<typename Key, typename Compare, typename Alloc>
+    void swap(btree_set<Key, Compare, Alloc>& lhs, btree_set<Key, Compare, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+
+#endif // MY_TINY_BTREE_SET_H_
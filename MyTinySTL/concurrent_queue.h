@@ -0,0 +1,370 @@
+#ifndef MY_TINY_CONCURRENT_QUEUE_H_
+#define MY_TINY_CONCURRENT_QUEUE_H_
+
+// 这个头文件包含两个有界的无锁队列
+// spsc_ring  : 单生产者单消费者的环形缓冲区，push 与 pop 都是 wait-free 的
+// mpmc_queue : 多生产者多消费者的有界队列，每个槽带有序号（Dmitry Vyukov 的算法）
+// 容量上调为 2 的幂，空间由 allocator 分配，元素以 construct / destroy 在槽上原地构造、析构
+// try_ 系列函数不阻塞，队列满（空）时返回 false；_n 系列函数一次处理多个元素，返回实际处理的个数
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+
+namespace mystl {
+
+    // 生产者与消费者各自修改的数据放在不同的缓存行，避免伪共享
+    enum { EQueueCachelineSize = 64 };
+
+    // 把容量上调为 2 的幂，至少为 2
+    inline size_t queue_round_capacity(size_t n) {
+        if(n > (static_cast<size_t>(-1) >> 1) + 1)
+            throw std::length_error("concurrent queue capacity too big");
+        size_t cap = 2;
+        while(cap < n)
+            cap <<= 1;
+        return cap;
+    }
+
+    /*****************************************************************************************/
+    // spsc_ring
+
+    // 模板类：spsc_ring
+    // 只允许一个线程 push、一个线程 pop；头尾下标只增不减，对容量取模得到槽的位置
+    // 生产者缓存消费者的下标，只有缓存的值显示队列已满时才重新读取，消费者同理，
+    // 因此多数操作只访问本线程所在的缓存行
+    template<typename T, typename Alloc = mystl::allocator<T>>
+    class spsc_ring {
+    public:
+        typedef T                   value_type;
+        typedef Alloc               allocator_type;
+        typedef size_t              size_type;
+
+    private:
+        // 只读部分
+        alignas(EQueueCachelineSize) T* slots_;
+        size_type mask_;
+        allocator_type alloc_;
+
+        // 生产者：写入的下标，以及读到的消费者下标
+        alignas(EQueueCachelineSize) std::atomic<size_type> tail_;
+        size_type head_cache_;
+
+        // 消费者：读取的下标，以及读到的生产者下标
+        alignas(EQueueCachelineSize) std::atomic<size_type> head_;
+        size_type tail_cache_;
+
+    public:
+        explicit spsc_ring(size_type capacity, const allocator_type& alloc = allocator_type())
+            : slots_(nullptr), mask_(queue_round_capacity(capacity) - 1), alloc_(alloc),
+              tail_(0), head_cache_(0), head_(0), tail_cache_(0) {
+            slots_ = alloc_.allocate(mask_ + 1);
+        }
+
+        spsc_ring(const spsc_ring&) = delete;
+        spsc_ring& operator=(const spsc_ring&) = delete;
+
+        ~spsc_ring() {
+            const size_type tail = tail_.load(std::memory_order_relaxed);
+            for(size_type i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+                mystl::destroy(slots_ + (i & mask_));
+            }
+            alloc_.deallocate(slots_, mask_ + 1);
+        }
+
+        size_type capacity() const noexcept { return mask_ + 1; }
+
+        // 其它线程同时操作时只是一个近似值
+        size_type size_approx() const noexcept {
+            const size_type head = head_.load(std::memory_order_acquire);
+            const size_type tail = tail_.load(std::memory_order_acquire);
+            return tail - head;
+        }
+        bool empty() const noexcept { return size_approx() == 0; }
+
+        // 生产者调用
+        template<typename... Args>
+        bool try_emplace(Args&& ...args) {
+            const size_type tail = tail_.load(std::memory_order_relaxed);
+            if(tail - head_cache_ > mask_) {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if(tail - head_cache_ > mask_)
+                    return false;
+            }
+            mystl::construct(slots_ + (tail & mask_), mystl::forward<Args>(args)...);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_push(const value_type& value) { return try_emplace(value); }
+        bool try_push(value_type&& value) { return try_emplace(mystl::move(value)); }
+
+        // 从 first 开始复制至多 n 个元素，只在最后发布一次下标
+        template<typename Iter>
+        size_type try_push_n(Iter first, size_type n) {
+            const size_type tail = tail_.load(std::memory_order_relaxed);
+            if(mask_ + 1 - (tail - head_cache_) < n)
+                head_cache_ = head_.load(std::memory_order_acquire);
+            const size_type free = mask_ + 1 - (tail - head_cache_);
+            if(n > free)
+                n = free;
+            size_type i = 0;
+            try {
+                for(; i < n; ++i, ++first) {
+                    mystl::construct(slots_ + ((tail + i) & mask_), *first);
+                }
+            } catch(...) {
+                tail_.store(tail + i, std::memory_order_release);
+                throw;
+            }
+            tail_.store(tail + n, std::memory_order_release);
+            return n;
+        }
+
+        // 消费者调用
+        bool try_pop(value_type& value) {
+            const size_type head = head_.load(std::memory_order_relaxed);
+            if(head == tail_cache_) {
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if(head == tail_cache_)
+                    return false;
+            }
+            T* p = slots_ + (head & mask_);
+            value = mystl::move(*p);
+            mystl::destroy(p);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 把至多 n 个元素移到 out 开始的位置，只在最后发布一次下标
+        template<typename Iter>
+        size_type try_pop_n(Iter out, size_type n) {
+            const size_type head = head_.load(std::memory_order_relaxed);
+            if(tail_cache_ - head < n)
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+            const size_type avail = tail_cache_ - head;
+            if(n > avail)
+                n = avail;
+            size_type i = 0;
+            try {
+                for(; i < n; ++i, ++out) {
+                    T* p = slots_ + ((head + i) & mask_);
+                    *out = mystl::move(*p);
+                    mystl::destroy(p);
+                }
+            } catch(...) {
+                head_.store(head + i, std::memory_order_release);
+                throw;
+            }
+            head_.store(head + n, std::memory_order_release);
+            return n;
+        }
+    };
+
+    /*****************************************************************************************/
+    // mpmc_queue
+
+    // 模板类：mpmc_queue
+    // 槽的序号 seq 记录槽的状态：seq == pos 时可写入第 pos 个元素，seq == pos + 1 时可读出，
+    // 读出后设为 pos + capacity，等待下一轮写入
+    // 生产者（消费者）以 CAS 推进写（读）下标来占有槽，占有之后只与该槽的另一方同步
+    // 已占有的槽必须完成写入（读出），因此 T 的移动构造不能抛出异常；
+    // 构造可能抛出异常时先构造临时对象，再占有槽
+    template<typename T, typename Alloc = mystl::allocator<T>>
+    class mpmc_queue {
+        static_assert(std::is_nothrow_move_constructible<T>::value,
+                      "mpmc_queue<T> requires a nothrow move constructible T");
+
+    public:
+        typedef T                   value_type;
+        typedef Alloc               allocator_type;
+        typedef size_t              size_type;
+
+    private:
+        struct cell {
+            std::atomic<size_type> seq;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* value() noexcept { return reinterpret_cast<T*>(storage); }
+        };
+
+        typedef typename Alloc::template rebind<cell>::other   cell_allocator;
+
+        // 只读部分
+        alignas(EQueueCachelineSize) cell* cells_;
+        size_type mask_;
+        cell_allocator alloc_;
+
+        alignas(EQueueCachelineSize) std::atomic<size_type> enqueue_pos_;
+        alignas(EQueueCachelineSize) std::atomic<size_type> dequeue_pos_;
+
+    public:
+        explicit mpmc_queue(size_type capacity, const allocator_type& alloc = allocator_type())
+            : cells_(nullptr), mask_(queue_round_capacity(capacity) - 1), alloc_(alloc),
+              enqueue_pos_(0), dequeue_pos_(0) {
+            cells_ = alloc_.allocate(mask_ + 1);
+            for(size_type i = 0; i <= mask_; ++i) {
+                ::new (static_cast<void*>(&cells_[i].seq)) std::atomic<size_type>(i);
+            }
+        }
+
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+        ~mpmc_queue() {
+            const size_type tail = enqueue_pos_.load(std::memory_order_relaxed);
+            for(size_type i = dequeue_pos_.load(std::memory_order_relaxed); i != tail; ++i) {
+                mystl::destroy(cells_[i & mask_].value());
+            }
+            alloc_.deallocate(cells_, mask_ + 1);
+        }
+
+        size_type capacity() const noexcept { return mask_ + 1; }
+
+        // 其它线程同时操作时只是一个近似值
+        size_type size_approx() const noexcept {
+            const size_type head = dequeue_pos_.load(std::memory_order_acquire);
+            const size_type tail = enqueue_pos_.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+        bool empty() const noexcept { return size_approx() == 0; }
+
+        template<typename... Args>
+        bool try_emplace(Args&& ...args) {
+            return M_emplace(std::integral_constant<bool,
+                std::is_nothrow_constructible<T, Args&&...>::value>(), mystl::forward<Args>(args)...);
+        }
+
+        bool try_push(const value_type& value) { return try_emplace(value); }
+        bool try_push(value_type&& value) { return try_emplace(mystl::move(value)); }
+
+        // 一次占有至多 n 个连续的槽，从 first 开始复制元素
+        template<typename Iter>
+        size_type try_push_n(Iter first, size_type n) {
+            return M_push_n(first, n, std::integral_constant<bool,
+                std::is_nothrow_constructible<T, decltype(*first)>::value>());
+        }
+
+        bool try_pop(value_type& value) {
+            size_type pos;
+            if(M_claim(dequeue_pos_, 1, 1, pos) == 0)
+                return false;
+            M_take(pos, value);
+            return true;
+        }
+
+        // 一次占有至多 n 个连续的槽，把元素移到 out 开始的位置
+        // 赋值抛出异常时，已占有但未读出的元素被丢弃
+        template<typename Iter>
+        size_type try_pop_n(Iter out, size_type n) {
+            size_type pos;
+            n = M_claim(dequeue_pos_, 1, n, pos);
+            size_type i = 0;
+            try {
+                for(; i < n; ++i, ++out) {
+                    M_take(pos + i, *out);
+                }
+            } catch(...) {
+                for(++i; i < n; ++i) {
+                    M_release(pos + i);
+                }
+                throw;
+            }
+            return n;
+        }
+
+    private:
+        // 槽的序号与期望值之差：为 0 时可用，小于 0 表示队列满（空），大于 0 表示下标已过期
+        std::intptr_t M_diff(size_type pos, size_type ready) const {
+            const size_type seq = cells_[pos & mask_].seq.load(std::memory_order_acquire);
+            return static_cast<std::intptr_t>(seq - (pos + ready));
+        }
+
+        // 从 counter 当前的下标起数出至多 n 个可用的连续槽，以 CAS 占有，返回占有的个数
+        // 可用的槽只会被占有它的线程修改，CAS 成功说明数出的槽仍然可用
+        size_type M_claim(std::atomic<size_type>& counter, size_type ready, size_type n, size_type& pos) {
+            if(n == 0)
+                return 0;
+            pos = counter.load(std::memory_order_relaxed);
+            for(;;) {
+                const std::intptr_t diff = M_diff(pos, ready);
+                if(diff < 0)
+                    return 0;
+                if(diff > 0) {
+                    pos = counter.load(std::memory_order_relaxed);
+                    continue;
+                }
+                size_type k = 1;
+                while(k < n && k <= mask_ && M_diff(pos + k, ready) == 0) {
+                    ++k;
+                }
+                if(counter.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed))
+                    return k;
+            }
+        }
+
+        template<typename... Args>
+        bool M_emplace(std::true_type, Args&& ...args) {
+            size_type pos;
+            if(M_claim(enqueue_pos_, 0, 1, pos) == 0)
+                return false;
+            cell& c = cells_[pos & mask_];
+            mystl::construct(c.value(), mystl::forward<Args>(args)...);
+            c.seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+        template<typename... Args>
+        bool M_emplace(std::false_type, Args&& ...args) {
+            T tmp(mystl::forward<Args>(args)...);
+            return M_emplace(std::true_type(), mystl::move(tmp));
+        }
+
+        template<typename Iter>
+        size_type M_push_n(Iter first, size_type n, std::true_type) {
+            size_type pos;
+            n = M_claim(enqueue_pos_, 0, n, pos);
+            for(size_type i = 0; i < n; ++i, ++first) {
+                cell& c = cells_[(pos + i) & mask_];
+                mystl::construct(c.value(), *first);
+                c.seq.store(pos + i + 1, std::memory_order_release);
+            }
+            return n;
+        }
+        template<typename Iter>
+        size_type M_push_n(Iter first, size_type n, std::false_type) {
+            size_type i = 0;
+            for(; i < n && try_emplace(*first); ++i, ++first) {
+            }
+            return i;
+        }
+
+        template<typename U>
+        void M_take(size_type pos, U& out) {
+            T* p = cells_[pos & mask_].value();
+            try {
+                out = mystl::move(*p);
+            } catch(...) {
+                M_release(pos);
+                throw;
+            }
+            M_release(pos);
+        }
+
+        // 析构第 pos 个元素，把槽交给下一轮的生产者
+        void M_release(size_type pos) {
+            cell& c = cells_[pos & mask_];
+            mystl::destroy(c.value());
+            c.seq.store(pos + mask_ + 1, std::memory_order_release);
+        }
+    };
+
+} // namespace mystl
+
+#endif // MY_TINY_CONCURRENT_QUEUE_H_
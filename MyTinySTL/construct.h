@@ -1,11 +1,14 @@
 #ifndef MY_TINY_CONSTRUCT_H_
 #define MY_TINY_CONSTRUCT_H_
 
-// 该头文件包含两个函数 construct，destroy
+// 该头文件包含函数 construct，destroy，uninitialized_relocate，relocate_n
 // construct：负责对象的构建
 // destroy：负责对象的析构
+// uninitialized_relocate，relocate_n：负责把对象搬到新地址，并结束原对象的生命期
 
+#include <cstring>
 #include <new>
+#include <utility>
 
 #include "type_traits.h"
 #include "iterator.h"
@@ -30,7 +33,7 @@ namespace mystl {
     }
 
     template<typename Ty, typename... Args>
-    void construct(Ty1* ptr, Args... args) {
+    void construct(Ty* ptr, Args&&... args) {
         ::new ((void*)ptr) Ty(mystl::forward<Args>(args)...);
     }
 
@@ -45,6 +48,11 @@ namespace mystl {
         }
     }
 
+    template<typename Ty>
+    void destroy(Ty* pointer) {
+        destroy_one(pointer, std::is_trivially_destructible<Ty>{});
+    }
+
     template<typename ForwardIter>
     void destroy_cat(ForwardIter, ForwardIter, std::true_type) {}
 
@@ -55,17 +63,78 @@ namespace mystl {
         }
     }
 
-    template<typename Ty>
-    void destroy(Ty* pointer) {
-        destroy_one(pointer, std::is_trivially_destructible<Ty>{});
-    }
-
     template<typename ForwardIter>
     void destroy(ForwardIter first, ForwardIter last) {
         destroy_cat(first, last, std::is_trivially_destructible<
             typename iterator_traits<ForwardIter>::value_type>{});
     }
 
+    // uninitialized_relocate
+    // 把 [first, last) 上的对象搬到未初始化的 [result, result + (last - first))，原区间的对象随之结束生命期
+    // 两个区间不能重叠；可平凡重定位的类型以一次 memcpy 完成
+    // 否则逐个构造：移动构造不抛出异常或不可复制时移动，否则复制
+    // 若抛出异常，已构造的新对象被销毁；原区间保持完整，除非元素只能以可能抛出异常的移动构造搬移
+    template<typename Ty>
+    Ty* uninitialized_relocate_cat(Ty* first, Ty* last, Ty* result, std::true_type) {
+        const size_t n = static_cast<size_t>(last - first);
+        if(n != 0)
+            std::memcpy(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(Ty));
+        return result + n;
+    }
+
+    template<typename Ty>
+    Ty* uninitialized_relocate_cat(Ty* first, Ty* last, Ty* result, std::false_type) {
+        Ty* cur = result;
+        try {
+            for(Ty* p = first; p != last; ++p, ++cur) {
+                mystl::construct(cur, std::move_if_noexcept(*p));
+            }
+        } catch(...) {
+            mystl::destroy(result, cur);
+            throw;
+        }
+        mystl::destroy(first, last);
+        return cur;
+    }
+
+    template<typename Ty>
+    Ty* uninitialized_relocate(Ty* first, Ty* last, Ty* result) {
+        return uninitialized_relocate_cat(first, last, result,
+            std::integral_constant<bool, is_trivially_relocatable<Ty>::value>{});
+    }
+
+    // relocate_n
+    // 把 first 起的 n 个对象搬到 result 起的位置，两个区间可以重叠（同一缓冲区内的平移）
+    // 目标区间中不与原区间重叠的部分必须是未初始化的；元素的移动构造不能抛出异常
+    template<typename Ty>
+    Ty* relocate_n_cat(Ty* first, size_t n, Ty* result, std::true_type) {
+        if(n != 0)
+            std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(Ty));
+        return result + n;
+    }
+
+    template<typename Ty>
+    Ty* relocate_n_cat(Ty* first, size_t n, Ty* result, std::false_type) {
+        if(result < first) {
+            for(size_t i = 0; i != n; ++i) {
+                mystl::construct(result + i, mystl::move(first[i]));
+                mystl::destroy(first + i);
+            }
+        } else if(first < result) {
+            for(size_t i = n; i != 0; --i) {
+                mystl::construct(result + i - 1, mystl::move(first[i - 1]));
+                mystl::destroy(first + i - 1);
+            }
+        }
+        return result + n;
+    }
+
+    template<typename Ty>
+    Ty* relocate_n(Ty* first, size_t n, Ty* result) {
+        return relocate_n_cat(first, n, result,
+            std::integral_constant<bool, is_trivially_relocatable<Ty>::value>{});
+    }
+
 }
 
 #ifdef _MSC_VER
@@ -0,0 +1,302 @@
+#ifndef MY_TINY_EXECUTION_H_
+#define MY_TINY_EXECUTION_H_
+
+// 这个头文件包含执行策略 execution::seq / par / par_unseq，
+// 以及 copy、fill、for_each、transform、reduce 接受执行策略的版本
+// 并行版本要求随机访问迭代器，区间按字节数切成若干块交给 execution_pool() 执行，
+// 其它迭代器或 seq 策略退化为串行版本；par_unseq 与 par 的实现相同
+// execution_pool() 默认为 thread_pool::instance()，可以用 set_execution_pool 换成指定大小的线程池
+// 某一块抛出异常时，剩余的块不再执行，第一个异常在调用线程重新抛出
+
+#include <cstddef>
+#include <atomic>
+#include <type_traits>
+
+#include "iterator.h"
+#include "algobase.h"
+#include "algo.h"
+#include "numeric.h"
+#include "functional.h"
+#include "thread_pool.h"
+#include "vector.h"
+#include "util.h"
+
+namespace mystl {
+
+namespace execution {
+
+class sequenced_policy {};
+class parallel_policy {};
+class parallel_unsequenced_policy {};
+
+constexpr sequenced_policy            seq{};
+constexpr parallel_policy             par{};
+constexpr parallel_unsequenced_policy par_unseq{};
+
+} // namespace execution
+
+template<typename T>
+struct is_execution_policy : std::false_type {};
+
+template<>
+struct is_execution_policy<execution::sequenced_policy> : std::true_type {};
+
+template<>
+struct is_execution_policy<execution::parallel_policy> : std::true_type {};
+
+template<>
+struct is_execution_policy<execution::parallel_unsequenced_policy> : std::true_type {};
+
+// 执行策略版本的返回类型，ExecutionPolicy 不是执行策略时不参与重载
+template<typename ExecutionPolicy, typename T>
+struct enable_if_execution_policy
+    : std::enable_if<is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value, T> {};
+
+// 判断以 ExecutionPolicy 遍历 Iter 时能否并行执行
+template<typename ExecutionPolicy, typename Iter>
+struct is_parallelizable : std::integral_constant<bool,
+    !std::is_same<typename std::decay<ExecutionPolicy>::type, execution::sequenced_policy>::value &&
+    std::is_convertible<typename iterator_traits<Iter>::iterator_category,
+                        random_access_iterator_tag>::value> {};
+
+/*****************************************************************************************/
+// 线程池
+// set_execution_pool(&pool) 之后并行版本在 pool 上执行，set_execution_pool(nullptr) 恢复为 thread_pool::instance()
+// 须在没有并行算法正在执行时切换，pool 的生命期由调用者保证
+/*****************************************************************************************/
+inline std::atomic<thread_pool*>& execution_pool_slot() {
+    static std::atomic<thread_pool*> slot(nullptr);
+    return slot;
+}
+
+inline thread_pool& execution_pool() {
+    thread_pool* pool = execution_pool_slot().load(std::memory_order_acquire);
+    return pool != nullptr ? *pool : thread_pool::instance();
+}
+
+inline void set_execution_pool(thread_pool* pool) {
+    execution_pool_slot().store(pool, std::memory_order_release);
+}
+
+/*****************************************************************************************/
+// 分块
+// 每块约 EParallelGrainBytes 字节，小于 L2 缓存，块内的读写不会互相挤出缓存，
+// 块数远多于线程数，由 parallel_for 动态领取以平衡负载；只有一块时直接在调用线程执行
+/*****************************************************************************************/
+enum { EParallelGrainBytes = 256 * 1024 };
+
+template<typename T>
+size_t parallel_grain() {
+    return sizeof(T) < EParallelGrainBytes ? EParallelGrainBytes / sizeof(T) : 1;
+}
+
+template<typename Function>
+void parallel_chunks(size_t n, size_t grain, Function fn) {
+    const size_t chunks = (n + grain - 1) / grain;
+    if(chunks <= 1) {
+        if(n != 0)
+            fn(0, 0, n);
+        return;
+    }
+    execution_pool().parallel_for(chunks, [&](size_t i) {
+        const size_t begin = i * grain;
+        fn(i, begin, n - begin < grain ? n : begin + grain);
+    });
+}
+
+/*****************************************************************************************/
+// copy
+/*****************************************************************************************/
+template<typename InputIter, typename OutputIter>
+OutputIter copy_policy_cat(InputIter first, InputIter last, OutputIter result, std::false_type) {
+    return mystl::copy(first, last, result);
+}
+
+template<typename RandomIter1, typename RandomIter2>
+RandomIter2 copy_policy_cat(RandomIter1 first, RandomIter1 last, RandomIter2 result, std::true_type) {
+    typedef typename iterator_traits<RandomIter1>::value_type value_type;
+    const size_t n = static_cast<size_t>(last - first);
+    parallel_chunks(n, parallel_grain<value_type>(), [&](size_t, size_t begin, size_t end) {
+        mystl::copy(first + begin, first + end, result + begin);
+    });
+    return result + n;
+}
+
+template<typename ExecutionPolicy, typename InputIter, typename OutputIter>
+typename enable_if_execution_policy<ExecutionPolicy, OutputIter>::type
+copy(ExecutionPolicy&&, InputIter first, InputIter last, OutputIter result) {
+    return copy_policy_cat(first, last, result, std::integral_constant<bool,
+        is_parallelizable<ExecutionPolicy, InputIter>::value &&
+        is_parallelizable<ExecutionPolicy, OutputIter>::value>{});
+}
+
+/*****************************************************************************************/
+// fill
+/*****************************************************************************************/
+template<typename ForwardIter, typename T>
+void fill_policy_cat(ForwardIter first, ForwardIter last, const T& value, std::false_type) {
+    mystl::fill(first, last, value);
+}
+
+template<typename RandomIter, typename T>
+void fill_policy_cat(RandomIter first, RandomIter last, const T& value, std::true_type) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    parallel_chunks(static_cast<size_t>(last - first), parallel_grain<value_type>(),
+        [&](size_t, size_t begin, size_t end) {
+        mystl::fill(first + begin, first + end, value);
+    });
+}
+
+template<typename ExecutionPolicy, typename ForwardIter, typename T>
+typename enable_if_execution_policy<ExecutionPolicy, void>::type
+fill(ExecutionPolicy&&, ForwardIter first, ForwardIter last, const T& value) {
+    fill_policy_cat(first, last, value, is_parallelizable<ExecutionPolicy, ForwardIter>{});
+}
+
+/*****************************************************************************************/
+// for_each
+// 并行版本中每一块使用 f 的一个副本，不返回函数对象
+/*****************************************************************************************/
+template<typename InputIter, typename Function>
+void for_each_policy_cat(InputIter first, InputIter last, Function f, std::false_type) {
+    mystl::for_each(first, last, f);
+}
+
+template<typename RandomIter, typename Function>
+void for_each_policy_cat(RandomIter first, RandomIter last, Function f, std::true_type) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    parallel_chunks(static_cast<size_t>(last - first), parallel_grain<value_type>(),
+        [&](size_t, size_t begin, size_t end) {
+        mystl::for_each(first + begin, first + end, f);
+    });
+}
+
+template<typename ExecutionPolicy, typename InputIter, typename Function>
+typename enable_if_execution_policy<ExecutionPolicy, void>::type
+for_each(ExecutionPolicy&&, InputIter first, InputIter last, Function f) {
+    for_each_policy_cat(first, last, f, is_parallelizable<ExecutionPolicy, InputIter>{});
+}
+
+/*****************************************************************************************/
+// transform
+/*****************************************************************************************/
+template<typename InputIter, typename OutputIter, typename UnaryOperation>
+OutputIter transform_policy_cat(InputIter first, InputIter last, OutputIter result,
+    UnaryOperation unary_op, std::false_type) {
+    return mystl::transform(first, last, result, unary_op);
+}
+
+template<typename RandomIter1, typename RandomIter2, typename UnaryOperation>
+RandomIter2 transform_policy_cat(RandomIter1 first, RandomIter1 last, RandomIter2 result,
+    UnaryOperation unary_op, std::true_type) {
+    typedef typename iterator_traits<RandomIter1>::value_type value_type;
+    const size_t n = static_cast<size_t>(last - first);
+    parallel_chunks(n, parallel_grain<value_type>(), [&](size_t, size_t begin, size_t end) {
+        mystl::transform(first + begin, first + end, result + begin, unary_op);
+    });
+    return result + n;
+}
+
+template<typename ExecutionPolicy, typename InputIter, typename OutputIter, typename UnaryOperation>
+typename enable_if_execution_policy<ExecutionPolicy, OutputIter>::type
+transform(ExecutionPolicy&&, InputIter first, InputIter last, OutputIter result,
+    UnaryOperation unary_op) {
+    return transform_policy_cat(first, last, result, unary_op, std::integral_constant<bool,
+        is_parallelizable<ExecutionPolicy, InputIter>::value &&
+        is_parallelizable<ExecutionPolicy, OutputIter>::value>{});
+}
+
+template<typename InputIter1, typename InputIter2, typename OutputIter, typename BinaryOperation>
+OutputIter transform_policy_cat(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+    OutputIter result, BinaryOperation binary_op, std::false_type) {
+    return mystl::transform(first1, last1, first2, result, binary_op);
+}
+
+template<typename RandomIter1, typename RandomIter2, typename RandomIter3, typename BinaryOperation>
+RandomIter3 transform_policy_cat(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2,
+    RandomIter3 result, BinaryOperation binary_op, std::true_type) {
+    typedef typename iterator_traits<RandomIter1>::value_type value_type;
+    const size_t n = static_cast<size_t>(last1 - first1);
+    parallel_chunks(n, parallel_grain<value_type>(), [&](size_t, size_t begin, size_t end) {
+        mystl::transform(first1 + begin, first1 + end, first2 + begin, result + begin, binary_op);
+    });
+    return result + n;
+}
+
+template<typename ExecutionPolicy, typename InputIter1, typename InputIter2, typename OutputIter,
+         typename BinaryOperation>
+typename enable_if_execution_policy<ExecutionPolicy, OutputIter>::type
+transform(ExecutionPolicy&&, InputIter1 first1, InputIter1 last1, InputIter2 first2,
+    OutputIter result, BinaryOperation binary_op) {
+    return transform_policy_cat(first1, last1, first2, result, binary_op, std::integral_constant<bool,
+        is_parallelizable<ExecutionPolicy, InputIter1>::value &&
+        is_parallelizable<ExecutionPolicy, InputIter2>::value &&
+        is_parallelizable<ExecutionPolicy, OutputIter>::value>{});
+}
+
+/*****************************************************************************************/
+// reduce
+// 每一块从 binary_op 的证同元素（functional.h 的 identity_element）开始归约，
+// binary_op 没有证同元素时以块的第一个元素开始；各块的结果再按块的顺序与 init 归约
+/*****************************************************************************************/
+// 有证同元素：返回证同元素，first 不变
+template<typename T, typename BinaryOp, typename RandomIter>
+auto reduce_chunk_seed(const BinaryOp& binary_op, RandomIter&, int)
+    -> decltype(static_cast<T>(identity_element(binary_op))) {
+    return static_cast<T>(identity_element(binary_op));
+}
+
+// 没有证同元素：返回块的第一个元素，first 前进一步
+template<typename T, typename BinaryOp, typename RandomIter>
+T reduce_chunk_seed(const BinaryOp&, RandomIter& first, long) {
+    return static_cast<T>(*first++);
+}
+
+template<typename InputIter, typename T, typename BinaryOp>
+T reduce_policy_cat(InputIter first, InputIter last, T init, BinaryOp binary_op, std::false_type) {
+    return mystl::reduce(first, last, init, binary_op);
+}
+
+template<typename RandomIter, typename T, typename BinaryOp>
+T reduce_policy_cat(RandomIter first, RandomIter last, T init, BinaryOp binary_op, std::true_type) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t grain = parallel_grain<value_type>();
+    if(n <= grain)
+        return mystl::reduce(first, last, init, binary_op);
+    mystl::vector<T> partial((n + grain - 1) / grain, init);
+    parallel_chunks(n, grain, [&](size_t i, size_t begin, size_t end) {
+        RandomIter cur = first + begin;
+        T acc = reduce_chunk_seed<T>(binary_op, cur, 0);
+        partial[i] = mystl::reduce(cur, first + end, acc, binary_op);
+    });
+    return mystl::reduce(partial.begin(), partial.end(), init, binary_op);
+}
+
+template<typename ExecutionPolicy, typename InputIter, typename T, typename BinaryOp>
+typename enable_if_execution_policy<ExecutionPolicy, T>::type
+reduce(ExecutionPolicy&&, InputIter first, InputIter last, T init, BinaryOp binary_op) {
+    return reduce_policy_cat(first, last, init, binary_op,
+                             is_parallelizable<ExecutionPolicy, InputIter>{});
+}
+
+template<typename ExecutionPolicy, typename InputIter, typename T>
+typename enable_if_execution_policy<ExecutionPolicy, T>::type
+reduce(ExecutionPolicy&& policy, InputIter first, InputIter last, T init) {
+    return mystl::reduce(mystl::forward<ExecutionPolicy>(policy), first, last, init,
+                         mystl::plus<T>());
+}
+
+template<typename ExecutionPolicy, typename InputIter>
+typename enable_if_execution_policy<
+    ExecutionPolicy, typename iterator_traits<InputIter>::value_type>::type
+reduce(ExecutionPolicy&& policy, InputIter first, InputIter last) {
+    typedef typename iterator_traits<InputIter>::value_type value_type;
+    return mystl::reduce(mystl::forward<ExecutionPolicy>(policy), first, last,
+                         mystl::identity_element(mystl::plus<value_type>()),
+                         mystl::plus<value_type>());
+}
+
+} // namespace mystl
+
+#endif // MY_TINY_EXECUTION_H_
@@ -0,0 +1,240 @@
+#ifndef MY_TINY_FLAT_HASH_MAP_H_
+#define MY_TINY_FLAT_HASH_MAP_H_
+
+// 这个头文件包含一个模板类 flat_hash_map
+// flat_hash_map : 开放定址的哈希映射，元素直接存放在连续的槽中，底层实现为 flat_hash_table
+// 与 std::unordered_map 不同，插入引起扩容或删除之后，指向元素的迭代器、指针与引用都可能失效
+
+#include <initializer_list>
+#include <stdexcept>
+
+#include "flat_hash_table.h"
+#include "functional.h"
+#include "allocator.h"
+#include "util.h"
+
+namespace mystl {
+
+    // 模板类 flat_hash_map，键值不允许重复
+    // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，参数四代表键值比较方式，参数五代表空间配置器
+    // 哈希函数与比较函数都定义 is_transparent 时，find、count、contains、erase 接受与键可比较的任意类型
+    template<typename Key, typename T, typename Hash = mystl::hash<Key>,
+             typename KeyEqual = mystl::equal_to<Key>,
+             typename Alloc = mystl::allocator<mystl::pair<const Key, T>>>
+    class flat_hash_map {
+    private:
+        typedef flat_hash_table<mystl::pair<const Key, T>, Key, mystl::selectfirst<mystl::pair<const Key, T>>,
+                                Hash, KeyEqual, Alloc> base_type;
+        base_type ht_;
+
+    public:
+        typedef typename base_type::allocator_type      allocator_type;
+        typedef typename base_type::key_type            key_type;
+        typedef T                                       mapped_type;
+        typedef typename base_type::value_type          value_type;
+        typedef typename base_type::hasher              hasher;
+        typedef typename base_type::key_equal           key_equal;
+
+        typedef typename base_type::size_type           size_type;
+        typedef typename base_type::difference_type     difference_type;
+        typedef typename base_type::pointer             pointer;
+        typedef typename base_type::const_pointer       const_pointer;
+        typedef typename base_type::reference           reference;
+        typedef typename base_type::const_reference     const_reference;
+
+        typedef typename base_type::iterator            iterator;
+        typedef typename base_type::const_iterator      const_iterator;
+
+    public:
+        // 构造、复制、移动函数
+        flat_hash_map() : ht_() {}
+
+        explicit flat_hash_map(size_type bucket_count, const hasher& hash = hasher(),
+            const key_equal& equal = key_equal(), const allocator_type& alloc = allocator_type())
+            : ht_(bucket_count, hash, equal, alloc) {}
+
+        template<typename Iter, typename std::enable_if<
+            mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        flat_hash_map(Iter first, Iter last, size_type bucket_count = 0, const hasher& hash = hasher(),
+            const key_equal& equal = key_equal(), const allocator_type& alloc = allocator_type())
+            : ht_(bucket_count, hash, equal, alloc) {
+            ht_.insert_unique(first, last);
+        }
+
+        flat_hash_map(std::initializer_list<value_type> ilist, size_type bucket_count = 0,
+            const hasher& hash = hasher(), const key_equal& equal = key_equal(),
+            const allocator_type& alloc = allocator_type())
+            : ht_(bucket_count, hash, equal, alloc) {
+            ht_.reserve(ilist.size());
+            ht_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        flat_hash_map(const flat_hash_map& rhs) : ht_(rhs.ht_) {}
+        flat_hash_map(flat_hash_map&& rhs) noexcept : ht_(mystl::move(rhs.ht_)) {}
+
+        flat_hash_map& operator=(const flat_hash_map& rhs) {
+            ht_ = rhs.ht_;
+            return *this;
+        }
+        flat_hash_map& operator=(flat_hash_map&& rhs) noexcept {
+            ht_ = mystl::move(rhs.ht_);
+            return *this;
+        }
+        flat_hash_map& operator=(std::initializer_list<value_type> ilist) {
+            ht_.clear();
+            ht_.reserve(ilist.size());
+            ht_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~flat_hash_map() = default;
+
+        // 迭代器相关
+        iterator begin() noexcept { return ht_.begin(); }
+        const_iterator begin() const noexcept { return ht_.begin(); }
+        iterator end() noexcept { return ht_.end(); }
+        const_iterator end() const noexcept { return ht_.end(); }
+
+        const_iterator cbegin() const noexcept { return ht_.cbegin(); }
+        const_iterator cend() const noexcept { return ht_.cend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return ht_.empty(); }
+        size_type size() const noexcept { return ht_.size(); }
+        size_type max_size() const noexcept { return ht_.max_size(); }
+
+        // 修改容器操作
+
+        // emplace
+        template<typename ...Args>
+        mystl::pair<iterator, bool> emplace(Args&& ...args) {
+            return ht_.emplace_unique(mystl::forward<Args>(args)...);
+        }
+
+        // 键不存在时以 key 与 args 构造元素，键已存在时不构造任何对象
+        template<typename ...Args>
+        mystl::pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args) {
+            return ht_.find_or_insert(key, [&](value_type* p) {
+                mystl::construct(p, key, mapped_type(mystl::forward<Args>(args)...));
+            });
+        }
+        template<typename ...Args>
+        mystl::pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args) {
+            return ht_.find_or_insert(key, [&](value_type* p) {
+                mystl::construct(p, mystl::move(key), mapped_type(mystl::forward<Args>(args)...));
+            });
+        }
+
+        // insert
+        mystl::pair<iterator, bool> insert(const value_type& value) {
+            return ht_.insert_unique(value);
+        }
+        mystl::pair<iterator, bool> insert(value_type&& value) {
+            return ht_.insert_unique(mystl::move(value));
+        }
+
+        template<typename Iter>
+        void insert(Iter first, Iter last) {
+            ht_.insert_unique(first, last);
+        }
+        void insert(std::initializer_list<value_type> ilist) {
+            ht_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        // 键已存在时把 obj 赋给它的实值
+        template<typename M>
+        mystl::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+            mystl::pair<iterator, bool> r = try_emplace(key, mystl::forward<M>(obj));
+            if(!r.second)
+                r.first->second = mystl::forward<M>(obj);
+            return r;
+        }
+
+        // erase / clear
+        iterator erase(iterator pos) { return ht_.erase(pos); }
+        iterator erase(const_iterator pos) { return ht_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+
+        template<typename K = key_type>
+        size_type erase(const K& key) { return ht_.template erase<K>(key); }
+
+        void clear() noexcept { ht_.clear(); }
+
+        void swap(flat_hash_map& rhs) noexcept { ht_.swap(rhs.ht_); }
+
+        // 查找相关
+        mapped_type& at(const key_type& key) {
+            iterator it = ht_.find(key);
+            if(it == ht_.end()) throw std::out_of_range("flat_hash_map<Key, T> no such element exists");
+            return it->second;
+        }
+        const mapped_type& at(const key_type& key) const {
+            const_iterator it = ht_.find(key);
+            if(it == ht_.end()) throw std::out_of_range("flat_hash_map<Key, T> no such element exists");
+            return it->second;
+        }
+
+        mapped_type& operator[](const key_type& key) {
+            return try_emplace(key).first->second;
+        }
+        mapped_type& operator[](key_type&& key) {
+            return try_emplace(mystl::move(key)).first->second;
+        }
+
+        template<typename K = key_type>
+        iterator find(const K& key) { return ht_.template find<K>(key); }
+        template<typename K = key_type>
+        const_iterator find(const K& key) const { return ht_.template find<K>(key); }
+
+        template<typename K = key_type>
+        size_type count(const K& key) const { return ht_.template count<K>(key); }
+
+        template<typename K = key_type>
+        bool contains(const K& key) const { return ht_.template contains<K>(key); }
+
+        // bucket interface
+        size_type bucket_count() const noexcept { return ht_.bucket_count(); }
+        size_type capacity() const noexcept { return ht_.capacity(); }
+
+        // hash policy
+        float load_factor() const noexcept { return ht_.load_factor(); }
+        float max_load_factor() const noexcept { return ht_.max_load_factor(); }
+
+        void rehash(size_type count) { ht_.rehash(count); }
+        void reserve(size_type count) { ht_.reserve(count); }
+
+        hasher hash_function() const { return ht_.hash_function(); }
+        key_equal key_eq() const { return ht_.key_eq(); }
+        allocator_type get_allocator() const { return ht_.get_allocator(); }
+    };
+
+    // 重载比较操作符
+    template<typename Key, typename T, typename Hash, typename KeyEqual, typename Alloc>
+    bool operator==(const flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+                    const flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& rhs) {
+        if(lhs.size() != rhs.size())
+            return false;
+        for(auto it = lhs.begin(); it != lhs.end(); ++it) {
+            auto jt = rhs.find(it->first);
+            if(jt == rhs.end() || !(jt->second == it->second))
+                return false;
+        }
+        return true;
+    }
+
+    template<typename Key, typename T, typename Hash, typename KeyEqual, typename Alloc>
+    bool operator!=(const flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+                    const flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    // 重载 mystl 的 swap
+    template<typename Key, typename T, typename Hash, typename KeyEqual, typename Alloc>
+    void swap(flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+              flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+
+#endif // MY_TINY_FLAT_HASH_MAP_H_
@@ -0,0 +1,195 @@
+#ifndef MY_TINY_FLAT_HASH_SET_H_
+#define MY_TINY_FLAT_HASH_SET_H_
+
+// 这个头文件包含一个模板类 flat_hash_set
+// flat_hash_set : 开放定址的哈希集合，元素直接存放在连续的槽中，底层实现为 flat_hash_table
+// 与 std::unordered_set 不同，插入引起扩容或删除之后，指向元素的迭代器、指针与引用都可能失效
+
+#include <initializer_list>
+
+#include "flat_hash_table.h"
+#include "functional.h"
+#include "allocator.h"
+#include "util.h"
+
+namespace mystl {
+
+    // 模板类 flat_hash_set，键值不允许重复
+    // 参数一代表键值类型，参数二代表哈希函数，参数三代表键值比较方式，参数四代表空间配置器
+    // 哈希函数与比较函数都定义 is_transparent 时，find、count、contains、erase 接受与键可比较的任意类型
+    template<typename Key, typename Hash = mystl::hash<Key>, typename KeyEqual = mystl::equal_to<Key>,
+             typename Alloc = mystl::allocator<Key>>
+    class flat_hash_set {
+    private:
+        typedef flat_hash_table<Key, Key, mystl::identity<Key>, Hash, KeyEqual, Alloc> base_type;
+        base_type ht_;
+
+    public:
+        typedef typename base_type::allocator_type      allocator_type;
+        typedef typename base_type::key_type            key_type;
+        typedef typename base_type::value_type          value_type;
+        typedef typename base_type::hasher              hasher;
+        typedef typename base_type::key_equal           key_equal;
+
+        typedef typename base_type::size_type           size_type;
+        typedef typename base_type::difference_type     difference_type;
+        typedef typename base_type::const_pointer       pointer;
+        typedef typename base_type::const_pointer       const_pointer;
+        typedef typename base_type::const_reference     reference;
+        typedef typename base_type::const_reference     const_reference;
+
+        // 元素即键，不允许通过迭代器修改
+        typedef typename base_type::const_iterator      iterator;
+        typedef typename base_type::const_iterator      const_iterator;
+
+    public:
+        // 构造、复制、移动函数
+        flat_hash_set() : ht_() {}
+
+        explicit flat_hash_set(size_type bucket_count, const hasher& hash = hasher(),
+            const key_equal& equal = key_equal(), const allocator_type& alloc = allocator_type())
+            : ht_(bucket_count, hash, equal, alloc) {}
+
+        template<typename Iter, typename std::enable_if<
+            mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        flat_hash_set(Iter first, Iter last, size_type bucket_count = 0, const hasher& hash = hasher(),
+            const key_equal& equal = key_equal(), const allocator_type& alloc = allocator_type())
+            : ht_(bucket_count, hash, equal, alloc) {
+            ht_.insert_unique(first, last);
+        }
+
+        flat_hash_set(std::initializer_list<value_type> ilist, size_type bucket_count = 0,
+            const hasher& hash = hasher(), const key_equal& equal = key_equal(),
+            const allocator_type& alloc = allocator_type())
+            : ht_(bucket_count, hash, equal, alloc) {
+            ht_.reserve(ilist.size());
+            ht_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        flat_hash_set(const flat_hash_set& rhs) : ht_(rhs.ht_) {}
+        flat_hash_set(flat_hash_set&& rhs) noexcept : ht_(mystl::move(rhs.ht_)) {}
+
+        flat_hash_set& operator=(const flat_hash_set& rhs) {
+            ht_ = rhs.ht_;
+            return *this;
+        }
+        flat_hash_set& operator=(flat_hash_set&& rhs) noexcept {
+            ht_ = mystl::move(rhs.ht_);
+            return *this;
+        }
+        flat_hash_set& operator=(std::initializer_list<value_type> ilist) {
+            ht_.clear();
+            ht_.reserve(ilist.size());
+            ht_.insert_unique(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+        ~flat_hash_set() = default;
+
+        // 迭代器相关
+        iterator begin() const noexcept { return ht_.begin(); }
+        iterator end() const noexcept { return ht_.end(); }
+
+        const_iterator cbegin() const noexcept { return ht_.cbegin(); }
+        const_iterator cend() const noexcept { return ht_.cend(); }
+
+        // 容量相关
+        bool empty() const noexcept { return ht_.empty(); }
+        size_type size() const noexcept { return ht_.size(); }
+        size_type max_size() const noexcept { return ht_.max_size(); }
+
+        // 修改容器操作
+
+        // emplace
+        template<typename ...Args>
+        mystl::pair<iterator, bool> emplace(Args&& ...args) {
+            return M_const_result(ht_.emplace_unique(mystl::forward<Args>(args)...));
+        }
+
+        // insert
+        mystl::pair<iterator, bool> insert(const value_type& value) {
+            return M_const_result(ht_.insert_unique(value));
+        }
+        mystl::pair<iterator, bool> insert(value_type&& value) {
+            return M_const_result(ht_.insert_unique(mystl::move(value)));
+        }
+
+        template<typename Iter>
+        void insert(Iter first, Iter last) {
+            ht_.insert_unique(first, last);
+        }
+        void insert(std::initializer_list<value_type> ilist) {
+            ht_.insert_unique(ilist.begin(), ilist.end());
+        }
+
+        // erase / clear
+        iterator erase(const_iterator pos) { return ht_.erase(pos); }
+        iterator erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+
+        template<typename K = key_type>
+        size_type erase(const K& key) { return ht_.template erase<K>(key); }
+
+        void clear() noexcept { ht_.clear(); }
+
+        void swap(flat_hash_set& rhs) noexcept { ht_.swap(rhs.ht_); }
+
+        // 查找相关
+        template<typename K = key_type>
+        const_iterator find(const K& key) const { return ht_.template find<K>(key); }
+
+        template<typename K = key_type>
+        size_type count(const K& key) const { return ht_.template count<K>(key); }
+
+        template<typename K = key_type>
+        bool contains(const K& key) const { return ht_.template contains<K>(key); }
+
+        // bucket interface
+        size_type bucket_count() const noexcept { return ht_.bucket_count(); }
+        size_type capacity() const noexcept { return ht_.capacity(); }
+
+        // hash policy
+        float load_factor() const noexcept { return ht_.load_factor(); }
+        float max_load_factor() const noexcept { return ht_.max_load_factor(); }
+
+        void rehash(size_type count) { ht_.rehash(count); }
+        void reserve(size_type count) { ht_.reserve(count); }
+
+        hasher hash_function() const { return ht_.hash_function(); }
+        key_equal key_eq() const { return ht_.key_eq(); }
+        allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+    private:
+        static mystl::pair<iterator, bool> M_const_result(const mystl::pair<typename base_type::iterator, bool>& r) {
+            return mystl::pair<iterator, bool>(r.first, r.second);
+        }
+    };
+
+    // 重载比较操作符
+    template<typename Key, typename Hash, typename KeyEqual, typename Alloc>
+    bool operator==(const flat_hash_set<Key, Hash, KeyEqual, Alloc>& lhs,
+                    const flat_hash_set<Key, Hash, KeyEqual, Alloc>& rhs) {
+        if(lhs.size() != rhs.size())
+            return false;
+        for(auto it = lhs.begin(); it != lhs.end(); ++it) {
+            if(!rhs.contains(*it))
+                return false;
+        }
+        return true;
+    }
+
+    template<typename Key, typename Hash, typename KeyEqual, typename Alloc>
+    bool operator!=(const flat_hash_set<Key, Hash, KeyEqual, Alloc>& lhs,
+                    const flat_hash_set<Key, Hash, KeyEqual, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    // 重载 mystl 的 swap
+    template<typename Key, typename Hash, typename KeyEqual, typename Alloc>
+    void swap(flat_hash_set<Key, Hash, KeyEqual, Alloc>& lhs,
+              flat_hash_set<Key, Hash, KeyEqual, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+
+#endif // MY_TINY_FLAT_HASH_SET_H_
@@ -0,0 +1,674 @@
+#ifndef MY_TINY_FLAT_HASH_TABLE_H_
+#define MY_TINY_FLAT_HASH_TABLE_H_
+
+// 这个头文件包含一个模板类 flat_hash_table，作为 flat_hash_map、flat_hash_set 的底层实现
+// 开放定址的哈希表（Swiss table）：元素直接存放在槽数组中，另有一个控制字节数组记录每个槽的状态
+// 控制字节为空、已删除、哨兵，或元素哈希值的低 7 位（h2）；哈希值的其余位（h1）决定探测的起点
+// 查找时一次比较一组控制字节（SSE2 下 16 个，否则 8 个），只有 h2 相同的槽才比较键，
+// 遇到含有空槽的组即可结束查找，因此负载率可以达到 7/8
+
+#include <cstring>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+#include "iterator.h"
+#include "allocator.h"
+#include "construct.h"
+#include "algobase.h"
+#include "type_traits.h"
+#include "util.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+
+namespace mystl {
+
+    // 控制字节：空槽、已删除的槽、数组末尾的哨兵；满的槽保存 h2（0 ~ 127）
+    typedef signed char hash_ctrl_t;
+
+    enum : hash_ctrl_t {
+        ECtrlEmpty = -128,
+        ECtrlDeleted = -2,
+        ECtrlSentinel = -1
+    };
+
+    inline unsigned hash_ctz64(uint64_t x) {
+#ifdef _MSC_VER
+        unsigned long i;
+        _BitScanForward64(&i, x);
+        return static_cast<unsigned>(i);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#endif // _MSC_VER
+    }
+
+    inline unsigned hash_clz64(uint64_t x) {
+#ifdef _MSC_VER
+        unsigned long i;
+        _BitScanReverse64(&i, x);
+        return 63u - static_cast<unsigned>(i);
+#else
+        return static_cast<unsigned>(__builtin_clzll(x));
+#endif // _MSC_VER
+    }
+
+    // 一组控制字节
+    // match 系列函数返回位掩码，每个匹配的控制字节对应一位（SSE2）或一个字节的最高位（可移植版本），
+    // 以 lowest 取出最低匹配位的下标，hash_group_clear_lowest 清除最低匹配位
+#ifdef MYSTL_SIMD
+    struct hash_group {
+        enum { width = 16 };
+
+        __m128i ctrl;
+
+        explicit hash_group(const hash_ctrl_t* p)
+            : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+        uint64_t match(hash_ctrl_t h2) const {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+        }
+        uint64_t match_empty() const {
+            return match(ECtrlEmpty);
+        }
+        // 空与已删除的控制字节都小于哨兵
+        uint64_t match_empty_or_deleted() const {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ECtrlSentinel), ctrl)));
+        }
+        // 从组的开头起连续的空或已删除的控制字节个数
+        size_t count_leading_empty_or_deleted() const {
+            return hash_ctz64(match_empty_or_deleted() + 1);
+        }
+
+        // 最低匹配位的下标
+        static size_t lowest(uint64_t mask) { return hash_ctz64(mask); }
+        // 最低匹配位之前、最高匹配位之后未匹配的控制字节个数，没有匹配时为组宽
+        static size_t trailing(uint64_t mask) { return mask == 0 ? static_cast<size_t>(width) : hash_ctz64(mask); }
+        static size_t leading(uint64_t mask) { return mask == 0 ? static_cast<size_t>(width) : hash_clz64(mask) - (64 - width); }
+    };
+#else
+    struct hash_group {
+        enum { width = 8 };
+
+        uint64_t ctrl;
+
+        explicit hash_group(const hash_ctrl_t* p) {
+            std::memcpy(&ctrl, p, sizeof(ctrl));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            ctrl = __builtin_bswap64(ctrl);
+#endif
+        }
+
+        // 可能把 h2 相邻的字节误报为匹配，调用者总会再比较键
+        uint64_t match(hash_ctrl_t h2) const {
+            const uint64_t lsbs = 0x0101010101010101ull;
+            const uint64_t x = ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+            return (x - lsbs) & ~x & 0x8080808080808080ull;
+        }
+        // 空为 0x80，已删除为 0xFE，哨兵为 0xFF，满的槽最高位为 0
+        uint64_t match_empty() const {
+            return (ctrl & ~(ctrl << 6)) & 0x8080808080808080ull;
+        }
+        uint64_t match_empty_or_deleted() const {
+            return (ctrl & ~(ctrl << 7)) & 0x8080808080808080ull;
+        }
+        size_t count_leading_empty_or_deleted() const {
+            return trailing(~match_empty_or_deleted() & 0x8080808080808080ull);
+        }
+
+        static size_t lowest(uint64_t mask) { return hash_ctz64(mask) >> 3; }
+        static size_t trailing(uint64_t mask) { return mask == 0 ? static_cast<size_t>(width) : hash_ctz64(mask) >> 3; }
+        static size_t leading(uint64_t mask) { return mask == 0 ? static_cast<size_t>(width) : hash_clz64(mask) >> 3; }
+    };
+#endif // MYSTL_SIMD
+
+    inline uint64_t hash_group_clear_lowest(uint64_t mask) {
+        return mask & (mask - 1);
+    }
+
+    // 空表共用的控制字节：哨兵之后是一组空槽，查找时不需要特判空表
+    inline hash_ctrl_t* hash_empty_group() {
+        alignas(16) static const hash_ctrl_t group[16] = {
+            ECtrlSentinel, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty,
+            ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty, ECtrlEmpty
+        };
+        return const_cast<hash_ctrl_t*>(group);
+    }
+
+    // 探测序列：以组为单位的三角数探测，容量为 2 的幂减 1 时能访问到每一组
+    struct hash_probe {
+        size_t mask;
+        size_t offset;
+        size_t index;
+
+        hash_probe(size_t h1, size_t capacity) : mask(capacity), offset(h1 & capacity), index(0) {}
+
+        size_t offset_at(size_t i) const { return (offset + i) & mask; }
+
+        void next() {
+            index += hash_group::width;
+            offset = (offset + index) & mask;
+        }
+    };
+
+    // 容量为 2 的幂减 1，最多存放 capacity - capacity / 8 个元素
+    inline size_t hash_capacity_to_growth(size_t capacity) {
+        return (hash_group::width == 8 && capacity == 7) ? 6 : capacity - capacity / 8;
+    }
+
+    inline size_t hash_growth_to_capacity(size_t growth) {
+        if(hash_group::width == 8 && growth == 7)
+            return 8;
+        return growth + (growth == 0 ? 0 : (growth - 1) / 7);
+    }
+
+    inline size_t hash_normalize_capacity(size_t n) {
+        return n == 0 ? 1 : static_cast<size_t>(~uint64_t(0) >> hash_clz64(n));
+    }
+
+    // 透明的哈希函数与比较函数同时提供 is_transparent 时，查找函数接受与键可比较的任意类型
+    template<typename T, typename = void>
+    struct hash_is_transparent : std::false_type {};
+
+    template<typename T>
+    struct hash_is_transparent<T, typename std::conditional<true, void, typename T::is_transparent>::type>
+        : std::true_type {};
+
+    template<bool Transparent>
+    struct hash_key_arg {
+        template<typename K, typename Key>
+        using type = Key;
+    };
+
+    template<>
+    struct hash_key_arg<true> {
+        template<typename K, typename Key>
+        using type = K;
+    };
+
+    // flat_hash_table 的迭代器，Ref、Ptr 决定是否为常量迭代器
+    template<typename T, typename Ref, typename Ptr>
+    struct flat_hash_iterator : public mystl::iterator<mystl::forward_iterator_tag, T, ptrdiff_t, Ptr, Ref> {
+        typedef flat_hash_iterator<T, Ref, Ptr>     self;
+
+        const hash_ctrl_t* ctrl;
+        T* slot;
+
+        flat_hash_iterator() noexcept : ctrl(nullptr), slot(nullptr) {}
+        flat_hash_iterator(const hash_ctrl_t* c, T* s) noexcept : ctrl(c), slot(s) {}
+
+        // 非常量迭代器可以转换为常量迭代器
+        template<typename R, typename P, typename std::enable_if<
+            std::is_same<Ref, const T&>::value && !std::is_same<R, Ref>::value, int>::type = 0>
+        flat_hash_iterator(const flat_hash_iterator<T, R, P>& rhs) noexcept : ctrl(rhs.ctrl), slot(rhs.slot) {}
+
+        Ref operator*() const { return *slot; }
+        Ptr operator->() const { return slot; }
+
+        self& operator++() {
+            ++ctrl;
+            ++slot;
+            M_skip_empty_or_deleted();
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        template<typename R, typename P>
+        bool operator==(const flat_hash_iterator<T, R, P>& rhs) const { return ctrl == rhs.ctrl; }
+        template<typename R, typename P>
+        bool operator!=(const flat_hash_iterator<T, R, P>& rhs) const { return ctrl != rhs.ctrl; }
+
+        // 跳过空与已删除的槽，停在满的槽或哨兵上
+        void M_skip_empty_or_deleted() {
+            while(*ctrl < ECtrlSentinel) {
+                const size_t n = hash_group(ctrl).count_leading_empty_or_deleted();
+                ctrl += n;
+                slot += n;
+            }
+        }
+    };
+
+    // 模板类：flat_hash_table
+    // Value 为元素类型，ExtractKey 从元素中取出键，Hash、KeyEqual 为键的哈希函数与比较函数
+    // 元素存放在连续的槽中，插入引起扩容或删除之后，指向元素的迭代器、指针与引用都可能失效
+    // 扩容时元素被移动到新的槽中，可平凡重定位的元素直接复制字节，其它元素的移动构造不应抛出异常
+    template<typename Value, typename Key, typename ExtractKey, typename Hash, typename KeyEqual, typename Alloc>
+    class flat_hash_table {
+    public:
+        typedef Key                                     key_type;
+        typedef Value                                   value_type;
+        typedef Hash                                    hasher;
+        typedef KeyEqual                                key_equal;
+        typedef Alloc                                   allocator_type;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+        typedef Value*                                  pointer;
+        typedef const Value*                            const_pointer;
+        typedef Value&                                  reference;
+        typedef const Value&                            const_reference;
+
+        typedef flat_hash_iterator<Value, Value&, Value*>               iterator;
+        typedef flat_hash_iterator<Value, const Value&, const Value*>   const_iterator;
+
+    private:
+        typedef typename Alloc::template rebind<hash_ctrl_t>::other     ctrl_allocator;
+
+        template<typename K>
+        using key_arg = typename hash_key_arg<
+            hash_is_transparent<Hash>::value && hash_is_transparent<KeyEqual>::value>::template type<K, key_type>;
+
+        hash_ctrl_t* ctrl_;         // 控制字节，共 capacity_ + width 个，末尾复制了开头的 width - 1 个
+        value_type* slots_;         // 槽，共 capacity_ 个
+        size_type size_;            // 元素个数
+        size_type capacity_;        // 槽数，为 0 或 2 的幂减 1
+        size_type growth_left_;     // 不扩容还能使用的空槽数
+        hasher hash_;
+        key_equal equal_;
+        allocator_type alloc_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        explicit flat_hash_table(size_type bucket_count = 0, const hasher& hash = hasher(),
+            const key_equal& equal = key_equal(), const allocator_type& alloc = allocator_type())
+            : ctrl_(hash_empty_group()), slots_(nullptr), size_(0), capacity_(0), growth_left_(0),
+              hash_(hash), equal_(equal), alloc_(alloc) {
+            if(bucket_count != 0)
+                M_resize(hash_normalize_capacity(bucket_count));
+        }
+
+        flat_hash_table(const flat_hash_table& rhs)
+            : ctrl_(hash_empty_group()), slots_(nullptr), size_(0), capacity_(0), growth_left_(0),
+              hash_(rhs.hash_), equal_(rhs.equal_), alloc_(rhs.alloc_) {
+            // 构造函数抛出异常时不会调用析构函数，已复制的元素与分配的空间须在此释放
+            try {
+                reserve(rhs.size_);
+                for(const_iterator it = rhs.begin(); it != rhs.end(); ++it) {
+                    M_insert_new(*it);
+                }
+            } catch(...) {
+                M_destroy_and_deallocate();
+                throw;
+            }
+        }
+
+        flat_hash_table(flat_hash_table&& rhs) noexcept
+            : ctrl_(rhs.ctrl_), slots_(rhs.slots_), size_(rhs.size_), capacity_(rhs.capacity_),
+              growth_left_(rhs.growth_left_), hash_(rhs.hash_), equal_(rhs.equal_),
+              alloc_(mystl::move(rhs.alloc_)) {
+            rhs.M_reset_empty();
+        }
+
+        flat_hash_table& operator=(const flat_hash_table& rhs) {
+            if(this != &rhs) {
+                flat_hash_table tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        flat_hash_table& operator=(flat_hash_table&& rhs) noexcept {
+            if(this != &rhs) {
+                M_destroy_and_deallocate();
+                ctrl_ = rhs.ctrl_;
+                slots_ = rhs.slots_;
+                size_ = rhs.size_;
+                capacity_ = rhs.capacity_;
+                growth_left_ = rhs.growth_left_;
+                hash_ = rhs.hash_;
+                equal_ = rhs.equal_;
+                alloc_ = mystl::move(rhs.alloc_);
+                rhs.M_reset_empty();
+            }
+            return *this;
+        }
+
+        ~flat_hash_table() {
+            M_destroy_and_deallocate();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept {
+            iterator it(ctrl_, slots_);
+            it.M_skip_empty_or_deleted();
+            return it;
+        }
+        const_iterator begin() const noexcept {
+            return const_cast<flat_hash_table*>(this)->begin();
+        }
+        iterator end() noexcept { return iterator(ctrl_ + capacity_, nullptr); }
+        const_iterator end() const noexcept { return const_iterator(ctrl_ + capacity_, nullptr); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return size_ == 0; }
+        size_type size() const noexcept { return size_; }
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(value_type); }
+        size_type capacity() const noexcept { return capacity_; }
+        size_type bucket_count() const noexcept { return capacity_; }
+
+        float load_factor() const noexcept {
+            return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+        }
+        float max_load_factor() const noexcept { return 7.0f / 8.0f; }
+
+        // 保证插入 n 个元素之前不会扩容
+        void reserve(size_type n) {
+            if(n > size_ + growth_left_)
+                M_resize(hash_normalize_capacity(hash_growth_to_capacity(n)));
+        }
+
+        // 以至少 n 个槽重建哈希表，同时清除已删除的槽；n 为 0 且没有元素时释放空间
+        void rehash(size_type n) {
+            if(n == 0 && size_ == 0) {
+                M_destroy_and_deallocate();
+                M_reset_empty();
+                return;
+            }
+            const size_type need = hash_growth_to_capacity(size_);
+            M_resize(hash_normalize_capacity(n > need ? n : need));
+        }
+
+        // 修改容器相关操作
+        template<typename... Args>
+        mystl::pair<iterator, bool> emplace_unique(Args&& ...args) {
+            value_type tmp(mystl::forward<Args>(args)...);
+            return M_find_or_insert(ExtractKey()(tmp), [&](value_type* p) {
+                mystl::construct(p, mystl::move(tmp));
+            });
+        }
+
+        mystl::pair<iterator, bool> insert_unique(const value_type& value) {
+            return M_find_or_insert(ExtractKey()(value), [&](value_type* p) {
+                mystl::construct(p, value);
+            });
+        }
+
+        mystl::pair<iterator, bool> insert_unique(value_type&& value) {
+            return M_find_or_insert(ExtractKey()(value), [&](value_type* p) {
+                mystl::construct(p, mystl::move(value));
+            });
+        }
+
+        template<typename Iter>
+        void insert_unique(Iter first, Iter last) {
+            for(; first != last; ++first) {
+                insert_unique(*first);
+            }
+        }
+
+        // 键不存在时以 construct(p) 在槽 p 上构造元素，construct 构造的元素的键必须等于 key
+        template<typename K, typename Construct>
+        mystl::pair<iterator, bool> find_or_insert(const K& key, Construct construct) {
+            return M_find_or_insert(key, construct);
+        }
+
+        // 删除之后，如果该槽前后 width 个槽之内有空槽，说明没有探测序列越过它，槽直接置空，
+        // 否则置为已删除，使已删除的槽只出现在确实需要的位置，探测长度不会因删除而增长
+        iterator erase(const_iterator pos) {
+            iterator it(pos.ctrl, pos.slot);
+            M_erase_at(static_cast<size_type>(pos.slot - slots_));
+            ++it;
+            return it;
+        }
+        iterator erase(iterator pos) {
+            return erase(const_iterator(pos));
+        }
+        iterator erase(const_iterator first, const_iterator last) {
+            while(first != last) {
+                first = erase(first);
+            }
+            return iterator(last.ctrl, last.slot);
+        }
+
+        template<typename K = key_type>
+        size_type erase(const key_arg<K>& key) {
+            const size_type i = M_find_index(key, hash_(key));
+            if(i == capacity_)
+                return 0;
+            M_erase_at(i);
+            return 1;
+        }
+
+        // 清除所有元素，保留容量
+        void clear() noexcept {
+            if(capacity_ == 0)
+                return;
+            M_destroy_all();
+            M_reset_ctrl();
+            size_ = 0;
+            growth_left_ = hash_capacity_to_growth(capacity_);
+        }
+
+        void swap(flat_hash_table& rhs) noexcept {
+            mystl::swap(ctrl_, rhs.ctrl_);
+            mystl::swap(slots_, rhs.slots_);
+            mystl::swap(size_, rhs.size_);
+            mystl::swap(capacity_, rhs.capacity_);
+            mystl::swap(growth_left_, rhs.growth_left_);
+            mystl::swap(hash_, rhs.hash_);
+            mystl::swap(equal_, rhs.equal_);
+            mystl::swap(alloc_, rhs.alloc_);
+        }
+
+        // 查找相关操作
+        template<typename K = key_type>
+        iterator find(const key_arg<K>& key) {
+            return M_iter(M_find_index(key, hash_(key)));
+        }
+        template<typename K = key_type>
+        const_iterator find(const key_arg<K>& key) const {
+            return const_cast<flat_hash_table*>(this)->find(key);
+        }
+
+        template<typename K = key_type>
+        size_type count(const key_arg<K>& key) const {
+            return M_find_index(key, hash_(key)) == capacity_ ? 0 : 1;
+        }
+
+        template<typename K = key_type>
+        bool contains(const key_arg<K>& key) const {
+            return M_find_index(key, hash_(key)) != capacity_;
+        }
+
+        hasher hash_function() const { return hash_; }
+        key_equal key_eq() const { return equal_; }
+        allocator_type get_allocator() const { return alloc_; }
+
+    private:
+        // helper functions
+
+        static hash_ctrl_t M_h2(size_t hash) { return static_cast<hash_ctrl_t>(hash & 0x7f); }
+        static size_t M_h1(size_t hash) { return hash >> 7; }
+        static bool M_is_full(hash_ctrl_t c) { return c >= 0; }
+
+        iterator M_iter(size_type i) {
+            return i == capacity_ ? end() : iterator(ctrl_ + i, slots_ + i);
+        }
+
+        // 设置控制字节，同时设置末尾复制的那一份
+        void M_set_ctrl(size_type i, hash_ctrl_t h) {
+            ctrl_[i] = h;
+            ctrl_[((i - (hash_group::width - 1)) & capacity_) + ((hash_group::width - 1) & capacity_)] = h;
+        }
+
+        void M_reset_ctrl() {
+            std::memset(ctrl_, static_cast<unsigned char>(ECtrlEmpty), capacity_ + hash_group::width);
+            ctrl_[capacity_] = ECtrlSentinel;
+        }
+
+        void M_reset_empty() noexcept {
+            ctrl_ = hash_empty_group();
+            slots_ = nullptr;
+            size_ = capacity_ = growth_left_ = 0;
+        }
+
+        // 查找键为 key 的元素，返回槽的下标，不存在时返回 capacity_
+        template<typename K>
+        size_type M_find_index(const K& key, size_t hash) const {
+            const hash_ctrl_t h2 = M_h2(hash);
+            hash_probe seq(M_h1(hash), capacity_);
+            for(;;) {
+                const hash_group g(ctrl_ + seq.offset);
+                for(uint64_t m = g.match(h2); m != 0; m = hash_group_clear_lowest(m)) {
+                    const size_type i = seq.offset_at(hash_group::lowest(m));
+                    if(equal_(ExtractKey()(slots_[i]), key))
+                        return i;
+                }
+                if(g.match_empty() != 0)
+                    return capacity_;
+                seq.next();
+            }
+        }
+
+        // 探测序列上第一个空或已删除的槽
+        size_type M_find_first_non_full(size_t hash) const {
+            hash_probe seq(M_h1(hash), capacity_);
+            for(;;) {
+                const uint64_t m = hash_group(ctrl_ + seq.offset).match_empty_or_deleted();
+                if(m != 0)
+                    return seq.offset_at(hash_group::lowest(m));
+                seq.next();
+            }
+        }
+
+        // 为哈希值为 hash 的新元素找到一个槽，必要时扩容
+        size_type M_prepare_insert(size_t hash) {
+            size_type i = M_find_first_non_full(hash);
+            if(growth_left_ == 0 && ctrl_[i] != ECtrlDeleted) {
+                M_rehash_and_grow_if_necessary();
+                i = M_find_first_non_full(hash);
+            }
+            return i;
+        }
+
+        // 槽 i 上的元素已构造，更新控制字节与计数
+        void M_commit_insert(size_type i, size_t hash) {
+            growth_left_ -= (ctrl_[i] == ECtrlEmpty);
+            M_set_ctrl(i, M_h2(hash));
+            ++size_;
+        }
+
+        template<typename K, typename Construct>
+        mystl::pair<iterator, bool> M_find_or_insert(const K& key, Construct construct) {
+            const size_t hash = hash_(key);
+            size_type i = M_find_index(key, hash);
+            if(i != capacity_)
+                return mystl::pair<iterator, bool>(iterator(ctrl_ + i, slots_ + i), false);
+            i = M_prepare_insert(hash);
+            construct(slots_ + i);
+            M_commit_insert(i, hash);
+            return mystl::pair<iterator, bool>(iterator(ctrl_ + i, slots_ + i), true);
+        }
+
+        // 插入确定不存在的元素
+        void M_insert_new(const value_type& value) {
+            const size_t hash = hash_(ExtractKey()(value));
+            const size_type i = M_prepare_insert(hash);
+            mystl::construct(slots_ + i, value);
+            M_commit_insert(i, hash);
+        }
+
+        void M_erase_at(size_type i) {
+            mystl::destroy(slots_ + i);
+            --size_;
+            const size_type before = (i - hash_group::width) & capacity_;
+            const uint64_t empty_before = hash_group(ctrl_ + before).match_empty();
+            const uint64_t empty_after = hash_group(ctrl_ + i).match_empty();
+            const bool was_never_full = empty_before != 0 && empty_after != 0 &&
+                hash_group::trailing(empty_after) + hash_group::leading(empty_before) < hash_group::width;
+            M_set_ctrl(i, was_never_full ? ECtrlEmpty : ECtrlDeleted);
+            growth_left_ += was_never_full;
+        }
+
+        // 已删除的槽较多时原容量重建即可回收，否则容量翻倍
+        void M_rehash_and_grow_if_necessary() {
+            if(capacity_ > hash_group::width && size_ * 32 <= capacity_ * 25)
+                M_resize(capacity_);
+            else
+                M_resize(capacity_ == 0 ? 1 : capacity_ * 2 + 1);
+        }
+
+        // 把元素搬到新的槽
+        static void M_transfer(value_type* dst, value_type* src, std::true_type) {
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(value_type));
+        }
+        static void M_transfer(value_type* dst, value_type* src, std::false_type) {
+            mystl::construct(dst, mystl::move(*src));
+            mystl::destroy(src);
+        }
+
+        void M_resize(size_type new_capacity) {
+            if(new_capacity > max_size())
+                throw std::length_error("flat_hash_table's size too big");
+            ctrl_allocator ctrl_alloc(alloc_);
+            hash_ctrl_t* new_ctrl = ctrl_alloc.allocate(new_capacity + hash_group::width);
+            value_type* new_slots = nullptr;
+            try {
+                new_slots = alloc_.allocate(new_capacity);
+            } catch(...) {
+                ctrl_alloc.deallocate(new_ctrl, new_capacity + hash_group::width);
+                throw;
+            }
+
+            hash_ctrl_t* old_ctrl = ctrl_;
+            value_type* old_slots = slots_;
+            const size_type old_capacity = capacity_;
+            ctrl_ = new_ctrl;
+            slots_ = new_slots;
+            capacity_ = new_capacity;
+            M_reset_ctrl();
+            growth_left_ = hash_capacity_to_growth(new_capacity) - size_;
+
+            for(size_type i = 0; i < old_capacity; ++i) {
+                if(M_is_full(old_ctrl[i])) {
+                    const size_t hash = hash_(ExtractKey()(old_slots[i]));
+                    const size_type j = M_find_first_non_full(hash);
+                    M_set_ctrl(j, M_h2(hash));
+                    M_transfer(slots_ + j, old_slots + i, std::integral_constant<bool,
+                        mystl::is_trivially_relocatable<value_type>::value>());
+                }
+            }
+            M_deallocate(old_ctrl, old_slots, old_capacity);
+        }
+
+        void M_destroy_all() {
+            if(std::is_trivially_destructible<value_type>::value)
+                return;
+            for(size_type i = 0; i < capacity_; ++i) {
+                if(M_is_full(ctrl_[i]))
+                    mystl::destroy(slots_ + i);
+            }
+        }
+
+        void M_deallocate(hash_ctrl_t* ctrl, value_type* slots, size_type capacity) {
+            if(capacity == 0)
+                return;
+            ctrl_allocator ctrl_alloc(alloc_);
+            ctrl_alloc.deallocate(ctrl, capacity + hash_group::width);
+            alloc_.deallocate(slots, capacity);
+        }
+
+        void M_destroy_and_deallocate() {
+            M_destroy_all();
+            M_deallocate(ctrl_, slots_, capacity_);
+        }
+    };
+
+    template<typename Value, typename Key, typename ExtractKey, typename Hash, typename KeyEqual, typename Alloc>
+    void swap(flat_hash_table<Value, Key, ExtractKey, Hash, KeyEqual, Alloc>& lhs,
+              flat_hash_table<Value, Key, ExtractKey, Hash, KeyEqual, Alloc>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+
+#endif // MY_TINY_FLAT_HASH_TABLE_H_
@@ -0,0 +1,457 @@
+#ifndef MY_TINY_FUNCTION_H_
+#define MY_TINY_FUNCTION_H_
+
+// 这个头文件包含两个类型擦除的可调用对象包装器
+// function           : 可复制，保存的可调用对象必须可复制构造
+// move_only_function : 只能移动，可以保存只能移动的可调用对象（如捕获了 unique_ptr 的 lambda）
+// 不超过 InlineSize 字节、移动不抛出异常的可调用对象直接存放在对象内部的缓冲区，否则分配在堆上
+// 调用通过一个函数指针完成，不使用虚函数；可平凡复制的小对象复制、移动、析构时只复制字节
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <exception>
+#include <type_traits>
+
+#include "util.h"
+
+#ifndef MYSTL_FUNCTION_INLINE_SIZE
+#define MYSTL_FUNCTION_INLINE_SIZE (4 * sizeof(void*))     // 默认的内部缓冲区大小
+#endif
+
+namespace mystl {
+
+    // 调用空的 function 时抛出
+    class bad_function_call : public std::exception {
+    public:
+        const char* what() const noexcept override { return "mystl::bad_function_call"; }
+    };
+
+    // 抛出异常的代码不内联到调用处
+#if defined(_MSC_VER)
+    __declspec(noinline)
+#else
+    __attribute__((noinline, noreturn))
+#endif
+    inline void function_throw_bad_call() {
+        throw bad_function_call();
+    }
+
+    // 统一的调用方式：普通可调用对象、成员函数指针、成员变量指针
+    // 成员指针的第一个参数可以是对象、对象的引用或指向对象的（智能）指针
+    template<typename F, typename... Args>
+    auto function_invoke(F&& f, Args&&... args)
+        -> decltype(mystl::forward<F>(f)(mystl::forward<Args>(args)...)) {
+        return mystl::forward<F>(f)(mystl::forward<Args>(args)...);
+    }
+
+    template<typename Obj>
+    Obj&& function_object(Obj&& obj, std::true_type) {
+        return mystl::forward<Obj>(obj);
+    }
+    template<typename Obj>
+    auto function_object(Obj&& obj, std::false_type) -> decltype(*mystl::forward<Obj>(obj)) {
+        return *mystl::forward<Obj>(obj);
+    }
+
+    template<typename M, typename C, typename Obj, typename... Args>
+    auto function_invoke(M C::* pm, Obj&& obj, Args&&... args)
+        -> typename std::enable_if<std::is_function<M>::value,
+               decltype((function_object(mystl::forward<Obj>(obj), std::is_base_of<C,
+                   typename std::decay<Obj>::type>()).*pm)(mystl::forward<Args>(args)...))>::type {
+        return (function_object(mystl::forward<Obj>(obj), std::is_base_of<C,
+            typename std::decay<Obj>::type>()).*pm)(mystl::forward<Args>(args)...);
+    }
+
+    template<typename M, typename C, typename Obj>
+    auto function_invoke(M C::* pm, Obj&& obj)
+        -> typename std::enable_if<!std::is_function<M>::value,
+               decltype(function_object(mystl::forward<Obj>(obj), std::is_base_of<C,
+                   typename std::decay<Obj>::type>()).*pm)>::type {
+        return function_object(mystl::forward<Obj>(obj), std::is_base_of<C,
+            typename std::decay<Obj>::type>()).*pm;
+    }
+
+    // F 的左值能以 Args 调用，且结果可以转换为 R（R 为 void 时忽略结果）
+    template<typename F, typename R, typename... Args>
+    class function_is_callable {
+        template<typename G>
+        static std::integral_constant<bool, std::is_void<R>::value || std::is_convertible<
+            decltype(function_invoke(std::declval<G&>(), std::declval<Args>()...)), R>::value> test(int);
+        template<typename G>
+        static std::false_type test(...);
+
+    public:
+        static const bool value = decltype(test<F>(0))::value;
+    };
+
+    // 可调用对象的存放空间：内部缓冲区，或指向堆上对象的指针
+    template<size_t InlineSize>
+    union function_storage {
+        void* heap;
+        alignas(std::max_align_t) unsigned char buf[InlineSize < sizeof(void*) ? sizeof(void*) : InlineSize];
+    };
+
+    enum function_op {
+        EFunctionCopy,      // 在 dst 复制构造 src 中的对象
+        EFunctionMove,      // 把 src 中的对象移到 dst，并析构 src 中的对象
+        EFunctionDestroy    // 析构 dst 中的对象
+    };
+
+    // 类型 F 在 function_storage<InlineSize> 中的构造、复制、移动与析构
+    template<typename F, size_t InlineSize, bool Copyable>
+    struct function_manager {
+        typedef function_storage<InlineSize> storage;
+
+        static const bool is_inline = sizeof(F) <= sizeof(storage) &&
+            alignof(storage) % alignof(F) == 0 && std::is_nothrow_move_constructible<F>::value;
+
+        // 可平凡复制的内部对象不需要管理函数，直接复制字节
+        static const bool is_trivial = is_inline && std::is_trivially_copyable<F>::value;
+
+        static F* get(storage& s) noexcept {
+            return M_get(s, std::integral_constant<bool, is_inline>());
+        }
+
+        template<typename... Args>
+        static void create(storage& s, Args&&... args) {
+            M_create(s, std::integral_constant<bool, is_inline>(), mystl::forward<Args>(args)...);
+        }
+
+        static void manage(function_op op, storage* dst, storage* src) {
+            M_manage(op, dst, src, std::integral_constant<bool, is_inline>());
+        }
+
+    private:
+        static F* M_get(storage& s, std::true_type) noexcept {
+            return reinterpret_cast<F*>(s.buf);
+        }
+        static F* M_get(storage& s, std::false_type) noexcept {
+            return static_cast<F*>(s.heap);
+        }
+
+        template<typename... Args>
+        static void M_create(storage& s, std::true_type, Args&&... args) {
+            ::new (static_cast<void*>(s.buf)) F(mystl::forward<Args>(args)...);
+        }
+        template<typename... Args>
+        static void M_create(storage& s, std::false_type, Args&&... args) {
+            s.heap = new F(mystl::forward<Args>(args)...);
+        }
+
+        static void M_copy(storage* dst, storage* src, std::true_type) {
+            create(*dst, *get(*src));
+        }
+        static void M_copy(storage*, storage*, std::false_type) {}
+
+        static void M_manage(function_op op, storage* dst, storage* src, std::true_type) {
+            switch(op) {
+            case EFunctionCopy:
+                M_copy(dst, src, std::integral_constant<bool, Copyable>());
+                break;
+            case EFunctionMove:
+                ::new (static_cast<void*>(dst->buf)) F(mystl::move(*get(*src)));
+                get(*src)->~F();
+                break;
+            case EFunctionDestroy:
+                get(*dst)->~F();
+                break;
+            }
+        }
+        static void M_manage(function_op op, storage* dst, storage* src, std::false_type) {
+            switch(op) {
+            case EFunctionCopy:
+                M_copy(dst, src, std::integral_constant<bool, Copyable>());
+                break;
+            case EFunctionMove:
+                dst->heap = src->heap;
+                break;
+            case EFunctionDestroy:
+                delete get(*dst);
+                break;
+            }
+        }
+    };
+
+    // function 与 move_only_function 共用的存储管理
+    // manager_ 为空表示没有对象或保存的对象可平凡复制
+    template<size_t InlineSize>
+    class function_base {
+    protected:
+        typedef function_storage<InlineSize> storage;
+        typedef void (*manager_type)(function_op, storage*, storage*);
+
+        mutable storage storage_;
+        manager_type manager_;
+
+        function_base() noexcept : manager_(nullptr) {}
+
+        ~function_base() { M_destroy(); }
+
+        template<typename F, bool Copyable, typename... Args>
+        void M_create(Args&&... args) {
+            typedef function_manager<F, InlineSize, Copyable> manager;
+            manager::create(storage_, mystl::forward<Args>(args)...);
+            manager_ = manager::is_trivial ? nullptr : &manager::manage;
+        }
+
+        void M_copy_from(const function_base& rhs) {
+            if(rhs.manager_ == nullptr)
+                std::memcpy(&storage_, &rhs.storage_, sizeof(storage));
+            else
+                rhs.manager_(EFunctionCopy, &storage_, &rhs.storage_);
+            manager_ = rhs.manager_;
+        }
+
+        void M_move_from(function_base& rhs) noexcept {
+            if(rhs.manager_ == nullptr)
+                std::memcpy(&storage_, &rhs.storage_, sizeof(storage));
+            else
+                rhs.manager_(EFunctionMove, &storage_, &rhs.storage_);
+            manager_ = rhs.manager_;
+            rhs.manager_ = nullptr;
+        }
+
+        void M_destroy() noexcept {
+            if(manager_ != nullptr)
+                manager_(EFunctionDestroy, &storage_, nullptr);
+            manager_ = nullptr;
+        }
+    };
+
+    // 空指针（函数指针、成员指针、空的包装器）构造出空的包装器
+    template<typename F>
+    bool function_is_null(const F&, std::false_type) noexcept { return false; }
+    template<typename F>
+    bool function_is_null(const F& f, std::true_type) noexcept { return !f; }
+
+    template<typename F>
+    bool function_is_null(const F& f) noexcept {
+        return function_is_null(f, std::integral_constant<bool, std::is_pointer<F>::value ||
+            std::is_member_pointer<F>::value>());
+    }
+
+    /*****************************************************************************************/
+    // function
+
+    template<typename Signature, size_t InlineSize = MYSTL_FUNCTION_INLINE_SIZE>
+    class function;
+
+    template<typename R, typename... Args, size_t InlineSize>
+    class function<R(Args...), InlineSize> : private function_base<InlineSize> {
+    private:
+        typedef function_base<InlineSize>   base_type;
+        typedef typename base_type::storage storage;
+        typedef R (*invoker_type)(storage&, Args&&...);
+
+        invoker_type invoke_;
+
+        template<typename F>
+        using enable_if_callable = typename std::enable_if<
+            !std::is_same<typename std::decay<F>::type, function>::value &&
+            std::is_copy_constructible<typename std::decay<F>::type>::value &&
+            function_is_callable<typename std::decay<F>::type, R, Args...>::value, int>::type;
+
+    public:
+        typedef R result_type;
+
+        // 构造、复制、移动、析构函数
+        function() noexcept : invoke_(nullptr) {}
+        function(std::nullptr_t) noexcept : invoke_(nullptr) {}
+
+        template<typename F, enable_if_callable<F> = 0>
+        function(F&& f) : invoke_(nullptr) {
+            typedef typename std::decay<F>::type functor;
+            if(function_is_null(f))
+                return;
+            this->template M_create<functor, true>(mystl::forward<F>(f));
+            invoke_ = &M_invoke<functor>;
+        }
+
+        function(const function& rhs) : invoke_(nullptr) {
+            this->M_copy_from(rhs);
+            invoke_ = rhs.invoke_;
+        }
+
+        function(function&& rhs) noexcept : invoke_(rhs.invoke_) {
+            this->M_move_from(rhs);
+            rhs.invoke_ = nullptr;
+        }
+
+        function& operator=(const function& rhs) {
+            function(rhs).swap(*this);
+            return *this;
+        }
+
+        function& operator=(function&& rhs) noexcept {
+            if(this != &rhs) {
+                this->M_destroy();
+                this->M_move_from(rhs);
+                invoke_ = rhs.invoke_;
+                rhs.invoke_ = nullptr;
+            }
+            return *this;
+        }
+
+        function& operator=(std::nullptr_t) noexcept {
+            this->M_destroy();
+            invoke_ = nullptr;
+            return *this;
+        }
+
+        template<typename F, enable_if_callable<F> = 0>
+        function& operator=(F&& f) {
+            function(mystl::forward<F>(f)).swap(*this);
+            return *this;
+        }
+
+        ~function() = default;
+
+        void swap(function& rhs) noexcept {
+            function tmp(mystl::move(rhs));
+            rhs = mystl::move(*this);
+            *this = mystl::move(tmp);
+        }
+
+        explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+        R operator()(Args... args) const {
+            if(invoke_ == nullptr)
+                function_throw_bad_call();
+            return invoke_(this->storage_, mystl::forward<Args>(args)...);
+        }
+
+    private:
+        template<typename F>
+        static R M_invoke(storage& s, Args&&... args) {
+            return static_cast<R>(function_invoke(*function_manager<F, InlineSize, true>::get(s),
+                mystl::forward<Args>(args)...));
+        }
+    };
+
+    /*****************************************************************************************/
+    // move_only_function
+
+    template<typename Signature, size_t InlineSize = MYSTL_FUNCTION_INLINE_SIZE>
+    class move_only_function;
+
+    template<typename R, typename... Args, size_t InlineSize>
+    class move_only_function<R(Args...), InlineSize> : private function_base<InlineSize> {
+    private:
+        typedef function_base<InlineSize>   base_type;
+        typedef typename base_type::storage storage;
+        typedef R (*invoker_type)(storage&, Args&&...);
+
+        invoker_type invoke_;
+
+        template<typename F>
+        using enable_if_callable = typename std::enable_if<
+            !std::is_same<typename std::decay<F>::type, move_only_function>::value &&
+            std::is_constructible<typename std::decay<F>::type, F>::value &&
+            function_is_callable<typename std::decay<F>::type, R, Args...>::value, int>::type;
+
+    public:
+        typedef R result_type;
+
+        // 构造、移动、析构函数
+        move_only_function() noexcept : invoke_(nullptr) {}
+        move_only_function(std::nullptr_t) noexcept : invoke_(nullptr) {}
+
+        template<typename F, enable_if_callable<F> = 0>
+        move_only_function(F&& f) : invoke_(nullptr) {
+            typedef typename std::decay<F>::type functor;
+            if(function_is_null(f))
+                return;
+            this->template M_create<functor, false>(mystl::forward<F>(f));
+            invoke_ = &M_invoke<functor>;
+        }
+
+        move_only_function(const move_only_function&) = delete;
+        move_only_function& operator=(const move_only_function&) = delete;
+
+        move_only_function(move_only_function&& rhs) noexcept : invoke_(rhs.invoke_) {
+            this->M_move_from(rhs);
+            rhs.invoke_ = nullptr;
+        }
+
+        move_only_function& operator=(move_only_function&& rhs) noexcept {
+            if(this != &rhs) {
+                this->M_destroy();
+                this->M_move_from(rhs);
+                invoke_ = rhs.invoke_;
+                rhs.invoke_ = nullptr;
+            }
+            return *this;
+        }
+
+        move_only_function& operator=(std::nullptr_t) noexcept {
+            this->M_destroy();
+            invoke_ = nullptr;
+            return *this;
+        }
+
+        template<typename F, enable_if_callable<F> = 0>
+        move_only_function& operator=(F&& f) {
+            move_only_function(mystl::forward<F>(f)).swap(*this);
+            return *this;
+        }
+
+        ~move_only_function() = default;
+
+        void swap(move_only_function& rhs) noexcept {
+            move_only_function tmp(mystl::move(rhs));
+            rhs = mystl::move(*this);
+            *this = mystl::move(tmp);
+        }
+
+        explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+        R operator()(Args... args) {
+            if(invoke_ == nullptr)
+                function_throw_bad_call();
+            return invoke_(this->storage_, mystl::forward<Args>(args)...);
+        }
+
+    private:
+        template<typename F>
+        static R M_invoke(storage& s, Args&&... args) {
+            return static_cast<R>(function_invoke(*function_manager<F, InlineSize, false>::get(s),
+                mystl::forward<Args>(args)...));
+        }
+    };
+
+    /*****************************************************************************************/
+
+    // 与空指针比较
+    template<typename R, typename... Args, size_t InlineSize>
+    bool operator==(const function<R(Args...), InlineSize>& f, std::nullptr_t) noexcept { return !f; }
+    template<typename R, typename... Args, size_t InlineSize>
+    bool operator==(std::nullptr_t, const function<R(Args...), InlineSize>& f) noexcept { return !f; }
+    template<typename R, typename... Args, size_t InlineSize>
+    bool operator!=(const function<R(Args...), InlineSize>& f, std::nullptr_t) noexcept { return !!f; }
+    template<typename R, typename... Args, size_t InlineSize>
+    bool operator!=(std::nullptr_t, const function<R(Args...), InlineSize>& f) noexcept { return !!f; }
+
+    template<typename R, typename... Args, size_t InlineSize>
+    bool operator==(const move_only_function<R(Args...), InlineSize>& f, std::nullptr_t) noexcept { return !f; }
+    template<typename R, typename... Args, size_t InlineSize>
+    bool operator==(std::nullptr_t, const move_only_function<R(Args...), InlineSize>& f) noexcept { return !f; }
+    template<typename R, typename... Args, size_t InlineSize>
+    bool operator!=(const move_only_function<R(Args...), InlineSize>& f, std::nullptr_t) noexcept { return !!f; }
+    template<typename R, typename... Args, size_t InlineSize>
+    bool operator!=(std::nullptr_t, const move_only_function<R(Args...), InlineSize>& f) noexcept { return !!f; }
+
+    // 重载 mystl 的 swap
+    template<typename R, typename... Args, size_t InlineSize>
+    void swap(function<R(Args...), InlineSize>& lhs, function<R(Args...), InlineSize>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+    template<typename R, typename... Args, size_t InlineSize>
+    void swap(move_only_function<R(Args...), InlineSize>& lhs,
+              move_only_function<R(Args...), InlineSize>& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+
+#endif // MY_TINY_FUNCTION_H_
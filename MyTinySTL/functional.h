@@ -1,9 +1,17 @@
-#ifndef MY_TINY_STL_H_
-#define MY_TINY_STL_H_
+#ifndef MY_TINY_FUNCTIONAL_H_
+#define MY_TINY_FUNCTIONAL_H_
 
 // 该头文件包含了 mystl 的函数对象于哈希函数
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <chrono>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
 
 namespace mystl {
 
@@ -156,6 +164,130 @@ struct projectsecond : public binary_function<Arg1, Arg2, Arg2> {
 
 /*********************************************************************/
 // 哈希函数对象
+// 整数、指针、浮点数经 64 位乘法混合后作为哈希值，连续的整数与对齐的指针也能均匀分布到 2 的幂个桶中
+// 字节序列（字符串、缓冲区）使用 hash_bytes，每步读取 16 bytes，长序列分三路并行处理 48 bytes，
+// 每一路的混合常数由种子导出，状态逐步累积而不是被覆盖
+// 哈希函数对象可以用种子构造，以 random_hash_seed() 作为种子可以防止针对固定哈希函数构造的冲突攻击（HashDoS）
+
+// 混合常数
+enum : uint64_t {
+    EHashP0 = 0x2d358dccaa6c78a5ull,
+    EHashP1 = 0x8bb84b93962eacc9ull,
+    EHashP2 = 0x4b33a62ed433d4a3ull,
+    EHashP3 = 0x4d5a2da51de1aa47ull
+};
+
+// 计算 a * b 的 128 位乘积，返回高 64 位与低 64 位的异或
+inline uint64_t hash_mum(uint64_t a, uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t hi;
+    const uint64_t lo = _umul128(a, b, &hi);
+    return lo ^ hi;
+#else
+    const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    const uint64_t lo = t + (rm1 << 32);
+    const uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+    return lo ^ hi;
+#endif
+}
+
+// 64 位整数的混合函数，两轮乘法混合后每个输入位平均改变一半的输出位
+inline uint64_t hash_mix(uint64_t x, uint64_t seed = 0) noexcept {
+    return mystl::hash_mum(mystl::hash_mum(x ^ seed ^ EHashP0, EHashP1), EHashP2);
+}
+
+inline uint64_t hash_read8(const unsigned char* p) noexcept {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t hash_read4(const unsigned char* p) noexcept {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+// hash_bytes 的种子状态：种子经一轮乘法混合，每一路的混合常数为它与 EHashP1 ~ EHashP3 的异或，
+// 种子未知时无法构造使某一步的乘积为 0 的输入
+inline uint64_t hash_bytes_state(uint64_t seed) noexcept {
+    return seed ^ mystl::hash_mum(seed ^ EHashP0, EHashP1);
+}
+
+// hash_bytes 的一步：把 16 bytes（a、b）混合进一路的状态 state
+// 状态与输入同时以加法累积，即使乘积为 0（a 等于 secret 或 b 等于 state），结果仍取决于 state、a 与 b
+// b 旋转之后相加，连续两步的乘积都为 0 时，交换这两步中的数据也不会得到相同的状态
+inline uint64_t hash_step(uint64_t state, uint64_t a, uint64_t b, uint64_t secret) noexcept {
+    return mystl::hash_mum(a ^ secret, b ^ state) ^ (state + a + ((b << 29) | (b >> 35)));
+}
+
+// 计算 [first, first + count) 内字节的哈希值
+inline uint64_t hash_bytes(const void* first, size_t count, uint64_t seed = 0) noexcept {
+    const unsigned char* p = static_cast<const unsigned char*>(first);
+    seed = mystl::hash_bytes_state(seed);
+    const uint64_t secret1 = seed ^ EHashP1;
+    uint64_t a, b;
+    if(count <= 16) {
+        if(count >= 4) {
+            // 4 ~ 16 bytes：首尾各读两个可能重叠的 4 bytes
+            const size_t mid = (count >> 3) << 2;
+            a = (hash_read4(p) << 32) | hash_read4(p + mid);
+            b = (hash_read4(p + count - 4) << 32) | hash_read4(p + count - 4 - mid);
+        } else if(count > 0) {
+            a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[count >> 1]) << 8) | p[count - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = count;
+        if(i > 48) {
+            const uint64_t secret2 = seed ^ EHashP2, secret3 = seed ^ EHashP3;
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mystl::hash_step(seed, hash_read8(p), hash_read8(p + 8), secret1);
+                see1 = mystl::hash_step(see1, hash_read8(p + 16), hash_read8(p + 24), secret2);
+                see2 = mystl::hash_step(see2, hash_read8(p + 32), hash_read8(p + 40), secret3);
+                p += 48;
+                i -= 48;
+            } while(i > 48);
+            seed = mystl::hash_step(seed, see1, see2, secret1);
+        }
+        while(i > 16) {
+            seed = mystl::hash_step(seed, hash_read8(p), hash_read8(p + 8), secret1);
+            p += 16;
+            i -= 16;
+        }
+        // 最后 16 bytes 可能与已处理的部分重叠
+        a = hash_read8(p + i - 16);
+        b = hash_read8(p + i - 8);
+    }
+    return mystl::hash_mum(mystl::hash_step(seed, a, b, secret1) ^ EHashP0 ^ count, EHashP1);
+}
+
+// 进程内随机的种子，由随机设备、时间与地址混合得到
+inline uint64_t random_hash_seed() {
+    static const uint64_t seed = []() {
+        std::random_device rd;
+        uint64_t s = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+        s ^= static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        s ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&rd));
+        return mystl::hash_mix(s, EHashP2);
+    }();
+    return seed;
+}
+
+// 哈希函数对象的公共基类，保存种子
+struct hash_seed {
+    uint64_t seed;
+
+    explicit hash_seed(uint64_t s = 0) noexcept : seed(s) {}
+};
 
 // 对于大部分类型，hash function 什么都不做
 template<typename Key>
@@ -163,89 +295,92 @@ struct hash {};
 
 // 针对指针的偏特化版本
 template<typename T>
-struct hash<T*> {
+struct hash<T*> : public hash_seed {
+    using hash_seed::hash_seed;
+
     size_t operator()(T* p) const noexcept {
-        return reinterpret_cast<size_t>(p);
+        return static_cast<size_t>(mystl::hash_mix(reinterpret_cast<uintptr_t>(p), seed));
     }
 };
 
-// 对于整数类型，只是返回原值
-#define MYSTL_TRIVAL_HASH_FCN(Type)                \
-template<> struct hash<Type> {                     \
-    size_t operator()(Type val) const noexcept     \
-    { return static_cast<size_t>(val); }           \
+// 对于整数类型，混合后返回
+#define MYSTL_INTEGER_HASH_FCN(Type)                                        \
+template<> struct hash<Type> : public hash_seed {                           \
+    using hash_seed::hash_seed;                                             \
+    size_t operator()(Type val) const noexcept                              \
+    { return static_cast<size_t>(mystl::hash_mix(static_cast<uint64_t>(val), seed)); } \
 };
 
-MYSTL_TRIVAL_HASH_FCN(bool)
+MYSTL_INTEGER_HASH_FCN(bool)
 
-MYSTL_TRIVAL_HASH_FCN(char)
+MYSTL_INTEGER_HASH_FCN(char)
 
-MYSTL_TRIVAL_HASH_FCN(signed char)
+MYSTL_INTEGER_HASH_FCN(signed char)
 
-MYSTL_TRIVAL_HASH_FCN(unsigned char)
+MYSTL_INTEGER_HASH_FCN(unsigned char)
 
-MYSTL_TRIVAL_HASH_FCN(wchar_t)
+MYSTL_INTEGER_HASH_FCN(wchar_t)
 
-MYSTL_TRIVAL_HASH_FCN(char16_t)
+MYSTL_INTEGER_HASH_FCN(char16_t)
 
-MYSTL_TRIVAL_HASH_FCN(char32_t)
+MYSTL_INTEGER_HASH_FCN(char32_t)
 
-MYSTL_TRIVAL_HASH_FCN(short)
+MYSTL_INTEGER_HASH_FCN(short)
 
-MYSTL_TRIVAL_HASH_FCN(unsigned short)
+MYSTL_INTEGER_HASH_FCN(unsigned short)
 
-MYSTL_TRIVAL_HASH_FCN(int)
+MYSTL_INTEGER_HASH_FCN(int)
 
-MYSTL_TRIVAL_HASH_FCN(unsigned int)
+MYSTL_INTEGER_HASH_FCN(unsigned int)
 
-MYSTL_TRIVAL_HASH_FCN(long)
+MYSTL_INTEGER_HASH_FCN(long)
 
-MYSTL_TRIVAL_HASH_FCN(unsigned long)
+MYSTL_INTEGER_HASH_FCN(unsigned long)
 
-MYSTL_TRIVAL_HASH_FCN(long long)
+MYSTL_INTEGER_HASH_FCN(long long)
 
-MYSTL_TRIVAL_HASH_FCN(unsigned long long)
+MYSTL_INTEGER_HASH_FCN(unsigned long long)
 
-#undef MYSTL_TRIVAL_HASH_FCN
-
-// 对于浮点数，逐位哈希
-inline size_t bitwies_hash(const unsigned char* first, size_t count) {
-#if (_MSC_VER && WIN64) || ((__GUNC__ || __clang__) && __SIZEOF_POINTER__ == 8)
-    const size_t fnv_offset = 14695981039346656037ull;
-    const size_t fnv_prime = 1099511628211ull;
-#else
-    const size_t fnv_offset = 26166136261u;
-    const size_t fnv_prime = 1099511628211u;
-#endif
-    size_t result = fnv_offset;
-    for(size_t i = 0; i < count; ++i) {
-        result ^= static_cast<size_t>(first[i]);
-        result *= fnv_prime;
-    }
-    return result;
-}
+#undef MYSTL_INTEGER_HASH_FCN
 
+// 对于浮点数，混合其位模式，+0.0 与 -0.0 的哈希值相同
 template<>
-struct hash<float> {
-    size_t operator()(const float& val) {
-        return val == 0.0f ? 0 : bitwies_hash((const unsigned char*)&val, sizeof(float));
+struct hash<float> : public hash_seed {
+    using hash_seed::hash_seed;
+
+    size_t operator()(float val) const noexcept {
+        uint32_t bits = 0;
+        if(val != 0.0f)
+            std::memcpy(&bits, &val, sizeof(float));
+        return static_cast<size_t>(mystl::hash_mix(bits, seed));
     }
 };
 
 template<>
-struct hash<double> {
-    size_t operator()(const double& val) {
-        return val == 0.0f ? 0 : bitwies_hash((const unsigned char*)&val, sizeof(double));
+struct hash<double> : public hash_seed {
+    using hash_seed::hash_seed;
+
+    size_t operator()(double val) const noexcept {
+        uint64_t bits = 0;
+        if(val != 0.0)
+            std::memcpy(&bits, &val, sizeof(double));
+        return static_cast<size_t>(mystl::hash_mix(bits, seed));
     }
 };
 
+// long double 只哈希有效的字节，x87 扩展精度格式的 80 位之后是填充字节
 template<>
-struct hash<long double> {
-    size_t operator()(const long double& val) {
-        return val == 0.0f ? 0 : bitwies_hash((const unsigned char*)&val, sizeof(long double));
+struct hash<long double> : public hash_seed {
+    using hash_seed::hash_seed;
+
+    size_t operator()(long double val) const noexcept {
+        if(val == 0.0L)
+            return static_cast<size_t>(mystl::hash_mix(0, seed));
+        const size_t bytes = std::numeric_limits<long double>::digits == 64 ? 10 : sizeof(long double);
+        return static_cast<size_t>(mystl::hash_bytes(&val, bytes, seed));
     }
 };
 
 }
 
-#endif // MY_TINY_STL_H_
\ No newline at end of file
+#endif // MY_TINY_FUNCTIONAL_H_
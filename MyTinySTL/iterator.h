@@ -4,6 +4,7 @@
 // 该头文件用于迭代器设计，包含了一些模板结构体与全局函数
 
 #include <cstddef>
+#include <utility>
 #include "type_traits.h"
 
 namespace mystl {
@@ -14,6 +15,8 @@ namespace mystl {
     struct forward_iterator_tag : public input_iterator_tag {};
     struct bidirectional_iterator_tag : public forward_iterator_tag {};
     struct random_access_iterator_tag : public bidirectional_iterator_tag {};
+    // 元素在内存中连续存放的随机访问迭代器，可以通过 to_address 转换为原生指针
+    struct contiguous_iterator_tag : public random_access_iterator_tag {};
 
     // iterator 模板
     template<typename Category, typename T, typename Distance = ptrdiff_t,
@@ -23,7 +26,7 @@ namespace mystl {
         typedef T         value_type;
         typedef Pointer   pointer;
         typedef Reference reference;
-        typedef Distance  distance_type;
+        typedef Distance  difference_type;
     };
 
     // iterator traits
@@ -35,7 +38,7 @@ namespace mystl {
         template<typename U> static two test(...);
         template<typename U> static char test(typename U::iterator_category* = 0);
     public:
-        static const bool value = sizeof(test<T>(0) == sizeof(char));
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
     };
 
     template<typename Iterator, bool>
@@ -47,7 +50,7 @@ namespace mystl {
         typedef typename Iterator::value_type        value_type;
         typedef typename Iterator::pointer           pointer;
         typedef typename Iterator::reference         reference;
-        typedef typename Iterator::distance_type     distance_type;
+        typedef typename Iterator::difference_type   difference_type;
     };
     
     template<typename Iterator, bool>
@@ -56,8 +59,8 @@ namespace mystl {
     template<typename Iterator>
     struct iterator_traits_helper<Iterator, true> 
         : public iterator_traits_impl<Iterator, 
-        std::is_constructible<typename Iterator::iterator_category, input_iterator_tag>::value ||
-        std::is_constructible<typename Iterator::iterator_category, output_iterator_tag>::value> 
+        std::is_convertible<typename Iterator::iterator_category, input_iterator_tag>::value ||
+        std::is_convertible<typename Iterator::iterator_category, output_iterator_tag>::value> 
     {};
 
     // 萃取器的特性
@@ -109,6 +112,11 @@ namespace mystl {
     template<typename Iter>
     struct is_random_access_iterator : public has_iterator_cat_of<Iter, random_access_iterator_tag> {};
 
+    // 原生指针与 iterator_category 为 contiguous_iterator_tag 的迭代器
+    template<typename Iter>
+    struct is_contiguous_iterator : public m_bool_constant<std::is_pointer<Iter>::value ||
+        has_iterator_cat_of<Iter, contiguous_iterator_tag>::value> {};
+
     template<typename Iterator>
     struct is_iterator :
         public m_bool_constant<is_input_iterator<Iterator>::value ||
@@ -136,6 +144,45 @@ namespace mystl {
         return static_cast<typename iterator_traits<Iterator>::value_type*>(0);
     }
 
+    // to_address
+    // 取得指针或连续迭代器所指元素的地址，迭代器通过 operator-> 取得，不要求迭代器可解引用
+    template<typename T>
+    constexpr T* to_address(T* p) noexcept {
+        return p;
+    }
+
+    template<typename Iter>
+    auto to_address(const Iter& it) noexcept -> decltype(mystl::to_address(it.operator->())) {
+        return mystl::to_address(it.operator->());
+    }
+
+    // 迭代器的解包与重新包装
+    // 批量算法把连续迭代器解包为原生指针，交给 memmove / SIMD 等指针版本处理，再把结果包装回迭代器
+    template<typename Iter, bool = is_contiguous_iterator<Iter>::value && !std::is_pointer<Iter>::value>
+    struct iter_unwrapper {
+        typedef Iter type;
+        static type unwrap(const Iter& it) { return it; }
+        static Iter rewrap(const Iter&, const type& p) { return p; }
+    };
+
+    template<typename Iter>
+    struct iter_unwrapper<Iter, true> {
+        typedef decltype(mystl::to_address(std::declval<const Iter&>())) type;
+        static type unwrap(const Iter& it) { return mystl::to_address(it); }
+        static Iter rewrap(const Iter& orig, const type& p) { return orig + (p - unwrap(orig)); }
+    };
+
+    template<typename Iter>
+    typename iter_unwrapper<Iter>::type unwrap_iter(const Iter& it) {
+        return iter_unwrapper<Iter>::unwrap(it);
+    }
+
+    // 把解包后的结果 p 包装回与 orig 同类型的迭代器，orig 是解包前的起点
+    template<typename Iter>
+    Iter rewrap_iter(const Iter& orig, const typename iter_unwrapper<Iter>::type& p) {
+        return iter_unwrapper<Iter>::rewrap(orig, p);
+    }
+
     // 以下函数用于计算迭代器间的距离
 
     // distance 的 input_iterator_tag 的版本
@@ -209,7 +256,8 @@ namespace mystl {
         // 构造函数
         reverse_iterator() {}
         explicit reverse_iterator(iterator_type i) : current(i) {}
-        reverse_iterator(const iterator_type& rhs) : current(rhs.current) {}
+        reverse_iterator(const self& rhs) : current(rhs.current) {}
+        self& operator=(const self& rhs) { current = rhs.current; return *this; }
 
     public:
         // 取出对应的正向迭代器
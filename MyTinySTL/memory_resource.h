@@ -0,0 +1,561 @@
+#ifndef MY_TINY_MEMORY_RESOURCE_H_
+#define MY_TINY_MEMORY_RESOURCE_H_
+
+// 这个头文件包含多态内存资源 memory_resource 及其派生类，以及使用它的 polymorphic_allocator
+// new_delete_resource：      调用 ::operator new / ::operator delete
+// null_memory_resource：     任何分配都抛出 std::bad_alloc
+// monotonic_buffer_resource：单调递增的 bump pointer 内存区，释放为空操作，release 时一次归还
+// unsynchronized_pool_resource：按 2 的幂分级的内存池，不加锁
+// synchronized_pool_resource：  加锁的内存池，可在多个线程间共享
+
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+#include "alloc.h"
+#include "construct.h"
+#include "util.h"
+
+namespace mystl {
+    // 将 p 上调至 alignment 的倍数，alignment 必须是 2 的幂
+    inline char* align_up(char* p, size_t alignment) {
+        const uintptr_t v = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char*>((v + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1));
+    }
+
+    // 抽象类：memory_resource
+    // 派生类实现 do_allocate、do_deallocate、do_is_equal
+    class memory_resource {
+    public:
+        virtual ~memory_resource() {}
+
+        void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+            return do_allocate(bytes, alignment);
+        }
+
+        void deallocate(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+            do_deallocate(p, bytes, alignment);
+        }
+
+        bool is_equal(const memory_resource& other) const noexcept {
+            return do_is_equal(other);
+        }
+
+    private:
+        virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+        virtual void do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+        virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+    };
+
+    inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+        return &lhs == &rhs || lhs.is_equal(rhs);
+    }
+
+    inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    /*****************************************************************************************/
+    // new_delete_resource
+
+    // 类：new_delete_memory_resource
+    // 对齐要求超过 std::max_align_t 时，多申请 alignment 大小，并在返回地址之前记录原始地址
+    class new_delete_memory_resource : public memory_resource {
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            if(alignment <= alignof(std::max_align_t))
+                return ::operator new(bytes);
+            char* raw = static_cast<char*>(::operator new(bytes + alignment));
+            char* p = align_up(raw + sizeof(void*), alignment);
+            reinterpret_cast<void**>(p)[-1] = raw;
+            return p;
+        }
+
+        void do_deallocate(void* p, size_t /*bytes*/, size_t alignment) override {
+            if(alignment <= alignof(std::max_align_t))
+                ::operator delete(p);
+            else
+                ::operator delete(reinterpret_cast<void**>(p)[-1]);
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    // 类：null_memory_resource_impl
+    // 任何分配都失败，用于确保 monotonic_buffer_resource 只使用给定的缓冲区
+    class null_memory_resource_impl : public memory_resource {
+    private:
+        void* do_allocate(size_t, size_t) override {
+            throw std::bad_alloc();
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    inline memory_resource* new_delete_resource() noexcept {
+        static new_delete_memory_resource resource;
+        return &resource;
+    }
+
+    inline memory_resource* null_memory_resource() noexcept {
+        static null_memory_resource_impl resource;
+        return &resource;
+    }
+
+    // 默认资源，初始为 new_delete_resource
+    inline std::atomic<memory_resource*>& default_resource_holder() noexcept {
+        static std::atomic<memory_resource*> holder(new_delete_resource());
+        return holder;
+    }
+
+    inline memory_resource* get_default_resource() noexcept {
+        return default_resource_holder().load(std::memory_order_acquire);
+    }
+
+    // 设置默认资源，传入 nullptr 时恢复为 new_delete_resource，返回原来的默认资源
+    inline memory_resource* set_default_resource(memory_resource* r) noexcept {
+        if(r == nullptr)
+            r = new_delete_resource();
+        return default_resource_holder().exchange(r, std::memory_order_acq_rel);
+    }
+
+    /*****************************************************************************************/
+    // monotonic_buffer_resource
+
+    // 类：monotonic_buffer_resource
+    // 从当前缓冲区中顺序切出内存，deallocate 为空操作；当前缓冲区不足时，向上游申请一块更大的缓冲区
+    // release 时一次性把所有上游缓冲区归还，并回到初始缓冲区，适合一次请求内同生共死的对象
+    class monotonic_buffer_resource : public memory_resource {
+    public:
+        monotonic_buffer_resource()
+            : monotonic_buffer_resource(get_default_resource()) {}
+
+        explicit monotonic_buffer_resource(memory_resource* upstream)
+            : upstream_(upstream), initial_buffer_(nullptr), initial_size_(0),
+              current_(nullptr), available_(0), initial_next_size_(EInitialSize),
+              next_size_(EInitialSize), blocks_(nullptr) {}
+
+        explicit monotonic_buffer_resource(size_t initial_size,
+            memory_resource* upstream = get_default_resource())
+            : upstream_(upstream), initial_buffer_(nullptr), initial_size_(0),
+              current_(nullptr), available_(0),
+              initial_next_size_(initial_size < sizeof(Block) ? sizeof(Block) : initial_size),
+              next_size_(initial_next_size_), blocks_(nullptr) {}
+
+        // 以调用者提供的缓冲区（例如栈上的数组）作为第一块缓冲区
+        monotonic_buffer_resource(void* buffer, size_t buffer_size,
+            memory_resource* upstream = get_default_resource())
+            : upstream_(upstream), initial_buffer_(static_cast<char*>(buffer)), initial_size_(buffer_size),
+              current_(static_cast<char*>(buffer)), available_(buffer_size),
+              initial_next_size_(buffer_size < EInitialSize ? static_cast<size_t>(EInitialSize) : buffer_size << 1),
+              next_size_(initial_next_size_), blocks_(nullptr) {}
+
+        monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+        monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+        ~monotonic_buffer_resource() override { release(); }
+
+        // 归还所有上游缓冲区，重新从初始缓冲区开始分配
+        // 下一次向上游申请的大小也回到构造时的值，反复使用时每一轮的申请不会越来越大
+        void release() {
+            while(blocks_ != nullptr) {
+                Block* next = blocks_->next;
+                upstream_->deallocate(blocks_, blocks_->size, alignof(std::max_align_t));
+                blocks_ = next;
+            }
+            current_ = initial_buffer_;
+            available_ = initial_size_;
+            next_size_ = initial_next_size_;
+        }
+
+        memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+    private:
+        // 上游缓冲区的头部
+        struct Block {
+            Block* next;    // 下一块缓冲区
+            size_t size;    // 整块缓冲区的大小，包括头部
+        };
+
+        enum { EInitialSize = 1024 };
+
+        memory_resource* upstream_;     // 上游资源
+        char* initial_buffer_;          // 调用者提供的初始缓冲区
+        size_t initial_size_;           // 初始缓冲区的大小
+        char* current_;                 // 当前缓冲区中下一次分配的位置
+        size_t available_;              // 当前缓冲区剩余的大小
+        size_t initial_next_size_;      // 构造时确定的第一次向上游申请的大小，release 时恢复
+        size_t next_size_;              // 下一次向上游申请的大小
+        Block* blocks_;                 // 向上游申请的所有缓冲区
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            if(bytes == 0) bytes = 1;
+            char* p = align_up(current_, alignment);
+            size_t need = static_cast<size_t>(p - current_) + bytes;
+            if(current_ == nullptr || need > available_) {
+                M_grow(bytes, alignment);
+                p = align_up(current_, alignment);
+                need = static_cast<size_t>(p - current_) + bytes;
+            }
+            current_ += need;
+            available_ -= need;
+            return p;
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        // 向上游申请一块新的缓冲区，大小按 2 倍增长，且至少容纳本次请求
+        void M_grow(size_t bytes, size_t alignment) {
+            size_t size = sizeof(Block) + bytes + alignment;
+            if(size < next_size_)
+                size = next_size_;
+            Block* block = static_cast<Block*>(upstream_->allocate(size, alignof(std::max_align_t)));
+            block->next = blocks_;
+            block->size = size;
+            blocks_ = block;
+            current_ = reinterpret_cast<char*>(block) + sizeof(Block);
+            available_ = size - sizeof(Block);
+            next_size_ = size << 1;
+        }
+    };
+
+    /*****************************************************************************************/
+    // pool resource
+
+    // 结构体：pool_options
+    // 为 0 的项使用默认值
+    struct pool_options {
+        size_t max_blocks_per_chunk;         // 每次向上游申请的 chunk 最多包含的区块数
+        size_t largest_required_pool_block;  // 由内存池管理的最大区块，更大的请求直接交给上游
+    };
+
+    // 类：unsynchronized_pool_resource
+    // 按 8、16、32 ... 2 的幂分级的内存池，每级用 FreeList 串起空闲区块，不加锁
+    // 超过 largest_required_pool_block 的请求直接交给上游，并记录下来以便 release 时归还
+    class unsynchronized_pool_resource : public memory_resource {
+    public:
+        unsynchronized_pool_resource()
+            : unsynchronized_pool_resource(pool_options(), get_default_resource()) {}
+
+        explicit unsynchronized_pool_resource(memory_resource* upstream)
+            : unsynchronized_pool_resource(pool_options(), upstream) {}
+
+        explicit unsynchronized_pool_resource(const pool_options& opts,
+            memory_resource* upstream = get_default_resource())
+            : upstream_(upstream), pool_count_(0), chunks_(nullptr), large_(nullptr) {
+            options_.max_blocks_per_chunk = opts.max_blocks_per_chunk == 0
+                ? static_cast<size_t>(EDefaultMaxBlocks) : opts.max_blocks_per_chunk;
+            size_t largest = opts.largest_required_pool_block == 0
+                ? static_cast<size_t>(ESmallObjectBytes) : opts.largest_required_pool_block;
+            if(largest > (static_cast<size_t>(EMinBlockBytes) << (EMaxPools - 1)))
+                largest = static_cast<size_t>(EMinBlockBytes) << (EMaxPools - 1);
+            while((static_cast<size_t>(EMinBlockBytes) << pool_count_) < largest)
+                ++pool_count_;
+            ++pool_count_;
+            options_.largest_required_pool_block = static_cast<size_t>(EMinBlockBytes) << (pool_count_ - 1);
+            for(size_t i = 0; i < pool_count_; ++i) {
+                pools_[i].free_list = nullptr;
+                pools_[i].next_blocks = EInitialBlocks;
+            }
+        }
+
+        unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+        unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+        ~unsynchronized_pool_resource() override { release(); }
+
+        // 归还所有 chunk 与直接交给上游的大块内存
+        void release() {
+            while(chunks_ != nullptr) {
+                Chunk* next = chunks_->next;
+                upstream_->deallocate(chunks_->base, chunks_->size, chunks_->alignment);
+                chunks_ = next;
+            }
+            while(large_ != nullptr) {
+                LargeBlock* next = large_->next;
+                upstream_->deallocate(large_->base, large_->size, large_->alignment);
+                large_ = next;
+            }
+            for(size_t i = 0; i < pool_count_; ++i) {
+                pools_[i].free_list = nullptr;
+                pools_[i].next_blocks = EInitialBlocks;
+            }
+        }
+
+        memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+        pool_options options() const { return options_; }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            const size_t need = bytes < alignment ? alignment : bytes;
+            if(need > options_.largest_required_pool_block)
+                return M_allocate_large(bytes, alignment);
+            Pool& pool = pools_[M_pool_index(need)];
+            if(pool.free_list == nullptr)
+                M_refill(pool, M_block_size(M_pool_index(need)));
+            FreeList* result = pool.free_list;
+            pool.free_list = result->next;
+            return result;
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            const size_t need = bytes < alignment ? alignment : bytes;
+            if(need > options_.largest_required_pool_block) {
+                M_deallocate_large(p, bytes, alignment);
+                return;
+            }
+            Pool& pool = pools_[M_pool_index(need)];
+            FreeList* q = static_cast<FreeList*>(p);
+            q->next = pool.free_list;
+            pool.free_list = q;
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        enum { EMinBlockBytes = 8 };
+        enum { EMaxPools = 16 };            // 最大区块为 8 << 15 = 256 KiB
+        enum { EInitialBlocks = 16 };
+        enum { EDefaultMaxBlocks = 1024 };
+
+        // 一级内存池
+        struct Pool {
+            FreeList* free_list;    // 空闲区块
+            size_t next_blocks;     // 下一次 chunk 包含的区块数
+        };
+
+        // chunk 的记录，放在 chunk 的尾部，不影响区块的对齐
+        struct Chunk {
+            Chunk* next;
+            void* base;
+            size_t size;
+            size_t alignment;
+        };
+
+        // 直接交给上游的大块内存的记录，放在返回地址之前
+        struct LargeBlock {
+            LargeBlock* prev;
+            LargeBlock* next;
+            void* base;
+            size_t size;
+            size_t alignment;
+        };
+
+        memory_resource* upstream_;
+        pool_options options_;
+        Pool pools_[EMaxPools];
+        size_t pool_count_;
+        Chunk* chunks_;
+        LargeBlock* large_;
+
+        static size_t M_pool_index(size_t bytes) {
+            size_t index = 0;
+            while((static_cast<size_t>(EMinBlockBytes) << index) < bytes)
+                ++index;
+            return index;
+        }
+
+        static size_t M_block_size(size_t index) {
+            return static_cast<size_t>(EMinBlockBytes) << index;
+        }
+
+        // 向上游申请一个 chunk 切成区块，chunk 按区块大小对齐，因此每个区块都按自身大小对齐
+        void M_refill(Pool& pool, size_t block_size) {
+            const size_t nblock = pool.next_blocks;
+            const size_t data_bytes = nblock * block_size;
+            const size_t size = data_bytes + sizeof(Chunk);
+            const size_t alignment = block_size < alignof(Chunk) ? alignof(Chunk) : block_size;
+            char* base = static_cast<char*>(upstream_->allocate(size, alignment));
+            Chunk* chunk = reinterpret_cast<Chunk*>(base + data_bytes);
+            chunk->next = chunks_;
+            chunk->base = base;
+            chunk->size = size;
+            chunk->alignment = alignment;
+            chunks_ = chunk;
+
+            for(size_t i = nblock; i > 0; --i) {
+                FreeList* q = reinterpret_cast<FreeList*>(base + (i - 1) * block_size);
+                q->next = pool.free_list;
+                pool.free_list = q;
+            }
+            if(pool.next_blocks < options_.max_blocks_per_chunk) {
+                pool.next_blocks <<= 1;
+                if(pool.next_blocks > options_.max_blocks_per_chunk)
+                    pool.next_blocks = options_.max_blocks_per_chunk;
+            }
+        }
+
+        // 头部的大小，保证返回地址满足 alignment
+        static size_t M_large_header(size_t alignment) {
+            const size_t a = alignment < alignof(LargeBlock) ? alignof(LargeBlock) : alignment;
+            return (sizeof(LargeBlock) + a - 1) & ~(a - 1);
+        }
+
+        void* M_allocate_large(size_t bytes, size_t alignment) {
+            const size_t header = M_large_header(alignment);
+            const size_t a = alignment < alignof(LargeBlock) ? alignof(LargeBlock) : alignment;
+            char* base = static_cast<char*>(upstream_->allocate(header + bytes, a));
+            char* p = base + header;
+            LargeBlock* block = reinterpret_cast<LargeBlock*>(p) - 1;
+            block->prev = nullptr;
+            block->next = large_;
+            block->base = base;
+            block->size = header + bytes;
+            block->alignment = a;
+            if(large_ != nullptr)
+                large_->prev = block;
+            large_ = block;
+            return p;
+        }
+
+        void M_deallocate_large(void* p, size_t, size_t) {
+            LargeBlock* block = static_cast<LargeBlock*>(p) - 1;
+            if(block->prev != nullptr)
+                block->prev->next = block->next;
+            else
+                large_ = block->next;
+            if(block->next != nullptr)
+                block->next->prev = block->prev;
+            upstream_->deallocate(block->base, block->size, block->alignment);
+        }
+    };
+
+    // 类：synchronized_pool_resource
+    // 以互斥锁保护的 unsynchronized_pool_resource，可以在多个线程之间共享
+    class synchronized_pool_resource : public memory_resource {
+    public:
+        synchronized_pool_resource()
+            : pool_(pool_options(), get_default_resource()) {}
+
+        explicit synchronized_pool_resource(memory_resource* upstream)
+            : pool_(pool_options(), upstream) {}
+
+        explicit synchronized_pool_resource(const pool_options& opts,
+            memory_resource* upstream = get_default_resource())
+            : pool_(opts, upstream) {}
+
+        synchronized_pool_resource(const synchronized_pool_resource&) = delete;
+        synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+
+        void release() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool_.release();
+        }
+
+        memory_resource* upstream_resource() const noexcept { return pool_.upstream_resource(); }
+
+        pool_options options() const { return pool_.options(); }
+
+    private:
+        unsynchronized_pool_resource pool_;
+        std::mutex mutex_;
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return pool_.allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool_.deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    /*****************************************************************************************/
+    // polymorphic_allocator
+
+    // 模板类：polymorphic_allocator
+    // 持有一个 memory_resource 指针，容器以它为分配器时，所有内存都来自该资源
+    // 例如以 monotonic_buffer_resource 为资源，请求结束时 release 即可一次释放全部数据
+    template<typename T>
+    class polymorphic_allocator {
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef const T*    const_pointer;
+        typedef T&          reference;
+        typedef const T&    const_reference;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        template<typename U>
+        struct rebind {
+            typedef polymorphic_allocator<U> other;
+        };
+
+    public:
+        polymorphic_allocator() noexcept : resource_(get_default_resource()) {}
+
+        polymorphic_allocator(memory_resource* r) noexcept : resource_(r) {}
+
+        polymorphic_allocator(const polymorphic_allocator& other) = default;
+
+        template<typename U>
+        polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept
+            : resource_(other.resource()) {}
+
+        polymorphic_allocator& operator=(const polymorphic_allocator&) = delete;
+
+        T* allocate(size_type n) {
+            if(n > static_cast<size_type>(-1) / sizeof(T))
+                throw std::bad_alloc();
+            return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* ptr, size_type n) {
+            resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        template<typename U, typename... Args>
+        void construct(U* ptr, Args&& ...args) {
+            mystl::construct(ptr, mystl::forward<Args>(args)...);
+        }
+
+        template<typename U>
+        void destroy(U* ptr) {
+            mystl::destroy(ptr);
+        }
+
+        // 容器拷贝时不传播资源，新容器使用默认资源
+        polymorphic_allocator select_on_container_copy_construction() const {
+            return polymorphic_allocator();
+        }
+
+        memory_resource* resource() const noexcept { return resource_; }
+
+    private:
+        memory_resource* resource_;
+    };
+
+    template<typename T, typename U>
+    bool operator==(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+    template<typename T, typename U>
+    bool operator!=(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+}
+
+#endif // MY_TINY_MEMORY_RESOURCE_H_
@@ -0,0 +1,41 @@
+#ifndef MY_TINY_NUMERIC_H_
+#define MY_TINY_NUMERIC_H_
+
+// 这个头文件包含了 mystl 的数值算法
+
+#include "iterator.h"
+#include "functional.h"
+
+namespace mystl {
+
+/*****************************************************************************************/
+// reduce
+// 以二元操作 binary_op 归约[first, last)区间内的元素与初值 init
+// binary_op 须满足结合律与交换律，并行版本（见 execution.h）不保证元素的结合顺序
+/*****************************************************************************************/
+template<typename InputIter, typename T, typename BinaryOp>
+T reduce(InputIter first, InputIter last, T init, BinaryOp binary_op) {
+    for(; first != last; ++first) {
+        init = binary_op(init, *first);
+    }
+    return init;
+}
+
+// 以加法归约
+template<typename InputIter, typename T>
+T reduce(InputIter first, InputIter last, T init) {
+    return mystl::reduce(first, last, init, mystl::plus<T>());
+}
+
+// 以加法归约，初值为加法的证同元素
+template<typename InputIter>
+typename iterator_traits<InputIter>::value_type
+reduce(InputIter first, InputIter last) {
+    typedef typename iterator_traits<InputIter>::value_type value_type;
+    return mystl::reduce(first, last, mystl::identity_element(mystl::plus<value_type>()),
+                         mystl::plus<value_type>());
+}
+
+} // namespace mystl
+
+#endif // MY_TINY_NUMERIC_H_
@@ -0,0 +1,350 @@
+#ifndef MY_TINY_OBJECT_POOL_H_
+#define MY_TINY_OBJECT_POOL_H_
+
+// 这个头文件包含一个模板类 object_pool，以及使用它的分配策略 object_pool_policy
+// object_pool : 按类型的 slab 分配器，把页大小的 slab 切分为恰好 sizeof(T) 大小的槽，
+//               空闲的槽以内嵌的 FreeList 串起来，相邻分配的对象落在相邻的地址上
+// object_pool_policy : allocator 的分配策略，单个对象的 allocate() / deallocate(T*) 经由每个类型一份的
+//                      全局 object_pool，每个线程另有一个小的缓存（magazine），快路径上不加锁
+
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+
+#include "alloc.h"
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+
+// 每个线程、每个类型缓存的空闲槽个数上限，定义为 0 时不使用线程缓存，每次分配与回收都加锁
+#ifndef MYSTL_OBJECT_MAGAZINE_SIZE
+#define MYSTL_OBJECT_MAGAZINE_SIZE 64
+#endif // MYSTL_OBJECT_MAGAZINE_SIZE
+
+namespace mystl {
+    // slab 的大小，对象较大时上调到能容纳 EObjectSlabMinObjects 个对象的页的整数倍
+    enum { EObjectSlabBytes = 4096 };
+    enum { EObjectSlabMinObjects = 8 };
+
+    // 线程缓存为空或过满时，与全局 object_pool 之间一次搬运的槽数
+    enum { EObjectMagazineSize = MYSTL_OBJECT_MAGAZINE_SIZE };
+    enum { EObjectMagazineBatch = EObjectMagazineSize / 2 > 0 ? EObjectMagazineSize / 2 : 1 };
+
+    // 模板类：object_pool
+    // 只分配单个 T 大小的槽，不构造对象；create / destroy 同时负责构造与析构
+    // 槽从 slab 中按顺序切出，用过的槽回收到自由链表，先于未切分的空间被再次使用
+    // 析构或 release 时把 slab 整块归还系统，不析构尚未 destroy 的对象
+    // 不加锁，多个线程共享时使用 object_pool_policy
+    template<typename T>
+    class object_pool {
+    public:
+        typedef T       value_type;
+        typedef size_t  size_type;
+
+        // 槽的对齐与大小：至少能放下一个 FreeList 指针
+        enum { slot_align = alignof(T) < alignof(FreeList) ? alignof(FreeList) : alignof(T) };
+        enum { slot_size = ((sizeof(T) < sizeof(FreeList) ? sizeof(FreeList) : sizeof(T)) + slot_align - 1)
+                           & ~(static_cast<size_t>(slot_align) - 1) };
+
+    private:
+        // 结构体：slab_header
+        // 位于每个 slab 的头部，把所有 slab 串成链表
+        struct slab_header {
+            slab_header* next;
+        };
+
+        enum { M_header_bytes = (sizeof(slab_header) + slot_align - 1) & ~(static_cast<size_t>(slot_align) - 1) };
+        enum { M_slab_align = static_cast<size_t>(slot_align) < static_cast<size_t>(EObjectSlabBytes)
+                              ? static_cast<size_t>(EObjectSlabBytes) : static_cast<size_t>(slot_align) };
+
+    public:
+        enum { slab_bytes = (static_cast<size_t>(M_header_bytes) + static_cast<size_t>(slot_size) * EObjectSlabMinObjects
+                             + EObjectSlabBytes - 1) & ~(static_cast<size_t>(EObjectSlabBytes) - 1) };
+        enum { objects_per_slab = (static_cast<size_t>(slab_bytes) - M_header_bytes) / slot_size };
+
+    private:
+        FreeList* free_;        // 回收的槽
+        char* cur_;             // 当前 slab 中尚未切分的空间
+        char* end_;
+        slab_header* slabs_;    // 所有的 slab，按申请的顺序串接
+        slab_header* last_;     // 最近申请的 slab
+        slab_header* reuse_;    // clear 之后，尚未重新切分的 slab
+        size_type slab_count_;
+
+    public:
+        object_pool() noexcept
+            : free_(nullptr), cur_(nullptr), end_(nullptr), slabs_(nullptr), last_(nullptr), reuse_(nullptr),
+              slab_count_(0) {}
+
+        object_pool(const object_pool&) = delete;
+        object_pool& operator=(const object_pool&) = delete;
+
+        ~object_pool() {
+            M_free_slabs();
+        }
+
+        // 分配一个未构造的槽
+        T* allocate() {
+            if(free_ != nullptr) {
+                FreeList* p = free_;
+                free_ = p->next;
+                return reinterpret_cast<T*>(p);
+            }
+            if(cur_ == end_)
+                M_next_slab();
+            T* p = reinterpret_cast<T*>(cur_);
+            cur_ += slot_size;
+            return p;
+        }
+
+        // 归还一个槽，p 必须来自本 object_pool，且其中的对象已析构
+        void deallocate(T* p) noexcept {
+            if(p == nullptr) return;
+            FreeList* node = reinterpret_cast<FreeList*>(p);
+            node->next = free_;
+            free_ = node;
+        }
+
+        // 分配并构造一个对象，构造抛出异常时归还槽
+        template<typename ...Args>
+        T* create(Args&& ...args) {
+            T* p = allocate();
+            try {
+                mystl::construct(p, mystl::forward<Args>(args)...);
+            } catch(...) {
+                deallocate(p);
+                throw;
+            }
+            return p;
+        }
+
+        // 析构并归还一个对象
+        void destroy(T* p) {
+            if(p == nullptr) return;
+            mystl::destroy(p);
+            deallocate(p);
+        }
+
+        // 一次回收所有的槽，不逐个析构与回收；slab 留作之后的分配，按原来的顺序重新切分
+        // 只适用于可平凡析构的 T，否则应逐个 destroy
+        void clear() noexcept {
+            static_assert(std::is_trivially_destructible<T>::value,
+                          "object_pool::clear requires a trivially destructible T");
+            free_ = nullptr;
+            cur_ = end_ = nullptr;
+            reuse_ = slabs_;
+        }
+
+        // 一次回收所有的槽，并把 slab 全部归还系统；只适用于可平凡析构的 T
+        void release() noexcept {
+            static_assert(std::is_trivially_destructible<T>::value,
+                          "object_pool::release requires a trivially destructible T");
+            M_free_slabs();
+        }
+
+        // 持有的 slab 个数与槽的总数
+        size_type slab_count() const noexcept { return slab_count_; }
+        size_type capacity() const noexcept { return slab_count_ * objects_per_slab; }
+
+    private:
+        template<typename U>
+        friend class object_pool_global;
+
+        // 取出至多 n 个槽，串成以 nullptr 结尾的链表，返回取出的个数
+        // 先取回收的槽，不够时从当前 slab 切分，不申请新的 slab，除非一个槽也取不到
+        // 回收的槽保持在自由链表中的次序整段摘下，切分的槽按地址递增接在其后，
+        // 因此连续回收的相邻槽被再次分配时仍然相邻
+        size_type M_take(FreeList*& head, size_type n) {
+            size_type got = 0;
+            FreeList** tail = &head;
+            while(got < n && free_ != nullptr) {
+                *tail = free_;
+                tail = &free_->next;
+                free_ = free_->next;
+                ++got;
+            }
+            if(got == 0 && cur_ == end_)
+                M_next_slab();
+            size_type avail = static_cast<size_type>(end_ - cur_) / slot_size;
+            size_type carve = n - got < avail ? n - got : avail;
+            for(size_type i = 0; i < carve; ++i) {
+                FreeList* node = reinterpret_cast<FreeList*>(cur_ + i * slot_size);
+                *tail = node;
+                tail = &node->next;
+            }
+            *tail = nullptr;
+            cur_ += carve * slot_size;
+            return got + carve;
+        }
+
+        // 归还 first 到 last 串起的一段槽
+        void M_give(FreeList* first, FreeList* last) noexcept {
+            last->next = free_;
+            free_ = first;
+        }
+
+        // 切换到下一个 slab：优先重用 clear 之后的 slab，否则向系统申请
+        void M_next_slab() {
+            char* slab;
+            if(reuse_ != nullptr) {
+                slab = reinterpret_cast<char*>(reuse_);
+                reuse_ = reuse_->next;
+            } else {
+                slab = static_cast<char*>(mystl::aligned_malloc(slab_bytes, M_slab_align));
+                if(slab == nullptr) throw std::bad_alloc();
+                slab_header* header = reinterpret_cast<slab_header*>(slab);
+                header->next = nullptr;
+                if(last_ != nullptr)
+                    last_->next = header;
+                else
+                    slabs_ = header;
+                last_ = header;
+                ++slab_count_;
+            }
+            cur_ = slab + M_header_bytes;
+            end_ = cur_ + static_cast<size_t>(objects_per_slab) * slot_size;
+        }
+
+        void M_free_slabs() noexcept {
+            while(slabs_ != nullptr) {
+                slab_header* next = slabs_->next;
+                mystl::aligned_free(slabs_);
+                slabs_ = next;
+            }
+            last_ = nullptr;
+            free_ = nullptr;
+            cur_ = end_ = nullptr;
+            reuse_ = nullptr;
+            slab_count_ = 0;
+        }
+    };
+
+    /*****************************************************************************************/
+
+    // 模板类：object_pool_global
+    // 每个类型一份的全局 object_pool，由互斥锁保护；每个线程持有一个 magazine，
+    // 分配与回收只操作 magazine，为空或过满时才加锁与全局 object_pool 成批交换 EObjectMagazineBatch 个槽
+    // 全局 object_pool 有意不析构，退出较晚的线程与静态对象仍可安全地归还槽
+    template<typename T>
+    class object_pool_global {
+    private:
+        struct central {
+            std::mutex mutex;
+            object_pool<T> pool;
+        };
+
+        // 结构体：magazine
+        // 线程私有的空闲槽链表，线程退出时全部归还全局 object_pool
+        struct magazine {
+            FreeList* head;
+            size_t count;
+
+            magazine() noexcept : head(nullptr), count(0) {}
+            ~magazine() {
+                if(count != 0)
+                    object_pool_global::M_flush(*this, count);
+            }
+        };
+
+        static central& M_central() {
+            static central* c = new central;
+            return *c;
+        }
+
+        static magazine& M_magazine() {
+            static thread_local magazine m;
+            return m;
+        }
+
+        // 从 magazine 摘下 n 个槽归还全局 object_pool
+        static void M_flush(magazine& m, size_t n) noexcept {
+            FreeList* first = m.head;
+            FreeList* last = first;
+            for(size_t i = 1; i < n; ++i)
+                last = last->next;
+            m.head = last->next;
+            m.count -= n;
+            central& c = M_central();
+            std::lock_guard<std::mutex> lock(c.mutex);
+            c.pool.M_give(first, last);
+        }
+
+        static T* M_refill(magazine& m) {
+            FreeList* head;
+            size_t got;
+            {
+                central& c = M_central();
+                std::lock_guard<std::mutex> lock(c.mutex);
+                got = c.pool.M_take(head, EObjectMagazineBatch);
+            }
+            m.head = head->next;
+            m.count = got - 1;
+            return reinterpret_cast<T*>(head);
+        }
+
+        static T* M_allocate(std::true_type) {
+            magazine& m = M_magazine();
+            FreeList* p = m.head;
+            if(p == nullptr)
+                return M_refill(m);
+            m.head = p->next;
+            --m.count;
+            return reinterpret_cast<T*>(p);
+        }
+
+        static T* M_allocate(std::false_type) {
+            central& c = M_central();
+            std::lock_guard<std::mutex> lock(c.mutex);
+            return c.pool.allocate();
+        }
+
+        static void M_deallocate(T* p, std::true_type) noexcept {
+            magazine& m = M_magazine();
+            FreeList* node = reinterpret_cast<FreeList*>(p);
+            node->next = m.head;
+            m.head = node;
+            if(++m.count > static_cast<size_t>(EObjectMagazineSize))
+                M_flush(m, EObjectMagazineBatch);
+        }
+
+        static void M_deallocate(T* p, std::false_type) noexcept {
+            central& c = M_central();
+            std::lock_guard<std::mutex> lock(c.mutex);
+            c.pool.deallocate(p);
+        }
+
+        typedef std::integral_constant<bool, (EObjectMagazineSize > 0)> M_use_magazine;
+
+    public:
+        static T* allocate() {
+            return M_allocate(M_use_magazine());
+        }
+
+        static void deallocate(T* p) noexcept {
+            if(p == nullptr) return;
+            M_deallocate(p, M_use_magazine());
+        }
+    };
+
+    // 分配策略：object_pool_policy
+    // 单个对象的分配由 allocator 经 allocate_object / deallocate_object 交给对应类型的全局 object_pool，
+    // 数组的分配退回 new_policy
+    struct object_pool_policy : new_policy {
+        typedef object_pool_policy object_policy_tag;
+
+        template<typename T>
+        static T* allocate_object() {
+            return object_pool_global<T>::allocate();
+        }
+
+        template<typename T>
+        static void deallocate_object(T* ptr) noexcept {
+            object_pool_global<T>::deallocate(ptr);
+        }
+    };
+
+} // namespace mystl
+
+#endif // MY_TINY_OBJECT_POOL_H_
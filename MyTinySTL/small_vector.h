@@ -0,0 +1,827 @@
+#ifndef MY_TINY_SMALL_VECTOR_H_
+#define MY_TINY_SMALL_VECTOR_H_
+
+// 这个头文件包含一个模板类 small_vector
+// small_vector : 带内联缓冲区的向量，至多 N 个元素时存放在对象内部，不申请堆空间；超过 N 个后改用空间配置器
+
+#include <initializer_list>
+#include <stdexcept>
+
+#include "iterator.h"
+#include "allocator.h"
+#include "construct.h"
+#include "uninitialized.h"
+#include "algobase.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+
+    // 模板类: small_vector
+    // 模板参数 T 代表元素类型，N 代表内联缓冲区可容纳的元素个数，Alloc 代表空间配置器
+    // 元素在内联缓冲区中时，移动操作逐个移动元素；已转存到堆上时，移动操作直接接管对方的空间
+    // 扩容、插入和删除时，可平凡重定位的元素（见 is_trivially_relocatable）以 memcpy / memmove 整体搬移
+    // 对象内部保存指向内联缓冲区的指针，small_vector 本身不是可平凡重定位的
+    template<typename T, size_t N, typename Alloc = mystl::allocator<T>>
+    class small_vector {
+        static_assert(N > 0, "small_vector requires an inline capacity greater than 0");
+        static_assert(!std::is_same<bool, T>::value, "small_vector<bool> is not supported in mystl");
+
+    public:
+        typedef Alloc                                       allocator_type;
+        typedef T                                           value_type;
+        typedef T*                                          pointer;
+        typedef const T*                                    const_pointer;
+        typedef T&                                          reference;
+        typedef const T&                                    const_reference;
+        typedef size_t                                      size_type;
+        typedef ptrdiff_t                                   difference_type;
+
+        typedef T*                                          iterator;
+        typedef const T*                                    const_iterator;
+        typedef mystl::reverse_iterator<iterator>           reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+        // 内联缓冲区的容量
+        enum { inline_capacity = N };
+
+    private:
+        allocator_type alloc_;  // 空间配置器
+        iterator begin_;        // 表示目前使用空间的头部
+        iterator end_;          // 表示目前使用空间的尾部
+        iterator cap_;          // 表示目前储存空间的尾部
+        alignas(T) unsigned char buf_[sizeof(T) * N];   // 内联缓冲区
+
+    public:
+        // 构造、复制、移动、析构函数
+        small_vector() noexcept
+            : alloc_(), begin_(M_inline()), end_(M_inline()), cap_(M_inline() + N) {}
+
+        explicit small_vector(const allocator_type& alloc) noexcept
+            : alloc_(alloc), begin_(M_inline()), end_(M_inline()), cap_(M_inline() + N) {}
+
+        explicit small_vector(size_type n, const allocator_type& alloc = allocator_type())
+            : alloc_(alloc), begin_(M_inline()), end_(M_inline()), cap_(M_inline() + N) {
+            M_default_append(n);
+        }
+
+        small_vector(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+            : alloc_(alloc), begin_(M_inline()), end_(M_inline()), cap_(M_inline() + N) {
+            M_fill_assign(n, value);
+        }
+
+        template<typename Iter, typename std::enable_if<
+            mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        small_vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+            : alloc_(alloc), begin_(M_inline()), end_(M_inline()), cap_(M_inline() + N) {
+            M_range_assign(first, last, iterator_category(first));
+        }
+
+        small_vector(const small_vector& rhs)
+            : alloc_(M_select_on_copy(rhs.alloc_, 0)), begin_(M_inline()), end_(M_inline()), cap_(M_inline() + N) {
+            M_range_assign(rhs.begin_, rhs.end_, mystl::random_access_iterator_tag());
+        }
+
+        small_vector(const small_vector& rhs, const allocator_type& alloc)
+            : alloc_(alloc), begin_(M_inline()), end_(M_inline()), cap_(M_inline() + N) {
+            M_range_assign(rhs.begin_, rhs.end_, mystl::random_access_iterator_tag());
+        }
+
+        // rhs 在堆上时接管它的空间，否则逐个移动元素；之后 rhs 为空
+        small_vector(small_vector&& rhs) noexcept(M_nothrow_steal::value)
+            : alloc_(rhs.alloc_), begin_(M_inline()), end_(M_inline()), cap_(M_inline() + N) {
+            if(rhs.M_is_inline()) {
+                M_steal_elements(rhs, M_relocatable());
+            } else {
+                begin_ = rhs.begin_;
+                end_ = rhs.end_;
+                cap_ = rhs.cap_;
+                rhs.M_reset();
+            }
+        }
+
+        small_vector(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+            : alloc_(alloc), begin_(M_inline()), end_(M_inline()), cap_(M_inline() + N) {
+            M_range_assign(ilist.begin(), ilist.end(), mystl::random_access_iterator_tag());
+        }
+
+        small_vector& operator=(const small_vector& rhs);
+        small_vector& operator=(small_vector&& rhs);
+
+        small_vector& operator=(std::initializer_list<value_type> ilist) {
+            M_range_assign(ilist.begin(), ilist.end(), mystl::random_access_iterator_tag());
+            return *this;
+        }
+
+        ~small_vector() {
+            M_free();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator begin() noexcept { return begin_; }
+        const_iterator begin() const noexcept { return begin_; }
+        iterator end() noexcept { return end_; }
+        const_iterator end() const noexcept { return end_; }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // 容量相关操作
+        bool empty() const noexcept { return begin_ == end_; }
+        size_type size() const noexcept { return static_cast<size_type>(end_ - begin_); }
+        size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+        size_type capacity() const noexcept { return static_cast<size_type>(cap_ - begin_); }
+        void reserve(size_type n);
+        void shrink_to_fit();
+
+        // 元素是否存放在内联缓冲区中
+        bool is_inline() const noexcept { return M_is_inline(); }
+
+        // 访问元素相关操作
+        reference operator[](size_type n) { return *(begin_ + n); }
+        const_reference operator[](size_type n) const { return *(begin_ + n); }
+
+        reference at(size_type n) {
+            if(n >= size()) throw std::out_of_range("small_vector<T, N>::at() subscript out of range");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const {
+            if(n >= size()) throw std::out_of_range("small_vector<T, N>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference front() { return *begin_; }
+        const_reference front() const { return *begin_; }
+        reference back() { return *(end_ - 1); }
+        const_reference back() const { return *(end_ - 1); }
+
+        pointer data() noexcept { return begin_; }
+        const_pointer data() const noexcept { return begin_; }
+
+        // 修改容器相关操作
+
+        // assign
+        void assign(size_type n, const value_type& value) { M_fill_assign(n, value); }
+
+        template<typename Iter, typename std::enable_if<
+            mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        void assign(Iter first, Iter last) {
+            M_range_assign(first, last, iterator_category(first));
+        }
+
+        void assign(std::initializer_list<value_type> ilist) {
+            M_range_assign(ilist.begin(), ilist.end(), mystl::random_access_iterator_tag());
+        }
+
+        // emplace / emplace_back
+        template<typename... Args>
+        iterator emplace(const_iterator pos, Args&& ...args);
+
+        template<typename... Args>
+        reference emplace_back(Args&& ...args);
+
+        // push_back / pop_back
+        void push_back(const value_type& value) { emplace_back(value); }
+        void push_back(value_type&& value) { emplace_back(mystl::move(value)); }
+
+        void pop_back() {
+            --end_;
+            mystl::destroy(end_);
+        }
+
+        // insert
+        iterator insert(const_iterator pos, const value_type& value) { return emplace(pos, value); }
+        iterator insert(const_iterator pos, value_type&& value) { return emplace(pos, mystl::move(value)); }
+
+        iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+        template<typename Iter, typename std::enable_if<
+            mystl::is_input_iterator<Iter>::value, int>::type = 0>
+        iterator insert(const_iterator pos, Iter first, Iter last) {
+            return M_range_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<value_type> ilist) {
+            return M_range_insert(const_cast<iterator>(pos), ilist.begin(), ilist.end(),
+                                  mystl::random_access_iterator_tag());
+        }
+
+        // erase / clear
+        iterator erase(const_iterator pos);
+        iterator erase(const_iterator first, const_iterator last);
+
+        void clear() noexcept {
+            mystl::destroy(begin_, end_);
+            end_ = begin_;
+        }
+
+        // resize
+        void resize(size_type new_size);
+        void resize(size_type new_size, const value_type& value);
+
+        // swap 只交换数据，不交换空间配置器，两者的配置器必须相等
+        // 两者都在堆上时只交换指针，否则经由一个临时对象逐个移动元素
+        void swap(small_vector& rhs) noexcept(M_nothrow_steal::value);
+
+        allocator_type get_allocator() const { return alloc_; }
+
+    private:
+        // helper functions
+
+        // 内联缓冲区
+        pointer M_inline() noexcept { return reinterpret_cast<pointer>(buf_); }
+        const_pointer M_inline() const noexcept { return reinterpret_cast<const_pointer>(buf_); }
+        bool M_is_inline() const noexcept { return begin_ == M_inline(); }
+
+        // 改为使用空的内联缓冲区，不析构元素，也不释放空间
+        void M_reset() noexcept {
+            begin_ = end_ = M_inline();
+            cap_ = M_inline() + N;
+        }
+
+        // 配置器对象：容器拷贝时若配置器提供 select_on_container_copy_construction，则以它的结果为准
+        template<typename A>
+        static auto M_select_on_copy(const A& a, int) -> decltype(a.select_on_container_copy_construction()) {
+            return a.select_on_container_copy_construction();
+        }
+        template<typename A>
+        static A M_select_on_copy(const A& a, long) {
+            return a;
+        }
+
+        // 分配与释放空间，内联缓冲区不归还配置器
+        pointer M_allocate(size_type n) {
+            return alloc_.allocate(n);
+        }
+        void M_deallocate(pointer p, size_type n) {
+            if(p != M_inline()) alloc_.deallocate(p, n);
+        }
+        void M_free();
+
+        size_type M_recommend(size_type add) const;
+
+        // 元素是否可平凡重定位
+        typedef std::integral_constant<bool,
+            mystl::is_trivially_relocatable<T>::value> M_relocatable;
+
+        // 从内联缓冲区中移走元素是否不抛出异常
+        typedef std::integral_constant<bool,
+            M_relocatable::value || std::is_nothrow_move_constructible<T>::value> M_nothrow_steal;
+
+        // 把 rhs 的元素搬到本容器的空间中，空间须已足够；之后 rhs 为空
+        void M_steal_elements(small_vector& rhs, std::true_type) noexcept {
+            end_ = mystl::uninitialized_relocate(rhs.begin_, rhs.end_, end_);
+            rhs.end_ = rhs.begin_;
+        }
+        void M_steal_elements(small_vector& rhs, std::false_type) {
+            end_ = mystl::uninitialized_move(rhs.begin_, rhs.end_, end_);
+            rhs.clear();
+        }
+
+        // 把 [first, last) 搬到未初始化空间 result
+        // 可平凡重定位的元素直接按字节重定位，否则复制或移动，原区间的元素由 M_adopt_storage 析构
+        static pointer M_transfer(pointer first, pointer last, pointer result, std::true_type);
+        static pointer M_transfer(pointer first, pointer last, pointer result, std::false_type);
+        static pointer M_transfer(pointer first, pointer last, pointer result) {
+            return M_transfer(first, last, result, M_relocatable());
+        }
+
+        void M_reallocate(size_type new_cap);
+        void M_replace_storage(pointer new_begin, pointer new_end, size_type new_cap);
+        void M_adopt_storage(pointer new_begin, pointer new_end, size_type new_cap);
+
+        template<typename... Args>
+        void M_realloc_emplace(iterator pos, Args&& ...args);
+
+        void M_default_append(size_type n);
+        void M_fill_assign(size_type n, const value_type& value);
+
+        template<typename Iter>
+        void M_range_assign(Iter first, Iter last, mystl::input_iterator_tag);
+        template<typename Iter>
+        void M_range_assign(Iter first, Iter last, mystl::forward_iterator_tag);
+
+        template<typename Iter>
+        iterator M_range_insert(iterator pos, Iter first, Iter last, mystl::input_iterator_tag);
+        template<typename Iter>
+        iterator M_range_insert(iterator pos, Iter first, Iter last, mystl::forward_iterator_tag);
+    };
+
+    /*****************************************************************************************/
+
+    // 复制赋值操作符
+    template<typename T, size_t N, typename Alloc>
+    small_vector<T, N, Alloc>& small_vector<T, N, Alloc>::operator=(const small_vector& rhs) {
+        if(this != &rhs) {
+            M_range_assign(rhs.begin_, rhs.end_, mystl::random_access_iterator_tag());
+        }
+        return *this;
+    }
+
+    // 移动赋值操作符
+    // rhs 在堆上且配置器相等时直接接管 rhs 的空间，否则逐个移动元素
+    template<typename T, size_t N, typename Alloc>
+    small_vector<T, N, Alloc>& small_vector<T, N, Alloc>::operator=(small_vector&& rhs) {
+        if(this == &rhs)
+            return *this;
+        if(!rhs.M_is_inline() && alloc_ == rhs.alloc_) {
+            M_free();
+            begin_ = rhs.begin_;
+            end_ = rhs.end_;
+            cap_ = rhs.cap_;
+            rhs.M_reset();
+        } else {
+            clear();
+            reserve(rhs.size());
+            M_steal_elements(rhs, M_relocatable());
+        }
+        return *this;
+    }
+
+    // 预留空间大小，当原容量小于要求大小时，才会重新分配
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::reserve(size_type n) {
+        if(n <= capacity())
+            return;
+        if(n > max_size())
+            throw std::length_error("n can not larger than max_size() in small_vector<T, N>::reserve(n)");
+        M_reallocate(n);
+    }
+
+    // 放弃多余的容量，元素个数不超过 N 时搬回内联缓冲区
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::shrink_to_fit() {
+        if(M_is_inline() || end_ == cap_)
+            return;
+        if(size() <= N) {
+            pointer new_end = M_transfer(begin_, end_, M_inline());
+            M_adopt_storage(M_inline(), new_end, N);
+            return;
+        }
+        M_reallocate(size());
+    }
+
+    // 在 pos 位置就地构造元素，避免额外的复制或移动开销
+    template<typename T, size_t N, typename Alloc>
+    template<typename... Args>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::emplace(const_iterator pos, Args&& ...args) {
+        iterator xpos = const_cast<iterator>(pos);
+        const size_type n = static_cast<size_type>(xpos - begin_);
+        if(end_ == cap_) {
+            M_realloc_emplace(xpos, mystl::forward<Args>(args)...);
+        } else if(xpos == end_) {
+            mystl::construct(end_, mystl::forward<Args>(args)...);
+            ++end_;
+        } else if(M_relocatable::value && std::is_nothrow_move_constructible<T>::value) {
+            // 参数可能引用容器内的元素，先构造出临时对象，再把 [xpos, end_) 整体后移一位
+            value_type tmp(mystl::forward<Args>(args)...);
+            mystl::relocate_n(xpos, static_cast<size_type>(end_ - xpos), xpos + 1);
+            mystl::construct(xpos, mystl::move(tmp));
+            ++end_;
+        } else {
+            // 参数可能引用容器内的元素，先构造出临时对象
+            value_type tmp(mystl::forward<Args>(args)...);
+            mystl::construct(end_, mystl::move(*(end_ - 1)));
+            ++end_;
+            mystl::move_backward(xpos, end_ - 2, end_ - 1);
+            *xpos = mystl::move(tmp);
+        }
+        return begin_ + n;
+    }
+
+    // 在尾部就地构造元素，均摊 O(1)
+    template<typename T, size_t N, typename Alloc>
+    template<typename... Args>
+    typename small_vector<T, N, Alloc>::reference
+    small_vector<T, N, Alloc>::emplace_back(Args&& ...args) {
+        if(end_ != cap_) {
+            mystl::construct(end_, mystl::forward<Args>(args)...);
+            ++end_;
+        } else {
+            M_realloc_emplace(end_, mystl::forward<Args>(args)...);
+        }
+        return *(end_ - 1);
+    }
+
+    // 在 pos 处插入 n 个元素
+    template<typename T, size_t N, typename Alloc>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::insert(const_iterator pos, size_type n, const value_type& value) {
+        iterator xpos = const_cast<iterator>(pos);
+        const size_type index = static_cast<size_type>(xpos - begin_);
+        if(n == 0)
+            return xpos;
+        if(static_cast<size_type>(cap_ - end_) >= n) {
+            // 备用空间足够，value 可能引用容器内的元素，先复制一份
+            const value_type value_copy(value);
+            const size_type after = static_cast<size_type>(end_ - xpos);
+            iterator old_end = end_;
+            if(after > n) {
+                end_ = mystl::uninitialized_move(end_ - n, end_, end_);
+                mystl::move_backward(xpos, old_end - n, old_end);
+                mystl::fill_n(xpos, n, value_copy);
+            } else {
+                end_ = mystl::uninitialized_fill_n(end_, n - after, value_copy);
+                end_ = mystl::uninitialized_move(xpos, old_end, end_);
+                mystl::fill_n(xpos, after, value_copy);
+            }
+        } else {
+            const size_type new_cap = M_recommend(n);
+            pointer new_begin = M_allocate(new_cap);
+            pointer new_pos = new_begin + index;
+            pointer new_end = new_begin;
+            pointer fill_end = new_pos;
+            try {
+                fill_end = mystl::uninitialized_fill_n(new_pos, n, value);
+                new_end = M_transfer(begin_, xpos, new_begin);
+                new_end = M_transfer(xpos, end_, fill_end);
+            } catch(...) {
+                mystl::destroy(new_pos, fill_end);
+                mystl::destroy(new_begin, new_end);
+                M_deallocate(new_begin, new_cap);
+                throw;
+            }
+            M_adopt_storage(new_begin, new_end, new_cap);
+        }
+        return begin_ + index;
+    }
+
+    // 删除 pos 位置上的元素
+    template<typename T, size_t N, typename Alloc>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::erase(const_iterator pos) {
+        iterator xpos = const_cast<iterator>(pos);
+        if(M_relocatable::value) {
+            // 析构被删除的元素，再把后面的元素整体前移
+            mystl::destroy(xpos);
+            mystl::relocate_n(xpos + 1, static_cast<size_type>(end_ - xpos - 1), xpos);
+        } else {
+            mystl::move(xpos + 1, end_, xpos);
+            mystl::destroy(end_ - 1);
+        }
+        --end_;
+        return xpos;
+    }
+
+    // 删除 [first, last) 上的元素
+    template<typename T, size_t N, typename Alloc>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::erase(const_iterator first, const_iterator last) {
+        iterator xfirst = const_cast<iterator>(first);
+        iterator xlast = const_cast<iterator>(last);
+        if(first == last) {
+            return xfirst;
+        }
+        if(M_relocatable::value) {
+            mystl::destroy(xfirst, xlast);
+            end_ = mystl::relocate_n(xlast, static_cast<size_type>(end_ - xlast), xfirst);
+        } else {
+            iterator new_end = mystl::move(xlast, end_, xfirst);
+            mystl::destroy(new_end, end_);
+            end_ = new_end;
+        }
+        return xfirst;
+    }
+
+    // 重置容器大小，新增的元素值初始化
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::resize(size_type new_size) {
+        if(new_size < size()) {
+            erase(begin_ + new_size, end_);
+        } else {
+            M_default_append(new_size - size());
+        }
+    }
+
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::resize(size_type new_size, const value_type& value) {
+        if(new_size < size()) {
+            erase(begin_ + new_size, end_);
+        } else {
+            insert(end_, new_size - size(), value);
+        }
+    }
+
+    // 与另一个 small_vector 交换
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::swap(small_vector& rhs) noexcept(M_nothrow_steal::value) {
+        if(this == &rhs)
+            return;
+        if(!M_is_inline() && !rhs.M_is_inline()) {
+            mystl::swap(begin_, rhs.begin_);
+            mystl::swap(end_, rhs.end_);
+            mystl::swap(cap_, rhs.cap_);
+            return;
+        }
+        small_vector tmp(mystl::move(rhs));
+        rhs = mystl::move(*this);
+        *this = mystl::move(tmp);
+    }
+
+    /*****************************************************************************************/
+    // helper functions
+
+    // 销毁所有元素并释放空间，回到内联缓冲区
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::M_free() {
+        mystl::destroy(begin_, end_);
+        M_deallocate(begin_, static_cast<size_type>(cap_ - begin_));
+        M_reset();
+    }
+
+    // 需要再容纳 add 个元素时，计算新的容量，增长方式与 vector 相同
+    template<typename T, size_t N, typename Alloc>
+    typename small_vector<T, N, Alloc>::size_type
+    small_vector<T, N, Alloc>::M_recommend(size_type add) const {
+        const size_type old_size = size();
+        if(add > max_size() - old_size)
+            throw std::length_error("small_vector<T, N>'s size too big");
+        const size_type old_cap = capacity();
+        const size_type need = old_size + add;
+        const size_type max_grow = max_size() / MYSTL_VECTOR_GROWTH_NUM * MYSTL_VECTOR_GROWTH_DEN;
+        if(old_cap > max_grow)
+            return need > old_cap ? need : old_cap;
+        const size_type grow = old_cap / MYSTL_VECTOR_GROWTH_DEN * MYSTL_VECTOR_GROWTH_NUM
+                             + old_cap % MYSTL_VECTOR_GROWTH_DEN * MYSTL_VECTOR_GROWTH_NUM / MYSTL_VECTOR_GROWTH_DEN;
+        return need > grow ? need : grow;
+    }
+
+    // 可平凡重定位的元素：一次 memcpy，原对象的生命期随之结束
+    template<typename T, size_t N, typename Alloc>
+    typename small_vector<T, N, Alloc>::pointer
+    small_vector<T, N, Alloc>::M_transfer(pointer first, pointer last, pointer result, std::true_type) {
+        return mystl::uninitialized_relocate(first, last, result);
+    }
+
+    // 其它元素：移动构造不抛出异常或不可复制时移动，否则复制，以保证扩容的强异常安全
+    template<typename T, size_t N, typename Alloc>
+    typename small_vector<T, N, Alloc>::pointer
+    small_vector<T, N, Alloc>::M_transfer(pointer first, pointer last, pointer result, std::false_type) {
+        pointer cur = result;
+        try {
+            for(; first != last; ++first, ++cur) {
+                mystl::construct(cur, std::move_if_noexcept(*first));
+            }
+        } catch(...) {
+            mystl::destroy(result, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    // 重新分配 new_cap 大小的堆空间，并把元素搬过去
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::M_reallocate(size_type new_cap) {
+        pointer new_begin = M_allocate(new_cap);
+        pointer new_end;
+        try {
+            new_end = M_transfer(begin_, end_, new_begin);
+        } catch(...) {
+            M_deallocate(new_begin, new_cap);
+            throw;
+        }
+        M_adopt_storage(new_begin, new_end, new_cap);
+    }
+
+    // 销毁旧空间中的元素，旧空间在堆上时释放它，改用新空间
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::M_replace_storage(pointer new_begin, pointer new_end, size_type new_cap) {
+        mystl::destroy(begin_, end_);
+        M_deallocate(begin_, static_cast<size_type>(cap_ - begin_));
+        begin_ = new_begin;
+        end_ = new_end;
+        cap_ = new_begin + new_cap;
+    }
+
+    // 元素已由 M_transfer 搬到新空间，改用新空间
+    // 已被重定位的旧元素不再析构
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::M_adopt_storage(pointer new_begin, pointer new_end, size_type new_cap) {
+        if(M_relocatable::value)
+            end_ = begin_;
+        M_replace_storage(new_begin, new_end, new_cap);
+    }
+
+    // 空间不足时，扩容并在 pos 处构造元素
+    // 新元素先在新空间中构造，参数引用旧空间中的元素也是安全的
+    template<typename T, size_t N, typename Alloc>
+    template<typename... Args>
+    void small_vector<T, N, Alloc>::M_realloc_emplace(iterator pos, Args&& ...args) {
+        const size_type new_cap = M_recommend(1);
+        pointer new_begin = M_allocate(new_cap);
+        pointer new_pos = new_begin + (pos - begin_);
+        pointer new_end = new_begin;
+        bool constructed = false;
+        try {
+            mystl::construct(new_pos, mystl::forward<Args>(args)...);
+            constructed = true;
+            new_end = M_transfer(begin_, pos, new_begin);
+            new_end = M_transfer(pos, end_, new_pos + 1);
+        } catch(...) {
+            if(constructed)
+                mystl::destroy(new_pos);
+            mystl::destroy(new_begin, new_end);
+            M_deallocate(new_begin, new_cap);
+            throw;
+        }
+        M_adopt_storage(new_begin, new_end, new_cap);
+    }
+
+    // 在尾部追加 n 个值初始化的元素
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::M_default_append(size_type n) {
+        if(n == 0)
+            return;
+        if(static_cast<size_type>(cap_ - end_) >= n) {
+            end_ = mystl::uninitialized_value_construct_n(end_, n);
+            return;
+        }
+        const size_type new_cap = M_recommend(n);
+        pointer new_begin = M_allocate(new_cap);
+        pointer new_pos = new_begin + size();
+        pointer append_end = new_pos;
+        try {
+            append_end = mystl::uninitialized_value_construct_n(new_pos, n);
+            M_transfer(begin_, end_, new_begin);
+        } catch(...) {
+            mystl::destroy(new_pos, append_end);
+            M_deallocate(new_begin, new_cap);
+            throw;
+        }
+        M_adopt_storage(new_begin, append_end, new_cap);
+    }
+
+    // 把容器的内容替换为 n 个 value
+    template<typename T, size_t N, typename Alloc>
+    void small_vector<T, N, Alloc>::M_fill_assign(size_type n, const value_type& value) {
+        if(n > capacity()) {
+            if(n > max_size())
+                throw std::length_error("small_vector<T, N>'s size too big");
+            pointer new_begin = M_allocate(n);
+            pointer new_end;
+            try {
+                new_end = mystl::uninitialized_fill_n(new_begin, n, value);
+            } catch(...) {
+                M_deallocate(new_begin, n);
+                throw;
+            }
+            M_replace_storage(new_begin, new_end, n);
+        } else if(n > size()) {
+            mystl::fill(begin_, end_, value);
+            end_ = mystl::uninitialized_fill_n(end_, n - size(), value);
+        } else {
+            erase(mystl::fill_n(begin_, n, value), end_);
+        }
+    }
+
+    // 用 [first, last) 替换容器的内容，input_iterator_tag 版本
+    template<typename T, size_t N, typename Alloc>
+    template<typename Iter>
+    void small_vector<T, N, Alloc>::M_range_assign(Iter first, Iter last, mystl::input_iterator_tag) {
+        iterator cur = begin_;
+        for(; first != last && cur != end_; ++first, ++cur) {
+            *cur = *first;
+        }
+        if(first == last) {
+            erase(cur, end_);
+        } else {
+            M_range_insert(end_, first, last, mystl::input_iterator_tag());
+        }
+    }
+
+    // forward_iterator_tag 版本
+    template<typename T, size_t N, typename Alloc>
+    template<typename Iter>
+    void small_vector<T, N, Alloc>::M_range_assign(Iter first, Iter last, mystl::forward_iterator_tag) {
+        const size_type len = static_cast<size_type>(mystl::distance(first, last));
+        if(len > capacity()) {
+            if(len > max_size())
+                throw std::length_error("small_vector<T, N>'s size too big");
+            pointer new_begin = M_allocate(len);
+            pointer new_end;
+            try {
+                new_end = mystl::uninitialized_copy(first, last, new_begin);
+            } catch(...) {
+                M_deallocate(new_begin, len);
+                throw;
+            }
+            M_replace_storage(new_begin, new_end, len);
+        } else if(size() >= len) {
+            iterator new_end = mystl::copy(first, last, begin_);
+            mystl::destroy(new_end, end_);
+            end_ = new_end;
+        } else {
+            Iter mid = first;
+            mystl::advance(mid, size());
+            mystl::copy(first, mid, begin_);
+            end_ = mystl::uninitialized_copy(mid, last, end_);
+        }
+    }
+
+    // 在 pos 处插入 [first, last)，input_iterator_tag 版本
+    template<typename T, size_t N, typename Alloc>
+    template<typename Iter>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::M_range_insert(iterator pos, Iter first, Iter last, mystl::input_iterator_tag) {
+        const size_type index = static_cast<size_type>(pos - begin_);
+        for(size_type i = index; first != last; ++first, ++i) {
+            emplace(begin_ + i, *first);
+        }
+        return begin_ + index;
+    }
+
+    // forward_iterator_tag 版本
+    template<typename T, size_t N, typename Alloc>
+    template<typename Iter>
+    typename small_vector<T, N, Alloc>::iterator
+    small_vector<T, N, Alloc>::M_range_insert(iterator pos, Iter first, Iter last, mystl::forward_iterator_tag) {
+        const size_type index = static_cast<size_type>(pos - begin_);
+        if(first == last)
+            return pos;
+        const size_type n = static_cast<size_type>(mystl::distance(first, last));
+        if(static_cast<size_type>(cap_ - end_) >= n) {
+            const size_type after = static_cast<size_type>(end_ - pos);
+            iterator old_end = end_;
+            if(after > n) {
+                end_ = mystl::uninitialized_move(end_ - n, end_, end_);
+                mystl::move_backward(pos, old_end - n, old_end);
+                mystl::copy(first, last, pos);
+            } else {
+                Iter mid = first;
+                mystl::advance(mid, after);
+                end_ = mystl::uninitialized_copy(mid, last, end_);
+                end_ = mystl::uninitialized_move(pos, old_end, end_);
+                mystl::copy(first, mid, pos);
+            }
+        } else {
+            const size_type new_cap = M_recommend(n);
+            pointer new_begin = M_allocate(new_cap);
+            pointer new_pos = new_begin + index;
+            pointer new_end = new_begin;
+            pointer copy_end = new_pos;
+            try {
+                copy_end = mystl::uninitialized_copy(first, last, new_pos);
+                new_end = M_transfer(begin_, pos, new_begin);
+                new_end = M_transfer(pos, end_, copy_end);
+            } catch(...) {
+                mystl::destroy(new_pos, copy_end);
+                mystl::destroy(new_begin, new_end);
+                M_deallocate(new_begin, new_cap);
+                throw;
+            }
+            M_adopt_storage(new_begin, new_end, new_cap);
+        }
+        return begin_ + index;
+    }
+
+    /*****************************************************************************************/
+    // 重载比较操作符
+
+    template<typename T, size_t N, typename Alloc>
+    bool operator==(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<typename T, size_t N, typename Alloc>
+    bool operator<(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<typename T, size_t N, typename Alloc>
+    bool operator!=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<typename T, size_t N, typename Alloc>
+    bool operator>(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return rhs < lhs;
+    }
+
+    template<typename T, size_t N, typename Alloc>
+    bool operator<=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<typename T, size_t N, typename Alloc>
+    bool operator>=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+        return !(lhs < rhs);
+    }
+
+    // 重载 mystl 的 swap
+    template<typename T, size_t N, typename Alloc>
+    void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+        lhs.swap(rhs);
+    }
+
+} // namespace mystl
+
+#endif // MY_TINY_SMALL_VECTOR_H_
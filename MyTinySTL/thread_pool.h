@@ -0,0 +1,654 @@
+#ifndef MY_TINY_THREAD_POOL_H_
+#define MY_TINY_THREAD_POOL_H_
+
+// 这个头文件包含一个工作窃取（work stealing）线程池 thread_pool，作为 mystl 的并行运行时
+// submit：      提交一个任务，由池中的线程异步执行，没有工作线程时在调用线程上执行
+// task_group：  fork/join，spawn 在栈上构造的 fork_task，sync 等待它们完成
+// parallel_for：把 fn(0) ... fn(n - 1) 分给池中的线程与调用线程一起执行，全部完成后返回
+// 每个工作线程有一个 Chase-Lev 双端队列，自己从底部压入、弹出任务，空闲的线程从其它队列顶部窃取；
+// 池外的线程使用 task_group 时借用一个备用的队列，借不到时 spawn 的任务进入共享的注入队列；
+// 等待任务完成的线程不阻塞，而是继续执行其它任务
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif // __linux__
+
+#include "function.h"
+#include "vector.h"
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+
+namespace mystl {
+
+    class thread_pool;
+    class task_group;
+
+    enum {
+        EWorkDequeSize = 4096,      // 每个工作线程的双端队列容量，满时任务进入注入队列
+        EWorkerSpinRounds = 64,     // 找不到任务时，休眠（让出时间片）之前重试的次数
+        EExternalSlots = 4,         // 供池外的线程借用的队列个数
+        EParallelForChunks = 16     // parallel_for 自动选择粒度时，每个线程平均分到的块数
+    };
+
+    // 工作线程的 CPU 亲和性
+    enum thread_affinity {
+        EAffinityNone,              // 由操作系统调度
+        EAffinityPinned             // 第 i 个工作线程固定在第 i + 1 个 CPU 上（目前只在 Linux 上生效）
+    };
+
+    // 任务的公共部分，run 执行任务
+    // spawn 的任务属于一个 task_group，submit 的任务 group 为空，执行之后释放自身
+    struct task_base {
+        void (*run)(task_base*);
+        task_group* group;
+        task_base* next;            // 注入队列中的下一个任务
+        task_base* sibling;         // 同一 task_group 中上一个 spawn 的任务
+    };
+
+    /*****************************************************************************************/
+    // work_deque
+    // Chase-Lev 双端队列（固定容量，内存序按 Le 等人对弱内存模型的修订）
+    // 只有拥有者调用 push / pop，其它线程调用 steal；steal 与 pop 竞争最后一个任务时以 CAS 决定
+    /*****************************************************************************************/
+    class work_deque {
+    private:
+        alignas(64) std::atomic<ptrdiff_t> top_;
+        alignas(64) std::atomic<ptrdiff_t> bottom_;
+        alignas(64) std::atomic<task_base*> buffer_[EWorkDequeSize];
+
+    public:
+        work_deque() noexcept : top_(0), bottom_(0) {}
+
+        work_deque(const work_deque&) = delete;
+        work_deque& operator=(const work_deque&) = delete;
+
+        bool empty() const noexcept {
+            return bottom_.load(std::memory_order_acquire) <= top_.load(std::memory_order_acquire);
+        }
+
+        // 队列已满时返回 false
+        bool push(task_base* t) noexcept {
+            const ptrdiff_t b = bottom_.load(std::memory_order_relaxed);
+            const ptrdiff_t top = top_.load(std::memory_order_acquire);
+            if(b - top >= static_cast<ptrdiff_t>(EWorkDequeSize))
+                return false;
+            buffer_[b & (EWorkDequeSize - 1)].store(t, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 取出最近压入的任务
+        task_base* pop() noexcept {
+            const ptrdiff_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            ptrdiff_t top = top_.load(std::memory_order_relaxed);
+            task_base* t = nullptr;
+            if(top <= b) {
+                t = buffer_[b & (EWorkDequeSize - 1)].load(std::memory_order_relaxed);
+                if(top == b) {
+                    if(!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                     std::memory_order_relaxed))
+                        t = nullptr;
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                }
+            } else {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+            return t;
+        }
+
+        // 窃取最早压入的任务，队列为空或与其它线程竞争失败时返回空
+        task_base* steal() noexcept {
+            ptrdiff_t top = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const ptrdiff_t b = bottom_.load(std::memory_order_acquire);
+            if(top >= b)
+                return nullptr;
+            task_base* t = buffer_[top & (EWorkDequeSize - 1)].load(std::memory_order_relaxed);
+            if(!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed))
+                return nullptr;
+            return t;
+        }
+    };
+
+    /*****************************************************************************************/
+    // thread_pool
+    /*****************************************************************************************/
+    class thread_pool {
+    public:
+        // 池中线程数，默认比硬件线程数少一个，等待任务的调用线程自身也参与计算
+        explicit thread_pool(size_t nthreads = default_size(), thread_affinity affinity = EAffinityNone);
+        ~thread_pool();
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        size_t size() const noexcept { return workers_.size(); }
+
+        // 提交一个任务，任务可以是只能移动的可调用对象，任务抛出的异常被忽略
+        // 线程池没有工作线程时直接在当前线程执行；析构线程池时，尚未执行的任务在析构的线程上执行
+        void submit(mystl::move_only_function<void()> fn);
+
+        // grain 为每块的最少下标数，为 0 时按 n 与线程数自动选择
+        // 区间先对半切分到每个线程都有事可做，此后只在自己的队列为空（任务已被窃取）时才继续切分，
+        // 因此负载均衡时块较大，负载不均时块自动变小；某一下标抛出异常时，剩余的下标不再执行
+        template<typename F>
+        void parallel_for(size_t n, F&& fn) {
+            parallel_for(n, 0, mystl::forward<F>(fn));
+        }
+        template<typename F>
+        void parallel_for(size_t n, size_t grain, F&& fn);
+
+        // 全局线程池，首次使用时创建
+        static thread_pool& instance() {
+            static thread_pool pool;
+            return pool;
+        }
+
+        // 环境变量 MYSTL_NUM_THREADS 指定参与计算的线程总数（包括调用线程）时以它为准
+        static size_t default_size() {
+            const char* env = std::getenv("MYSTL_NUM_THREADS");
+            if(env != nullptr) {
+                const long n = std::strtol(env, nullptr, 10);
+                if(n > 0)
+                    return static_cast<size_t>(n - 1);
+            }
+            const size_t n = std::thread::hardware_concurrency();
+            return n > 1 ? n - 1 : 0;
+        }
+
+    private:
+        friend class task_group;
+        template<typename F> friend class fork_task;
+
+        struct worker {
+            work_deque deque;
+            thread_pool* pool;
+            std::thread thread;
+            std::atomic<bool> claimed;      // 供池外线程借用的队列是否已被借出
+        };
+
+        // submit 提交的任务，执行之后释放自身
+        struct heap_task : task_base {
+            mystl::move_only_function<void()> fn;
+
+            static void M_run(task_base* t) {
+                heap_task* h = static_cast<heap_task*>(t);
+                try {
+                    h->fn();
+                } catch(...) {
+                }
+                delete h;
+            }
+        };
+
+        mystl::vector<worker*> workers_;
+        mystl::vector<worker*> victims_;        // 可以窃取的队列：工作线程的队列在前，借给池外线程的队列在后
+        size_t split_depth_;                    // parallel_for 无条件切分的层数
+
+        // 注入队列
+        std::mutex inject_mutex_;
+        task_base* inject_head_;
+        task_base* inject_tail_;
+        std::atomic<size_t> inject_size_;
+
+        // 空闲的工作线程在这里休眠
+        std::mutex sleep_mutex_;
+        std::condition_variable sleep_cv_;
+        std::atomic<size_t> sleepers_;
+        bool stop_;
+
+        // 当前线程所在的工作线程或借用的队列，池外的线程为空
+        static worker*& M_current() noexcept {
+            static thread_local worker* current = nullptr;
+            return current;
+        }
+        worker* M_self() const noexcept {
+            worker* w = M_current();
+            return w != nullptr && w->pool == this ? w : nullptr;
+        }
+
+        static size_t M_random() noexcept {
+            static thread_local uint64_t state = 0;
+            if(state == 0)
+                state = reinterpret_cast<uintptr_t>(&state) | 1;
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return static_cast<size_t>(state);
+        }
+
+        // worker 按缓存行对齐，C++11 的 new 不保证扩展对齐
+        typedef mystl::aligned_allocator<worker, alignof(worker)> worker_allocator;
+
+        worker* M_claim_guest() noexcept;
+        void M_push(task_base* t);
+        task_base* M_pop_injected();
+        task_base* M_find_task(worker* self);
+        bool M_has_work() const noexcept;
+        static void M_execute(task_base* t);
+        void M_wait(task_group& g);
+        void M_worker_loop(worker* self, thread_affinity affinity, size_t index);
+        bool M_should_split(size_t depth) const noexcept;
+
+        template<typename F>
+        void M_for(size_t lo, size_t hi, size_t grain, size_t depth, F& fn, std::atomic<bool>& stop);
+    };
+
+    /*****************************************************************************************/
+    // task_group 与 fork_task
+    /*****************************************************************************************/
+
+    // 类：task_group
+    // spawn 把任务交给线程池，sync 等待本组所有任务完成并重新抛出其中第一个异常
+    // 等待期间当前线程执行自己队列中的任务或窃取其它任务，不会阻塞
+    // 只有创建 task_group 的线程可以调用 spawn 与 sync，析构时等待所有任务完成但不抛出异常
+    class task_group {
+    public:
+        // 池外的线程在最外层的 task_group 存续期间借用一个队列，此后与工作线程的行为相同
+        explicit task_group(thread_pool& pool = thread_pool::instance()) noexcept
+            : pool_(pool), pending_(0), failed_(false), spawned_(nullptr),
+              saved_(thread_pool::M_current()), guest_(nullptr) {
+            if(pool_.size() != 0 && pool_.M_self() == nullptr) {
+                guest_ = pool_.M_claim_guest();
+                if(guest_ != nullptr)
+                    thread_pool::M_current() = guest_;
+            }
+        }
+
+        ~task_group() {
+            pool_.M_wait(*this);
+            if(guest_ != nullptr) {
+                thread_pool::M_current() = saved_;
+                guest_->claimed.store(false, std::memory_order_release);
+            }
+        }
+
+        task_group(const task_group&) = delete;
+        task_group& operator=(const task_group&) = delete;
+
+        // task 在 sync 返回之前不能销毁；线程池没有工作线程时直接在当前线程执行
+        void spawn(task_base& task) {
+            task.group = this;
+            task.next = nullptr;
+            task.sibling = spawned_;
+            spawned_ = &task;
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            if(pool_.size() == 0)
+                thread_pool::M_execute(&task);
+            else
+                pool_.M_push(&task);
+        }
+
+        void sync() {
+            pool_.M_wait(*this);
+            if(failed_.load(std::memory_order_relaxed)) {
+                std::exception_ptr e = error_;
+                error_ = nullptr;
+                failed_.store(false, std::memory_order_relaxed);
+                std::rethrow_exception(e);
+            }
+        }
+
+    private:
+        friend class thread_pool;
+        template<typename F> friend class fork_task;
+
+        thread_pool& pool_;
+        std::atomic<size_t> pending_;
+        std::atomic<bool> failed_;
+        std::exception_ptr error_;
+        std::mutex error_mutex_;
+        task_base* spawned_;
+        thread_pool::worker* saved_;    // 借用队列之前当前线程所在的工作线程
+        thread_pool::worker* guest_;    // 借用的队列
+
+        void M_set_error(std::exception_ptr e) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if(!failed_.load(std::memory_order_relaxed)) {
+                error_ = e;
+                failed_.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        // 所有任务已完成，解除任务与本组的关联
+        void M_detach() noexcept {
+            for(task_base* t = spawned_; t != nullptr; t = t->sibling) {
+                t->group = nullptr;
+            }
+            spawned_ = nullptr;
+        }
+    };
+
+    // 模板类：fork_task
+    // 由调用者在栈上构造、交给 task_group::spawn 的任务，不需要为每个任务分配堆空间
+    // 析构时如果任务仍属于某个 task_group（例如异常跳过了 sync），先等待该组完成
+    template<typename F>
+    class fork_task : public task_base {
+    private:
+        F fn_;
+
+        static void M_run(task_base* t) {
+            static_cast<fork_task*>(t)->fn_();
+        }
+
+        void M_init() noexcept {
+            run = &M_run;
+            group = nullptr;
+            next = nullptr;
+            sibling = nullptr;
+        }
+
+    public:
+        explicit fork_task(const F& fn) : fn_(fn) { M_init(); }
+        explicit fork_task(F&& fn) : fn_(mystl::move(fn)) { M_init(); }
+
+        // 只能在 spawn 之前移动
+        fork_task(fork_task&& rhs) : fn_(mystl::move(rhs.fn_)) { M_init(); }
+
+        fork_task(const fork_task&) = delete;
+        fork_task& operator=(const fork_task&) = delete;
+
+        ~fork_task() {
+            if(group != nullptr)
+                group->pool_.M_wait(*group);
+        }
+    };
+
+    template<typename F>
+    fork_task<typename std::decay<F>::type> make_task(F&& fn) {
+        return fork_task<typename std::decay<F>::type>(mystl::forward<F>(fn));
+    }
+
+    // 并行执行 f1 与 f2，全部完成后返回
+    template<typename F1, typename F2>
+    void parallel_invoke(F1&& f1, F2&& f2, thread_pool& pool = thread_pool::instance()) {
+        auto task = make_task([&f2]() { f2(); });
+        task_group g(pool);
+        g.spawn(task);
+        f1();
+        g.sync();
+    }
+
+    /*****************************************************************************************/
+    // thread_pool 的实现
+    /*****************************************************************************************/
+
+    inline thread_pool::thread_pool(size_t nthreads, thread_affinity affinity)
+        : split_depth_(1), inject_head_(nullptr), inject_tail_(nullptr), inject_size_(0),
+          sleepers_(0), stop_(false) {
+        for(size_t n = 1; n < nthreads + 1; n <<= 1) {
+            ++split_depth_;
+        }
+        workers_.reserve(nthreads);
+        victims_.reserve(nthreads + EExternalSlots);
+        for(size_t i = 0; i < nthreads + EExternalSlots; ++i) {
+            worker* w = worker_allocator::allocate();
+            mystl::construct(w);
+            w->pool = this;
+            w->claimed.store(i < nthreads, std::memory_order_relaxed);
+            victims_.push_back(w);
+            if(i < nthreads)
+                workers_.push_back(w);
+        }
+        // 所有队列就绪之后再启动线程，工作线程会窃取其它线程的队列
+        for(size_t i = 0; i < nthreads; ++i) {
+            workers_[i]->thread = std::thread(&thread_pool::M_worker_loop, this, workers_[i], affinity, i);
+        }
+    }
+
+    inline thread_pool::~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_ = true;
+        }
+        sleep_cv_.notify_all();
+        for(size_t i = 0; i < workers_.size(); ++i) {
+            workers_[i]->thread.join();
+        }
+        while(task_base* t = M_pop_injected()) {
+            M_execute(t);
+        }
+        for(size_t i = 0; i < victims_.size(); ++i) {
+            mystl::destroy(victims_[i]);
+            worker_allocator::deallocate(victims_[i]);
+        }
+    }
+
+    inline void thread_pool::submit(mystl::move_only_function<void()> fn) {
+        if(size() == 0) {
+            try {
+                fn();
+            } catch(...) {
+            }
+            return;
+        }
+        heap_task* t = new heap_task;
+        t->run = &heap_task::M_run;
+        t->group = nullptr;
+        t->next = nullptr;
+        t->sibling = nullptr;
+        t->fn = mystl::move(fn);
+        M_push(t);
+    }
+
+    inline thread_pool::worker* thread_pool::M_claim_guest() noexcept {
+        for(size_t i = workers_.size(); i < victims_.size(); ++i) {
+            worker* w = victims_[i];
+            if(!w->claimed.load(std::memory_order_relaxed) &&
+               !w->claimed.exchange(true, std::memory_order_acquire))
+                return w;
+        }
+        return nullptr;
+    }
+
+    // 有队列的线程压入自己的队列，其它线程或队列已满时进入注入队列，然后唤醒一个休眠的工作线程
+    // 与休眠一方的 M_has_work 之间以 seq_cst 栅栏配对：双方至少有一方能看到对方的写入
+    inline void thread_pool::M_push(task_base* t) {
+        worker* self = M_self();
+        if(self == nullptr || !self->deque.push(t)) {
+            std::lock_guard<std::mutex> lock(inject_mutex_);
+            if(inject_tail_ != nullptr)
+                inject_tail_->next = t;
+            else
+                inject_head_ = t;
+            inject_tail_ = t;
+            inject_size_.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(sleepers_.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            sleep_cv_.notify_one();
+        }
+    }
+
+    inline task_base* thread_pool::M_pop_injected() {
+        if(inject_size_.load(std::memory_order_relaxed) == 0)
+            return nullptr;
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        task_base* t = inject_head_;
+        if(t != nullptr) {
+            inject_head_ = t->next;
+            if(inject_head_ == nullptr)
+                inject_tail_ = nullptr;
+            inject_size_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return t;
+    }
+
+    // 依次尝试：自己队列的底部、从随机位置开始窃取其它队列、注入队列
+    inline task_base* thread_pool::M_find_task(worker* self) {
+        task_base* t;
+        if(self != nullptr && (t = self->deque.pop()) != nullptr)
+            return t;
+        const size_t n = victims_.size();
+        if(n != 0) {
+            const size_t start = M_random() % n;
+            for(size_t k = 0; k < n; ++k) {
+                worker* victim = victims_[start + k < n ? start + k : start + k - n];
+                if(victim != self && (t = victim->deque.steal()) != nullptr)
+                    return t;
+            }
+        }
+        return M_pop_injected();
+    }
+
+    inline bool thread_pool::M_has_work() const noexcept {
+        if(inject_size_.load(std::memory_order_relaxed) != 0)
+            return true;
+        for(size_t i = 0; i < victims_.size(); ++i) {
+            if(!victims_[i]->deque.empty())
+                return true;
+        }
+        return false;
+    }
+
+    // 执行任务；任务所属的组在计数减为 0 之后可能随时销毁，之后不能再访问任务与组
+    inline void thread_pool::M_execute(task_base* t) {
+        task_group* g = t->group;
+        if(g == nullptr) {
+            t->run(t);
+            return;
+        }
+        try {
+            t->run(t);
+        } catch(...) {
+            g->M_set_error(std::current_exception());
+        }
+        g->pending_.fetch_sub(1, std::memory_order_release);
+    }
+
+    // 等待 g 的所有任务完成，期间执行其它任务
+    // 没有队列的池外线程只等待：它 spawn 的任务都在注入队列中，若也从中取任务执行，
+    // 取到的总是最早、最大的任务，嵌套的等待会使栈无限增长
+    inline void thread_pool::M_wait(task_group& g) {
+        worker* self = M_self();
+        size_t idle = 0;
+        while(g.pending_.load(std::memory_order_acquire) != 0) {
+            task_base* t = self != nullptr ? M_find_task(self) : nullptr;
+            if(t != nullptr) {
+                M_execute(t);
+                idle = 0;
+            } else if(++idle > EWorkerSpinRounds) {
+                std::this_thread::yield();
+            }
+        }
+        g.M_detach();
+    }
+
+    inline void thread_pool::M_worker_loop(worker* self, thread_affinity affinity, size_t index) {
+#if defined(__linux__)
+        if(affinity == EAffinityPinned) {
+            const size_t ncpu = std::thread::hardware_concurrency();
+            if(ncpu != 0) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(static_cast<int>((index + 1) % ncpu % CPU_SETSIZE), &set);
+                pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            }
+        }
+#else
+        (void)affinity;
+        (void)index;
+#endif // __linux__
+        M_current() = self;
+        size_t idle = 0;
+        for(;;) {
+            task_base* t = M_find_task(self);
+            if(t != nullptr) {
+                M_execute(t);
+                idle = 0;
+                continue;
+            }
+            if(++idle < EWorkerSpinRounds) {
+                std::this_thread::yield();
+                continue;
+            }
+            idle = 0;
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while(!stop_ && !M_has_work()) {
+                sleep_cv_.wait(lock);
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            if(stop_ && !M_has_work())
+                return;
+        }
+    }
+
+    // 池外的线程与浅层的切分无条件进行，此后只在自己的队列为空时切分
+    inline bool thread_pool::M_should_split(size_t depth) const noexcept {
+        if(depth < split_depth_)
+            return true;
+        worker* self = M_self();
+        return self != nullptr && self->deque.empty();
+    }
+
+    template<typename F>
+    void thread_pool::M_for(size_t lo, size_t hi, size_t grain, size_t depth, F& fn, std::atomic<bool>& stop) {
+        for(;;) {
+            if(stop.load(std::memory_order_relaxed))
+                return;
+            if(hi - lo > grain && M_should_split(depth)) {
+                const size_t mid = lo + (hi - lo) / 2;
+                auto right = make_task([this, mid, hi, grain, depth, &fn, &stop]() {
+                    M_for(mid, hi, grain, depth + 1, fn, stop);
+                });
+                task_group g(*this);
+                g.spawn(right);
+                M_for(lo, mid, grain, depth + 1, fn, stop);
+                g.sync();
+                return;
+            }
+            const size_t end = hi - lo > grain ? lo + grain : hi;
+            try {
+                for(size_t i = lo; i < end; ++i) {
+                    fn(i);
+                }
+            } catch(...) {
+                stop.store(true, std::memory_order_relaxed);
+                throw;
+            }
+            if(end == hi)
+                return;
+            lo = end;
+        }
+    }
+
+    template<typename F>
+    void thread_pool::parallel_for(size_t n, size_t grain, F&& fn) {
+        if(n == 0)
+            return;
+        if(grain == 0) {
+            grain = n / (EParallelForChunks * (size() + 1));
+            if(grain == 0)
+                grain = 1;
+        }
+        if(size() == 0 || n <= grain) {
+            for(size_t i = 0; i < n; ++i) {
+                fn(i);
+            }
+            return;
+        }
+        std::atomic<bool> stop(false);
+        M_for(0, n, grain, 0, fn, stop);
+    }
+
+} // namespace mystl
+
+#endif // MY_TINY_THREAD_POOL_H_
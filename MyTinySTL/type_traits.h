@@ -35,6 +35,19 @@ namespace mystl {
 
     template<typename T, typename U>
     struct is_pair<mystl::pair<T, U>> : mystl::m_true_type {};
+
+    // is_trivially_relocatable
+
+    // 可平凡重定位：把对象的字节搬到新地址并放弃原对象，等价于移动构造新对象后析构原对象
+    // 可平凡复制的类型自动满足；其它类型（如只持有堆指针的字符串、独占指针）可特化本模板以启用
+    template<typename T>
+    struct is_trivially_relocatable
+        : mystl::m_bool_constant<std::is_trivially_copyable<T>::value> {};
+
+    template<typename T, typename U>
+    struct is_trivially_relocatable<mystl::pair<T, U>>
+        : mystl::m_bool_constant<is_trivially_relocatable<T>::value &&
+                                 is_trivially_relocatable<U>::value> {};
     
 }   // namespzce mystl
 
@@ -0,0 +1,284 @@
+#ifndef MY_TINY_UNINITIALIZED_H_
+#define MY_TINY_UNINITIALIZED_H_
+
+// 这个头文件用于对未初始化空间构造元素
+// uninitialized_copy, uninitialized_fill, uninitialized_move,
+// uninitialized_default_construct, uninitialized_value_construct 及其 _n 版本
+// 连续存储的可平凡复制类型以 memmove / memset 完成，其它类型逐个构造，
+// 构造中途抛出异常时，已构造的元素被销毁，异常继续向外抛出
+
+#include <cstring>
+
+#include "type_traits.h"
+#include "iterator.h"
+#include "construct.h"
+#include "util.h"
+
+namespace mystl {
+
+    // 判断对象 value 的所有字节是否相同，相同时以 byte 返回该字节
+    template<typename T>
+    bool uninit_same_bytes(const T& value, unsigned char& byte) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(&value);
+        for(size_t i = 1; i < sizeof(T); ++i) {
+            if(p[i] != p[0])
+                return false;
+        }
+        byte = p[0];
+        return true;
+    }
+
+    /*****************************************************************************************/
+    // uninitialized_copy
+    // 把 [first, last) 上的内容复制到以 result 为起始处的空间，返回复制结束的位置
+    /*****************************************************************************************/
+    template<typename InputIter, typename ForwardIter>
+    ForwardIter uninitialized_copy(InputIter first, InputIter last, ForwardIter result) {
+        ForwardIter cur = result;
+        try {
+            for(; first != last; ++first, ++cur) {
+                mystl::construct(&*cur, *first);
+            }
+        } catch(...) {
+            mystl::destroy(result, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    // 为 trivially_copyable 类型提供特化版本
+    template<typename Tp, typename Up>
+    typename std::enable_if<
+        std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+        std::is_trivially_copyable<Up>::value,
+        Up*>::type
+    uninitialized_copy(Tp* first, Tp* last, Up* result) {
+        const auto n = static_cast<size_t>(last - first);
+        if(n != 0)
+            std::memmove(result, first, n * sizeof(Up));
+        return result + n;
+    }
+
+    /*****************************************************************************************/
+    // uninitialized_copy_n
+    // 把 [first, first + n) 上的内容复制到以 result 为起始处的空间，返回复制结束的位置
+    /*****************************************************************************************/
+    template<typename InputIter, typename Size, typename ForwardIter>
+    ForwardIter uninitialized_copy_n(InputIter first, Size n, ForwardIter result) {
+        ForwardIter cur = result;
+        try {
+            for(; n > 0; --n, ++first, ++cur) {
+                mystl::construct(&*cur, *first);
+            }
+        } catch(...) {
+            mystl::destroy(result, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    template<typename Tp, typename Size, typename Up>
+    typename std::enable_if<
+        std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+        std::is_trivially_copyable<Up>::value,
+        Up*>::type
+    uninitialized_copy_n(Tp* first, Size n, Up* result) {
+        return mystl::uninitialized_copy(first, first + n, result);
+    }
+
+    /*****************************************************************************************/
+    // uninitialized_fill_n
+    // 从 first 位置开始，填充 n 个元素值，返回填充结束的位置
+    /*****************************************************************************************/
+    template<typename ForwardIter, typename Size, typename T>
+    ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T& value) {
+        ForwardIter cur = first;
+        try {
+            for(; n > 0; --n, ++cur) {
+                mystl::construct(&*cur, value);
+            }
+        } catch(...) {
+            mystl::destroy(first, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    // 为 trivially_copyable 类型提供特化版本，所有字节相同的值（如 0、-1、单字节类型）以 memset 填充
+    template<typename Tp, typename Size, typename Up>
+    typename std::enable_if<
+        std::is_same<typename std::remove_cv<Up>::type, Tp>::value &&
+        std::is_trivially_copyable<Tp>::value,
+        Tp*>::type
+    uninitialized_fill_n(Tp* first, Size n, const Up& value) {
+        if(n <= 0)
+            return first;
+        unsigned char byte;
+        if(mystl::uninit_same_bytes(value, byte)) {
+            std::memset(static_cast<void*>(first), byte, static_cast<size_t>(n) * sizeof(Tp));
+            return first + n;
+        }
+        for(; n > 0; --n, ++first) {
+            std::memcpy(static_cast<void*>(first), &value, sizeof(Tp));
+        }
+        return first;
+    }
+
+    /*****************************************************************************************/
+    // uninitialized_fill
+    // 在 [first, last) 区间内填充元素值
+    /*****************************************************************************************/
+    template<typename ForwardIter, typename T>
+    void uninitialized_fill_cat(ForwardIter first, ForwardIter last, const T& value, mystl::forward_iterator_tag) {
+        ForwardIter cur = first;
+        try {
+            for(; cur != last; ++cur) {
+                mystl::construct(&*cur, value);
+            }
+        } catch(...) {
+            mystl::destroy(first, cur);
+            throw;
+        }
+    }
+
+    template<typename RandomIter, typename T>
+    void uninitialized_fill_cat(RandomIter first, RandomIter last, const T& value, mystl::random_access_iterator_tag) {
+        mystl::uninitialized_fill_n(first, last - first, value);
+    }
+
+    template<typename ForwardIter, typename T>
+    void uninitialized_fill(ForwardIter first, ForwardIter last, const T& value) {
+        uninitialized_fill_cat(first, last, value, iterator_category(first));
+    }
+
+    /*****************************************************************************************/
+    // uninitialized_move
+    // 把 [first, last) 上的内容移动到以 result 为起始处的空间，返回移动结束的位置
+    /*****************************************************************************************/
+    template<typename InputIter, typename ForwardIter>
+    ForwardIter uninitialized_move(InputIter first, InputIter last, ForwardIter result) {
+        ForwardIter cur = result;
+        try {
+            for(; first != last; ++first, ++cur) {
+                mystl::construct(&*cur, mystl::move(*first));
+            }
+        } catch(...) {
+            mystl::destroy(result, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    template<typename Tp, typename Up>
+    typename std::enable_if<
+        std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+        std::is_trivially_copyable<Up>::value,
+        Up*>::type
+    uninitialized_move(Tp* first, Tp* last, Up* result) {
+        return mystl::uninitialized_copy(first, last, result);
+    }
+
+    /*****************************************************************************************/
+    // uninitialized_move_n
+    // 把 [first, first + n) 上的内容移动到以 result 为起始处的空间，返回移动结束的位置
+    /*****************************************************************************************/
+    template<typename InputIter, typename Size, typename ForwardIter>
+    ForwardIter uninitialized_move_n(InputIter first, Size n, ForwardIter result) {
+        ForwardIter cur = result;
+        try {
+            for(; n > 0; --n, ++first, ++cur) {
+                mystl::construct(&*cur, mystl::move(*first));
+            }
+        } catch(...) {
+            mystl::destroy(result, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    template<typename Tp, typename Size, typename Up>
+    typename std::enable_if<
+        std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+        std::is_trivially_copyable<Up>::value,
+        Up*>::type
+    uninitialized_move_n(Tp* first, Size n, Up* result) {
+        return mystl::uninitialized_copy(first, first + n, result);
+    }
+
+    /*****************************************************************************************/
+    // uninitialized_default_construct_n
+    // 从 first 位置开始默认初始化 n 个元素，平凡默认构造的类型什么都不做
+    /*****************************************************************************************/
+    template<typename ForwardIter, typename Size>
+    ForwardIter uninitialized_default_construct_n_cat(ForwardIter first, Size n, std::true_type) {
+        mystl::advance(first, n);
+        return first;
+    }
+
+    template<typename ForwardIter, typename Size>
+    ForwardIter uninitialized_default_construct_n_cat(ForwardIter first, Size n, std::false_type) {
+        typedef typename iterator_traits<ForwardIter>::value_type value_type;
+        ForwardIter cur = first;
+        try {
+            for(; n > 0; --n, ++cur) {
+                ::new (static_cast<void*>(&*cur)) value_type;
+            }
+        } catch(...) {
+            mystl::destroy(first, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    template<typename ForwardIter, typename Size>
+    ForwardIter uninitialized_default_construct_n(ForwardIter first, Size n) {
+        return uninitialized_default_construct_n_cat(first, n, std::is_trivially_default_constructible<
+            typename iterator_traits<ForwardIter>::value_type>{});
+    }
+
+    template<typename ForwardIter>
+    void uninitialized_default_construct(ForwardIter first, ForwardIter last) {
+        typedef typename iterator_traits<ForwardIter>::value_type value_type;
+        if(std::is_trivially_default_constructible<value_type>::value)
+            return;
+        mystl::uninitialized_default_construct_n(first, mystl::distance(first, last));
+    }
+
+    /*****************************************************************************************/
+    // uninitialized_value_construct_n
+    // 从 first 位置开始值初始化 n 个元素，算术、枚举与指针类型的值初始化即全零，以 memset 完成
+    /*****************************************************************************************/
+    template<typename ForwardIter, typename Size>
+    ForwardIter uninitialized_value_construct_n(ForwardIter first, Size n) {
+        typedef typename iterator_traits<ForwardIter>::value_type value_type;
+        ForwardIter cur = first;
+        try {
+            for(; n > 0; --n, ++cur) {
+                ::new (static_cast<void*>(&*cur)) value_type();
+            }
+        } catch(...) {
+            mystl::destroy(first, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    template<typename Tp, typename Size>
+    typename std::enable_if<
+        std::is_arithmetic<Tp>::value || std::is_enum<Tp>::value || std::is_pointer<Tp>::value,
+        Tp*>::type
+    uninitialized_value_construct_n(Tp* first, Size n) {
+        if(n <= 0)
+            return first;
+        std::memset(static_cast<void*>(first), 0, static_cast<size_t>(n) * sizeof(Tp));
+        return first + n;
+    }
+
+    template<typename ForwardIter>
+    void uninitialized_value_construct(ForwardIter first, ForwardIter last) {
+        mystl::uninitialized_value_construct_n(first, mystl::distance(first, last));
+    }
+
+} // namespace mystl
+
+#endif // MY_TINY_UNINITIALIZED_H_
@@ -8,13 +8,13 @@
 namespace mystl {
     // move
     template<typename T>
-    typename std::remove_reference<T>::type move(T&& arg) noexcept {
+    typename std::remove_reference<T>::type&& move(T&& arg) noexcept {
         return static_cast<typename std::remove_reference<T>::type&&>(arg);
     }
 
     // forward
     template<typename T>
-    T&& forward(typename std::remove_reference<T>::type&& arg) noexcept {
+    T&& forward(typename std::remove_reference<T>::type& arg) noexcept {
         return static_cast<T&&>(arg);
     }
 
@@ -242,4 +242,4 @@ namespace mystl {
     }
 }
 
-#endif // MY_TINY_STL_H_
\ No newline at end of file
+#endif // MY_TINY_UTIL_H_
\ No newline at end of file
@@ -0,0 +1,245 @@
+// algobase.h 中 SIMD 内核的测试
+// 对 8 种整数类型，长度 n = 0 ~ 299、起点相对对齐地址偏移 0 ~ 3 个元素，与逐个比较的参考实现对照：
+// equal、mismatch 在每个失配位置上的结果，find 找到唯一出现的值、找不到时返回 last，count 的个数，
+// lexicographical_compare 两个方向的结果（有符号类型中负数小于正数，不能按无符号字节比较），
+// fill / fill_n 只写入 [first, last)，不越过前后的哨兵；
+// 浮点数的 fill 按位写入，-0.0 与 NaN 的位模式保持不变，find / count 按 == 比较（0.0 == -0.0，NaN 不等于自身）。
+// 同一份源码另以 MYSTL_NO_SIMD 构建，若编译器支持，再以 -mavx2 构建，见 Test/CMakeLists.txt。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "algobase.h"
+#include "test.h"
+
+namespace {
+
+    const size_t kMaxLength = 300;
+    const size_t kOffsets = 4;
+
+    // 简单的线性同余随机数
+    struct lcg {
+        uint64_t x;
+        explicit lcg(uint64_t seed) : x(seed) {}
+        uint64_t next() {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+            return x >> 33;
+        }
+    };
+
+    // 取值集中在少数几个值上，使相等与失配都经常出现；包含 0、±1、最小值与最大值
+    template<typename T>
+    T pick(lcg& rng) {
+        switch(rng.next() % 6) {
+        case 0: return T(0);
+        case 1: return T(1);
+        case 2: return static_cast<T>(-1);
+        case 3: return std::numeric_limits<T>::min();
+        case 4: return std::numeric_limits<T>::max();
+        default: return static_cast<T>(rng.next());
+        }
+    }
+
+    // 与 v 不同的值
+    template<typename T>
+    T other_than(T v) {
+        return static_cast<T>(v + 1);
+    }
+
+    template<typename T>
+    size_t ref_mismatch(const T* a, const T* b, size_t n) {
+        size_t i = 0;
+        while(i < n && a[i] == b[i])
+            ++i;
+        return i;
+    }
+
+    template<typename T>
+    bool ref_less(const T* a, size_t na, const T* b, size_t nb) {
+        for(size_t i = 0; i < na && i < nb; ++i) {
+            if(a[i] < b[i]) return true;
+            if(b[i] < a[i]) return false;
+        }
+        return na < nb;
+    }
+
+    // 缓冲区按 64 bytes 对齐，区间从第 offset 个元素开始
+    template<typename T>
+    struct buffer {
+        std::vector<unsigned char> raw;
+        T* base;
+        explicit buffer(size_t n) : raw((n + 16) * sizeof(T) + 64) {
+            const uintptr_t p = reinterpret_cast<uintptr_t>(raw.data());
+            base = reinterpret_cast<T*>((p + 63) & ~uintptr_t(63));
+        }
+    };
+
+    template<typename T>
+    void check_compare(const T* a, T* b, size_t n) {
+        // 两个区间相等
+        MYSTL_CHECK(mystl::equal(a, a + n, b));
+        MYSTL_CHECK(mystl::mismatch(a, a + n, b).first == a + n);
+        MYSTL_CHECK(!mystl::lexicographical_compare(a, a + n, b, b + n));
+        if(n != 0) {
+            MYSTL_CHECK(mystl::lexicographical_compare(a, a + n - 1, b, b + n));
+            MYSTL_CHECK(!mystl::lexicographical_compare(a, a + n, b, b + n - 1));
+        }
+        // 短区间上检查每个失配位置，长区间上检查开头、结尾与若干中间位置
+        for(size_t p = 0; p < n; p = (n <= 80 || p < 40 || p + 40 >= n) ? p + 1 : p + 7) {
+            const T saved = b[p];
+            const T values[] = { other_than(saved), std::numeric_limits<T>::min(), std::numeric_limits<T>::max() };
+            for(size_t v = 0; v < sizeof(values) / sizeof(values[0]); ++v) {
+                if(values[v] == saved)
+                    continue;
+                b[p] = values[v];
+                MYSTL_CHECK(!mystl::equal(a, a + n, b));
+                const mystl::pair<const T*, T*> r = mystl::mismatch(a, a + n, b);
+                MYSTL_CHECK(r.first == a + p && r.second == b + p);
+                MYSTL_CHECK(mystl::lexicographical_compare(a, a + n, b, b + n) == ref_less(a, n, b, n));
+                MYSTL_CHECK(mystl::lexicographical_compare(b, b + n, a, a + n) == ref_less(b, n, a, n));
+                // 失配之前较短的区间
+                MYSTL_CHECK(mystl::lexicographical_compare(a, a + p, b, b + n) == (p < n));
+            }
+            b[p] = saved;
+        }
+    }
+
+    template<typename T>
+    void check_search(T* p, size_t n, lcg& rng) {
+        // count 与 find 对照参考结果
+        for(int k = 0; k < 4; ++k) {
+            const T v = pick<T>(rng);
+            size_t expected = 0, first = n;
+            for(size_t i = 0; i < n; ++i) {
+                if(p[i] == v) {
+                    ++expected;
+                    if(first == n)
+                        first = i;
+                }
+            }
+            MYSTL_CHECK(mystl::count(p, p + n, v) == expected);
+            MYSTL_CHECK(mystl::find(p, p + n, v) == p + first);
+        }
+        // 只出现一次的值在每个位置上都能找到，其它元素与之不同
+        if(n == 0)
+            return;
+        const T needle = static_cast<T>(0x5a);
+        const T hay = static_cast<T>(0x33);
+        for(size_t i = 0; i < n; ++i)
+            p[i] = hay;
+        MYSTL_CHECK(mystl::find(p, p + n, needle) == p + n);
+        MYSTL_CHECK(mystl::count(p, p + n, needle) == 0);
+        MYSTL_CHECK(mystl::count(p, p + n, hay) == n);
+        for(size_t at = 0; at < n; at = (n <= 80 || at < 40 || at + 40 >= n) ? at + 1 : at + 5) {
+            p[at] = needle;
+            MYSTL_CHECK(mystl::find(p, p + n, needle) == p + at);
+            MYSTL_CHECK(mystl::count(p, p + n, needle) == 1);
+            MYSTL_CHECK(mystl::count(p, p + n, hay) == n - 1);
+            p[at] = hay;
+        }
+    }
+
+    // 在 [p, p + n) 前后各留 8 个元素的哨兵
+    template<typename T>
+    void check_fill(T* p, size_t n, T value) {
+        const unsigned char guard = 0xa5;
+        std::memset(p - 8, guard, (n + 16) * sizeof(T));
+        mystl::fill(p, p + n, value);
+        for(size_t i = 0; i < n; ++i)
+            MYSTL_CHECK(std::memcmp(p + i, &value, sizeof(T)) == 0);
+        const unsigned char* before = reinterpret_cast<const unsigned char*>(p - 8);
+        const unsigned char* after = reinterpret_cast<const unsigned char*>(p + n);
+        for(size_t i = 0; i < 8 * sizeof(T); ++i)
+            MYSTL_CHECK(before[i] == guard && after[i] == guard);
+
+        std::memset(p - 8, guard, (n + 16) * sizeof(T));
+        MYSTL_CHECK(mystl::fill_n(p, n, value) == p + n);
+        for(size_t i = 0; i < n; ++i)
+            MYSTL_CHECK(std::memcmp(p + i, &value, sizeof(T)) == 0);
+        for(size_t i = 0; i < 8 * sizeof(T); ++i)
+            MYSTL_CHECK(before[i] == guard && after[i] == guard);
+    }
+
+    template<typename T>
+    void test_integer(const char* name) {
+        lcg rng(sizeof(T) * 1000 + std::numeric_limits<T>::is_signed);
+        buffer<T> ba(kMaxLength), bb(kMaxLength), bf(kMaxLength + 16);
+        for(size_t n = 0; n < kMaxLength; ++n) {
+            for(size_t off = 0; off < kOffsets; ++off) {
+                T* a = ba.base + off;
+                // 第二个区间取不同的偏移，两个区间相对错开
+                T* b = bb.base + (off + n) % kOffsets;
+                for(size_t i = 0; i < n; ++i)
+                    a[i] = b[i] = pick<T>(rng);
+                check_compare<T>(a, b, n);
+                check_search(a, n, rng);
+                check_fill(bf.base + 8 + off, n, pick<T>(rng));
+            }
+        }
+        std::printf("  %s: ok\n", name);
+    }
+
+    template<typename T>
+    void test_floating(const char* name) {
+        const T values[] = { T(0), -T(0), T(1.5), -std::numeric_limits<T>::infinity(),
+                             std::numeric_limits<T>::quiet_NaN() };
+        buffer<T> bf(kMaxLength + 16);
+        for(size_t n = 0; n < kMaxLength; n += (n < 70 ? 1 : 13)) {
+            for(size_t off = 0; off < kOffsets; ++off) {
+                for(size_t v = 0; v < sizeof(values) / sizeof(values[0]); ++v)
+                    check_fill(bf.base + 8 + off, n, values[v]);
+            }
+        }
+        // 由整数转换后写入
+        T* p = bf.base + 8;
+        mystl::fill_n(p, 37, 3);
+        for(size_t i = 0; i < 37; ++i)
+            MYSTL_CHECK(p[i] == T(3));
+
+        // 按 == 比较：-0.0 等于 0.0，NaN 与任何值都不相等
+        for(size_t i = 0; i < 40; ++i)
+            p[i] = T(i + 1);
+        p[17] = -T(0);
+        p[23] = std::numeric_limits<T>::quiet_NaN();
+        MYSTL_CHECK(mystl::find(p, p + 40, T(0)) == p + 17);
+        MYSTL_CHECK(mystl::count(p, p + 40, T(0)) == 1);
+        MYSTL_CHECK(mystl::find(p, p + 40, std::numeric_limits<T>::quiet_NaN()) == p + 40);
+        MYSTL_CHECK(mystl::count(p, p + 40, std::numeric_limits<T>::quiet_NaN()) == 0);
+        std::vector<T> q(p, p + 40);
+        q[17] = T(0);
+        MYSTL_CHECK(mystl::mismatch(p, p + 40, q.data()).first == p + 23);
+        MYSTL_CHECK(!mystl::equal(p, p + 40, q.data()));
+        std::printf("  %s: ok\n", name);
+    }
+
+} // namespace
+
+int main() {
+#ifdef MYSTL_SIMD
+#if defined(__AVX2__) && defined(__GNUC__)
+    if(!__builtin_cpu_supports("avx2")) {
+        std::printf("algobase_simd_test: skipped, the CPU does not support AVX2\n");
+        return 0;
+    }
+#endif
+    std::printf("algobase_simd_test: SIMD kernels, %d-byte vectors\n", static_cast<int>(mystl::ESimdBytes));
+#else
+    std::printf("algobase_simd_test: scalar fallback\n");
+#endif // MYSTL_SIMD
+    test_integer<int8_t>("int8_t");
+    test_integer<uint8_t>("uint8_t");
+    test_integer<char>("char");
+    test_integer<int16_t>("int16_t");
+    test_integer<uint16_t>("uint16_t");
+    test_integer<int32_t>("int32_t");
+    test_integer<int64_t>("int64_t");
+    test_integer<uint64_t>("uint64_t");
+    test_floating<float>("float");
+    test_floating<double>("double");
+    std::printf("algobase_simd_test: ok\n");
+    return 0;
+}
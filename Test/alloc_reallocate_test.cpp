@@ -0,0 +1,190 @@
+// alloc::reallocate 与 alloc::try_expand_in_place 的测试
+// 检查：以 reallocate 逐步追加把空间从 1 byte 增长到 1 MiB 再逐步缩小，每一步都保留原有的数据；
+// 新旧大小属于同一个 free list 时 try_expand_in_place 成功，reallocate 返回原指针；
+// 跨越 free list 或跨越小内存与大内存的边界时数据同样保留；
+// 大内存在 malloc 实际给出的大小之内原地满足。
+// 以 MYSTL_ALLOC_STATS 构建时另外检查全部释放后大内存的申请与释放字节数相等。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "alloc.h"
+#include "test.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif // __GLIBC__
+
+namespace {
+
+    const size_t kSmall = static_cast<size_t>(mystl::ESmallObjectBytes);
+
+    // 与 alloc 的 free list 划分相同：bytes 所在的 free list 的区块大小
+    size_t class_size(size_t bytes) {
+        size_t align = 0;
+        if(bytes <= 128)       align = mystl::EAlign128;
+        else if(bytes <= 256)  align = mystl::EAlign256;
+        else if(bytes <= 512)  align = mystl::EAlign512;
+        else if(bytes <= 1024) align = mystl::EAlign1024;
+        else if(bytes <= 2048) align = mystl::EAlign2048;
+        else                   align = mystl::EAlign4096;
+        return (bytes + align - 1) & ~(align - 1);
+    }
+
+    // 第 i 个字节的内容由 seed 与位置决定
+    inline unsigned char pattern(size_t i, unsigned seed) {
+        return static_cast<unsigned char>((i * 131 + seed) ^ (i >> 8));
+    }
+
+    void fill(void* p, size_t from, size_t to, unsigned seed) {
+        unsigned char* c = static_cast<unsigned char*>(p);
+        for(size_t i = from; i < to; ++i)
+            c[i] = pattern(i, seed);
+    }
+
+    bool intact(const void* p, size_t n, unsigned seed) {
+        const unsigned char* c = static_cast<const unsigned char*>(p);
+        for(size_t i = 0; i < n; ++i) {
+            if(c[i] != pattern(i, seed))
+                return false;
+        }
+        return true;
+    }
+
+    /*****************************************************************************************/
+
+    // 像字符串追加那样每次增长 1/8（至少 1 byte），到 1 MiB 后再按同样的比例缩小
+    void test_append_growth() {
+        const size_t limit = size_t(1) << 20;
+        size_t size = 1;
+        void* p = mystl::alloc::allocate(size);
+        fill(p, 0, size, 1);
+        size_t steps = 0, in_place = 0;
+        while(size < limit) {
+            const size_t next = size + (size / 8 > 0 ? size / 8 : 1);
+            void* q = mystl::alloc::reallocate(p, size, next);
+            MYSTL_CHECK(q != nullptr);
+            MYSTL_CHECK(intact(q, size, 1));
+            if(q == p)
+                ++in_place;
+            fill(q, size, next, 1);
+            p = q;
+            size = next;
+            ++steps;
+        }
+        std::printf("  grow: %zu steps, %zu in place\n", steps, in_place);
+        MYSTL_CHECK(in_place != 0);
+
+        while(size > 1) {
+            const size_t next = size - (size / 8 > 0 ? size / 8 : 1);
+            void* q = mystl::alloc::reallocate(p, size, next);
+            MYSTL_CHECK(q != nullptr);
+            MYSTL_CHECK(intact(q, next, 1));
+            p = q;
+            size = next;
+        }
+        mystl::alloc::deallocate(p, size);
+    }
+
+    // 每个小内存的大小增长到所在 free list 的区块大小时不移动，再多 1 byte 时移到下一个 free list
+    void test_same_class() {
+        for(size_t n = 1; n <= kSmall; ++n) {
+            const size_t limit = class_size(n);
+            MYSTL_CHECK(mystl::alloc::try_expand_in_place(nullptr, n, limit));
+            if(limit < kSmall)
+                MYSTL_CHECK(!mystl::alloc::try_expand_in_place(nullptr, n, limit + 1));
+
+            void* p = mystl::alloc::allocate(n);
+            fill(p, 0, n, 2);
+            void* q = mystl::alloc::reallocate(p, n, limit);
+            MYSTL_CHECK(q == p);
+            MYSTL_CHECK(intact(q, n, 2));
+            fill(q, n, limit, 2);
+
+            // 缩回原来的大小同样不移动
+            MYSTL_CHECK(mystl::alloc::reallocate(q, limit, n) == q);
+            MYSTL_CHECK(intact(q, n, 2));
+
+            if(limit < kSmall) {
+                void* r = mystl::alloc::reallocate(q, n, limit + 1);
+                MYSTL_CHECK(r != q);
+                MYSTL_CHECK(intact(r, n, 2));
+                mystl::alloc::deallocate(r, limit + 1);
+            } else {
+                mystl::alloc::deallocate(q, n);
+            }
+        }
+        // 大小为 0 的空间不能原地扩展
+        MYSTL_CHECK(!mystl::alloc::try_expand_in_place(nullptr, 0, 8));
+        MYSTL_CHECK(!mystl::alloc::try_expand_in_place(nullptr, 8, 0));
+    }
+
+    // 在小内存与大内存之间来回移动
+    void test_small_large_boundary() {
+        const size_t sizes[] = { 100, kSmall, kSmall + 1, 3 * kSmall, kSmall, 64, 100000, 10, 1 };
+        size_t size = sizes[0];
+        void* p = mystl::alloc::allocate(size);
+        fill(p, 0, size, 3);
+        for(size_t i = 1; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+            const size_t next = sizes[i];
+            MYSTL_CHECK(!mystl::alloc::try_expand_in_place(p, size, next) ||
+                        (size > kSmall) == (next > kSmall));
+            void* q = mystl::alloc::reallocate(p, size, next);
+            MYSTL_CHECK(q != nullptr);
+            MYSTL_CHECK(intact(q, size < next ? size : next, 3));
+            if(next > size)
+                fill(q, size, next, 3);
+            p = q;
+            size = next;
+        }
+        mystl::alloc::deallocate(p, size);
+
+        // p 为空时等同于 allocate
+        void* q = mystl::alloc::reallocate(nullptr, 0, 300);
+        MYSTL_CHECK(q != nullptr);
+        fill(q, 0, 300, 4);
+        mystl::alloc::deallocate(q, 300);
+    }
+
+    // 大内存在 malloc 实际给出的大小之内原地满足，超出时交给 std::realloc
+    void test_large_in_place() {
+        const size_t n = 10000;
+        void* p = mystl::alloc::allocate(n);
+        fill(p, 0, n, 5);
+#ifdef __GLIBC__
+        const size_t usable = malloc_usable_size(p);
+        MYSTL_CHECK(usable >= n);
+        MYSTL_CHECK(mystl::alloc::try_expand_in_place(p, n, usable));
+        MYSTL_CHECK(!mystl::alloc::try_expand_in_place(p, usable, usable + 1));
+        MYSTL_CHECK(mystl::alloc::reallocate(p, usable, n) == p);
+#endif // __GLIBC__
+        // 缩小总能原地满足
+        MYSTL_CHECK(mystl::alloc::reallocate(p, n, n - 100) == p);
+        MYSTL_CHECK(intact(p, n - 100, 5));
+        void* q = mystl::alloc::reallocate(p, n - 100, 4 * n);
+        MYSTL_CHECK(q != nullptr);
+        MYSTL_CHECK(intact(q, n - 100, 5));
+        mystl::alloc::deallocate(q, 4 * n);
+    }
+
+} // namespace
+
+int main() {
+#ifdef MYSTL_ALLOC_STATS
+    const mystl::alloc_stats before = mystl::alloc::stats();
+#endif // MYSTL_ALLOC_STATS
+    test_append_growth();
+    test_same_class();
+    test_small_large_boundary();
+    test_large_in_place();
+#ifdef MYSTL_ALLOC_STATS
+    const mystl::alloc_stats after = mystl::alloc::stats();
+    MYSTL_CHECK(after.large_alloc_bytes - before.large_alloc_bytes ==
+                after.large_free_bytes - before.large_free_bytes);
+    MYSTL_CHECK(after.large_allocs - before.large_allocs == after.large_frees - before.large_frees);
+#endif // MYSTL_ALLOC_STATS
+    std::printf("alloc_reallocate_test: ok\n");
+    return 0;
+}
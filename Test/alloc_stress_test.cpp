@@ -0,0 +1,185 @@
+// alloc 的多线程压力测试
+// 多个线程以随机大小分配、写入、原地扩展与回收区块，其中一部分区块经共享的信箱交给其它线程回收，
+// 一部分线程提前退出，留下的区块在它的线程缓存销毁之后才被回收。
+// 每个区块写满由所有者与序号决定的字节，回收前逐字节校验，区块被重复分配或被其它区块覆盖时校验失败。
+// 以 MYSTL_ALLOC_STATS 编译时，最后还检查每个 free list 的分配与回收次数相等，并且 trim 之后
+// 内存池不再持有任何 chunk。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "alloc.h"
+#include "test.h"
+
+namespace {
+
+    const size_t kThreads = 8;
+    const size_t kOpsPerThread = 200000;
+    const size_t kLiveBlocks = 256;       // 每个线程最多同时持有的区块数
+    const size_t kMailboxBlocks = 4096;   // 信箱中最多积压的区块数
+
+    struct block {
+        unsigned char* p;
+        size_t size;
+        unsigned char tag;
+    };
+
+    class rng {
+    public:
+        explicit rng(uint64_t seed) : state_(seed * 0x9E3779B97F4A7C15ull + 1) {}
+        uint64_t operator()() {
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 7;
+            state_ ^= state_ << 17;
+            return state_;
+        }
+        size_t below(size_t n) { return static_cast<size_t>((*this)() % n); }
+
+    private:
+        uint64_t state_;
+    };
+
+    // 大多数为小内存，约 2% 超过 4096 bytes 走 std::malloc
+    size_t random_size(rng& r) {
+        if(r.below(50) == 0)
+            return 4097 + r.below(12288);
+        return 1 + r.below(r.below(4) == 0 ? 4096 : 256);
+    }
+
+    void fill(const block& b) {
+        std::memset(b.p, b.tag, b.size);
+    }
+
+    void verify(const block& b, size_t size) {
+        for(size_t i = 0; i < size; ++i)
+            MYSTL_CHECK(b.p[i] == b.tag);
+    }
+
+    block make_block(rng& r, unsigned char tag) {
+        block b;
+        b.size = random_size(r);
+        b.p = static_cast<unsigned char*>(mystl::alloc::allocate(b.size));
+        MYSTL_CHECK(b.p != nullptr);
+        b.tag = tag;
+        fill(b);
+        return b;
+    }
+
+    void release(const block& b) {
+        verify(b, b.size);
+        mystl::alloc::deallocate(b.p, b.size);
+    }
+
+    // 线程之间交换区块的信箱
+    class mailbox {
+    public:
+        bool put(const block& b) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(blocks_.size() >= kMailboxBlocks)
+                return false;
+            blocks_.push_back(b);
+            return true;
+        }
+
+        bool take(block& b) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(blocks_.empty())
+                return false;
+            b = blocks_.back();
+            blocks_.pop_back();
+            return true;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<block> blocks_;
+    };
+
+    void worker(size_t id, size_t ops, mailbox& box) {
+        rng r(id + 1);
+        std::vector<block> live;
+        live.reserve(kLiveBlocks);
+        unsigned char seq = 0;
+        for(size_t i = 0; i < ops; ++i) {
+            const size_t op = r.below(16);
+            if(live.size() < kLiveBlocks && op < 8) {
+                live.push_back(make_block(r, static_cast<unsigned char>(id * 31 + ++seq)));
+            } else if(!live.empty() && op < 12) {
+                const size_t k = r.below(live.size());
+                release(live[k]);
+                live[k] = live.back();
+                live.pop_back();
+            } else if(!live.empty() && op < 13) {
+                // 改变大小：内容的公共前缀必须保留
+                block& b = live[r.below(live.size())];
+                const size_t new_size = random_size(r);
+                void* p = mystl::alloc::reallocate(b.p, b.size, new_size);
+                MYSTL_CHECK(p != nullptr);
+                b.p = static_cast<unsigned char*>(p);
+                verify(b, b.size < new_size ? b.size : new_size);
+                b.size = new_size;
+                fill(b);
+            } else if(!live.empty() && op < 15) {
+                // 交给其它线程回收
+                const size_t k = r.below(live.size());
+                if(box.put(live[k])) {
+                    live[k] = live.back();
+                    live.pop_back();
+                }
+            } else {
+                block b;
+                if(box.take(b))
+                    release(b);
+            }
+        }
+        // 一半的线程把剩下的区块留在信箱中退出，由其它线程或主线程回收
+        for(size_t k = 0; k < live.size(); ++k) {
+            if(id % 2 == 0 || !box.put(live[k]))
+                release(live[k]);
+        }
+    }
+
+} // namespace
+
+int main() {
+    mailbox box;
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < kThreads; ++i) {
+        // 一部分线程只做很少的操作，在其它线程仍在运行时退出
+        const size_t ops = i % 4 == 3 ? kOpsPerThread / 20 : kOpsPerThread;
+        threads.emplace_back(worker, i, ops, std::ref(box));
+    }
+    for(size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+
+    block b;
+    while(box.take(b))
+        release(b);
+    mystl::alloc::flush_thread_cache();
+
+    const mystl::alloc_stats s = mystl::alloc::stats();
+    if(s.enabled) {
+        for(size_t i = 0; i < mystl::EFreeListsNumber; ++i) {
+            MYSTL_CHECK(s.size_class[i].allocs == s.size_class[i].frees);
+            MYSTL_CHECK(s.size_class[i].cached_blocks == 0);
+        }
+        MYSTL_CHECK(s.large_allocs == s.large_frees);
+        MYSTL_CHECK(s.large_alloc_bytes == s.large_free_bytes);
+    }
+
+    // 全部区块都已回收，trim 应当归还所有 chunk，之后内存池仍可正常使用
+    mystl::alloc::trim();
+    if(s.enabled)
+        MYSTL_CHECK(mystl::alloc::stats().heap_bytes == 0);
+    rng r(99);
+    release(make_block(r, 0x5a));
+
+    std::printf("alloc_stress_test: ok\n");
+    return 0;
+}
@@ -0,0 +1,88 @@
+// alloc::trim 的测试
+// 分配一大批小区块并写满，全部回收后调用 trim，检查空闲的 chunk 被归还系统：
+// trim 返回的字节数不少于这批区块的大小，进程的 RSS 随之下降；
+// 仍在使用的区块所在的 chunk 不被归还，内容保持不变。
+// 以 MYSTL_ALLOC_STATS 编译时，还检查 trims、trimmed_bytes 与 heap_bytes 的变化。
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "alloc.h"
+#include "test.h"
+
+namespace {
+
+    const size_t kBurstBytes = 64 * 1024 * 1024;
+
+    // 分配总计约 kBurstBytes 的区块，大小在 16 ~ 512 bytes 之间循环，每个区块写满
+    std::vector<std::pair<void*, size_t>> burst() {
+        std::vector<std::pair<void*, size_t>> blocks;
+        size_t total = 0;
+        for(size_t i = 0; total < kBurstBytes; ++i) {
+            const size_t n = 16 + (i * 37) % 497;
+            void* p = mystl::alloc::allocate(n);
+            MYSTL_CHECK(p != nullptr);
+            std::memset(p, 0xab, n);
+            blocks.push_back(std::make_pair(p, n));
+            total += n;
+        }
+        return blocks;
+    }
+
+    void release(std::vector<std::pair<void*, size_t>>& blocks) {
+        for(size_t i = 0; i < blocks.size(); ++i)
+            mystl::alloc::deallocate(blocks[i].first, blocks[i].second);
+        blocks.clear();
+    }
+
+} // namespace
+
+int main() {
+    // 在这批区块之前分配，所在的 chunk 始终有区块在使用
+    const size_t survivor_size = 200;
+    char* survivor = static_cast<char*>(mystl::alloc::allocate(survivor_size));
+    std::memset(survivor, 0x5a, survivor_size);
+
+    const mystl::alloc_stats before = mystl::alloc::stats();
+    std::vector<std::pair<void*, size_t>> blocks = burst();
+    const long peak_rss = mystl_test::current_rss_kb();
+    const mystl::alloc_stats grown = mystl::alloc::stats();
+    release(blocks);
+
+    const size_t trimmed = mystl::alloc::trim();
+    const long trimmed_rss = mystl_test::current_rss_kb();
+    MYSTL_CHECK(trimmed >= kBurstBytes);
+
+    // RSS 至少下降这批区块的一半；不支持读取 RSS 的平台上两者都为 0
+    if(peak_rss != 0)
+        MYSTL_CHECK(peak_rss - trimmed_rss >= static_cast<long>(kBurstBytes / 1024 / 2));
+
+    if(before.enabled) {
+        const mystl::alloc_stats after = mystl::alloc::stats();
+        MYSTL_CHECK(after.trims == before.trims + 1);
+        MYSTL_CHECK(after.trimmed_bytes == before.trimmed_bytes + trimmed);
+        MYSTL_CHECK(after.heap_bytes == grown.heap_bytes - trimmed);
+        MYSTL_CHECK(after.heap_bytes != 0);
+    }
+
+    for(size_t i = 0; i < survivor_size; ++i)
+        MYSTL_CHECK(survivor[i] == 0x5a);
+
+    // 没有可归还的 chunk 时 trim 返回 0
+    MYSTL_CHECK(mystl::alloc::trim() == 0);
+
+    // trim 之后内存池仍可正常使用
+    blocks = burst();
+    release(blocks);
+    mystl::alloc::deallocate(survivor, survivor_size);
+    mystl::alloc::trim();
+    if(before.enabled)
+        MYSTL_CHECK(mystl::alloc::stats().heap_bytes == 0);
+
+    std::printf("alloc_trim_test: ok (trimmed %zu bytes, rss %ld KB -> %ld KB)\n",
+                trimmed, peak_rss, trimmed_rss);
+    return 0;
+}
@@ -0,0 +1,298 @@
+// execution.h 的测试
+// 以 3 个工作线程的线程池（见 set_execution_pool）执行 seq、par 与 par_unseq，结果与串行版本或逐个计算的参考结果对照：
+// copy、fill、for_each、一元与二元 transform（含原地变换）在长度 0、1、一块上下与多块时的结果与返回值，
+// 不写出目标区间；reduce 以有证同元素的 plus（init 不为 0）、默认的 reduce 与没有证同元素的 min / max 归约；
+// 非随机访问迭代器退化为串行版本；某一块的函数对象抛出异常时，异常原样在调用线程抛出，之后线程池仍可使用。
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include "execution.h"
+#include "test.h"
+
+namespace {
+
+    struct injected_failure : std::runtime_error {
+        explicit injected_failure(size_t i) : std::runtime_error("injected failure"), index(i) {}
+        size_t index;
+    };
+
+    // 简单的线性同余随机数
+    struct lcg {
+        uint64_t x;
+        explicit lcg(uint64_t seed) : x(seed) {}
+        uint64_t next() {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+            return x >> 11;
+        }
+    };
+
+    const size_t kGrain = mystl::parallel_grain<uint64_t>();
+    const uint64_t kGuard = 0xa5a5a5a5a5a5a5a5ULL;
+
+    // 长度 0、1、不足一块、一块上下与多块
+    const size_t kLengths[] = { 0, 1, 1000, kGrain - 1, kGrain, kGrain + 1, 5 * kGrain + 17, 40 * kGrain };
+    const size_t kLengthCount = sizeof(kLengths) / sizeof(kLengths[0]);
+
+    std::vector<uint64_t> random_values(size_t n, uint64_t seed) {
+        lcg rng(seed);
+        std::vector<uint64_t> v(n);
+        for(size_t i = 0; i < n; ++i)
+            v[i] = rng.next();
+        return v;
+    }
+
+    // 目标区间后留一个哨兵
+    struct output {
+        std::vector<uint64_t> buf;
+        explicit output(size_t n) : buf(n + 1, 0) { buf[n] = kGuard; }
+        uint64_t* data() { return buf.data(); }
+        bool guard_intact() const { return buf.back() == kGuard; }
+    };
+
+    struct mix {
+        uint64_t operator()(uint64_t x) const { return x * 0x9e3779b97f4a7c15ULL + (x >> 7); }
+    };
+
+    struct combine {
+        uint64_t operator()(uint64_t a, uint64_t b) const { return a * 31 + (b ^ (a >> 3)); }
+    };
+
+    // 没有证同元素的二元运算
+    struct min_op {
+        uint64_t operator()(uint64_t a, uint64_t b) const { return b < a ? b : a; }
+    };
+
+    /*****************************************************************************************/
+
+    template<typename Policy>
+    void test_copy_fill(const Policy& policy) {
+        for(size_t k = 0; k < kLengthCount; ++k) {
+            const size_t n = kLengths[k];
+            const std::vector<uint64_t> src = random_values(n, n + 1);
+            const uint64_t* s = src.data();
+
+            // 复制的结果直接与 src 对照
+            output a(n), b(n);
+            std::copy(src.begin(), src.end(), a.buf.begin());
+            MYSTL_CHECK(mystl::copy(policy, s, s + n, b.data()) == b.data() + n);
+            MYSTL_CHECK(a.buf == b.buf && b.guard_intact());
+
+            mystl::fill(mystl::execution::seq, a.data(), a.data() + n, uint64_t(77));
+            mystl::fill(policy, b.data(), b.data() + n, uint64_t(77));
+            MYSTL_CHECK(a.buf == b.buf && b.guard_intact());
+            for(size_t i = 0; i < n; ++i)
+                MYSTL_CHECK(b.buf[i] == 77);
+        }
+    }
+
+    template<typename Policy>
+    void test_for_each_transform(const Policy& policy) {
+        for(size_t k = 0; k < kLengthCount; ++k) {
+            const size_t n = kLengths[k];
+            const std::vector<uint64_t> src = random_values(n, n + 2);
+            const std::vector<uint64_t> src2 = random_values(n, n + 3);
+            const uint64_t* s = src.data();
+            const uint64_t* s2 = src2.data();
+
+            // 每个元素恰好访问一次：访问两次或漏掉的元素与串行结果不同
+            output a(n), b(n);
+            std::copy(src.begin(), src.end(), a.buf.begin());
+            std::copy(src.begin(), src.end(), b.buf.begin());
+            mystl::for_each(mystl::execution::seq, a.data(), a.data() + n, [](uint64_t& x) { x = x * 3 + 1; });
+            mystl::for_each(policy, b.data(), b.data() + n, [](uint64_t& x) { x = x * 3 + 1; });
+            MYSTL_CHECK(a.buf == b.buf && b.guard_intact());
+
+            MYSTL_CHECK(mystl::transform(mystl::execution::seq, s, s + n, a.data(), mix()) == a.data() + n);
+            MYSTL_CHECK(mystl::transform(policy, s, s + n, b.data(), mix()) == b.data() + n);
+            MYSTL_CHECK(a.buf == b.buf && b.guard_intact());
+
+            // 原地变换
+            MYSTL_CHECK(mystl::transform(mystl::execution::seq, a.data(), a.data() + n, a.data(), mix()) == a.data() + n);
+            MYSTL_CHECK(mystl::transform(policy, b.data(), b.data() + n, b.data(), mix()) == b.data() + n);
+            MYSTL_CHECK(a.buf == b.buf && b.guard_intact());
+
+            MYSTL_CHECK(mystl::transform(mystl::execution::seq, s, s + n, s2, a.data(), combine()) == a.data() + n);
+            MYSTL_CHECK(mystl::transform(policy, s, s + n, s2, b.data(), combine()) == b.data() + n);
+            MYSTL_CHECK(a.buf == b.buf && b.guard_intact());
+            for(size_t i = 0; i < n; ++i)
+                MYSTL_CHECK(b.buf[i] == combine()(s[i], s2[i]));
+        }
+    }
+
+    template<typename Policy>
+    void test_reduce(const Policy& policy) {
+        for(size_t k = 0; k < kLengthCount; ++k) {
+            const size_t n = kLengths[k];
+            std::vector<uint64_t> src = random_values(n, n + 4);
+            // 取值不小于 1000，各块若从 0 开始求 min 会得到错误的结果
+            for(size_t i = 0; i < n; ++i)
+                src[i] = src[i] % 1000000 + 1000;
+            const uint64_t* s = src.data();
+
+            uint64_t expected = 12345;
+            for(size_t i = 0; i < n; ++i)
+                expected += s[i];
+            // init 只参与一次归约
+            MYSTL_CHECK(mystl::reduce(mystl::execution::seq, s, s + n, uint64_t(12345)) == expected);
+            MYSTL_CHECK(mystl::reduce(policy, s, s + n, uint64_t(12345)) == expected);
+            MYSTL_CHECK(mystl::reduce(policy, s, s + n, uint64_t(12345), mystl::plus<uint64_t>()) == expected);
+            MYSTL_CHECK(mystl::reduce(policy, s, s + n) == expected - 12345);
+
+            uint64_t lo = ~uint64_t(0), hi = 0;
+            for(size_t i = 0; i < n; ++i) {
+                lo = s[i] < lo ? s[i] : lo;
+                hi = s[i] > hi ? s[i] : hi;
+            }
+            MYSTL_CHECK(mystl::reduce(mystl::execution::seq, s, s + n, ~uint64_t(0), min_op()) == lo);
+            MYSTL_CHECK(mystl::reduce(policy, s, s + n, ~uint64_t(0), min_op()) == lo);
+            // init 比所有元素都小时结果就是 init
+            MYSTL_CHECK(mystl::reduce(policy, s, s + n, uint64_t(1), min_op()) == 1);
+            MYSTL_CHECK(mystl::reduce(policy, s, s + n, uint64_t(1),
+                [](uint64_t a, uint64_t b) { return a < b ? b : a; }) == (n == 0 ? 1 : hi));
+
+            // 元素类型与 init 的类型不同
+            std::vector<uint32_t> narrow(src.begin(), src.end());
+            const uint32_t* w = narrow.data();
+            MYSTL_CHECK(mystl::reduce(policy, w, w + n, uint64_t(12345)) == expected);
+        }
+    }
+
+    // 只能前进的迭代器，不能并行
+    struct forward_ptr : public mystl::iterator<mystl::forward_iterator_tag, int> {
+        int* p;
+        explicit forward_ptr(int* q) : p(q) {}
+        int& operator*() const { return *p; }
+        forward_ptr& operator++() { ++p; return *this; }
+        forward_ptr operator++(int) { forward_ptr t = *this; ++p; return t; }
+        bool operator==(const forward_ptr& rhs) const { return p == rhs.p; }
+        bool operator!=(const forward_ptr& rhs) const { return p != rhs.p; }
+    };
+
+    // 非随机访问迭代器退化为串行版本
+    template<typename Policy>
+    void test_non_random_access(const Policy& policy) {
+        std::vector<int> v(1000);
+        for(int i = 0; i < 1000; ++i)
+            v[i] = i;
+        const forward_ptr first(v.data()), last(v.data() + 1000);
+        std::vector<int> out(1000, 0);
+        MYSTL_CHECK(mystl::copy(policy, first, last, out.data()) == out.data() + 1000);
+        for(int i = 0; i < 1000; ++i)
+            MYSTL_CHECK(out[i] == i);
+        mystl::for_each(policy, first, last, [](int& x) { x *= 2; });
+        MYSTL_CHECK(mystl::reduce(policy, first, last, 0) == 999 * 1000);
+        mystl::transform(policy, first, last, out.data(), [](int x) { return x + 1; });
+        MYSTL_CHECK(out[999] == 1999);
+        mystl::fill(policy, first, last, 3);
+        MYSTL_CHECK(mystl::reduce(policy, first, last, 0, mystl::plus<int>()) == 3000);
+    }
+
+    /*****************************************************************************************/
+    // 异常
+
+    // op 在下标为 at 的元素上抛出异常，检查调用线程得到的就是这个异常
+    template<typename Op>
+    void expect_throw(const char* name, size_t at, Op op) {
+        bool caught = false;
+        try {
+            op();
+        } catch(const injected_failure& e) {
+            caught = true;
+            MYSTL_CHECK(e.index == at);
+        }
+        if(!caught)
+            std::fprintf(stderr, "%s: no exception for element %zu\n", name, at);
+        MYSTL_CHECK(caught);
+    }
+
+    template<typename Policy>
+    void test_exceptions(const Policy& policy) {
+        const size_t n = 20 * kGrain + 5;
+        const std::vector<uint64_t> src = random_values(n, 99);
+        const uint64_t* s = src.data();
+        std::vector<uint64_t> index(n);
+        for(size_t i = 0; i < n; ++i)
+            index[i] = i;
+        const uint64_t* idx = index.data();
+        output out(n);
+
+        // 第一块、中间某块与最后一块
+        const size_t positions[] = { 0, 7 * kGrain + 3, n - 1 };
+        for(size_t p = 0; p < sizeof(positions) / sizeof(positions[0]); ++p) {
+            const size_t at = positions[p];
+            expect_throw("for_each", at, [&] {
+                mystl::for_each(policy, idx, idx + n, [at](uint64_t i) {
+                    if(i == at)
+                        throw injected_failure(at);
+                });
+            });
+            expect_throw("transform", at, [&] {
+                mystl::transform(policy, idx, idx + n, out.data(), [at](uint64_t i) {
+                    if(i == at)
+                        throw injected_failure(at);
+                    return i;
+                });
+            });
+            expect_throw("transform2", at, [&] {
+                mystl::transform(policy, idx, idx + n, s, out.data(), [at](uint64_t i, uint64_t x) {
+                    if(i == at)
+                        throw injected_failure(at);
+                    return x;
+                });
+            });
+            // 归约的参数顺序不确定，在值为 at 的元素参与运算时抛出异常
+            expect_throw("reduce", at, [&] {
+                mystl::reduce(policy, idx, idx + n, uint64_t(0), [at](uint64_t a, uint64_t b) {
+                    if(a == at || b == at)
+                        throw injected_failure(at);
+                    return a < b ? b : a;
+                });
+            });
+            MYSTL_CHECK(out.guard_intact());
+        }
+
+        // 线程池在异常之后仍可使用
+        uint64_t expected = 0;
+        for(size_t i = 0; i < n; ++i)
+            expected += s[i];
+        MYSTL_CHECK(mystl::reduce(policy, s, s + n, uint64_t(0)) == expected);
+        output a(n), b(n);
+        mystl::transform(mystl::execution::seq, s, s + n, a.data(), mix());
+        mystl::transform(policy, s, s + n, b.data(), mix());
+        MYSTL_CHECK(a.buf == b.buf);
+    }
+
+    template<typename Policy>
+    void test_policy(const Policy& policy) {
+        test_copy_fill(policy);
+        test_for_each_transform(policy);
+        test_reduce(policy);
+        test_non_random_access(policy);
+        test_exceptions(policy);
+    }
+
+} // namespace
+
+int main() {
+    // 机器只有一个 CPU 时 thread_pool::instance() 没有工作线程，这里指定 3 个工作线程，保证并行版本真正分块执行
+    mystl::thread_pool pool(3);
+    mystl::set_execution_pool(&pool);
+    MYSTL_CHECK(&mystl::execution_pool() == &pool);
+    test_policy(mystl::execution::seq);
+    test_policy(mystl::execution::par);
+    test_policy(mystl::execution::par_unseq);
+    mystl::set_execution_pool(nullptr);
+    MYSTL_CHECK(&mystl::execution_pool() == &mystl::thread_pool::instance());
+
+    // 默认的线程池
+    test_copy_fill(mystl::execution::par);
+    test_reduce(mystl::execution::par);
+    test_exceptions(mystl::execution::par);
+    std::printf("execution_test: ok\n");
+    return 0;
+}
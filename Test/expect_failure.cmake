@@ -0,0 +1,16 @@
+# 以 cmake -P 运行：执行 PROGRAM，要求它以失败（非零退出码或信号）结束，且错误输出包含 EXPECT
+# 用于检查程序按预期终止的测试，ctest 总把被信号终止的进程判为失败，不能直接用 WILL_FAIL
+
+execute_process(
+    COMMAND ${PROGRAM}
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE error)
+
+if(result EQUAL 0)
+    message(FATAL_ERROR "${PROGRAM} exited successfully, expected it to fail")
+endif()
+if(NOT error MATCHES "${EXPECT}")
+    message(FATAL_ERROR "${PROGRAM} failed without reporting \"${EXPECT}\":\n${error}")
+endif()
+message(STATUS "${PROGRAM} failed as expected: ${result}")
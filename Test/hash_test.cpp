@@ -0,0 +1,121 @@
+// functional.h 中 hash_bytes 的测试
+// 16 bytes 一步的乘法 hash_mum(a ^ secret, b ^ state) 在 a 等于 secret 或 b 等于 state 时为 0，
+// 过去每一步直接以乘积覆盖状态，a 取 EHashP1 ~ EHashP3 的键（如 64 bytes 的 [P1, x, P2, y, P3, z, 尾部]、
+// 以 P1 开头的 32 bytes 的键）的哈希值与种子、之前的数据无关；检查这些键以及按当前种子构造的、
+// 使各步乘积为 0 的键，其哈希值随种子与每个数据字都不同；
+// 另外检查各种长度下改变任一字节、改变种子都改变哈希值，起始地址不对齐时结果不变。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include "functional.h"
+#include "test.h"
+
+namespace {
+
+    const uint64_t kSeeds[] = { 0, 1, 0x0123456789abcdefULL, 0xffffffffffffffffULL };
+    const size_t kSeedCount = sizeof(kSeeds) / sizeof(kSeeds[0]);
+
+    uint64_t hash_words(const std::vector<uint64_t>& words, uint64_t seed) {
+        return mystl::hash_bytes(words.data(), words.size() * sizeof(uint64_t), seed);
+    }
+
+    // 把哈希值加入 seen，与已有的值相同时失败
+    void expect_new(std::set<uint64_t>& seen, uint64_t h, const char* what) {
+        if(!seen.insert(h).second) {
+            std::fprintf(stderr, "hash_test: collision in %s\n", what);
+            MYSTL_CHECK(false);
+        }
+    }
+
+    /*****************************************************************************************/
+
+    // 以混合常数开头的块不再把状态清零
+    void test_constant_blocks() {
+        std::set<uint64_t> seen64, seen32;
+        for(size_t s = 0; s < kSeedCount; ++s) {
+            for(uint64_t x = 0; x < 4; ++x) {
+                for(uint64_t y = 0; y < 4; ++y) {
+                    for(uint64_t z = 0; z < 4; ++z) {
+                        const uint64_t key[] = { mystl::EHashP1, x, mystl::EHashP2, y, mystl::EHashP3, z, 7, 8 };
+                        expect_new(seen64, hash_words(std::vector<uint64_t>(key, key + 8), kSeeds[s]),
+                                   "64-byte [P1, x, P2, y, P3, z, tail] keys");
+                    }
+                }
+                const uint64_t key[] = { mystl::EHashP1, x, 7, 8 };
+                expect_new(seen32, hash_words(std::vector<uint64_t>(key, key + 4), kSeeds[s]),
+                           "32-byte keys starting with P1");
+            }
+        }
+    }
+
+    // 已知种子时构造使乘积为 0 的键：a 等于 secret 或 b 等于 state，结果仍取决于种子与其它数据
+    void test_zero_products() {
+        for(size_t s = 0; s < kSeedCount; ++s) {
+            const uint64_t state = mystl::hash_bytes_state(kSeeds[s]);
+            const uint64_t secret[] = { state ^ mystl::EHashP1, state ^ mystl::EHashP2, state ^ mystl::EHashP3 };
+            std::set<uint64_t> seen;
+            for(uint64_t x = 0; x < 8; ++x) {
+                for(uint64_t y = 0; y < 8; ++y) {
+                    // 16 bytes：最后一步 a 等于 secret，b 取不同的值
+                    const uint64_t k16[] = { secret[0], x * 8 + y };
+                    expect_new(seen, hash_words(std::vector<uint64_t>(k16, k16 + 2), kSeeds[s]), "16-byte keys");
+                    // 32 bytes：第一步 b 等于初始状态，最后一步 a 等于 secret
+                    const uint64_t k32[] = { x, state, secret[0], y };
+                    expect_new(seen, hash_words(std::vector<uint64_t>(k32, k32 + 4), kSeeds[s]), "32-byte keys");
+                    // 64 bytes：三路的第一步乘积都为 0
+                    const uint64_t k64[] = { secret[0], x, secret[1], y, secret[2], x ^ y, 1, 2 };
+                    expect_new(seen, hash_words(std::vector<uint64_t>(k64, k64 + 8), kSeeds[s]), "64-byte keys");
+                    const uint64_t k64b[] = { x, state, y, state, x + y, state, 1, 2 };
+                    expect_new(seen, hash_words(std::vector<uint64_t>(k64b, k64b + 8), kSeeds[s]), "64-byte keys");
+                }
+            }
+            // 同一个键在其它种子下的哈希值不同
+            const uint64_t k[] = { secret[0], 1, secret[1], 2, secret[2], 3, 4, 5 };
+            const std::vector<uint64_t> key(k, k + 8);
+            for(size_t t = 0; t < kSeedCount; ++t) {
+                if(t != s)
+                    MYSTL_CHECK(hash_words(key, kSeeds[t]) != hash_words(key, kSeeds[s]));
+            }
+        }
+    }
+
+    // 各种长度下改变任一字节、改变种子都改变哈希值；不对齐的起始地址结果相同
+    void test_lengths() {
+        std::vector<unsigned char> buf(300 + 8);
+        for(size_t i = 0; i < buf.size(); ++i)
+            buf[i] = static_cast<unsigned char>(i * 131 + 7);
+        std::set<uint64_t> seen;
+        for(size_t n = 0; n <= 300; ++n) {
+            unsigned char* p = buf.data();
+            const uint64_t h = mystl::hash_bytes(p, n, 42);
+            expect_new(seen, h, "lengths");
+            MYSTL_CHECK(mystl::hash_bytes(p, n, 43) != h);
+            for(size_t off = 1; off < 8; ++off) {
+                std::memmove(p + off, p, n);
+                MYSTL_CHECK(mystl::hash_bytes(p + off, n, 42) == h);
+                std::memmove(p, p + off, n);
+            }
+            for(size_t i = 0; i < n; ++i) {
+                for(int bit = 0; bit < 8; bit += 3) {
+                    p[i] ^= static_cast<unsigned char>(1 << bit);
+                    MYSTL_CHECK(mystl::hash_bytes(p, n, 42) != h);
+                    p[i] ^= static_cast<unsigned char>(1 << bit);
+                }
+            }
+        }
+    }
+
+} // namespace
+
+int main() {
+    test_constant_blocks();
+    test_zero_products();
+    test_lengths();
+    std::printf("hash_test: ok\n");
+    return 0;
+}
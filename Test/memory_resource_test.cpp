@@ -0,0 +1,255 @@
+// memory_resource 的测试
+// 以记录每次申请的上游资源检查：
+// monotonic_buffer_resource 先用初始缓冲区，release 归还全部上游缓冲区，反复“分配 - release”时每轮向上游的申请不变；
+// unsynchronized_pool_resource 的区块满足对齐、回收后被重用，大块直接交给上游，release 与析构归还全部内存；
+// synchronized_pool_resource 在多个线程间共享时区块互不重叠；
+// mystl::vector<T, polymorphic_allocator<T>> 的内存全部来自给定的资源，复制的容器改用默认资源。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "memory_resource.h"
+#include "vector.h"
+#include "test.h"
+
+namespace {
+
+    // 转发给 new_delete_resource，并记录申请的次数、最大的一次申请与尚未归还的字节数
+    class counting_resource : public mystl::memory_resource {
+    public:
+        counting_resource() : allocs(0), largest(0), live_bytes(0) {}
+
+        size_t allocs;
+        size_t largest;
+        size_t live_bytes;
+
+        void reset_counts() {
+            allocs = 0;
+            largest = 0;
+        }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            ++allocs;
+            if(bytes > largest)
+                largest = bytes;
+            live_bytes += bytes;
+            return mystl::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            live_bytes -= bytes;
+            mystl::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const mystl::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    bool is_aligned(const void* p, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+    }
+
+    /*****************************************************************************************/
+
+    void test_monotonic_initial_buffer() {
+        counting_resource upstream;
+        alignas(std::max_align_t) char buffer[4096];
+        mystl::monotonic_buffer_resource arena(buffer, sizeof(buffer), &upstream);
+
+        void* p = arena.allocate(100, 8);
+        void* q = arena.allocate(100, 64);
+        MYSTL_CHECK(p >= static_cast<void*>(buffer) && p < static_cast<void*>(buffer + sizeof(buffer)));
+        MYSTL_CHECK(q >= static_cast<void*>(buffer) && q < static_cast<void*>(buffer + sizeof(buffer)));
+        MYSTL_CHECK(is_aligned(q, 64));
+        MYSTL_CHECK(upstream.allocs == 0);
+
+        // 超出初始缓冲区后才向上游申请
+        arena.allocate(8000, 16);
+        MYSTL_CHECK(upstream.allocs == 1);
+        arena.deallocate(p, 100, 8);
+        arena.release();
+        MYSTL_CHECK(upstream.live_bytes == 0);
+
+        // release 之后重新从初始缓冲区开始
+        MYSTL_CHECK(arena.allocate(100, 8) == p);
+    }
+
+    // 每轮在 4 KiB 的栈缓冲区上分配 6.4 KiB 后 release：每轮向上游的申请次数与大小都与第一轮相同
+    void test_monotonic_release_cycles() {
+        counting_resource upstream;
+        alignas(std::max_align_t) char buffer[4096];
+        mystl::monotonic_buffer_resource arena(buffer, sizeof(buffer), &upstream);
+
+        size_t first_allocs = 0, first_largest = 0;
+        for(int cycle = 0; cycle < 64; ++cycle) {
+            upstream.reset_counts();
+            for(int i = 0; i < 100; ++i) {
+                char* p = static_cast<char*>(arena.allocate(64, 8));
+                std::memset(p, cycle, 64);
+            }
+            if(cycle == 0) {
+                first_allocs = upstream.allocs;
+                first_largest = upstream.largest;
+                MYSTL_CHECK(first_allocs != 0);
+            }
+            MYSTL_CHECK(upstream.allocs == first_allocs);
+            MYSTL_CHECK(upstream.largest == first_largest);
+            arena.release();
+            MYSTL_CHECK(upstream.live_bytes == 0);
+        }
+    }
+
+    // 由 initial_size 构造时，release 同样恢复第一次申请的大小
+    void test_monotonic_initial_size() {
+        counting_resource upstream;
+        mystl::monotonic_buffer_resource arena(2048, &upstream);
+        for(int cycle = 0; cycle < 16; ++cycle) {
+            upstream.reset_counts();
+            for(int i = 0; i < 200; ++i)
+                arena.allocate(48, 16);
+            MYSTL_CHECK(upstream.largest <= 2048 * 8);
+            arena.release();
+            MYSTL_CHECK(upstream.live_bytes == 0);
+        }
+    }
+
+    /*****************************************************************************************/
+
+    void test_pool_resource() {
+        counting_resource upstream;
+        {
+            mystl::pool_options opts = { 64, 1024 };
+            mystl::unsynchronized_pool_resource pool(opts, &upstream);
+            MYSTL_CHECK(pool.options().largest_required_pool_block == 1024);
+
+            // 不同大小与对齐的区块，写满后检查互不覆盖
+            std::vector<std::pair<char*, size_t>> blocks;
+            for(size_t i = 0; i < 2000; ++i) {
+                const size_t bytes = 1 + (i * 37) % 1500;
+                const size_t alignment = size_t(1) << (i % 7);
+                char* p = static_cast<char*>(pool.allocate(bytes, alignment));
+                MYSTL_CHECK(is_aligned(p, alignment));
+                std::memset(p, static_cast<int>(i & 0xff), bytes);
+                blocks.push_back(std::make_pair(p, bytes));
+            }
+            for(size_t i = 0; i < blocks.size(); ++i) {
+                for(size_t j = 0; j < blocks[i].second; ++j)
+                    MYSTL_CHECK(static_cast<unsigned char>(blocks[i].first[j]) == (i & 0xff));
+            }
+
+            // 回收的区块被同样大小的下一次分配重用
+            void* p = pool.allocate(48, 8);
+            pool.deallocate(p, 48, 8);
+            MYSTL_CHECK(pool.allocate(48, 8) == p);
+
+            // 大块直接交给上游，回收时立即归还
+            const size_t before = upstream.live_bytes;
+            void* large = pool.allocate(100000, 64);
+            MYSTL_CHECK(is_aligned(large, 64));
+            MYSTL_CHECK(upstream.live_bytes >= before + 100000);
+            pool.deallocate(large, 100000, 64);
+            MYSTL_CHECK(upstream.live_bytes == before);
+
+            // 未回收的大块在 release 时归还
+            pool.allocate(5000, 8);
+            pool.release();
+            MYSTL_CHECK(upstream.live_bytes == 0);
+
+            // release 之后仍可继续使用，析构时归还
+            for(size_t i = 0; i < 100; ++i)
+                pool.allocate(16 + i, 8);
+            MYSTL_CHECK(upstream.live_bytes != 0);
+        }
+        MYSTL_CHECK(upstream.live_bytes == 0);
+    }
+
+    void test_synchronized_pool_resource() {
+        counting_resource upstream;
+        mystl::synchronized_pool_resource pool(&upstream);
+        const size_t nthreads = 4;
+        const size_t per_thread = 5000;
+        std::vector<std::thread> threads;
+        for(size_t t = 0; t < nthreads; ++t) {
+            threads.emplace_back([&pool, t] {
+                std::vector<uint64_t*> live;
+                for(size_t i = 0; i < per_thread; ++i) {
+                    uint64_t* p = static_cast<uint64_t*>(pool.allocate(32, 8));
+                    p[0] = p[3] = t * per_thread + i;
+                    live.push_back(p);
+                    if(i % 3 == 2) {
+                        uint64_t* q = live[live.size() / 2];
+                        live[live.size() / 2] = live.back();
+                        live.pop_back();
+                        MYSTL_CHECK(q[0] == q[3]);
+                        pool.deallocate(q, 32, 8);
+                    }
+                }
+                for(size_t i = 0; i < live.size(); ++i) {
+                    MYSTL_CHECK(live[i][0] == live[i][3]);
+                    MYSTL_CHECK(live[i][0] / per_thread == t);
+                    pool.deallocate(live[i], 32, 8);
+                }
+            });
+        }
+        for(size_t t = 0; t < nthreads; ++t)
+            threads[t].join();
+        pool.release();
+        MYSTL_CHECK(upstream.live_bytes == 0);
+    }
+
+    /*****************************************************************************************/
+
+    void test_vector_with_polymorphic_allocator() {
+        counting_resource upstream;
+        mystl::monotonic_buffer_resource arena(&upstream);
+        {
+            typedef mystl::polymorphic_allocator<int> alloc_type;
+            mystl::vector<int, alloc_type> v{alloc_type(&arena)};
+            for(int i = 0; i < 10000; ++i)
+                v.push_back(i);
+            v.insert(v.begin() + 5, 3, -1);
+            v.erase(v.begin(), v.begin() + 2);
+            MYSTL_CHECK(v.size() == 10001);
+            MYSTL_CHECK(v[3] == -1 && v[6] == 5 && v.back() == 9999);
+            MYSTL_CHECK(v.get_allocator().resource() == &arena);
+            MYSTL_CHECK(upstream.allocs != 0);
+
+            // 复制的容器不传播资源
+            const size_t allocs = upstream.allocs;
+            mystl::vector<int, alloc_type> copy(v);
+            MYSTL_CHECK(copy.get_allocator().resource() == mystl::get_default_resource());
+            MYSTL_CHECK(upstream.allocs == allocs);
+            MYSTL_CHECK(copy == v);
+        }
+        {
+            typedef mystl::polymorphic_allocator<std::string> alloc_type;
+            mystl::vector<std::string, alloc_type> v{alloc_type(&arena)};
+            for(int i = 0; i < 1000; ++i)
+                v.push_back(std::string(40, static_cast<char>('a' + i % 26)));
+            v.erase(v.begin() + 10, v.begin() + 20);
+            MYSTL_CHECK(v.size() == 990);
+            MYSTL_CHECK(v[10] == std::string(40, 'u'));
+        }
+        arena.release();
+        MYSTL_CHECK(upstream.live_bytes == 0);
+    }
+
+} // namespace
+
+int main() {
+    test_monotonic_initial_buffer();
+    test_monotonic_release_cycles();
+    test_monotonic_initial_size();
+    test_pool_resource();
+    test_synchronized_pool_resource();
+    test_vector_with_polymorphic_allocator();
+    std::printf("memory_resource_test: ok\n");
+    return 0;
+}
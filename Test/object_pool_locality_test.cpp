@@ -0,0 +1,121 @@
+// object_pool 的局部性测试
+// 在新建的线程中经 allocator<Node, object_pool_policy>::allocate() 连续分配一批节点，检查：
+// 相继分配的节点地址相差恰好一个槽（跨越 slab 的边界处除外），节点紧密地落在尽量少的 cache line 上；
+// 把这批节点全部回收后再分配（按分配顺序回收与按相反顺序回收各一次），相继分配的节点仍然大多相邻。
+// 另外直接检查 object_pool 的 clear：之后的分配按原来的顺序重新切分同一批 slab。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "object_pool.h"
+#include "test.h"
+
+namespace {
+
+    struct Node {
+        Node* left;
+        Node* right;
+        long value;
+    };
+
+    typedef mystl::allocator<Node, mystl::object_pool_policy> node_allocator;
+    typedef mystl::object_pool<Node> node_pool;
+
+    const size_t kNodes = 100;
+    const size_t kCacheLine = 64;
+
+    // 相继的两个节点地址相差恰好一个槽（不论方向）的对数
+    size_t adjacent_pairs(const std::vector<Node*>& v) {
+        size_t count = 0;
+        for(size_t i = 1; i < v.size(); ++i) {
+            const intptr_t d = reinterpret_cast<intptr_t>(v[i]) - reinterpret_cast<intptr_t>(v[i - 1]);
+            if(d == static_cast<intptr_t>(node_pool::slot_size) || d == -static_cast<intptr_t>(node_pool::slot_size))
+                ++count;
+        }
+        return count;
+    }
+
+    // 这批节点覆盖的 cache line 个数
+    size_t cache_lines(const std::vector<Node*>& v) {
+        std::vector<uintptr_t> lines;
+        for(size_t i = 0; i < v.size(); ++i) {
+            const uintptr_t first = reinterpret_cast<uintptr_t>(v[i]) / kCacheLine;
+            const uintptr_t last = (reinterpret_cast<uintptr_t>(v[i]) + sizeof(Node) - 1) / kCacheLine;
+            for(uintptr_t line = first; line <= last; ++line)
+                lines.push_back(line);
+        }
+        std::sort(lines.begin(), lines.end());
+        return static_cast<size_t>(std::unique(lines.begin(), lines.end()) - lines.begin());
+    }
+
+    std::vector<Node*> allocate_nodes() {
+        std::vector<Node*> v;
+        for(size_t i = 0; i < kNodes; ++i) {
+            Node* p = node_allocator::allocate();
+            MYSTL_CHECK(p != nullptr);
+            p->left = p->right = nullptr;
+            p->value = static_cast<long>(i);
+            v.push_back(p);
+        }
+        return v;
+    }
+
+    void test_global_pool() {
+        // 一批节点最多跨越的 slab 边界数
+        const size_t boundaries = kNodes / node_pool::objects_per_slab + 1;
+
+        std::vector<Node*> v = allocate_nodes();
+        const size_t fresh = adjacent_pairs(v);
+        std::printf("  fresh: %zu/%zu adjacent, %zu cache lines\n", fresh, kNodes - 1, cache_lines(v));
+        MYSTL_CHECK(fresh + boundaries >= kNodes - 1);
+        // 紧密排列时只比节点的总字节数多出首尾与 slab 边界处的零头
+        MYSTL_CHECK(cache_lines(v) <= kNodes * node_pool::slot_size / kCacheLine + 2 * boundaries);
+
+        for(size_t i = 0; i < kNodes; ++i)
+            node_allocator::deallocate(v[i]);
+        v = allocate_nodes();
+        const size_t forward = adjacent_pairs(v);
+        std::printf("  after forward free: %zu/%zu adjacent\n", forward, kNodes - 1);
+
+        for(size_t i = kNodes; i > 0; --i)
+            node_allocator::deallocate(v[i - 1]);
+        v = allocate_nodes();
+        const size_t reverse = adjacent_pairs(v);
+        std::printf("  after reverse free: %zu/%zu adjacent\n", reverse, kNodes - 1);
+
+        // magazine 与全局 object_pool 之间按批交换槽，每次交换至多打断一处相邻
+        const size_t batches = kNodes / mystl::EObjectMagazineBatch + 1;
+        MYSTL_CHECK(forward + batches + boundaries >= kNodes - 1);
+        MYSTL_CHECK(reverse + batches + boundaries >= kNodes - 1);
+
+        for(size_t i = 0; i < kNodes; ++i)
+            node_allocator::deallocate(v[i]);
+    }
+
+    void test_clear() {
+        node_pool pool;
+        const size_t n = node_pool::objects_per_slab * 3 / 2;
+        std::vector<Node*> first;
+        for(size_t i = 0; i < n; ++i)
+            first.push_back(pool.allocate());
+        MYSTL_CHECK(pool.slab_count() == 2);
+
+        pool.clear();
+        for(size_t i = 0; i < n; ++i)
+            MYSTL_CHECK(pool.allocate() == first[i]);
+        MYSTL_CHECK(pool.slab_count() == 2);
+    }
+
+} // namespace
+
+int main() {
+    // 新建的线程没有 magazine，节点来自全局 object_pool 中连续切分的槽
+    std::thread(test_global_pool).join();
+    test_clear();
+    std::printf("object_pool_locality_test: ok\n");
+    return 0;
+}
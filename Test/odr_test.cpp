@@ -0,0 +1,22 @@
+// 头文件的 ODR 测试
+// 两个翻译单元包含 MyTinySTL 的全部头文件后链接为一个程序：头文件中的非内联定义会造成重复定义的链接错误。
+// 运行时再检查两个翻译单元看到的是同一个内存池：一方分配的区块可由另一方回收，统计到的 chunk 总量相同。
+
+#include <cstdio>
+
+#include "odr_test.h"
+#include "test.h"
+
+int main() {
+    void* p = odr_test::other_allocate(64);
+    MYSTL_CHECK(p != nullptr);
+    MYSTL_CHECK(mystl::alloc::stats().heap_bytes == odr_test::other_heap_bytes());
+    MYSTL_CHECK(mystl::alloc::stats().heap_bytes != 0);
+    mystl::alloc::deallocate(p, 64);
+
+    void* q = mystl::alloc::allocate(200);
+    odr_test::other_deallocate(q, 200);
+
+    std::printf("odr_test: ok\n");
+    return 0;
+}
@@ -0,0 +1,43 @@
+#ifndef MY_TINY_ODR_TEST_H_
+#define MY_TINY_ODR_TEST_H_
+
+// odr_test 两个翻译单元共同包含的头文件：包含 MyTinySTL 的全部头文件，并声明另一个翻译单元提供的函数
+
+#include <cstddef>
+
+#include "algo.h"
+#include "algobase.h"
+#include "alloc.h"
+#include "allocator.h"
+#include "btree.h"
+#include "btree_map.h"
+#include "btree_set.h"
+#include "concurrent_queue.h"
+#include "construct.h"
+#include "execution.h"
+#include "flat_hash_map.h"
+#include "flat_hash_set.h"
+#include "flat_hash_table.h"
+#include "function.h"
+#include "functional.h"
+#include "iterator.h"
+#include "memory_resource.h"
+#include "numeric.h"
+#include "object_pool.h"
+#include "small_vector.h"
+#include "thread_pool.h"
+#include "type_traits.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "vector.h"
+
+namespace odr_test {
+
+    // 定义在 odr_test_other.cpp 中
+    void* other_allocate(size_t n);
+    void other_deallocate(void* p, size_t n);
+    size_t other_heap_bytes();
+
+} // namespace odr_test
+
+#endif // MY_TINY_ODR_TEST_H_
@@ -0,0 +1,29 @@
+// odr_test 的第二个翻译单元，与 odr_test.cpp 包含同样的头文件，见 odr_test.cpp
+// 定义 ODR_TEST_MIXED_STATS 时，本翻译单元取与 odr_test.cpp 相反的 MYSTL_ALLOC_STATS 设置，
+// 程序应在静态初始化时检测到不一致并终止
+
+#ifdef ODR_TEST_MIXED_STATS
+#ifdef MYSTL_ALLOC_STATS
+#undef MYSTL_ALLOC_STATS
+#else
+#define MYSTL_ALLOC_STATS
+#endif // MYSTL_ALLOC_STATS
+#endif // ODR_TEST_MIXED_STATS
+
+#include "odr_test.h"
+
+namespace odr_test {
+
+    void* other_allocate(size_t n) {
+        return mystl::alloc::allocate(n);
+    }
+
+    void other_deallocate(void* p, size_t n) {
+        mystl::alloc::deallocate(p, n);
+    }
+
+    size_t other_heap_bytes() {
+        return mystl::alloc::stats().heap_bytes;
+    }
+
+} // namespace odr_test
@@ -0,0 +1,218 @@
+// construct.h 中 uninitialized_relocate 与 relocate_n 的测试
+// 检查：元素的复制在第 k 次时抛出异常（移动构造可能抛出异常，因此应当复制）时，对每个 k，
+// 已构造的新对象全部被销毁，原区间的每个元素保持原值且未被析构；不抛出异常时原区间的对象全部结束生命期；
+// 只能移动且移动不抛出异常的类型逐个移动；可平凡重定位的类型按字节搬移，原对象不再析构；
+// relocate_n 在同一缓冲区内向前与向后平移，区间重叠时结果正确，对象个数不变。
+
+#include <cstddef>
+#include <cstdio>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "construct.h"
+#include "test.h"
+
+namespace {
+
+    struct injected_failure : std::runtime_error {
+        injected_failure() : std::runtime_error("injected failure") {}
+    };
+
+    // 复制在 countdown 归零时抛出异常；移动构造未声明 noexcept，被移动的对象的值变为 -1
+    // live 为尚未析构的对象数，析构后 magic 清零，以发现重复析构
+    class copy_thrower {
+    public:
+        static long live;
+        static long countdown;     // 小于 0 时不抛出
+
+        explicit copy_thrower(int v) : value_(v), magic_(kMagic) { ++live; }
+        copy_thrower(const copy_thrower& rhs) : value_(rhs.checked()), magic_(kMagic) {
+            if(countdown >= 0 && countdown-- == 0)
+                throw injected_failure();
+            ++live;
+        }
+        copy_thrower(copy_thrower&& rhs) : value_(rhs.checked()), magic_(kMagic) {
+            rhs.value_ = -1;
+            ++live;
+        }
+        ~copy_thrower() {
+            checked();
+            magic_ = 0;
+            --live;
+        }
+
+        int value() const { return checked(); }
+
+    private:
+        static const int kMagic = 0x5a5a5a5a;
+        int value_;
+        int magic_;
+
+        int checked() const {
+            MYSTL_CHECK(magic_ == kMagic);
+            return value_;
+        }
+    };
+
+    long copy_thrower::live = 0;
+    long copy_thrower::countdown = -1;
+
+    // 只能移动，移动不抛出异常
+    class move_only {
+    public:
+        static long live;
+
+        explicit move_only(int v) : p_(new int(v)) { ++live; }
+        move_only(move_only&& rhs) noexcept : p_(rhs.p_) { rhs.p_ = nullptr; ++live; }
+        move_only(const move_only&) = delete;
+        move_only& operator=(const move_only&) = delete;
+        ~move_only() { delete p_; --live; }
+
+        int value() const { return p_ == nullptr ? -1 : *p_; }
+
+    private:
+        int* p_;
+    };
+
+    long move_only::live = 0;
+
+    // 特化为可平凡重定位，按字节搬移后原对象不再析构
+    class relocatable {
+    public:
+        static long live;
+
+        explicit relocatable(int v) : p_(new int(v)) { ++live; }
+        relocatable(relocatable&& rhs) noexcept : p_(rhs.p_) { rhs.p_ = nullptr; ++live; }
+        relocatable(const relocatable&) = delete;
+        relocatable& operator=(const relocatable&) = delete;
+        ~relocatable() { delete p_; --live; }
+
+        int value() const { return p_ == nullptr ? -1 : *p_; }
+
+    private:
+        int* p_;
+    };
+
+    long relocatable::live = 0;
+
+} // namespace
+
+namespace mystl {
+    template<>
+    struct is_trivially_relocatable<relocatable> : mystl::m_true_type {};
+} // namespace mystl
+
+namespace {
+
+    const size_t kCount = 8;
+
+    // 未初始化的缓冲区，可容纳 n 个 T
+    template<typename T>
+    T* raw_buffer(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    template<typename T>
+    void free_buffer(T* p) {
+        ::operator delete(p);
+    }
+
+    template<typename T>
+    T* construct_values(size_t n) {
+        T* p = raw_buffer<T>(n);
+        for(size_t i = 0; i < n; ++i)
+            mystl::construct(p + i, static_cast<int>(i * 10 + 1));
+        return p;
+    }
+
+    /*****************************************************************************************/
+
+    void test_relocate_throwing_copy() {
+        for(long k = 0; k <= static_cast<long>(kCount); ++k) {
+            copy_thrower* src = construct_values<copy_thrower>(kCount);
+            copy_thrower* dst = raw_buffer<copy_thrower>(kCount);
+            bool threw = false;
+            copy_thrower::countdown = k;
+            try {
+                mystl::uninitialized_relocate(src, src + kCount, dst);
+            } catch(const injected_failure&) {
+                threw = true;
+            }
+            copy_thrower::countdown = -1;
+            MYSTL_CHECK(threw == (k < static_cast<long>(kCount)));
+            if(threw) {
+                // 新对象已全部销毁，原区间完整
+                MYSTL_CHECK(copy_thrower::live == static_cast<long>(kCount));
+                for(size_t i = 0; i < kCount; ++i)
+                    MYSTL_CHECK(src[i].value() == static_cast<int>(i * 10 + 1));
+                mystl::destroy(src, src + kCount);
+            } else {
+                // 原区间的对象已结束生命期，只剩目标区间的对象
+                MYSTL_CHECK(copy_thrower::live == static_cast<long>(kCount));
+                for(size_t i = 0; i < kCount; ++i)
+                    MYSTL_CHECK(dst[i].value() == static_cast<int>(i * 10 + 1));
+                mystl::destroy(dst, dst + kCount);
+            }
+            MYSTL_CHECK(copy_thrower::live == 0);
+            free_buffer(src);
+            free_buffer(dst);
+        }
+    }
+
+    template<typename T>
+    void test_relocate_nothrow() {
+        T* src = construct_values<T>(kCount);
+        T* dst = raw_buffer<T>(kCount);
+        MYSTL_CHECK(mystl::uninitialized_relocate(src, src + kCount, dst) == dst + kCount);
+        MYSTL_CHECK(T::live == static_cast<long>(kCount));
+        for(size_t i = 0; i < kCount; ++i)
+            MYSTL_CHECK(dst[i].value() == static_cast<int>(i * 10 + 1));
+        mystl::destroy(dst, dst + kCount);
+        MYSTL_CHECK(T::live == 0);
+        free_buffer(src);
+        free_buffer(dst);
+    }
+
+    // 在 2 * kCount 的缓冲区中，把开头的 kCount 个对象向后移 shift 位，再移回原处
+    template<typename T>
+    void test_relocate_n_overlap() {
+        const size_t shifts[] = { 1, 3, kCount / 2, kCount };
+        for(size_t s = 0; s < sizeof(shifts) / sizeof(shifts[0]); ++s) {
+            const size_t shift = shifts[s];
+            T* buf = raw_buffer<T>(2 * kCount);
+            T* first = buf;
+            for(size_t i = 0; i < kCount; ++i)
+                mystl::construct(first + i, static_cast<int>(i * 10 + 1));
+
+            T* moved = first + shift;
+            MYSTL_CHECK(mystl::relocate_n(first, kCount, moved) == moved + kCount);
+            MYSTL_CHECK(T::live == static_cast<long>(kCount));
+            for(size_t i = 0; i < kCount; ++i)
+                MYSTL_CHECK(moved[i].value() == static_cast<int>(i * 10 + 1));
+
+            MYSTL_CHECK(mystl::relocate_n(moved, kCount, first) == first + kCount);
+            MYSTL_CHECK(T::live == static_cast<long>(kCount));
+            for(size_t i = 0; i < kCount; ++i)
+                MYSTL_CHECK(first[i].value() == static_cast<int>(i * 10 + 1));
+
+            // 原地不动
+            MYSTL_CHECK(mystl::relocate_n(first, kCount, first) == first + kCount);
+            mystl::destroy(first, first + kCount);
+            MYSTL_CHECK(T::live == 0);
+            free_buffer(buf);
+        }
+    }
+
+} // namespace
+
+int main() {
+    test_relocate_throwing_copy();
+    test_relocate_nothrow<copy_thrower>();
+    test_relocate_nothrow<move_only>();
+    test_relocate_nothrow<relocatable>();
+    test_relocate_n_overlap<move_only>();
+    test_relocate_n_overlap<relocatable>();
+    std::printf("relocate_test: ok\n");
+    return 0;
+}
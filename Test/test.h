@@ -0,0 +1,49 @@
+#ifndef MY_TINY_TEST_H_
+#define MY_TINY_TEST_H_
+
+// Test/ 下各测试程序的公共部分：不依赖 NDEBUG 的检查宏
+// 每个测试是一个独立的可执行文件，失败时打印位置并以非零值退出，由 ctest 运行
+
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <cstring>
+#endif // __linux__
+
+namespace mystl_test {
+
+    inline void check_failed(const char* expr, const char* file, int line) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+        std::fflush(stderr);
+        std::abort();
+    }
+
+    // 读取 /proc/self/status 中的 VmRSS，单位 KB；不支持时返回 0
+    inline long current_rss_kb() {
+#ifdef __linux__
+        std::FILE* f = std::fopen("/proc/self/status", "r");
+        if(f == nullptr)
+            return 0;
+        char line[256];
+        long value = 0;
+        while(std::fgets(line, sizeof(line), f) != nullptr) {
+            if(std::strncmp(line, "VmRSS:", 6) == 0) {
+                value = std::strtol(line + 6, nullptr, 10);
+                break;
+            }
+        }
+        std::fclose(f);
+        return value;
+#else
+        return 0;
+#endif // __linux__
+    }
+
+} // namespace mystl_test
+
+// 与 assert 不同，Release 构建中同样生效
+#define MYSTL_CHECK(expr) \
+    ((expr) ? (void)0 : mystl_test::check_failed(#expr, __FILE__, __LINE__))
+
+#endif // MY_TINY_TEST_H_
@@ -0,0 +1,253 @@
+// uninitialized.h 的测试
+// 回滚：元素的构造在第 k 次时抛出异常，对每个 k 与每个算法（copy、copy_n、fill、fill_n、move、move_n、
+// default_construct(_n)、value_construct(_n)），检查已构造的元素全部被销毁、没有重复析构，异常原样抛出；
+// 快速路径：可平凡复制的类型经 memmove / memset 复制、移动与填充，各种长度（含 0）与所有字节相同或不同的值
+// 结果与逐个构造一致，返回的结束位置正确，值初始化得到全零，平凡的默认初始化不写入内存。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "uninitialized.h"
+#include "test.h"
+
+namespace {
+
+    struct injected_failure : std::runtime_error {
+        injected_failure() : std::runtime_error("injected failure") {}
+    };
+
+    // 每次构造（默认、由 int、复制、移动）都计数，countdown 归零时抛出异常
+    // live 为尚未析构的对象数，析构后 magic 清零，以发现重复析构
+    class thrower {
+    public:
+        static long live;
+        static long countdown;     // 小于 0 时不抛出
+
+        thrower() : value_(0), magic_(0) { tick(); init(); }
+        explicit thrower(int v) : value_(v), magic_(0) { tick(); init(); }
+        thrower(const thrower& rhs) : value_(rhs.checked()), magic_(0) { tick(); init(); }
+        thrower(thrower&& rhs) : value_(rhs.checked()), magic_(0) { tick(); init(); }
+        thrower& operator=(const thrower&) = delete;
+        ~thrower() {
+            checked();
+            magic_ = 0;
+            --live;
+        }
+
+        int value() const { return checked(); }
+
+    private:
+        static const int kMagic = 0x5a5a5a5a;
+        int value_;
+        int magic_;
+
+        void init() {
+            magic_ = kMagic;
+            ++live;
+        }
+        static void tick() {
+            if(countdown >= 0 && countdown-- == 0)
+                throw injected_failure();
+        }
+        int checked() const {
+            MYSTL_CHECK(magic_ == kMagic);
+            return value_;
+        }
+    };
+
+    long thrower::live = 0;
+    long thrower::countdown = -1;
+
+    const size_t kCount = 10;
+
+    // 依次让第 0、1、2 ... 次构造抛出异常，直到 op 成功；op 在未初始化的 dst 上构造 kCount 个元素
+    template<typename Op>
+    void inject(const char* name, Op op) {
+        const long live_at_entry = thrower::live;
+        thrower* src = static_cast<thrower*>(::operator new(kCount * sizeof(thrower)));
+        for(size_t i = 0; i < kCount; ++i)
+            ::new (static_cast<void*>(src + i)) thrower(static_cast<int>(i));
+        thrower* dst = static_cast<thrower*>(::operator new(kCount * sizeof(thrower)));
+        for(long k = 0; ; ++k) {
+            const long live_before = thrower::live;
+            bool threw = false;
+            thrower::countdown = k;
+            thrower* end = nullptr;
+            try {
+                end = op(src, dst);
+            } catch(const injected_failure&) {
+                threw = true;
+            }
+            thrower::countdown = -1;
+            if(threw) {
+                if(thrower::live != live_before)
+                    std::fprintf(stderr, "%s: %ld objects leaked at k = %ld\n", name, thrower::live - live_before, k);
+                MYSTL_CHECK(thrower::live == live_before);
+                MYSTL_CHECK(k < static_cast<long>(kCount));
+                continue;
+            }
+            MYSTL_CHECK(k == static_cast<long>(kCount));
+            MYSTL_CHECK(end == dst + kCount);
+            MYSTL_CHECK(thrower::live == live_before + static_cast<long>(kCount));
+            mystl::destroy(dst, dst + kCount);
+            break;
+        }
+        mystl::destroy(src, src + kCount);
+        MYSTL_CHECK(thrower::live == live_at_entry);
+        ::operator delete(src);
+        ::operator delete(dst);
+    }
+
+    void test_rollback() {
+        const thrower value(42);
+        const long base = thrower::live;
+        inject("uninitialized_copy", [](thrower* s, thrower* d) {
+            return mystl::uninitialized_copy(s, s + kCount, d);
+        });
+        inject("uninitialized_copy_n", [](thrower* s, thrower* d) {
+            return mystl::uninitialized_copy_n(s, kCount, d);
+        });
+        inject("uninitialized_fill_n", [&](thrower*, thrower* d) {
+            return mystl::uninitialized_fill_n(d, kCount, value);
+        });
+        inject("uninitialized_fill", [&](thrower*, thrower* d) {
+            mystl::uninitialized_fill(d, d + kCount, value);
+            return d + kCount;
+        });
+        inject("uninitialized_move", [](thrower* s, thrower* d) {
+            return mystl::uninitialized_move(s, s + kCount, d);
+        });
+        inject("uninitialized_move_n", [](thrower* s, thrower* d) {
+            return mystl::uninitialized_move_n(s, kCount, d);
+        });
+        inject("uninitialized_default_construct_n", [](thrower*, thrower* d) {
+            return mystl::uninitialized_default_construct_n(d, kCount);
+        });
+        inject("uninitialized_default_construct", [](thrower*, thrower* d) {
+            mystl::uninitialized_default_construct(d, d + kCount);
+            return d + kCount;
+        });
+        inject("uninitialized_value_construct_n", [](thrower*, thrower* d) {
+            return mystl::uninitialized_value_construct_n(d, kCount);
+        });
+        inject("uninitialized_value_construct", [](thrower*, thrower* d) {
+            mystl::uninitialized_value_construct(d, d + kCount);
+            return d + kCount;
+        });
+        MYSTL_CHECK(thrower::live == base);
+    }
+
+    /*****************************************************************************************/
+    // 快速路径
+
+    struct pod {
+        uint16_t a;
+        uint8_t b;
+        uint8_t c;
+        bool operator==(const pod& rhs) const { return a == rhs.a && b == rhs.b && c == rhs.c; }
+    };
+
+    template<typename T>
+    T sample(size_t i) {
+        return static_cast<T>(i * 2654435761u);
+    }
+
+    template<>
+    pod sample<pod>(size_t i) {
+        pod p = { static_cast<uint16_t>(i * 7), static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 3) };
+        return p;
+    }
+
+    template<typename T>
+    void test_fast_paths(const T* fill_values, size_t nvalues) {
+        const size_t lengths[] = { 0, 1, 2, 7, 16, 33, 1000 };
+        for(size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+            const size_t n = lengths[l];
+            std::vector<T> src(n + 1);
+            for(size_t i = 0; i < n; ++i)
+                src[i] = sample<T>(i);
+            // 目标多留一个元素，检查不越界写入
+            std::vector<T> dst(n + 1);
+            const T guard = sample<T>(12345);
+
+            const T* csrc = src.data();
+            dst[n] = guard;
+            MYSTL_CHECK(mystl::uninitialized_copy(csrc, csrc + n, dst.data()) == dst.data() + n);
+            MYSTL_CHECK(std::memcmp(dst.data(), src.data(), n * sizeof(T)) == 0 && dst[n] == guard);
+
+            std::memset(static_cast<void*>(dst.data()), 0xcd, n * sizeof(T));
+            MYSTL_CHECK(mystl::uninitialized_copy_n(src.data(), n, dst.data()) == dst.data() + n);
+            MYSTL_CHECK(std::memcmp(dst.data(), src.data(), n * sizeof(T)) == 0 && dst[n] == guard);
+
+            std::memset(static_cast<void*>(dst.data()), 0xcd, n * sizeof(T));
+            MYSTL_CHECK(mystl::uninitialized_move(src.data(), src.data() + n, dst.data()) == dst.data() + n);
+            MYSTL_CHECK(std::memcmp(dst.data(), src.data(), n * sizeof(T)) == 0 && dst[n] == guard);
+
+            std::memset(static_cast<void*>(dst.data()), 0xcd, n * sizeof(T));
+            MYSTL_CHECK(mystl::uninitialized_move_n(src.data(), n, dst.data()) == dst.data() + n);
+            MYSTL_CHECK(std::memcmp(dst.data(), src.data(), n * sizeof(T)) == 0 && dst[n] == guard);
+
+            for(size_t v = 0; v < nvalues; ++v) {
+                const T value = fill_values[v];
+                std::memset(static_cast<void*>(dst.data()), 0xcd, n * sizeof(T));
+                MYSTL_CHECK(mystl::uninitialized_fill_n(dst.data(), n, value) == dst.data() + n);
+                for(size_t i = 0; i < n; ++i)
+                    MYSTL_CHECK(std::memcmp(&dst[i], &value, sizeof(T)) == 0);
+                MYSTL_CHECK(dst[n] == guard);
+
+                std::memset(static_cast<void*>(dst.data()), 0xcd, n * sizeof(T));
+                mystl::uninitialized_fill(dst.data(), dst.data() + n, value);
+                for(size_t i = 0; i < n; ++i)
+                    MYSTL_CHECK(std::memcmp(&dst[i], &value, sizeof(T)) == 0);
+                MYSTL_CHECK(dst[n] == guard);
+            }
+
+            // 平凡的默认初始化不写入内存
+            std::memset(static_cast<void*>(dst.data()), 0xcd, n * sizeof(T));
+            MYSTL_CHECK(mystl::uninitialized_default_construct_n(dst.data(), n) == dst.data() + n);
+            for(size_t i = 0; i < n * sizeof(T); ++i)
+                MYSTL_CHECK(reinterpret_cast<const unsigned char*>(dst.data())[i] == 0xcd);
+            MYSTL_CHECK(dst[n] == guard);
+        }
+    }
+
+    template<typename T>
+    void test_value_construct() {
+        const size_t n = 777;
+        std::vector<unsigned char> raw((n + 1) * sizeof(T), 0xcd);
+        T* p = reinterpret_cast<T*>(raw.data());
+        MYSTL_CHECK(mystl::uninitialized_value_construct_n(p, n) == p + n);
+        for(size_t i = 0; i < n * sizeof(T); ++i)
+            MYSTL_CHECK(raw[i] == 0);
+        MYSTL_CHECK(raw[n * sizeof(T)] == 0xcd);
+        MYSTL_CHECK(mystl::uninitialized_value_construct_n(p, 0) == p);
+    }
+
+} // namespace
+
+int main() {
+    test_rollback();
+
+    const char chars[] = { 0, 'x', static_cast<char>(-1) };
+    test_fast_paths<char>(chars, 3);
+    const int ints[] = { 0, -1, 0x01010101, 0x01020304, 7 };
+    test_fast_paths<int>(ints, 5);
+    const uint64_t words[] = { 0, ~uint64_t(0), 0x8080808080808080ULL, 0x0102030405060708ULL };
+    test_fast_paths<uint64_t>(words, 4);
+    const double doubles[] = { 0.0, -0.0, 1.5 };
+    test_fast_paths<double>(doubles, 3);
+    const pod pods[] = { { 0, 0, 0 }, { 0x4141, 0x41, 0x41 }, { 1, 2, 3 } };
+    test_fast_paths<pod>(pods, 3);
+
+    test_value_construct<int>();
+    test_value_construct<double>();
+    test_value_construct<int*>();
+
+    std::printf("uninitialized_test: ok\n");
+    return 0;
+}
@@ -0,0 +1,376 @@
+// vector 的测试
+// 差分测试：对 mystl::vector 与 std::vector 施加同一串随机操作（push_back、emplace、insert、erase、
+// resize、assign、reserve、shrink_to_fit、复制、移动、swap 等），每一步后比较内容；
+// 元素类型为 int、std::string 与特化了 is_trivially_relocatable 的持有堆指针的类型，覆盖 memcpy 与逐个搬移两种路径。
+// 异常安全：元素的复制、移动与赋值在第 k 次时抛出异常，对每个操作依次取 k = 0, 1, 2, ... 直到操作成功，
+// 检查没有泄漏或重复析构的对象；push_back、emplace_back、尾部 insert、reserve 与 shrink_to_fit
+// 满足强异常安全，抛出异常后内容与容量不变，其它操作满足基本异常安全，容器中的元素仍然有效。
+
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "vector.h"
+#include "test.h"
+
+namespace {
+
+    // 只持有一个堆指针的类型，按字节搬移后放弃原对象是安全的
+    class boxed {
+    public:
+        boxed() : p_(new int(0)) {}
+        explicit boxed(int v) : p_(new int(v)) {}
+        boxed(const boxed& rhs) : p_(new int(*rhs.p_)) {}
+        boxed(boxed&& rhs) noexcept : p_(rhs.p_) { rhs.p_ = nullptr; }
+        boxed& operator=(const boxed& rhs) {
+            boxed tmp(rhs);
+            std::swap(p_, tmp.p_);
+            return *this;
+        }
+        boxed& operator=(boxed&& rhs) noexcept {
+            std::swap(p_, rhs.p_);
+            return *this;
+        }
+        ~boxed() { delete p_; }
+
+        int value() const { return p_ == nullptr ? -1 : *p_; }
+        bool operator==(const boxed& rhs) const { return value() == rhs.value(); }
+
+    private:
+        int* p_;
+    };
+
+} // namespace
+
+namespace mystl {
+    template<>
+    struct is_trivially_relocatable<boxed> : mystl::m_true_type {};
+} // namespace mystl
+
+namespace {
+
+    template<typename T> T make_value(int i);
+    template<> int make_value<int>(int i) { return i; }
+    template<> std::string make_value<std::string>(int i) {
+        // 超过短字符串优化的长度，元素持有堆上的缓冲区
+        return std::string(20 + i % 7, static_cast<char>('a' + i % 26)) + std::to_string(i);
+    }
+    template<> boxed make_value<boxed>(int i) { return boxed(i); }
+
+    /*****************************************************************************************/
+    // 差分测试
+
+    template<typename T>
+    bool same(const mystl::vector<T>& v, const std::vector<T>& s) {
+        if(v.size() != s.size() || v.empty() != s.empty() || v.capacity() < v.size())
+            return false;
+        for(size_t i = 0; i < s.size(); ++i) {
+            if(!(v[i] == s[i]))
+                return false;
+        }
+        return v.size() == 0 || (&v.front() == v.data() && &v.back() == v.data() + v.size() - 1);
+    }
+
+    // 简单的线性同余随机数，与 std::vector 使用同一串操作
+    struct lcg {
+        unsigned long long x;
+        explicit lcg(unsigned long long seed) : x(seed) {}
+        size_t below(size_t n) {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+            return n == 0 ? 0 : static_cast<size_t>((x >> 33) % n);
+        }
+    };
+
+    template<typename T>
+    void test_differential(unsigned long long seed) {
+        lcg rng(seed);
+        mystl::vector<T> v;
+        std::vector<T> s;
+        for(int step = 0; step < 20000; ++step) {
+            const int value = static_cast<int>(rng.below(100000));
+            const size_t pos = rng.below(s.size() + 1);
+            switch(rng.below(16)) {
+            case 0: case 1: case 2:
+                v.push_back(make_value<T>(value));
+                s.push_back(make_value<T>(value));
+                break;
+            case 3: {
+                const T x = make_value<T>(value);
+                v.push_back(x);
+                s.push_back(x);
+                break;
+            }
+            case 4:
+                v.emplace(v.begin() + pos, make_value<T>(value));
+                s.emplace(s.begin() + static_cast<std::ptrdiff_t>(pos), make_value<T>(value));
+                break;
+            case 5:
+                // 插入容器内已有的元素
+                if(!s.empty()) {
+                    const size_t from = rng.below(s.size());
+                    v.insert(v.begin() + pos, v[from]);
+                    s.insert(s.begin() + static_cast<std::ptrdiff_t>(pos), s[from]);
+                }
+                break;
+            case 6: {
+                const size_t n = rng.below(20);
+                if(!s.empty() && rng.below(2) == 0) {
+                    const size_t from = rng.below(s.size());
+                    v.insert(v.begin() + pos, n, v[from]);
+                    s.insert(s.begin() + static_cast<std::ptrdiff_t>(pos), n, T(s[from]));
+                } else {
+                    v.insert(v.begin() + pos, n, make_value<T>(value));
+                    s.insert(s.begin() + static_cast<std::ptrdiff_t>(pos), n, make_value<T>(value));
+                }
+                break;
+            }
+            case 7: {
+                std::vector<T> src;
+                for(size_t i = rng.below(30); i > 0; --i)
+                    src.push_back(make_value<T>(value + static_cast<int>(i)));
+                v.insert(v.begin() + pos, src.data(), src.data() + src.size());
+                s.insert(s.begin() + static_cast<std::ptrdiff_t>(pos), src.begin(), src.end());
+                break;
+            }
+            case 8:
+                if(!s.empty()) {
+                    const size_t at = rng.below(s.size());
+                    MYSTL_CHECK(v.erase(v.begin() + at) == v.begin() + at);
+                    s.erase(s.begin() + static_cast<std::ptrdiff_t>(at));
+                }
+                break;
+            case 9: {
+                const size_t first = rng.below(s.size() + 1);
+                const size_t last = first + rng.below(s.size() - first + 1);
+                v.erase(v.begin() + first, v.begin() + last);
+                s.erase(s.begin() + static_cast<std::ptrdiff_t>(first), s.begin() + static_cast<std::ptrdiff_t>(last));
+                break;
+            }
+            case 10: {
+                const size_t n = rng.below(s.size() + 40);
+                if(rng.below(2) == 0) {
+                    v.resize(n);
+                    s.resize(n);
+                } else {
+                    v.resize(n, make_value<T>(value));
+                    s.resize(n, make_value<T>(value));
+                }
+                break;
+            }
+            case 11:
+                if(!s.empty()) {
+                    v.pop_back();
+                    s.pop_back();
+                }
+                break;
+            case 12:
+                if(rng.below(2) == 0) {
+                    v.reserve(s.size() + rng.below(100));
+                    MYSTL_CHECK(v.capacity() >= s.size());
+                } else {
+                    v.shrink_to_fit();
+                    MYSTL_CHECK(v.capacity() == v.size());
+                }
+                break;
+            case 13: {
+                const size_t n = rng.below(60);
+                if(rng.below(2) == 0) {
+                    v.assign(n, make_value<T>(value));
+                    s.assign(n, make_value<T>(value));
+                } else {
+                    std::vector<T> src;
+                    for(size_t i = 0; i < n; ++i)
+                        src.push_back(make_value<T>(value + static_cast<int>(i)));
+                    v.assign(src.data(), src.data() + src.size());
+                    s.assign(src.begin(), src.end());
+                }
+                break;
+            }
+            case 14: {
+                // 复制、移动与 swap
+                mystl::vector<T> copy(v);
+                MYSTL_CHECK(copy == v);
+                mystl::vector<T> moved(std::move(copy));
+                MYSTL_CHECK(copy.empty());
+                mystl::vector<T> other;
+                other.swap(moved);
+                v = other;
+                MYSTL_CHECK(same(v, s));
+                v = std::move(other);
+                break;
+            }
+            default:
+                if(rng.below(50) == 0) {
+                    v.clear();
+                    s.clear();
+                }
+                break;
+            }
+            MYSTL_CHECK(same(v, s));
+        }
+    }
+
+    /*****************************************************************************************/
+    // 异常安全
+
+    struct injected_failure : std::runtime_error {
+        injected_failure() : std::runtime_error("injected failure") {}
+    };
+
+    // 元素的复制、移动与赋值计数，countdown 归零时抛出异常；live 为尚未析构的对象数，被移动的对象的值变为 -1
+    class thrower {
+    public:
+        static long live;
+        static long countdown;     // 小于 0 时不抛出
+
+        explicit thrower(int v) : value_(v), magic_(kMagic) { ++live; }
+        thrower(const thrower& rhs) : value_(rhs.checked()), magic_(kMagic) { tick(); ++live; }
+        // 移动构造可能抛出异常，vector 扩容时应改用复制以保证强异常安全
+        thrower(thrower&& rhs) : value_(rhs.checked()), magic_(kMagic) {
+            tick();
+            rhs.value_ = -1;
+            ++live;
+        }
+        thrower& operator=(const thrower& rhs) {
+            checked();
+            tick();
+            value_ = rhs.checked();
+            return *this;
+        }
+        thrower& operator=(thrower&& rhs) {
+            checked();
+            tick();
+            value_ = rhs.checked();
+            rhs.value_ = -1;
+            return *this;
+        }
+        ~thrower() {
+            checked();
+            magic_ = 0;
+            --live;
+        }
+
+        int value() const { return checked(); }
+
+    private:
+        static const int kMagic = 0x5a5a5a5a;
+        int value_;
+        int magic_;
+
+        static void tick() {
+            if(countdown >= 0 && countdown-- == 0)
+                throw injected_failure();
+        }
+        // 使用已析构或未构造的对象时失败
+        int checked() const {
+            MYSTL_CHECK(magic_ == kMagic);
+            return value_;
+        }
+    };
+
+    long thrower::live = 0;
+    long thrower::countdown = -1;
+
+    typedef mystl::vector<thrower> tvec;
+
+    tvec make_tvec(size_t n, size_t cap) {
+        tvec v;
+        v.reserve(cap);
+        for(size_t i = 0; i < n; ++i)
+            v.emplace_back(static_cast<int>(i));
+        return v;
+    }
+
+    std::vector<int> values_of(const tvec& v) {
+        std::vector<int> r;
+        for(size_t i = 0; i < v.size(); ++i)
+            r.push_back(v[i].value());
+        return r;
+    }
+
+    // 依次让第 0、1、2 ... 次复制或移动抛出异常，直到 op 成功
+    // strong 为 true 时检查抛出异常后内容与容量不变，否则只检查元素仍然有效
+    template<typename Op>
+    void inject(size_t n, size_t cap, bool strong, Op op) {
+        for(long k = 0; ; ++k) {
+            const long live_before = thrower::live;
+            bool threw = false;
+            {
+                tvec v = make_tvec(n, cap);
+                const std::vector<int> before = values_of(v);
+                const size_t cap_before = v.capacity();
+                thrower::countdown = k;
+                try {
+                    op(v);
+                } catch(const injected_failure&) {
+                    threw = true;
+                }
+                thrower::countdown = -1;
+                MYSTL_CHECK(thrower::live == live_before + static_cast<long>(v.size()));
+                const std::vector<int> after = values_of(v);
+                if(threw && strong) {
+                    MYSTL_CHECK(after == before);
+                    MYSTL_CHECK(v.capacity() == cap_before);
+                }
+                // 仍然可以继续使用
+                v.emplace_back(-2);
+                v.erase(v.begin());
+            }
+            MYSTL_CHECK(thrower::live == live_before);
+            if(!threw)
+                break;
+            MYSTL_CHECK(k < 1000);
+        }
+    }
+
+    void test_exception_safety() {
+        const thrower x(7);
+        const size_t sizes[] = { 0, 1, 5, 16 };
+        for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+            const size_t n = sizes[i];
+            // 不扩容与扩容两种情况
+            const size_t caps[] = { n + 8, n };
+            for(size_t j = 0; j < 2; ++j) {
+                const size_t cap = caps[j];
+                inject(n, cap, true, [&](tvec& v) { v.push_back(x); });
+                inject(n, cap, true, [&](tvec& v) { v.push_back(thrower(8)); });
+                inject(n, cap, true, [&](tvec& v) { v.emplace_back(9); });
+                inject(n, cap, true, [&](tvec& v) { v.insert(v.end(), x); });
+                inject(n, cap, true, [&](tvec& v) { v.reserve(cap + 10); });
+                inject(n, cap, true, [&](tvec& v) { v.shrink_to_fit(); });
+                inject(n, cap, false, [&](tvec& v) { v.insert(v.begin() + v.size() / 2, x); });
+                inject(n, cap, false, [&](tvec& v) { v.insert(v.begin(), 3, x); });
+                inject(n, cap, false, [&](tvec& v) { v.insert(v.begin() + v.size() / 3, 12, x); });
+                inject(n, cap, false, [&](tvec& v) {
+                    const thrower src[] = { thrower(1), thrower(2), thrower(3), thrower(4) };
+                    v.insert(v.begin() + v.size() / 2, src, src + 4);
+                });
+                inject(n, cap, false, [&](tvec& v) {
+                    if(!v.empty())
+                        v.erase(v.begin());
+                });
+                inject(n, cap, false, [&](tvec& v) { v.erase(v.begin(), v.begin() + v.size() / 2); });
+                inject(n, cap, false, [&](tvec& v) { v.resize(v.size() + 9, x); });
+                inject(n, cap, false, [&](tvec& v) { v.assign(n + 3, x); });
+                inject(n, cap, false, [&](tvec& v) {
+                    tvec copy(v);
+                    v = copy;
+                });
+            }
+        }
+        MYSTL_CHECK(thrower::live == 1);
+    }
+
+} // namespace
+
+int main() {
+    test_differential<int>(1);
+    test_differential<std::string>(2);
+    test_differential<boxed>(3);
+    test_exception_safety();
+    std::printf("vector_test: ok\n");
+    return 0;
+}